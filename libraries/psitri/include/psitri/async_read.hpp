@@ -0,0 +1,328 @@
+#pragma once
+#include <coroutine>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <psitri/lock_policy.hpp>
+#include <psitri/scoped_exit.hpp>
+#include <sal/allocator_session.hpp>
+#include <utility>
+#include <vector>
+
+namespace psitri
+{
+   template <class T>
+   class read_task;
+   template <class LockPolicy>
+   class basic_read_scheduler;
+
+   namespace detail
+   {
+      /// Ends a read_task by resuming whoever awaited it, if anyone.
+      struct resume_continuation
+      {
+         bool await_ready() noexcept { return false; }
+
+         template <class Promise>
+         std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> h) noexcept
+         {
+            if (auto c = h.promise().continuation)
+               return c;
+            return std::noop_coroutine();
+         }
+         void await_resume() noexcept {}
+      };
+
+      struct read_promise_base
+      {
+         std::coroutine_handle<> continuation;
+         std::exception_ptr      error;
+
+         std::suspend_always initial_suspend() noexcept { return {}; }
+         resume_continuation final_suspend() noexcept { return {}; }
+
+         void unhandled_exception() noexcept { error = std::current_exception(); }
+      };
+
+      template <class T>
+      struct read_promise : read_promise_base
+      {
+         std::optional<T> value;
+
+         read_task<T> get_return_object() noexcept;
+         void         return_value(T v) { value.emplace(std::move(v)); }
+
+         T result()
+         {
+            if (error)
+               std::rethrow_exception(error);
+            return std::move(*value);
+         }
+      };
+
+      template <>
+      struct read_promise<void> : read_promise_base
+      {
+         read_task<void> get_return_object() noexcept;
+         void            return_void() noexcept {}
+
+         void result()
+         {
+            if (error)
+               std::rethrow_exception(error);
+         }
+      };
+
+      /// The lookups one read scheduler is running: those ready to resume
+      /// and those parked until the page of their next node arrives.
+      class read_parking
+      {
+        public:
+         /// A parked lookup is resumed after this many polls even if its page
+         /// still looks absent; it then simply faults.
+         static constexpr uint32_t max_polls = 64;
+
+         /// The parking of the scheduler running on this thread, if any.
+         static read_parking*& current() noexcept
+         {
+            static thread_local read_parking* cur = nullptr;
+            return cur;
+         }
+
+         void ready(std::coroutine_handle<> h) { _ready.push_back(h); }
+
+         void park(std::coroutine_handle<> h, const sal::allocator_session& session,
+                   sal::ptr_address adr)
+         {
+            _parked.push_back({h, &session, adr, 0});
+            ++_parks;
+         }
+
+         /// Resume every ready lookup, including ones made ready meanwhile.
+         void resume_ready()
+         {
+            while (!_ready.empty())
+            {
+               auto batch = std::move(_ready);
+               _ready.clear();
+               for (auto h : batch)
+                  h.resume();
+            }
+         }
+
+         /// Make ready the parked lookups whose page arrived.  If none did,
+         /// the longest parked one is made ready anyway: its read is the
+         /// oldest in flight, and faulting on it beats idling the thread.
+         void poll()
+         {
+            size_t kept = 0;
+            for (auto& p : _parked)
+            {
+               if (++p.polls >= max_polls || p.session->is_resident(p.adr))
+                  _ready.push_back(p.handle);
+               else
+                  _parked[kept++] = p;
+            }
+            _parked.resize(kept);
+            if (_ready.empty() && !_parked.empty())
+            {
+               _ready.push_back(_parked.front().handle);
+               _parked.erase(_parked.begin());
+            }
+         }
+
+         bool     idle() const noexcept { return _ready.empty() && _parked.empty(); }
+         size_t   parked() const noexcept { return _parked.size(); }
+         uint64_t parks() const noexcept { return _parks; }
+
+        private:
+         struct parked_read
+         {
+            std::coroutine_handle<>       handle;
+            const sal::allocator_session* session;
+            sal::ptr_address              adr;
+            uint32_t                      polls;
+         };
+
+         std::vector<std::coroutine_handle<>> _ready;
+         std::vector<parked_read>             _parked;
+         uint64_t                             _parks = 0;
+      };
+
+      /// Awaited before reading a node that is not resident: starts its read
+      /// and parks the lookup with the running scheduler.  With no scheduler
+      /// on this thread it does not suspend, and reading the node faults.
+      struct page_wait
+      {
+         const sal::allocator_session& session;
+         sal::ptr_address              adr;
+
+         bool await_ready() const noexcept { return read_parking::current() == nullptr; }
+         void await_suspend(std::coroutine_handle<> h) const
+         {
+            session.will_need(adr);
+            read_parking::current()->park(h, session, adr);
+         }
+         void await_resume() const noexcept {}
+      };
+   }  // namespace detail
+
+   /**
+    * A lazily started coroutine returned by the async read API
+    * (cursor::async_get(), transaction::async_get()).
+    *
+    * Awaiting it from another read_task runs it to completion and yields its
+    * result; the awaiting coroutine continues on the same thread.  A lookup
+    * that reaches a node whose page is not in RAM starts the page's read and
+    * suspends until it arrives, so a basic_read_scheduler running many tasks
+    * keeps their storage reads in flight together.
+    */
+   template <class T = void>
+   class [[nodiscard]] read_task
+   {
+     public:
+      using promise_type = detail::read_promise<T>;
+
+      read_task() = default;
+      read_task(read_task&& other) noexcept : _handle(std::exchange(other._handle, {})) {}
+      read_task& operator=(read_task&& other) noexcept
+      {
+         if (this != &other)
+         {
+            if (_handle)
+               _handle.destroy();
+            _handle = std::exchange(other._handle, {});
+         }
+         return *this;
+      }
+      ~read_task()
+      {
+         if (_handle)
+            _handle.destroy();
+      }
+
+      bool done() const noexcept { return !_handle || _handle.done(); }
+
+      auto operator co_await() noexcept
+      {
+         struct awaiter
+         {
+            std::coroutine_handle<promise_type> handle;
+
+            bool await_ready() const noexcept { return handle.done(); }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept
+            {
+               handle.promise().continuation = caller;
+               return handle;
+            }
+            T await_resume() { return handle.promise().result(); }
+         };
+         return awaiter{_handle};
+      }
+
+     private:
+      friend promise_type;
+      template <class LockPolicy>
+      friend class basic_read_scheduler;
+
+      explicit read_task(std::coroutine_handle<promise_type> h) noexcept : _handle(h) {}
+
+      std::coroutine_handle<promise_type> _handle;
+   };
+
+   namespace detail
+   {
+      template <class T>
+      read_task<T> read_promise<T>::get_return_object() noexcept
+      {
+         return read_task<T>(std::coroutine_handle<read_promise<T>>::from_promise(*this));
+      }
+
+      inline read_task<void> read_promise<void>::get_return_object() noexcept
+      {
+         return read_task<void>(std::coroutine_handle<read_promise<void>>::from_promise(*this));
+      }
+   }  // namespace detail
+
+   /**
+    * Runs read_tasks on one thread, resuming whichever can make progress
+    * while the others wait for their pages, so a single thread keeps
+    * hundreds of beyond-RAM lookups in flight.
+    *
+    * Tasks run on the thread that calls run(), which must be the thread
+    * whose sessions the tasks read through.  spawn() may be called from any
+    * thread or fiber; the queue it feeds is guarded by the policy's
+    * mutex_type, so a fiber scheduler's policy yields instead of blocking.
+    */
+   template <class LockPolicy = std_lock_policy>
+   class basic_read_scheduler
+   {
+     public:
+      /// Queue @p task to start on the next round of run().
+      void spawn(read_task<> task)
+      {
+         std::lock_guard lock(_mutex);
+         _incoming.push_back(std::move(task));
+      }
+
+      /// Run spawned tasks, including ones they spawn, until all have
+      /// finished.  Rethrows the first exception a task ended with.
+      void run()
+      {
+         auto* outer = std::exchange(detail::read_parking::current(), &_parking);
+         scoped_exit restore([&] { detail::read_parking::current() = outer; });
+         for (;;)
+         {
+            {
+               std::lock_guard lock(_mutex);
+               for (auto& t : _incoming)
+               {
+                  _parking.ready(t._handle);
+                  _tasks.push_back(std::move(t));
+               }
+               _incoming.clear();
+            }
+            _parking.resume_ready();
+            reap();
+            if (_parking.idle())
+            {
+               std::lock_guard lock(_mutex);
+               if (_incoming.empty())
+                  return;
+               continue;
+            }
+            _parking.poll();
+         }
+      }
+
+      /// Lookups currently waiting for a page.
+      size_t parked() const noexcept { return _parking.parked(); }
+
+      /// Times a lookup suspended to wait for a page, over this scheduler's life.
+      uint64_t parks() const noexcept { return _parking.parks(); }
+
+     private:
+      void reap()
+      {
+         std::exception_ptr error;
+         std::erase_if(_tasks,
+                       [&](const read_task<>& t)
+                       {
+                          if (!t.done())
+                             return false;
+                          if (!error)
+                             error = t._handle.promise().error;
+                          return true;
+                       });
+         if (error)
+            std::rethrow_exception(error);
+      }
+
+      typename LockPolicy::mutex_type _mutex;
+      std::vector<read_task<>>        _incoming;
+      std::vector<read_task<>>        _tasks;
+      detail::read_parking            _parking;
+   };
+
+   using read_scheduler = basic_read_scheduler<std_lock_policy>;
+}  // namespace psitri
@@ -1,5 +1,6 @@
 #pragma once
 #include <cstring>
+#include <psitri/async_read.hpp>
 #include <psitri/count_keys.hpp>
 #include <psitri/node/inner.hpp>
 #include <psitri/node/leaf.hpp>
@@ -8,7 +9,9 @@
 #include <psitri/value_pin.hpp>
 #include <psitri/value_type.hpp>
 #include <sal/smart_ptr.hpp>
+#include <span>
 #include <stdexcept>
+#include <string>
 #include <utility>
 
 namespace psitri
@@ -148,7 +151,8 @@ namespace psitri
       /// checks if the position is after last key
       bool is_end() const noexcept { return depth() == 0 and _path[0].branch == _root_end_branch; }
 
-      /// seek to the first key that is greater than or equal to the given key
+      /// seek to the first key that is greater than or equal to the given key;
+      /// starts at the current leaf instead of the root when its keys span it
       /// @return is_end()
       bool lower_bound(key_view key) noexcept;
       bool upper_bound(key_view key) noexcept;
@@ -199,6 +203,29 @@ namespace psitri
          return true;
       }
 
+      /// Looks up every key in @p keys, calling @p lambda(index, value) for
+      /// each one that get(key, lambda) would find, in no particular order.
+      ///
+      /// Keys are looked up a group at a time, all advancing one level per
+      /// step, and each key's next control block and node are prefetched a
+      /// step before they are read, so the cache misses of the group overlap
+      /// instead of being taken one after another.  The value view is only
+      /// valid during the callback.
+      /// @return the number of keys found
+      size_t get_many(std::span<const key_view>                 keys,
+                      std::invocable<size_t, value_view> auto&& lambda) const;
+
+      /// Looks up @p key like get<T>(key), as a coroutine: before reading a
+      /// node whose page is not in RAM it starts the page's read and
+      /// suspends, so the lookups a read_scheduler runs overlap their
+      /// storage reads.  The task keeps the tree this cursor had and a copy
+      /// of the key; awaited outside a scheduler it never suspends.
+      template <ConstructibleBuffer T = std::string>
+      read_task<std::optional<T>> async_get(key_view key) const
+      {
+         return async_get_impl<T>(_node, _version, std::string(key));
+      }
+
       /**
        * Get the value at the specified key into a buffer
        * @tparam Buffer Type that supports resize() and data() for contiguous memory access
@@ -245,11 +272,20 @@ namespace psitri
       }
 
      private:
+      /// Lookups get_many() keeps in flight at once.
+      static constexpr uint32_t get_many_group = 16;
+
       int32_t  get_impl(key_view key, Buffer auto* buffer) noexcept;
+      template <ConstructibleBuffer T>
+      static read_task<std::optional<T>> async_get_impl(sal::smart_ptr<sal::alloc_header> root,
+                                                        uint64_t                          version,
+                                                        std::string                       key);
+      bool     get_leaf_value(const leaf_node* l, key_view key, value_view& value) const noexcept;
       key_info get_key_info_impl(key_view key) noexcept;
       bool     next_impl() noexcept;
       bool     prev_impl() noexcept;
       bool     lower_bound_impl(key_view key) noexcept;
+      bool     resume_in_leaf(key_view& key) noexcept;
 
       auto visit(ptr_address adr, auto&& lambda);
 
@@ -270,12 +306,20 @@ namespace psitri
       branch_number                     _root_end_branch;
       uint64_t                          _version = UINT64_MAX;
 
+      /// True if the leaf entry was created after @p version.
+      static bool is_leaf_entry_newer(const leaf_node* l,
+                                      branch_number    bn,
+                                      uint64_t         version) noexcept
+      {
+         const uint64_t created_at = l->get_version(bn);
+         return version != UINT64_MAX && created_at != 0 &&
+                version_newer_than(created_at, version, value_version_bits);
+      }
+
       /// Check if the current leaf entry is hidden at the cursor's version.
       bool is_leaf_entry_hidden(const leaf_node* l, branch_number bn) const noexcept
       {
-         const uint64_t created_at = l->get_version(bn);
-         if (_version != UINT64_MAX && created_at != 0 &&
-             version_newer_than(created_at, _version, value_version_bits))
+         if (is_leaf_entry_newer(l, bn, _version))
             return true;
          if (l->get_value_type(bn) != leaf_node::value_type_flag::value_node)
             return false;
@@ -382,14 +426,42 @@ namespace psitri
          return next();  // skip exact match; true=found next, false=at end
       return true;       // already positioned past key
    }
+   /// If the cursor is on an entry of a leaf whose keys span @p key, the
+   /// search for @p key can start at that leaf instead of the root: the
+   /// leaf holds the key's lower bound.  Leaves the cursor at the leaf with
+   /// its entry's key dropped and @p key trimmed to the part the leaf
+   /// stores, and @return true; else @return false with nothing changed.
+   inline bool cursor::resume_in_leaf(key_view& key) noexcept
+   {
+      auto ref = _node.session()->get_ref<node>(_path_back->adr);
+      if (ref->type() != node_type::leaf)
+         return false;
+      auto* l = static_cast<const leaf_node*>(ref.obj());
+      if (_path_back->branch >= l->num_branches())
+         return false;  // rend, or no entry yet
+      const uint32_t base = _key_len - _path_back->prefix_len;
+      if (!key.starts_with(key_view(_key_buf.data(), base)))
+         return false;
+      key_view rest = key.substr(base);
+      if (rest < l->get_key(branch_zero) ||
+          rest > l->get_key(branch_number(l->num_branches() - 1)))
+         return false;
+      key                    = rest;
+      _key_len               = base;
+      _path_back->prefix_len = 0;
+      return true;
+   }
    inline bool cursor::lower_bound_impl(key_view key) noexcept
    {
       if (sal::null_ptr_address == _node.address()) [[unlikely]]
          return false;
-      seek_rend();
+      if (!resume_in_leaf(key))
+         seek_rend();
       while (true)
       {
-         const node* n = _node.session()->get_ref<node>(_path_back->adr).obj();
+         auto        ref = _node.session()->get_ref<node>(_path_back->adr);
+         const node* n   = ref.obj();
+         ref.maybe_update_read_stats(n->size());
          switch (n->type())
          {
             [[unlikely]] case node_type::leaf:
@@ -469,10 +541,13 @@ namespace psitri
 
    int32_t cursor::get_impl(key_view key, Buffer auto* buffer) noexcept
    {
-      seek_rend();
+      if (!resume_in_leaf(key))
+         seek_rend();
       while (true)
       {
-         const node* n = _node.session()->get_ref<node>(_path_back->adr).obj();
+         auto        ref = _node.session()->get_ref<node>(_path_back->adr);
+         const node* n   = ref.obj();
+         ref.maybe_update_read_stats(n->size());
          switch (n->type())
          {
             [[likely]] case node_type::inner:
@@ -518,13 +593,14 @@ namespace psitri
                   }
                   case leaf_node::value_type_flag::value_node:
                   {
-                     auto ref = _node.session()->get_ref<value_node>(
+                     auto vref = _node.session()->get_ref<value_node>(
                          l->get_value_address(_path_back->branch));
-                     auto [offset, idx] = ref->find_version(_version);
+                     vref.maybe_update_read_stats(vref->size());
+                     auto [offset, idx] = vref->find_version(_version);
                      if (offset == value_node::offset_tombstone ||
                          offset == value_node::offset_null)
                         return seek_end(), cursor::value_not_found;
-                     auto vv = ref->get_value_at_version(_version);
+                     auto vv = vref->get_value_at_version(_version);
                      buffer->resize(vv.size());
                      std::memcpy(buffer->data(), vv.data(), vv.size());
                      return buffer->size();
@@ -543,6 +619,218 @@ namespace psitri
       }
    }
 
+   size_t cursor::get_many(std::span<const key_view>                 keys,
+                           std::invocable<size_t, value_view> auto&& lambda) const
+   {
+      if (sal::null_ptr_address == _node.address() || keys.empty()) [[unlikely]]
+         return 0;
+
+      struct lane
+      {
+         key_view    key;
+         ptr_address adr;
+         size_t      index;
+      };
+      const auto& session   = _node.session();
+      auto   read_lock = session->lock();
+      size_t found     = 0;
+      lane   lanes[get_many_group];
+
+      for (size_t base = 0; base < keys.size(); base += get_many_group)
+      {
+         uint32_t active = std::min<size_t>(get_many_group, keys.size() - base);
+         for (uint32_t i = 0; i < active; ++i)
+            lanes[i] = {keys[base + i], _node.address(), base + i};
+
+         while (active)
+         {
+            // The control blocks were prefetched by the previous step, so
+            // resolving the nodes they point at is cheap.
+            for (uint32_t i = 0; i < active; ++i)
+               session->prefetch(lanes[i].adr);
+
+            // Descend one level, prefetching the child's control block; a
+            // lane that reaches a leaf or misses a prefix is done and is
+            // replaced by the last one.
+            for (uint32_t i = 0; i < active;)
+            {
+               lane&       ln  = lanes[i];
+               auto        ref = session->get_ref<node>(ln.adr);
+               const node* n   = ref.obj();
+               ref.maybe_update_read_stats(n->size());
+               switch (n->type())
+               {
+                  [[likely]] case node_type::inner:
+                  {
+                     const auto* in = static_cast<const inner_node*>(n);
+                     ln.adr         = in->get_branch(in->lower_bound(ln.key));
+                     session->prefetch_control(ln.adr);
+                     ++i;
+                     continue;
+                  }
+                  [[likely]] case node_type::inner_prefix:
+                  {
+                     const auto* ip   = static_cast<const inner_prefix_node*>(n);
+                     auto        cpre = ucc::common_prefix(ln.key, ip->prefix());
+                     if (cpre.size() == ip->prefix().size())
+                     {
+                        ln.key = ln.key.substr(cpre.size());
+                        ln.adr = ip->get_branch(ip->lower_bound(ln.key));
+                        session->prefetch_control(ln.adr);
+                        ++i;
+                        continue;
+                     }
+                     break;
+                  }
+                  [[unlikely]] case node_type::leaf:
+                  {
+                     value_view vv;
+                     if (get_leaf_value(static_cast<const leaf_node*>(n), ln.key, vv))
+                     {
+                        lambda(ln.index, vv);
+                        ++found;
+                     }
+                     break;
+                  }
+                  [[unlikely]] case node_type::value:
+                     [[fallthrough]];
+                  default:
+                     std::unreachable();
+               }
+               ln = lanes[--active];
+            }
+         }
+      }
+      return found;
+   }
+
+   template <ConstructibleBuffer T>
+   read_task<std::optional<T>> cursor::async_get_impl(sal::smart_ptr<sal::alloc_header> root,
+                                                      uint64_t                          version,
+                                                      std::string                       key_buf)
+   {
+      ptr_address adr = root.address();
+      if (adr == sal::null_ptr_address) [[unlikely]]
+         co_return std::nullopt;
+
+      auto copy = [](value_view v)
+      {
+         T buf;
+         buf.resize(v.size());
+         std::memcpy(buf.data(), v.data(), v.size());
+         return buf;
+      };
+
+      const auto& session  = root.session();
+      key_view    key      = key_buf;
+      bool        at_value = false;  // adr is the found entry's value_node
+      // without a scheduler there is nothing to do but fault, so skip the probe
+      const bool  parking  = detail::read_parking::current() != nullptr;
+      bool        resident = !parking || session->is_resident(adr);
+      for (;;)
+      {
+         // The read lock is only held while the nodes are in RAM; the tree
+         // is kept alive by root, so the addresses stay valid across a wait.
+         if (!resident)
+            co_await detail::page_wait{*session, adr};
+         auto read_lock = session->lock();
+         do
+         {
+            if (at_value)
+            {
+               auto vref = session->get_ref<value_node>(adr);
+               vref.maybe_update_read_stats(vref->size());
+               auto [offset, idx] = vref->find_version(version);
+               if (offset == value_node::offset_tombstone || offset == value_node::offset_null)
+                  co_return std::nullopt;
+               co_return copy(vref->get_value_at_version(version));
+            }
+
+            auto        ref = session->get_ref<node>(adr);
+            const node* n   = ref.obj();
+            ref.maybe_update_read_stats(n->size());
+            switch (n->type())
+            {
+               [[likely]] case node_type::inner:
+               {
+                  const auto* in = static_cast<const inner_node*>(n);
+                  adr            = in->get_branch(in->lower_bound(key));
+                  break;
+               }
+               [[likely]] case node_type::inner_prefix:
+               {
+                  const auto* ip   = static_cast<const inner_prefix_node*>(n);
+                  auto        cpre = ucc::common_prefix(key, ip->prefix());
+                  if (cpre.size() != ip->prefix().size())
+                     co_return std::nullopt;
+                  key = key.substr(cpre.size());
+                  adr = ip->get_branch(ip->lower_bound(key));
+                  break;
+               }
+               [[unlikely]] case node_type::leaf:
+               {
+                  const auto*   l  = static_cast<const leaf_node*>(n);
+                  branch_number bn = l->get(key);
+                  if (bn == l->num_branches() || is_leaf_entry_newer(l, bn, version))
+                     co_return std::nullopt;
+                  switch (l->get_value_type(bn))
+                  {
+                     case leaf_node::value_type_flag::null:
+                        co_return T();
+                     case leaf_node::value_type_flag::inline_data:
+                        co_return copy(l->get_value_view(bn));
+                     case leaf_node::value_type_flag::value_node:
+                        adr      = l->get_value_address(bn);
+                        at_value = true;
+                        break;
+                     case leaf_node::value_type_flag::subtree:
+                        co_return std::nullopt;
+                     default:
+                        std::unreachable();
+                  }
+                  break;
+               }
+               [[unlikely]] case node_type::value:
+                  [[fallthrough]];
+               default:
+                  std::unreachable();
+            }
+         } while ((resident = !parking || session->is_resident(adr)));
+      }
+   }
+
+   inline bool cursor::get_leaf_value(const leaf_node* l,
+                                      key_view         key,
+                                      value_view&      value) const noexcept
+   {
+      branch_number bn = l->get(key);
+      if (bn == l->num_branches() || is_leaf_entry_hidden(l, bn))
+         return false;
+      switch (l->get_value_type(bn))
+      {
+         case leaf_node::value_type_flag::null:
+            value = {};
+            return true;
+         case leaf_node::value_type_flag::inline_data:
+            value = l->get_value_view(bn);
+            return true;
+         case leaf_node::value_type_flag::value_node:
+         {
+            auto vref = _node.session()->get_ref<value_node>(l->get_value_address(bn));
+            vref.maybe_update_read_stats(vref->size());
+            auto [offset, idx] = vref->find_version(_version);
+            if (offset == value_node::offset_tombstone || offset == value_node::offset_null)
+               return false;
+            value = vref->get_value_at_version(_version);
+            return true;
+         }
+         case leaf_node::value_type_flag::subtree:
+            return false;
+         default:
+            std::unreachable();
+      }
+   }
+
    inline void cursor::append_key(key_view key) noexcept
    {
       // TODO: it is always possible to read 7 bytes past the end of the key stored in nodes; therefore,
@@ -247,12 +247,41 @@ namespace psitri
       uint64_t pinned_bytes           = 0;  ///< Total bytes in pinned segments (pinned_segments x 32 MB).
       uint32_t cache_difficulty       = 0;  ///< Current MFU promotion difficulty (self-tuning).
       uint64_t total_promoted_bytes   = 0;  ///< Cumulative bytes promoted to pinned cache.
+      sal::cache_admission_policy cache_admission = sal::cache_admission_policy::read_bits;  ///< Active admission policy.
+      uint64_t cache_sampled_reads    = 0;  ///< Point-lookup node reads sampled since open (1 in 16).
+      uint64_t cache_sampled_hits     = 0;  ///< Sampled reads served from pinned segments.
+      uint64_t cache_promotions       = 0;  ///< Objects promoted to pinned cache since open.
+      uint64_t cache_admission_rejects = 0;  ///< Sketch candidates not more frequent than the victims.
+
+      /// Fraction of sampled reads served from pinned segments.
+      double cache_hit_rate() const
+      {
+         return cache_sampled_reads ? double(cache_sampled_hits) / cache_sampled_reads : 0.0;
+      }
+
+      /// Objects promoted per node read, estimated from the sampled reads.
+      double promotion_rate() const
+      {
+         return cache_sampled_reads
+                    ? double(cache_promotions) /
+                          (double(cache_sampled_reads) * sal::read_sample_rate)
+                    : 0.0;
+      }
       ///@}
 
       /** @name Sessions */
       ///@{
       uint32_t active_sessions        = 0;  ///< Number of active allocator sessions (read + write).
-      int64_t  pending_releases       = 0;  ///< Objects queued for deferred deallocation by the compactor.
+      int64_t  pending_releases       = 0;  ///< Objects queued for deferred deallocation by the release workers.
+      uint64_t release_backlog_age_ms = 0;  ///< Time since the release backlog was last empty (0 if empty now).
+      uint64_t total_released         = 0;  ///< Cumulative objects freed by the release workers.
+      uint64_t release_busy_ns        = 0;  ///< Cumulative time the release workers spent freeing.
+
+      /// Release throughput while busy, in objects per second.
+      double release_rate() const
+      {
+         return release_busy_ns ? total_released / (release_busy_ns / 1e9) : 0.0;
+      }
       ///@}
 
       /** @name Recycling */
@@ -261,6 +290,38 @@ namespace psitri
       uint64_t recycled_queue_capacity= 0;  ///< Maximum capacity of the recycled-segments queue.
       ///@}
 
+      /** @name Durability (sync_type::background_full) */
+      ///@{
+      uint64_t durability_lag_ms      = 0;  ///< Age of the oldest commit not yet durable (0 if none).
+      uint64_t durability_syncs       = 0;  ///< Background snapshots written since open.
+      ///@}
+
+      /** @name Group commit (sync_mode >= msync_sync) */
+      ///@{
+      uint64_t group_commit_requests  = 0;  ///< Commit syncs that shared a flush with others.
+      uint64_t group_commit_flushes   = 0;  ///< Flushes issued; requests / flushes is the batch size.
+      uint64_t group_flush_total_us   = 0;  ///< Cumulative flush time.
+      uint64_t group_flush_max_us     = 0;  ///< Slowest single flush.
+
+      double commits_per_flush() const
+      {
+         return group_commit_flushes ? double(group_commit_requests) / group_commit_flushes : 0;
+      }
+      ///@}
+
+      /** @name Tiers (database opened with a cold directory) */
+      ///@{
+      bool     cold_tier_attached     = false;
+      uint64_t hot_segments           = 0;  ///< Segments stored in the database directory.
+      uint64_t cold_segments          = 0;  ///< Segments stored in the cold directory.
+      uint64_t hot_live_bytes         = 0;  ///< Allocated minus freed bytes in hot segments.
+      uint64_t cold_live_bytes        = 0;  ///< Allocated minus freed bytes in cold segments.
+      uint64_t hot_disk_bytes         = 0;  ///< Disk space used by the hot segment file.
+      uint64_t cold_disk_bytes        = 0;  ///< Disk space used by the cold segment file.
+      uint64_t cold_segments_migrated = 0;  ///< Aged segments copied into the cold tier since open.
+      uint64_t cold_bytes_migrated    = 0;  ///< Live bytes those copies moved.
+      ///@}
+
       /**
        * @brief Format the stats as a human-readable multi-line string.
        */
@@ -291,9 +352,46 @@ namespace psitri
          s += "  pinned memory:   " + fmt_bytes(pinned_bytes) + "\n";
          s += "  difficulty:      " + std::to_string(cache_difficulty) + "\n";
          s += "  promoted:        " + fmt_bytes(total_promoted_bytes) + "\n";
+         s += std::string("  admission:       ") +
+              (cache_admission == sal::cache_admission_policy::frequency_sketch ? "frequency_sketch"
+                                                                                 : "read_bits") +
+              "\n";
+         s += "  hit rate:        " + std::to_string(cache_hit_rate() * 100) + " %\n";
+         s += "  promotion rate:  " + std::to_string(promotion_rate() * 1e6) + " per M reads\n";
+         s += "  rejected:        " + std::to_string(cache_admission_rejects) + "\n";
          s += "Sessions:\n";
          s += "  active:          " + std::to_string(active_sessions) + "\n";
          s += "  pending releases:" + std::to_string(pending_releases) + "\n";
+         s += "  release backlog: " + std::to_string(release_backlog_age_ms) + " ms\n";
+         s += "  release rate:    " + std::to_string(uint64_t(release_rate())) + " obj/s\n";
+         if (durability_syncs > 0)
+         {
+            s += "Durability:\n";
+            s += "  lag:             " + std::to_string(durability_lag_ms) + " ms\n";
+            s += "  syncs:           " + std::to_string(durability_syncs) + "\n";
+         }
+         if (group_commit_flushes > 0)
+         {
+            char buf[32];
+            snprintf(buf, sizeof(buf), "%.2f", commits_per_flush());
+            s += "Group commit:\n";
+            s += "  flushes:         " + std::to_string(group_commit_flushes) + "\n";
+            s += "  per flush:       " + std::string(buf) + "\n";
+            s += "  avg flush:       " +
+                 std::to_string(group_flush_total_us / group_commit_flushes) + " us\n";
+            s += "  max flush:       " + std::to_string(group_flush_max_us) + " us\n";
+         }
+         if (cold_tier_attached)
+         {
+            s += "Tiers:\n";
+            s += "  hot:             " + std::to_string(hot_segments) + " segments, " +
+                 fmt_bytes(hot_live_bytes) + " live, " + fmt_bytes(hot_disk_bytes) + " on disk\n";
+            s += "  cold:            " + std::to_string(cold_segments) + " segments, " +
+                 fmt_bytes(cold_live_bytes) + " live, " + fmt_bytes(cold_disk_bytes) +
+                 " on disk\n";
+            s += "  migrated:        " + std::to_string(cold_segments_migrated) + " segments, " +
+                 fmt_bytes(cold_bytes_migrated) + "\n";
+         }
          return s;
       }
 
@@ -343,13 +441,18 @@ namespace psitri
        * @param dir   Directory containing (or to contain) the database files.
        * @param mode  How to handle existing vs. new databases.
        * @param cfg   Runtime configuration (cache budget, sync mode, etc.).
+       * @param cold_dir  Optional directory, typically on cheaper storage, that
+       *              receives segments whose data is older than
+       *              runtime_config::cold_tier_age_sec. It is remembered, so
+       *              later opens may leave it empty.
        * @return A shared_ptr to the database.
        */
       static std::shared_ptr<basic_database> open(
-          std::filesystem::path dir,
-          open_mode             mode     = open_mode::create_or_open,
-          const runtime_config& cfg      = {},
-          recovery_mode         recovery = recovery_mode::none);
+          std::filesystem::path        dir,
+          open_mode                    mode     = open_mode::create_or_open,
+          const runtime_config&        cfg      = {},
+          recovery_mode                recovery = recovery_mode::none,
+          const std::filesystem::path& cold_dir = {});
 
       /**
        * @brief Create-only convenience helper. Fails if the database already exists.
@@ -371,7 +474,8 @@ namespace psitri
        */
       basic_database(const std::filesystem::path& dir,
                      const runtime_config&        cfg,
-                     recovery_mode                mode = recovery_mode::none);
+                     recovery_mode                mode     = recovery_mode::none,
+                     const std::filesystem::path& cold_dir = {});
       /// @endcond
 
       /** @name Sessions */
@@ -391,6 +495,19 @@ namespace psitri
          _allocator.sync(_cfg.sync_mode);
       }
 
+      /**
+       * Block until every commit made before this call is on physical media,
+       * or until timeout expires. Only needed with sync_type::background_full,
+       * where commits otherwise become durable within
+       * runtime_config::max_durability_lag_ms.
+       *
+       * @return true if everything committed before the call is durable
+       */
+      bool wait_for_durability(std::chrono::milliseconds timeout = std::chrono::milliseconds(10000))
+      {
+         return _allocator.wait_for_durability(timeout);
+      }
+
       void set_runtime_config(const runtime_config& cfg)
       {
          _cfg = cfg;
@@ -419,10 +536,36 @@ namespace psitri
          s.pinned_bytes         = uint64_t(d.mlocked_segments_count) * sal::segment_size;
          s.cache_difficulty     = d.cache_difficulty;
          s.total_promoted_bytes = d.total_promoted_bytes;
+         s.cache_admission      = sal::cache_admission_policy(d.cache_admission);
+         s.cache_sampled_reads  = d.cache_sampled_reads;
+         s.cache_sampled_hits   = d.cache_sampled_hits;
+         s.cache_promotions     = d.cache_promotions;
+         s.cache_admission_rejects = d.cache_admission_rejects;
          s.active_sessions      = d.active_sessions;
-         s.pending_releases     = d.free_release_count;
+         s.pending_releases     = d.pending_releases;
+         s.release_backlog_age_ms = d.release_backlog_age_ms;
+         for (const auto& w : d.release_workers)
+         {
+            s.total_released += w.released;
+            s.release_busy_ns += w.busy_ns;
+         }
          s.recycled_queue_depth    = d.recycled_queue_depth;
          s.recycled_queue_capacity = d.recycled_queue_capacity;
+         s.durability_lag_ms       = d.durability_lag_ms;
+         s.durability_syncs        = d.durability_syncs;
+         s.group_commit_requests   = d.group_commit_requests;
+         s.group_commit_flushes    = d.group_commit_flushes;
+         s.group_flush_total_us    = d.group_flush_total_us;
+         s.group_flush_max_us      = d.group_flush_max_us;
+         s.cold_tier_attached      = d.cold_tier_attached;
+         s.hot_segments            = d.hot_segments;
+         s.cold_segments           = d.cold_segments;
+         s.hot_live_bytes          = d.hot_live_bytes;
+         s.cold_live_bytes         = d.cold_live_bytes;
+         s.hot_disk_bytes          = d.hot_disk_bytes;
+         s.cold_disk_bytes         = d.cold_disk_bytes;
+         s.cold_segments_migrated  = d.cold_segments_migrated;
+         s.cold_bytes_migrated     = d.cold_bytes_migrated;
          return s;
       }
 
@@ -446,23 +589,14 @@ namespace psitri
 
       bool wait_for_compactor(std::chrono::milliseconds timeout = std::chrono::milliseconds(10000))
       {
-         auto deadline = std::chrono::steady_clock::now() + timeout;
-         while (std::chrono::steady_clock::now() < deadline)
-         {
-            if (_allocator.total_pending_releases() == 0)
-            {
-               std::this_thread::sleep_for(std::chrono::milliseconds(50));
-               if (_allocator.total_pending_releases() == 0)
-               {
-                  // Publish any accumulated dead versions so defrag/COW can see them
-                  _dead_versions.flush_pending();
-                  _dead_versions.publish_snapshot();
-                  return true;
-               }
-            }
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
-         }
-         return false;
+         // release workers signal when their queues drain and nothing is in flight
+         if (not _allocator.wait_for_releases(timeout))
+            return false;
+
+         // Publish any accumulated dead versions so defrag/COW can see them
+         _dead_versions.flush_pending();
+         _dead_versions.publish_snapshot();
+         return true;
       }
 
       void compact_and_truncate()
@@ -473,6 +607,10 @@ namespace psitri
 
       void defrag();
 
+      /// Drop the unpinned segments from RAM so later reads fault them back
+      /// in; see sal::allocator::page_out_unpinned().
+      uint32_t page_out_unpinned() noexcept { return _allocator.page_out_unpinned(); }
+
       ///@}
 
       /** @name Recovery */
@@ -480,6 +618,10 @@ namespace psitri
 
       bool ref_counts_stale() const;
 
+      /// True while the background pass started for stale ref counts is
+      /// still reclaiming leaked objects (see runtime_config::leak_reclaim_objects_per_sec)
+      bool leak_reclamation_active() const { return _allocator.leak_reclamation_active(); }
+
       void reclaim_leaked_memory();
 
       sal::verify_result verify() { return detail::verify_all_roots(_allocator); }
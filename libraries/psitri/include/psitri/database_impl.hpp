@@ -15,9 +15,21 @@ namespace psitri
          flag_ref_counts_stale = 1u << 0,  ///< ref counts need cleanup (deferred_cleanup)
       };
 
+      /// On-disk layout of the tree nodes, bumped whenever a node format
+      /// changes so that files written with another layout are refused
+      /// instead of misread.
+      ///
+      /// 1: original layout
+      /// 2: leaf header padded to 64 bytes, arrays sized by leaf _capacity
+      static constexpr uint32_t node_format_version = 2;
+
+      /// Magic number stored in and checked against database_state::magic:
+      /// the sal build constants combined with the node format.
+      inline const uint32_t database_magic = sal::file_magic ^ (node_format_version - 1);
+
       struct database_state
       {
-         uint32_t          magic          = sal::file_magic;
+         uint32_t          magic          = database_magic;
          uint32_t          flags          = 0;
          std::atomic<bool> clean_shutdown = true;
          runtime_config    config;
@@ -71,11 +83,12 @@ namespace psitri
    template <class LockPolicy>
    basic_database<LockPolicy>::basic_database(const std::filesystem::path& dir,
                                               const runtime_config&        cfg,
-                                              recovery_mode                mode)
+                                              recovery_mode                mode,
+                                              const std::filesystem::path& cold_dir)
        : _dir(dir),
          _cfg(cfg),
          _object_registry(_dead_versions),
-         _allocator(dir, cfg, false),
+         _allocator(dir, cfg, false, cold_dir),
          _dbfile(dir / "dbfile.bin", sal::access_mode::read_write)
    {
       _object_registry.install(_allocator);
@@ -94,11 +107,16 @@ namespace psitri
       _dbm = reinterpret_cast<detail::database_state*>(_dbfile.data());
 
       if (_dbfile.size() != sizeof(detail::database_state))
-         throw std::runtime_error("Wrong size for file: " + (dir / "db").native());
+         throw std::runtime_error("Wrong size for file: " + (dir / "dbfile.bin").native());
 
-      /// TODO: add custom magic number of database file
-      if (_dbm->magic != sal::file_magic)
-         throw std::runtime_error("Not a arbtrie file: " + (dir / "db").native());
+      if (_dbm->magic != detail::database_magic)
+      {
+         // version 1 files carry the plain sal magic
+         if (_dbm->magic == sal::file_magic)
+            throw std::runtime_error("Database uses an older node format and must be rebuilt: " +
+                                     (dir / "dbfile.bin").native());
+         throw std::runtime_error("Not a arbtrie file: " + (dir / "dbfile.bin").native());
+      }
 
       // Determine effective recovery mode
       auto effective_mode = mode;
@@ -130,6 +148,14 @@ namespace psitri
             break;
       }
       recover_global_version_from_roots();
+
+      // Reclaim objects leaked by the crash in the background. No session
+      // holds references yet, which is what begin_leak_reclamation requires.
+      // The counts of reachable objects may still be too high, so the flag
+      // stays set until reclaim_leaked_memory() rebuilds them.
+      if (_dbm->flags & detail::flag_ref_counts_stale)
+         _allocator.begin_leak_reclamation();
+
       _dbm->clean_shutdown = false;
       _allocator.start_background_threads();
    }
@@ -167,10 +193,11 @@ namespace psitri
 
    template <class LockPolicy>
    std::shared_ptr<basic_database<LockPolicy>>
-   basic_database<LockPolicy>::open(std::filesystem::path dir,
-                                    open_mode             mode,
-                                    const runtime_config& cfg,
-                                    recovery_mode         recovery)
+   basic_database<LockPolicy>::open(std::filesystem::path        dir,
+                                    open_mode                    mode,
+                                    const runtime_config&        cfg,
+                                    recovery_mode                recovery,
+                                    const std::filesystem::path& cold_dir)
    {
       bool exists = detail::database_exists(dir);
 
@@ -196,7 +223,7 @@ namespace psitri
       if (!exists)
          std::filesystem::create_directories(dir / "data");
 
-      auto db = std::make_shared<basic_database<LockPolicy>>(dir, cfg, recovery);
+      auto db = std::make_shared<basic_database<LockPolicy>>(dir, cfg, recovery, cold_dir);
       db->_allocator.init_shared_ownership(db);
       return db;
    }
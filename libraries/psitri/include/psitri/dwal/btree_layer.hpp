@@ -4,16 +4,66 @@
 #include <psitri/dwal/range_tombstone_list.hpp>
 #include <sal/allocator.hpp>
 
+#include <atomic>
 #include <cstring>
+#include <memory>
+#include <string>
 #include <string_view>
 
 namespace psitri::dwal
 {
+   /// How far a merge that publishes in chunks (dwal_config::
+   /// merge_publish_entries) has committed an RO layer to the Tri.  Every
+   /// range tombstone, and every entry with a key below the watermark, is
+   /// in the Tri, so a reader whose Tri view was taken after it loaded the
+   /// watermark can skip the layer for those keys.
+   ///
+   /// The merge thread publishes; readers load it without locks.  A
+   /// published key is never moved or freed before the layer.
+   class merge_watermark
+   {
+     public:
+      /// Make room for @p chunks publications; called before the first.
+      void reserve(size_t chunks)
+      {
+         _keys     = std::make_unique<std::string[]>(chunks);
+         _capacity = chunks;
+      }
+
+      /// Entries below @p next_key are committed.  Ignored once reserve()'s
+      /// room is used up, which only leaves readers probing the layer.
+      void publish(std::string_view next_key)
+      {
+         uint32_t n = _count.load(std::memory_order_relaxed);
+         if (n == _capacity)
+            return;
+         _keys[n].assign(next_key);
+         _count.store(n + 1, std::memory_order_release);
+      }
+
+      /// Publications so far; load before taking the Tri view and pass to
+      /// covers().
+      uint32_t load() const noexcept { return _count.load(std::memory_order_acquire); }
+
+      /// True if @p key was committed by the first @p seen publications.
+      bool covers(uint32_t seen, std::string_view key) const noexcept
+      {
+         return seen && key < _keys[seen - 1];
+      }
+
+     private:
+      std::unique_ptr<std::string[]> _keys;
+      size_t                         _capacity = 0;
+      std::atomic<uint32_t>          _count{0};
+   };
+
    /// A btree layer: ART map + range tombstones.
    ///
    /// Keys are stored in the ART arena. Value data (string_view payloads)
    /// is also stored in the ART arena — no separate pool needed.
-   /// The arena is freed as a unit when the layer is discarded.
+   /// The arena is freed as a unit when the layer is discarded.  Layers
+   /// are always owned by a shared_ptr, so a reader that found one through
+   /// dwal_root::buffered_ptr can keep it with shared_from_this().
    ///
    /// Ref-count contract for subtree values:
    /// While a subtree `sal::ptr_address` lives in this layer's map, the
@@ -31,7 +81,7 @@ namespace psitri::dwal
    /// calling thread's thread-local session, so either can be invoked
    /// safely from any thread that touches this layer (writer, merge
    /// thread, or the database-destructor flush thread).
-   struct btree_layer
+   struct btree_layer : std::enable_shared_from_this<btree_layer>
    {
       using map_type = art::art_map<btree_value>;
       using iterator = map_type::iterator;
@@ -40,6 +90,9 @@ namespace psitri::dwal
       range_tombstone_list tombstones;
       uint32_t             generation = 0;
 
+      /// Progress of the merge draining this layer once it is RO.
+      merge_watermark merged;
+
       /// Allocator used to retain/release subtree addresses. Null when
       /// the layer is constructed without one (e.g. standalone tests
       /// that stash fake addresses and never actually reference real
@@ -5,7 +5,11 @@
 #include <psitri/dwal/epoch_lock.hpp>
 #include <psitri/dwal/merge_cursor.hpp>
 #include <psitri/dwal/merge_pool.hpp>
+#include <psitri/dwal/shared_wal.hpp>
 #include <psitri/dwal/transaction.hpp>
+#include <psitri/dwal/wal_io.hpp>
+#include <psitri/dwal/wal_reader.hpp>
+#include <psitri/dwal/wal_replay.hpp>
 #include <psitri/fwd.hpp>
 #include <psitri/lock_policy.hpp>
 
@@ -13,6 +17,7 @@
 #include <cstdint>
 #include <filesystem>
 #include <memory>
+#include <span>
 
 namespace psitri::dwal
 {
@@ -22,9 +27,51 @@ namespace psitri::dwal
       /// Maximum RW btree size (entries) before triggering a swap.
       uint32_t max_rw_entries = 100'000;
 
-      /// Maximum WAL file size (bytes) before triggering a swap.
+      /// Maximum WAL file size (bytes) before triggering a swap.  With
+      /// shared_log, the bytes a root has logged since its last swap.
       uint64_t max_wal_bytes = 64 * 1024 * 1024;  // 64 MB
 
+      /// Log every root to one segmented WAL stream (wal_dir/shared/)
+      /// instead of a file per root.  Concurrent commits, and the entries a
+      /// multi-root transaction writes for each of its roots, then share
+      /// one write and one sync.
+      bool shared_log = false;
+
+      /// Size at which the shared log starts a new segment.
+      uint64_t shared_log_segment_bytes = 64 * 1024 * 1024;  // 64 MB
+
+      /// Durability each commit waits for before returning.  fsync and full
+      /// sync the WAL — every written root's file, or a single group commit
+      /// with shared_log; lower levels only hand it to the OS.  none leaves
+      /// syncing to flush_wal().  background_full is handled like
+      /// msync_async: the WAL has no background sync thread.
+      sal::sync_type commit_sync = sal::sync_type::none;
+
+      /// How per-root WAL files are written; see wal_io_mode.  With
+      /// thread_pool or io_uring a commit's write and fdatasync run in the
+      /// background, and a multi-root commit syncs its roots' files in
+      /// parallel.  The shared log keeps its own group-commit path.
+      wal_io_mode wal_io = wal_io_mode::sync;
+
+      /// I/O threads for wal_io_mode::thread_pool (and the io_uring fallback).
+      uint32_t wal_io_threads = 2;
+
+      /// Preallocate each root's WAL file to max_wal_bytes, and once a
+      /// merge has drained a file keep it (as wal-free.dwal) to become the
+      /// root's next RW file instead of deleting it.  In steady state every
+      /// append then overwrites blocks that are already allocated and
+      /// written, so a commit's fdatasync changes no file metadata.
+      bool wal_preallocate = false;
+
+      /// Roots whose WAL files recovery replays concurrently.  Each file
+      /// in progress uses a thread to verify entry hashes and one to apply
+      /// the verified entries behind it.
+      uint32_t recovery_threads = 4;
+
+      /// Committed WAL entries are written once this much is buffered
+      /// (and on every flush).
+      uint32_t wal_buffer_bytes = 256 * 1024;
+
       /// Idle flush interval — RW btrees untouched for this long are swapped.
       /// Zero disables time-based flushing.
       std::chrono::milliseconds idle_flush_interval{1000};
@@ -39,6 +86,24 @@ namespace psitri::dwal
       /// Number of merge threads in the pool.
       uint32_t merge_threads = 2;
 
+      /// RO btrees with at least this many entries are merged by several
+      /// pool threads at once, split by the Tri root's top-level branches.
+      uint64_t merge_partition_min_entries = 16384;
+
+      /// Commit a drain to the Tri, and publish its root, every this many
+      /// RO entries rather than once at the end (0: once).  Trie readers
+      /// then lag a large swap by about one chunk instead of the whole
+      /// drain — though they may see part of its transactions — and other
+      /// readers look up the merged keys in the Tri instead of the RO
+      /// btree.  Chunks of merge_partition_min_entries or more are still
+      /// split across the pool.
+      uint64_t merge_publish_entries = 0;
+
+      /// Also end a chunk once it has taken this long (zero: no limit).
+      /// Checked between the batches of a serial drain; a partitioned
+      /// chunk always completes.
+      std::chrono::milliseconds merge_publish_interval{0};
+
       /// Maximum RW arena capacity before the writer blocks waiting for merge.
       /// The ART arena is a bump allocator with uint32_t offsets (4 GB max)
       /// that grows by doubling.  When capacity reaches this limit and the
@@ -47,6 +112,22 @@ namespace psitri::dwal
       /// would need to fill the full 2 GB before attempting a 4 GB growth.
       /// Set to 0 to disable (not recommended).
       uint64_t max_rw_arena_bytes = 1ULL * 1024 * 1024 * 1024;
+
+      /// Pace each root's swaps and writers by its measured ingest and
+      /// merge rates (see swap_controller).  max_rw_entries and
+      /// max_wal_bytes become the smallest swap thresholds, scaled up by at
+      /// most adaptive_swap_max_scale while merges keep up easily; a
+      /// preallocated WAL file grows past its preallocation when needed.
+      /// While a merge runs and the RW arena is past adaptive_soft_arena of
+      /// max_rw_arena_bytes, commits are delayed in proportion (by at most
+      /// max_commit_delay each) so the hard limit is rarely reached.
+      bool adaptive_swap = false;
+
+      double adaptive_swap_max_scale = 8;
+
+      double adaptive_soft_arena = 0.5;
+
+      std::chrono::microseconds max_commit_delay{2000};
    };
 
    namespace detail
@@ -93,7 +174,8 @@ namespace psitri::dwal
    /// for amortized COW cost.
    ///
    /// Each root (0-511) has independent state: its own btree, WAL file, undo log,
-   /// mutex, and RO slot. Operations on different roots never contend.
+   /// mutex, and RO slot. Operations on different roots never contend, except
+   /// on the log itself when dwal_config::shared_log replaces the WAL files.
    template <class LockPolicy = std_lock_policy>
    class basic_dwal_database
    {
@@ -143,6 +225,12 @@ namespace psitri::dwal
 
       lookup_result get_latest(uint32_t root_index, std::string_view key);
 
+      /// get_latest() for each of @p keys, in order.  Keys the RW and RO
+      /// btrees do not settle are looked up in the Tri together with
+      /// cursor::get_many().  Found data values are always owned copies.
+      std::vector<lookup_result> get_latest_many(uint32_t                          root_index,
+                                                 std::span<const std::string_view> keys);
+
       owned_merge_cursor create_cursor(uint32_t root_index, read_mode mode,
                                        bool skip_rw_lock = false);
 
@@ -163,9 +251,24 @@ namespace psitri::dwal
 
       epoch_registry_type& epochs() noexcept { return _epochs; }
 
+      /// The shared log, or nullptr when each root has its own WAL file.
+      shared_wal* shared_log() noexcept { return _shared_wal.get(); }
+
+      /// The engine writing per-root WAL files, or nullptr for
+      /// wal_io_mode::sync.
+      wal_io_engine* wal_io() noexcept { return _wal_io.get(); }
+
       bool should_swap(uint32_t root_index) const;
       bool should_backpressure(uint32_t root_index) const;
 
+      /// Count a commit on the root (its writer holds it) and return how
+      /// long the writer should pause; zero unless adaptive_swap is set.
+      std::chrono::nanoseconds commit_delay(uint32_t root_index);
+
+      /// Merge pool queue depth and wait time, plus the drain latency of
+      /// each root that has merged and, with adaptive_swap, its pacing.
+      merge_stats get_merge_stats() const;
+
       void request_shutdown();
 
       dwal_root_type& ensure_root_public(uint32_t index) { return ensure_root(index); }
@@ -184,15 +287,45 @@ namespace psitri::dwal
       void recover();
 
      private:
-      void replay_wal_to_tri(uint32_t root_index, const std::filesystem::path& wal_path);
+      /// Recovery bookkeeping for the entries of one multi-root transaction.
+      struct multi_tx_info
+      {
+         uint16_t participant_count = 0;
+         uint16_t entries_found     = 0;
+         bool     commit_seen       = false;
+      };
+
+      /// The RW and RO btree half of get_latest(): true if either settles
+      /// @p key, with @p result set (left not-found for a deleted key);
+      /// false if the key must be looked up in the Tri.  With @p copy a
+      /// found value is copied while its layer is still protected, so the
+      /// result outlives a merge that frees the layer.
+      bool buffered_get_latest(uint32_t         root_index,
+                               std::string_view key,
+                               lookup_result&   result,
+                               bool             copy);
+
+      /// This thread's Tri cursor, refreshed to the latest root.
+      psitri::cursor& refresh_tri_cursor(uint32_t root_index);
+
+      static void replay_entry_to_rw(dwal_root_type& root, const wal_entry& entry);
+      void replay_wal_to_tri(uint32_t root_index, wal_replay_source& source);
       void replay_wal_to_rw(uint32_t root_index, const std::filesystem::path& wal_path);
+      void recover_shared_log();
       void ensure_wal(uint32_t root_index);
 
+      /// Open a root's wal-rw.dwal, reusing its wal-free.dwal when
+      /// wal_preallocate left one.
+      std::unique_ptr<wal_writer> open_rw_wal(uint32_t root_index);
+
       std::shared_ptr<database_type> _db;
       std::filesystem::path          _wal_dir;
       dwal_config                    _cfg;
 
-      static constexpr uint32_t       max_roots = 512;
+      /// Declared before _roots: their writers may have I/O in flight.
+      std::unique_ptr<wal_io_engine> _wal_io;
+
+      static constexpr uint32_t       max_roots = merge_pool_type::max_roots;
       std::unique_ptr<dwal_root_type> _roots[max_roots];
 
       dwal_root_type& ensure_root(uint32_t index);
@@ -201,6 +334,7 @@ namespace psitri::dwal
 
       epoch_registry_type _epochs;
 
+      std::unique_ptr<shared_wal>      _shared_wal;
       std::unique_ptr<merge_pool_type> _merge_pool;
    };
 
@@ -12,7 +12,6 @@
 #include <cassert>
 #include <stdexcept>
 #include <unordered_map>
-#include <unordered_set>
 
 namespace psitri::dwal
 {
@@ -24,11 +23,19 @@ namespace psitri::dwal
    {
       std::filesystem::create_directories(_wal_dir);
 
+      if (_cfg.shared_log)
+         _shared_wal = std::make_unique<shared_wal>(_wal_dir / "shared",
+                                                    _cfg.shared_log_segment_bytes, max_roots);
+      else
+         _wal_io = wal_io_engine::create(_cfg.wal_io, _cfg.wal_io_threads);
+
       recover();
 
       if (_cfg.merge_threads > 0)
          _merge_pool = std::make_unique<merge_pool_type>(
-             _db, _cfg.merge_threads, _epochs, _wal_dir, _cfg.max_rw_arena_bytes);
+             _db, _cfg.merge_threads, _epochs, _wal_dir, _cfg.max_rw_arena_bytes,
+             _cfg.merge_partition_min_entries, _shared_wal.get(), _cfg.wal_preallocate,
+             _cfg.merge_publish_entries, _cfg.merge_publish_interval);
    }
 
    template <class LockPolicy>
@@ -70,151 +77,233 @@ namespace psitri::dwal
              {root_index, entry.path() / "wal-ro.dwal", entry.path() / "wal-rw.dwal"});
       }
 
+      // Roots are independent, so each phase replays their files in
+      // parallel (see wal_replay); ensure_root() only touches the root's
+      // own slot.
+      wal_replay_options opts;
+      opts.threads = _cfg.recovery_threads;
+
       // Phase 1: Replay RO WALs into PsiTri (frozen data that wasn't merged).
+      std::vector<uint32_t>              ro_roots;
+      std::vector<std::filesystem::path> ro_files;
       for (auto& ri : roots)
       {
          if (std::filesystem::exists(ri.ro_wal, ec))
          {
-            replay_wal_to_tri(ri.root_index, ri.ro_wal);
-            std::filesystem::remove(ri.ro_wal, ec);
+            ro_roots.push_back(ri.root_index);
+            ro_files.push_back(ri.ro_wal);
          }
       }
-
-      // Phase 2a: Scan all RW WALs to build multi-tx index.
-      struct multi_tx_info
-      {
-         uint16_t participant_count = 0;
-         uint16_t entries_found     = 0;
-         bool     commit_seen       = false;
-      };
-      std::unordered_map<uint64_t, multi_tx_info> multi_tx_index;
-
+      wal_replay::run(ro_files, opts, [&](size_t i, wal_replay_source& source)
+                      { replay_wal_to_tri(ro_roots[i], source); });
+      for (auto& f : ro_files)
+         std::filesystem::remove(f, ec);
+
+      // Phase 2: Replay RW WALs into RW btrees.  A multi-root transaction's
+      // entries are applied only if every participant's file holds one and
+      // the commit marker was seen; wal_replay resolves that across files
+      // while they are still being scanned.
+      std::vector<uint32_t>              rw_roots;
+      std::vector<std::filesystem::path> rw_files;
       for (auto& ri : roots)
       {
-         if (!std::filesystem::exists(ri.rw_wal, ec))
-            continue;
-
-         wal_reader reader;
-         if (!reader.open(ri.rw_wal) || reader.was_clean_close())
-            continue;
-
-         wal_entry entry;
-         while (reader.next(entry))
+         if (std::filesystem::exists(ri.rw_wal, ec))
          {
-            if (entry.is_multi_tx())
-            {
-               auto& info             = multi_tx_index[entry.multi_tx_id];
-               info.participant_count = entry.multi_participant_count;
-               info.entries_found++;
-               if (entry.is_multi_tx_commit())
-                  info.commit_seen = true;
-            }
+            rw_roots.push_back(ri.root_index);
+            rw_files.push_back(ri.rw_wal);
          }
       }
+      opts.skip_clean_close = true;
+      opts.filter_multi_tx  = true;
+      wal_replay::run(rw_files, opts,
+                      [&](size_t i, wal_replay_source& source)
+                      {
+                         auto& root = ensure_root(rw_roots[i]);
+
+                         wal_entry entry;
+                         while (source.next(entry))
+                            replay_entry_to_rw(root, entry);
+
+                         root.next_wal_seq = source.end_sequence();
+
+                         root.cow.set_root(root.rw_layer->map.snapshot_root());
+                      });
+      for (auto& f : rw_files)
+         std::filesystem::remove(f, ec);
+
+      // Phase 3: Replay the shared log.
+      recover_shared_log();
+   }
 
-      std::unordered_set<uint64_t> committed_multi_txs;
-      for (auto& [tx_id, info] : multi_tx_index)
+   template <class LockPolicy>
+   void basic_dwal_database<LockPolicy>::recover_shared_log()
+   {
+      std::error_code ec;
+
+      auto dir      = _wal_dir / "shared";
+      auto segments = shared_wal::list_segments(dir);
+      if (_shared_wal)
       {
-         if (info.commit_seen && info.entries_found == info.participant_count)
-            committed_multi_txs.insert(tx_id);
+         // The log's own new segment holds nothing yet.
+         uint64_t active = _shared_wal->active_segment();
+         std::erase_if(segments, [&](uint64_t seg) { return seg >= active; });
       }
 
-      // Phase 2b: Replay RW WALs into RW btrees, filtering multi-tx entries.
-      for (auto& ri : roots)
+      // A clean close means every root was flushed into PsiTri.
+      bool clean = true;
+      if (!segments.empty())
       {
-         if (!std::filesystem::exists(ri.rw_wal, ec))
-            continue;
-
          wal_reader reader;
-         if (!reader.open(ri.rw_wal) || reader.was_clean_close())
+         clean = reader.open(shared_wal::segment_path(dir, segments.back())) &&
+                 reader.was_clean_close();
+      }
+
+      if (!clean)
+      {
+         std::unordered_map<uint64_t, multi_tx_info> multi_tx_index;
+         for (auto seg : segments)
          {
-            std::filesystem::remove(ri.rw_wal, ec);
-            continue;
-         }
+            wal_reader reader;
+            if (!reader.open(shared_wal::segment_path(dir, seg)) || !reader.is_shared_log())
+               continue;
 
-         auto& root = ensure_root(ri.root_index);
+            wal_entry entry;
+            while (reader.next(entry))
+            {
+               if (entry.is_multi_tx())
+               {
+                  auto& info             = multi_tx_index[entry.multi_tx_id];
+                  info.participant_count = entry.multi_participant_count;
+                  info.entries_found++;
+                  if (entry.is_multi_tx_commit())
+                     info.commit_seen = true;
+               }
+            }
+         }
 
-         wal_entry entry;
-         while (reader.next(entry))
+         // Demultiplex by root.  The segments also hold entries that were
+         // already merged into PsiTri, but PsiTri only ever holds a prefix
+         // of the log, so replaying the whole log in order over it is
+         // idempotent.
+         std::unordered_map<uint32_t, uint64_t> first_segment;
+         uint64_t                               max_tx_id = 0;
+         for (auto seg : segments)
          {
-            if (entry.is_multi_tx() &&
-                committed_multi_txs.find(entry.multi_tx_id) == committed_multi_txs.end())
+            wal_reader reader;
+            if (!reader.open(shared_wal::segment_path(dir, seg)) || !reader.is_shared_log())
                continue;
 
-            for (auto& op : entry.ops)
+            wal_entry entry;
+            while (reader.next(entry))
             {
-               switch (op.type)
+               max_tx_id = std::max(max_tx_id, entry.multi_tx_id);
+               if (entry.root_index >= max_roots)
+                  continue;
+               if (entry.is_multi_tx())
                {
-                  case wal_op_type::upsert_data:
-                     root.rw_layer->store_data(op.key, op.value);
-                     break;
-                  case wal_op_type::upsert_subtree:
-                     root.rw_layer->store_subtree(op.key, op.subtree);
-                     break;
-                  case wal_op_type::remove:
-                     root.rw_layer->store_tombstone(op.key);
-                     break;
-                  case wal_op_type::remove_range:
-                  {
-                     std::vector<std::string> keys_to_erase;
-                     auto it = root.rw_layer->map.lower_bound(op.range_low);
-                     for (; it != root.rw_layer->map.end() && it.key() < op.range_high; ++it)
-                        keys_to_erase.emplace_back(it.key());
-                     for (auto& k : keys_to_erase)
-                        root.rw_layer->erase(k);
-                     root.rw_layer->tombstones.add(std::string(op.range_low),
-                                                   std::string(op.range_high));
-                     break;
-                  }
+                  auto& info = multi_tx_index[entry.multi_tx_id];
+                  if (!info.commit_seen || info.entries_found != info.participant_count)
+                     continue;
                }
+
+               auto& root = ensure_root(entry.root_index);
+               replay_entry_to_rw(root, entry);
+               root.next_wal_seq = std::max(root.next_wal_seq, entry.sequence + 1);
+               first_segment.try_emplace(entry.root_index, seg);
             }
          }
 
-         root.next_wal_seq = reader.end_sequence();
-
-         root.cow.set_root(root.rw_layer->map.snapshot_root());
+         for (auto [root_index, seg] : first_segment)
+         {
+            auto& root = *_roots[root_index];
+            root.cow.set_root(root.rw_layer->map.snapshot_root());
+            if (_shared_wal)
+               _shared_wal->pin_recovered(static_cast<uint16_t>(root_index), seg);
+         }
 
-         std::filesystem::remove(ri.rw_wal, ec);
+         // Retained segments keep their transaction ids; don't reuse them.
+         if (max_tx_id >= _next_multi_tx_id.load(std::memory_order_relaxed))
+            _next_multi_tx_id.store(max_tx_id + 1, std::memory_order_relaxed);
       }
+
+      // The shared log keeps the segments until the replayed roots merge;
+      // without it the data now lives only in the RW btrees, as with
+      // replayed per-root WALs.
+      if (_shared_wal)
+         _shared_wal->retire();
+      else
+         for (auto seg : segments)
+            std::filesystem::remove(shared_wal::segment_path(dir, seg), ec);
    }
 
    template <class LockPolicy>
-   void basic_dwal_database<LockPolicy>::replay_wal_to_tri(
-       uint32_t root_index, const std::filesystem::path& wal_path)
+   void basic_dwal_database<LockPolicy>::replay_entry_to_rw(dwal_root_type&  root,
+                                                            const wal_entry& entry)
    {
-      wal_reader reader;
-      if (!reader.open(wal_path))
-         return;
+      for (auto& op : entry.ops)
+      {
+         switch (op.type)
+         {
+            case wal_op_type::upsert_data:
+               root.rw_layer->store_data(op.key, op.value);
+               break;
+            case wal_op_type::upsert_subtree:
+               root.rw_layer->store_subtree(op.key, op.subtree);
+               break;
+            case wal_op_type::remove:
+               root.rw_layer->store_tombstone(op.key);
+               break;
+            case wal_op_type::remove_range:
+            {
+               std::vector<std::string> keys_to_erase;
+               auto it = root.rw_layer->map.lower_bound(op.range_low);
+               for (; it != root.rw_layer->map.end() && it.key() < op.range_high; ++it)
+                  keys_to_erase.emplace_back(it.key());
+               for (auto& k : keys_to_erase)
+                  root.rw_layer->erase(k);
+               root.rw_layer->tombstones.add(std::string(op.range_low),
+                                             std::string(op.range_high));
+               break;
+            }
+         }
+      }
+   }
 
+   template <class LockPolicy>
+   void basic_dwal_database<LockPolicy>::replay_wal_to_tri(uint32_t           root_index,
+                                                           wal_replay_source& source)
+   {
       auto ws = _db->start_write_session();
       auto tx = ws->start_transaction(root_index);
 
-      uint64_t count = reader.replay_all(
-          [&](const wal_entry& entry)
-          {
-             for (auto& op : entry.ops)
-             {
-                switch (op.type)
-                {
-                   case wal_op_type::upsert_data:
-                      tx.upsert(op.key, op.value);
-                      break;
-                   case wal_op_type::upsert_subtree:
-                   {
-                      auto subtree = ws->make_ptr(op.subtree, /*retain=*/true);
-                      if (subtree)
-                         tx.upsert(op.key, std::move(subtree));
-                      break;
-                   }
-                   case wal_op_type::remove:
-                      tx.remove(op.key);
-                      break;
-                   case wal_op_type::remove_range:
-                      tx.remove_range(op.range_low, op.range_high);
-                      break;
-                }
-             }
-          });
+      uint64_t  count = 0;
+      wal_entry entry;
+      while (source.next(entry))
+      {
+         for (auto& op : entry.ops)
+         {
+            switch (op.type)
+            {
+               case wal_op_type::upsert_data:
+                  tx.upsert(op.key, op.value);
+                  break;
+               case wal_op_type::upsert_subtree:
+               {
+                  auto subtree = ws->make_ptr(op.subtree, /*retain=*/true);
+                  if (subtree)
+                     tx.upsert(op.key, std::move(subtree));
+                  break;
+               }
+               case wal_op_type::remove:
+                  tx.remove(op.key);
+                  break;
+               case wal_op_type::remove_range:
+                  tx.remove_range(op.range_low, op.range_high);
+                  break;
+            }
+         }
+         ++count;
+      }
 
       if (count > 0)
          tx.commit();
@@ -230,37 +319,7 @@ namespace psitri::dwal
 
       auto& root = ensure_root(root_index);
 
-      uint64_t count = reader.replay_all(
-          [&](const wal_entry& entry)
-          {
-             for (auto& op : entry.ops)
-             {
-                switch (op.type)
-                {
-                   case wal_op_type::upsert_data:
-                      root.rw_layer->store_data(op.key, op.value);
-                      break;
-                   case wal_op_type::upsert_subtree:
-                      root.rw_layer->store_subtree(op.key, op.subtree);
-                      break;
-                   case wal_op_type::remove:
-                      root.rw_layer->store_tombstone(op.key);
-                      break;
-                   case wal_op_type::remove_range:
-                   {
-                      std::vector<std::string> keys_to_erase;
-                      auto it = root.rw_layer->map.lower_bound(op.range_low);
-                      for (; it != root.rw_layer->map.end() && it.key() < op.range_high; ++it)
-                         keys_to_erase.emplace_back(it.key());
-                      for (auto& k : keys_to_erase)
-                         root.rw_layer->erase(k);
-                      root.rw_layer->tombstones.add(std::string(op.range_low),
-                                                    std::string(op.range_high));
-                      break;
-                   }
-                }
-             }
-          });
+      reader.replay_all([&](const wal_entry& entry) { replay_entry_to_rw(root, entry); });
 
       root.next_wal_seq = reader.end_sequence();
    }
@@ -284,6 +343,7 @@ namespace psitri::dwal
          {
          }
 
+         bool all_flushed = true;
          for (uint32_t i = 0; i < max_roots; ++i)
          {
             if (!_roots[i])
@@ -291,7 +351,7 @@ namespace psitri::dwal
             auto& root = *_roots[i];
 
             bool flushed = false;
-            if (ws && (root.rw_layer || root.buffered_ptr))
+            if (ws && (root.rw_layer || root.buffered_owner))
             {
                try
                {
@@ -317,11 +377,8 @@ namespace psitri::dwal
                      tx.commit();
                   };
 
-                  std::shared_ptr<btree_layer> ro;
-                  {
-                     std::lock_guard lk(root.buffered_mutex);
-                     ro = root.buffered_ptr;
-                  }
+                  // The merge pool is shut down, so nothing unpublishes it.
+                  std::shared_ptr<btree_layer> ro = root.buffered_owner;
                   if (ro && !ro->map.empty())
                      flush_layer(*ro);
 
@@ -354,7 +411,11 @@ namespace psitri::dwal
                if (flushed)
                   root.wal->close();
             }
+            all_flushed = all_flushed && flushed;
          }
+
+         if (_shared_wal && all_flushed)
+            _shared_wal->close();
       }
    }
 
@@ -378,6 +439,14 @@ namespace psitri::dwal
       if (!_roots[index])
       {
          _roots[index] = std::make_unique<dwal_root_type>();
+
+         swap_controller::options opts;
+         opts.enabled     = _cfg.adaptive_swap;
+         opts.max_scale   = std::max(_cfg.adaptive_swap_max_scale, 1.0);
+         opts.arena_limit = _cfg.max_rw_arena_bytes;
+         opts.soft_arena  = _cfg.adaptive_soft_arena;
+         opts.max_delay   = _cfg.max_commit_delay;
+         _roots[index]->swap_ctl.configure(opts);
       }
       // Bind the allocator so the btree_layer can retain/release subtree
       // addresses. `sal::allocator::retain` is atomic and `release`
@@ -393,13 +462,35 @@ namespace psitri::dwal
    void basic_dwal_database<LockPolicy>::ensure_wal(uint32_t root_index)
    {
       auto& root = ensure_root(root_index);
-      if (!root.wal)
+      if (!root.wal && _shared_wal)
       {
-         auto dir = _wal_dir / ("root-" + std::to_string(root_index));
-         std::filesystem::create_directories(dir);
          root.wal = std::make_unique<wal_writer>(
-             dir / "wal-rw.dwal", static_cast<uint16_t>(root_index), root.next_wal_seq);
+             *_shared_wal, static_cast<uint16_t>(root_index), root.next_wal_seq);
+      }
+      else if (!root.wal)
+      {
+         root.wal = open_rw_wal(root_index);
+      }
+   }
+
+   template <class LockPolicy>
+   std::unique_ptr<wal_writer> basic_dwal_database<LockPolicy>::open_rw_wal(uint32_t root_index)
+   {
+      auto& root = *_roots[root_index];
+      auto  dir  = _wal_dir / ("root-" + std::to_string(root_index));
+      std::filesystem::create_directories(dir);
+
+      wal_writer_options opts;
+      opts.io           = _wal_io.get();
+      opts.buffer_bytes = _cfg.wal_buffer_bytes;
+      if (_cfg.wal_preallocate)
+      {
+         opts.preallocate_bytes = _cfg.max_wal_bytes;
+         if (auto spare = dir / "wal-free.dwal"; std::filesystem::exists(spare))
+            opts.recycle_from = spare;
       }
+      return std::make_unique<wal_writer>(dir / "wal-rw.dwal", static_cast<uint16_t>(root_index),
+                                          root.next_wal_seq, opts);
    }
 
    template <class LockPolicy>
@@ -417,7 +508,9 @@ namespace psitri::dwal
       if (_cfg.max_rw_arena_bytes > 0 &&
           root.rw_layer->map.arena_capacity() >= _cfg.max_rw_arena_bytes)
       {
+         root.merge_waiters.fetch_add(1, std::memory_order_relaxed);
          root.merge_complete.wait(false, std::memory_order_acquire);
+         root.merge_waiters.fetch_sub(1, std::memory_order_relaxed);
          try_swap_rw_to_ro(root_index);
       }
 
@@ -466,12 +559,8 @@ namespace psitri::dwal
       if (root.generation.load(std::memory_order_acquire) == 0)
          return {false, {}};
 
-      std::shared_ptr<btree_layer> ro;
-      {
-         std::lock_guard lk(root.buffered_mutex);
-         ro = root.buffered_ptr;
-      }
-      if (ro)
+      std::lock_guard pin(_epochs.thread_lock());
+      if (auto* ro = root.load_buffered())
       {
          auto* v = ro->map.get(key);
          if (v)
@@ -490,10 +579,11 @@ namespace psitri::dwal
    template <class LockPolicy>
    bool basic_dwal_database<LockPolicy>::should_swap(uint32_t root_index) const
    {
-      auto& root = *_roots[root_index];
-      if (root.rw_layer->size() >= _cfg.max_rw_entries)
+      auto&  root  = *_roots[root_index];
+      double scale = root.swap_ctl.scale();
+      if (root.rw_layer->size() >= _cfg.max_rw_entries * scale)
          return true;
-      if (root.wal && root.wal->file_size() >= _cfg.max_wal_bytes)
+      if (root.wal && root.wal->file_size() >= _cfg.max_wal_bytes * scale)
          return true;
       if (_cfg.max_freshness_delay.count() > 0 && !root.rw_layer->empty())
       {
@@ -513,6 +603,35 @@ namespace psitri::dwal
       return root.rw_layer->map.arena_capacity() >= _cfg.max_rw_arena_bytes;
    }
 
+   template <class LockPolicy>
+   std::chrono::nanoseconds basic_dwal_database<LockPolicy>::commit_delay(uint32_t root_index)
+   {
+      auto& root = *_roots[root_index];
+      if (!root.swap_ctl.enabled())
+         return {};
+      return root.swap_ctl.commit_delay(root.rw_layer->map.arena_capacity(),
+                                        !root.merge_complete.load(std::memory_order_acquire),
+                                        std::chrono::steady_clock::now());
+   }
+
+   template <class LockPolicy>
+   merge_stats basic_dwal_database<LockPolicy>::get_merge_stats() const
+   {
+      merge_stats s;
+      if (_merge_pool)
+         s = _merge_pool->stats();
+      for (uint32_t i = 0; i < max_roots; ++i)
+         if (_roots[i])
+         {
+            if (auto h = _roots[i]->merge_latency.snapshot(); h.count)
+               s.root_latency.emplace_back(i, h);
+            if (_roots[i]->swap_ctl.enabled())
+               if (auto f = _roots[i]->swap_ctl.stats(); f.ingest_rate > 0)
+                  s.root_flow.emplace_back(i, f);
+         }
+      return s;
+   }
+
    template <class LockPolicy>
    void basic_dwal_database<LockPolicy>::try_swap_rw_to_ro(uint32_t root_index)
    {
@@ -522,11 +641,10 @@ namespace psitri::dwal
       if (!root.merge_complete.load(std::memory_order_acquire))
          return;
 
+      root.swap_ctl.record_swap(root.rw_layer->size(), std::chrono::steady_clock::now());
+
       {
-         {
-            std::lock_guard lk(root.buffered_mutex);
-            root.buffered_ptr = std::move(root.rw_layer);
-         }
+         root.publish_buffered(std::move(root.rw_layer));
          root.rw_layer = std::make_shared<btree_layer>();
          root.rw_layer->set_allocator(&_db->underlying_allocator());
 
@@ -542,7 +660,20 @@ namespace psitri::dwal
 
       root.generation.fetch_add(1, std::memory_order_release);
 
-      if (root.wal)
+      if (_shared_wal)
+      {
+         // The log entries stay where they are; the root now needs them
+         // until the merge releases its RO btree.  A fresh writer restarts
+         // the per-root byte count checked by should_swap().
+         _shared_wal->swap_root(static_cast<uint16_t>(root_index));
+         if (root.wal)
+         {
+            root.next_wal_seq = root.wal->next_sequence();
+            root.wal          = std::make_unique<wal_writer>(
+                *_shared_wal, static_cast<uint16_t>(root_index), root.next_wal_seq);
+         }
+      }
+      else if (root.wal)
       {
          root.next_wal_seq = root.wal->next_sequence();
          root.wal->close();
@@ -555,12 +686,9 @@ namespace psitri::dwal
          if (std::filesystem::exists(rw_wal))
             std::filesystem::rename(rw_wal, ro_wal);
 
-         root.wal = std::make_unique<wal_writer>(
-             rw_wal, static_cast<uint16_t>(root_index), root.next_wal_seq);
+         root.wal = open_rw_wal(root_index);
       }
 
-      _epochs.broadcast_all(root.generation.load(std::memory_order_relaxed));
-
       if (_merge_pool)
          _merge_pool->signal(root_index, root);
    }
@@ -580,6 +708,11 @@ namespace psitri::dwal
    template <class LockPolicy>
    void basic_dwal_database<LockPolicy>::flush_wal(sal::sync_type sync)
    {
+      if (_shared_wal)
+      {
+         _shared_wal->flush(sync);
+         return;
+      }
       for (uint32_t i = 0; i < max_roots; ++i)
       {
          if (_roots[i] && _roots[i]->wal)
@@ -604,9 +737,65 @@ namespace psitri::dwal
    template <class LockPolicy>
    typename basic_dwal_database<LockPolicy>::lookup_result
    basic_dwal_database<LockPolicy>::get_latest(uint32_t root_index, std::string_view key)
+   {
+      lookup_result result;
+      if (buffered_get_latest(root_index, key, result, false))
+         return result;
+      return tri_get(root_index, key);
+   }
+
+   template <class LockPolicy>
+   std::vector<typename basic_dwal_database<LockPolicy>::lookup_result>
+   basic_dwal_database<LockPolicy>::get_latest_many(uint32_t                          root_index,
+                                                    std::span<const std::string_view> keys)
+   {
+      std::vector<lookup_result> results(keys.size());
+      std::vector<key_view>      misses;
+      std::vector<size_t>        miss_index;
+      for (size_t i = 0; i < keys.size(); ++i)
+      {
+         if (buffered_get_latest(root_index, keys[i], results[i], true))
+            continue;
+         misses.emplace_back(keys[i].data(), keys[i].size());
+         miss_index.push_back(i);
+      }
+
+      // The Tri view is taken after every RO watermark load above.  Results
+      // are filled in place: value.data points into owned_data, which a
+      // move would leave dangling for short values.
+      if (!misses.empty())
+         refresh_tri_cursor(root_index)
+             .get_many(misses,
+                       [&](size_t i, value_view v)
+                       {
+                          auto& r = results[miss_index[i]];
+                          r.found = true;
+                          r.owned_data.assign(v.data(), v.size());
+                          r.value = btree_value::make_data(r.owned_data);
+                       });
+      return results;
+   }
+
+   template <class LockPolicy>
+   bool basic_dwal_database<LockPolicy>::buffered_get_latest(uint32_t         root_index,
+                                                             std::string_view key,
+                                                             lookup_result&   result,
+                                                             bool             copy)
    {
       assert(root_index < max_roots);
 
+      auto settle = [&](const btree_value& v)
+      {
+         if (v.is_tombstone())
+            return;
+         result = {true, v};
+         if (copy && v.is_data())
+         {
+            result.owned_data.assign(v.data);
+            result.value = btree_value::make_data(result.owned_data);
+         }
+      };
+
       if (_roots[root_index])
       {
          auto& root = *_roots[root_index];
@@ -620,15 +809,14 @@ namespace psitri::dwal
                auto* v     = art::get<btree_value>(arena, head, key);
                if (v)
                {
+                  settle(*v);
                   root.cow.end_read_latest();
-                  if (v->is_tombstone())
-                     return {false, {}};
-                  return {true, *v};
+                  return true;
                }
                if (root.rw_layer->tombstones.is_deleted(key))
                {
                   root.cow.end_read_latest();
-                  return {false, {}};
+                  return true;
                }
             }
 
@@ -636,27 +824,24 @@ namespace psitri::dwal
          }
 
          {
-            std::shared_ptr<btree_layer> ro;
-            {
-               std::lock_guard lk(root.buffered_mutex);
-               ro = root.buffered_ptr;
-            }
-            if (ro)
+            std::lock_guard pin(_epochs.thread_lock());
+            auto*           ro = root.load_buffered();
+            // A Tri lookup after this sees any chunk of the merge published by now.
+            if (ro && !ro->merged.covers(ro->merged.load(), key))
             {
                auto* v = ro->map.get(key);
                if (v)
                {
-                  if (v->is_tombstone())
-                     return {false, {}};
-                  return {true, *v};
+                  settle(*v);
+                  return true;
                }
                if (ro->tombstones.is_deleted(key))
-                  return {false, {}};
+                  return true;
             }
          }
       }
 
-      return tri_get(root_index, key);
+      return false;
    }
 
    template <class LockPolicy>
@@ -677,8 +862,8 @@ namespace psitri::dwal
 
          if (mode != read_mode::trie)
          {
-            std::lock_guard lk(root.buffered_mutex);
-            ro = root.buffered_ptr;
+            std::lock_guard pin(_epochs.thread_lock());
+            ro = root.share_buffered();
          }
       }
 
@@ -718,6 +903,16 @@ namespace psitri::dwal
    template <class LockPolicy>
    typename basic_dwal_database<LockPolicy>::lookup_result
    basic_dwal_database<LockPolicy>::tri_get(uint32_t root_index, std::string_view key)
+   {
+      std::string buf;
+      if (refresh_tri_cursor(root_index).get(key_view(key.data(), key.size()), &buf) >= 0)
+         return lookup_result::make_owned(std::move(buf));
+
+      return {false, {}};
+   }
+
+   template <class LockPolicy>
+   psitri::cursor& basic_dwal_database<LockPolicy>::refresh_tri_cursor(uint32_t root_index)
    {
       auto& tlc      = detail::thread_local_cache();
       auto  db_owner = std::static_pointer_cast<void>(_db);
@@ -743,12 +938,7 @@ namespace psitri::dwal
       {
          tlc.tri_cursor->refresh(root_index);
       }
-
-      std::string buf;
-      if (tlc.tri_cursor->get(key_view(key.data(), key.size()), &buf) >= 0)
-         return lookup_result::make_owned(std::move(buf));
-
-      return {false, {}};
+      return *tlc.tri_cursor;
    }
 
    template <class LockPolicy>
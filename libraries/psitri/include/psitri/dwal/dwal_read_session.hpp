@@ -17,7 +17,8 @@ namespace psitri::dwal
    /// A read session for the DWAL layer.
    ///
    /// Caches per-root DWAL snapshots and PsiTri cursors, refreshing them
-   /// only when the generation counter changes (i.e., after a swap).
+   /// only when the generation counter changes (i.e., after a swap) or the
+   /// merge publishes another chunk of the snapshot.
    /// In the common case, get() checks an atomic generation counter and
    /// searches the cached snapshot — zero locks, zero contention with writers.
    ///
@@ -74,6 +75,7 @@ namespace psitri::dwal
          std::shared_ptr<btree_layer> snapshot;
          psitri::cursor               tri_cursor;
          uint32_t                     gen         = 0;
+         uint32_t                     merged      = 0;  ///< snapshot->merged.load() at refresh
          bool                         initialized = false;
 
          root_cache(sal::allocator_session_ptr session)
@@ -45,14 +45,17 @@ namespace psitri::dwal
       auto& cache = _cache[root_index];
 
       uint32_t cur_gen = root.generation.load(std::memory_order_acquire);
-      if (cache.initialized && cur_gen == cache.gen)
+      if (cache.initialized && cur_gen == cache.gen &&
+          (!cache.snapshot || cache.snapshot->merged.load() == cache.merged))
          return;
 
       {
-         std::lock_guard lk(root.buffered_mutex);
-         cache.snapshot = root.buffered_ptr;
+         std::lock_guard pin(_db.epochs().thread_lock());
+         cache.snapshot = root.share_buffered();
       }
 
+      // The cursor taken next includes every chunk published by now.
+      cache.merged = cache.snapshot ? cache.snapshot->merged.load() : 0;
       cache.tri_cursor.refresh(root_index);
 
       cache.gen         = cur_gen;
@@ -68,7 +71,8 @@ namespace psitri::dwal
       auto& cache = _cache[root_index];
 
       uint32_t cur_gen = _db.root(root_index).generation.load(std::memory_order_acquire);
-      if (!cache.initialized || cur_gen != cache.gen)
+      if (!cache.initialized || cur_gen != cache.gen ||
+          (cache.snapshot && cache.snapshot->merged.load() != cache.merged))
          refresh(root_index);
 
       if (mode == read_mode::trie)
@@ -124,7 +128,7 @@ namespace psitri::dwal
          }
       }
 
-      if (cache.snapshot)
+      if (cache.snapshot && !cache.snapshot->merged.covers(cache.merged, key))
       {
          auto* v = cache.snapshot->map.get(key);
          if (v)
@@ -1,6 +1,8 @@
 #pragma once
 #include <art/cow_coordinator.hpp>
 #include <psitri/dwal/btree_layer.hpp>
+#include <psitri/dwal/merge_stats.hpp>
+#include <psitri/dwal/swap_controller.hpp>
 #include <psitri/dwal/undo_log.hpp>
 #include <psitri/dwal/wal_writer.hpp>
 #include <psitri/lock_policy.hpp>
@@ -73,9 +75,15 @@ namespace psitri::dwal
       // ── Reader section (cache-line separated) ─────────────────────
 
       /// The frozen RO btree — published on arena swap, read by buffered readers.
-      /// Brief mutex for shared_ptr copy (only held for the copy, not during read).
-      alignas(128) mutex_type buffered_mutex;
-      std::shared_ptr<btree_layer> buffered_ptr;
+      /// Readers load it while holding their epoch lock (epoch_lock.hpp),
+      /// which writes only the reader's own cache line, and take
+      /// shared_from_this() to keep it past the epoch.
+      alignas(128) std::atomic<btree_layer*> buffered_ptr{nullptr};
+
+      /// Owning reference behind buffered_ptr.  Set by the writer on swap
+      /// and taken by the merge thread when the drain completes, which
+      /// merge_complete keeps from overlapping.
+      std::shared_ptr<btree_layer> buffered_owner;
 
       /// Generation counter — incremented on each arena swap.
       /// Readers compare against their cached gen to detect new RO snapshots.
@@ -95,6 +103,19 @@ namespace psitri::dwal
       /// Arena capacity recorded when the merge thread finishes.
       std::atomic<uint32_t> arena_at_merge_complete{0};
 
+      /// Swap thresholds and commit pacing with dwal_config::adaptive_swap,
+      /// which replaces the throttle above.
+      swap_controller swap_ctl;
+
+      // ── Merge scheduling ──────────────────────────────────────────
+
+      /// Writers blocked in backpressure until this root's merge completes;
+      /// the merge pool drains such roots ahead of all others.
+      std::atomic<uint32_t> merge_waiters{0};
+
+      /// Wall time of each drain of this root's RO btree.
+      atomic_latency_histogram merge_latency;
+
       /// Time of the last snapshot publication or arena swap.
       std::chrono::steady_clock::time_point last_snapshot_time{std::chrono::steady_clock::now()};
 
@@ -105,6 +126,34 @@ namespace psitri::dwal
       art::cow_coordinator cow;
 
       basic_dwal_root() : rw_layer(std::make_shared<btree_layer>()) {}
+
+      /// Publish @p layer as the RO btree.
+      void publish_buffered(std::shared_ptr<btree_layer> layer)
+      {
+         buffered_ptr.store(layer.get(), std::memory_order_seq_cst);
+         buffered_owner = std::move(layer);
+      }
+
+      /// Unpublish the RO btree and return it.  Readers inside an epoch
+      /// may still hold it, so free it through the epoch registry.
+      std::shared_ptr<btree_layer> unpublish_buffered()
+      {
+         buffered_ptr.store(nullptr, std::memory_order_seq_cst);
+         return std::move(buffered_owner);
+      }
+
+      /// The RO btree (or null); valid until the caller's epoch lock is released.
+      btree_layer* load_buffered() const noexcept
+      {
+         return buffered_ptr.load(std::memory_order_seq_cst);
+      }
+
+      /// An owning reference to the RO btree; call with the epoch locked.
+      std::shared_ptr<btree_layer> share_buffered() const
+      {
+         auto* ro = load_buffered();
+         return ro ? ro->shared_from_this() : nullptr;
+      }
    };
 
    using dwal_root = basic_dwal_root<std_lock_policy>;
@@ -2,12 +2,14 @@
 #include <psitri/dwal/btree_layer.hpp>
 #include <psitri/dwal/btree_value.hpp>
 #include <psitri/dwal/dwal_root.hpp>
+#include <psitri/dwal/epoch_lock.hpp>
 #include <psitri/dwal/merge_cursor.hpp>
 #include <psitri/dwal/undo_log.hpp>
 #include <psitri/dwal/wal_writer.hpp>
 #include <psitri/lock_policy.hpp>
 
 #include <cassert>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -209,6 +211,10 @@ namespace psitri::dwal
       friend class basic_remove_result<LockPolicy>;
 
       lookup_result ro_get(std::string_view key) const;
+      /// Locks this thread's epoch in the database's registry, guarding
+      /// loads of the RO btree.  Empty without a database, when nothing
+      /// else frees the RO btree.
+      std::unique_lock<dwal_session_lock> pin_epoch() const;
       bool          exists_in_lower_layers(std::string_view key) const;
       void          record_undo_for_upsert(std::string_view key);
       void          record_undo_for_remove(std::string_view key);
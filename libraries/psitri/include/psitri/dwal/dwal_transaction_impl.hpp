@@ -221,8 +221,8 @@ namespace psitri::dwal
 
       std::shared_ptr<btree_layer> ro;
       {
-         std::lock_guard lk(_root->buffered_mutex);
-         ro = _root->buffered_ptr;
+         auto pin = pin_epoch();
+         ro       = _root->share_buffered();
       }
 
       std::optional<psitri::cursor> tri;
@@ -236,12 +236,11 @@ namespace psitri::dwal
    typename basic_dwal_transaction<LockPolicy>::lookup_result
    basic_dwal_transaction<LockPolicy>::ro_get(std::string_view key) const
    {
-      std::shared_ptr<btree_layer> ro;
-      {
-         std::lock_guard lk(_root->buffered_mutex);
-         ro = _root->buffered_ptr;
-      }
-      if (!ro)
+      auto  pin = pin_epoch();
+      auto* ro  = _root->load_buffered();
+      // Keys the merge has already published are read from the Tri, which
+      // the caller looks at after this.
+      if (!ro || ro->merged.covers(ro->merged.load(), key))
          return {false, {}};
 
       auto* v = ro->map.get(key);
@@ -257,6 +256,14 @@ namespace psitri::dwal
       return {false, {}};
    }
 
+   template <class LockPolicy>
+   std::unique_lock<dwal_session_lock> basic_dwal_transaction<LockPolicy>::pin_epoch() const
+   {
+      if (!_db)
+         return {};
+      return std::unique_lock(_db->epochs().thread_lock());
+   }
+
    // ── Transaction Control ──────────────────────────────────────────
 
    template <class LockPolicy>
@@ -271,7 +278,11 @@ namespace psitri::dwal
       if (!_nested)
       {
          if (_wal)
+         {
             _wal->commit_entry();
+            if (_db && _db->config().commit_sync != sal::sync_type::none)
+               _wal->flush(_db->config().commit_sync);
+         }
 
          _undo.discard();
 
@@ -305,7 +316,12 @@ namespace psitri::dwal
             _db->try_swap_rw_to_ro(_root_index);
          }
 
-         if (uint32_t sleep_ns = _root->throttle_sleep_ns.load(std::memory_order_relaxed))
+         if (_db && _db->config().adaptive_swap)
+         {
+            if (auto delay = _db->commit_delay(_root_index); delay.count() > 0)
+               std::this_thread::sleep_for(delay);
+         }
+         else if (uint32_t sleep_ns = _root->throttle_sleep_ns.load(std::memory_order_relaxed))
          {
             uint32_t arena_cap = _root->rw_layer->map.arena_capacity();
             if (arena_cap >= (1u << 20) * 16)
@@ -2,10 +2,12 @@
 #include <psitri/lock_policy.hpp>
 #include <ucc/padded_atomic.hpp>
 
+#include <atomic>
 #include <cstdint>
 #include <limits>
 #include <memory>
 #include <mutex>
+#include <unordered_map>
 #include <vector>
 
 namespace psitri::dwal
@@ -25,10 +27,15 @@ namespace psitri::dwal
       ucc::padded_atomic<uint64_t> gen_ptr{uint64_t(-1)};
 
       /// Pin the current generation — copies high bits to low bits.
+      ///
+      /// The fence orders the pin before the reader's next loads: a
+      /// pointer retired after the broadcast it pinned is either seen as
+      /// retired or kept alive by the pin.
       void lock()
       {
          ucc::set_low_bits(gen_ptr,
                            static_cast<uint32_t>(gen_ptr.load(std::memory_order_relaxed) >> 32));
+         std::atomic_thread_fence(std::memory_order_seq_cst);
       }
 
       /// Release the pin — sets low bits to idle (0xFFFFFFFF).
@@ -46,59 +53,91 @@ namespace psitri::dwal
 
    /// Registry of session locks for epoch-based pool reclamation.
    ///
-   /// The merge thread checks `min_pinned()` to determine whether an old
-   /// RO pool can be safely freed: safe when min_pinned > pool_generation.
+   /// Readers pin the current epoch while they use a pointer loaded from
+   /// an epoch-protected slot (dwal_root::buffered_ptr).  The merge thread
+   /// unpublishes the pointer, retires the object at epoch() and calls
+   /// advance(); the object can be freed once `min_pinned()` exceeds the
+   /// epoch it was retired at.
    template <class LockPolicy = std_lock_policy>
    class basic_epoch_registry
    {
+      struct slots;
+
      public:
       using mutex_type = typename LockPolicy::mutex_type;
 
-      /// Allocate a new session lock. Returns its index.
-      uint32_t allocate()
+      basic_epoch_registry() : _slots(std::make_shared<slots>()) {}
+      ~basic_epoch_registry() { _slots->closed.store(true, std::memory_order_relaxed); }
+
+      basic_epoch_registry(const basic_epoch_registry&)            = delete;
+      basic_epoch_registry& operator=(const basic_epoch_registry&) = delete;
+
+      /// Allocate a new session lock, idle at the current epoch. Returns its index.
+      uint32_t allocate() { return _slots->allocate(); }
+
+      /// Release a session lock slot back to the free list.
+      void release(uint32_t idx) { _slots->release(idx); }
+
+      /// Get the lock at an index.
+      dwal_session_lock& operator[](uint32_t idx) { return *_slots->locks[idx]; }
+
+      /// The calling thread's session lock in this registry, allocated on
+      /// first use and released when the thread exits.  A thread may hold
+      /// one in several registries at once (e.g. two open databases).
+      /// Lock it (std::lock_guard) around each use of a protected pointer.
+      dwal_session_lock& thread_lock()
       {
-         std::lock_guard<mutex_type> lk(_mu);
-         if (!_free_list.empty())
+         thread_local std::unordered_map<const slots*, thread_slot> ts;
+         auto it = ts.find(_slots.get());
+         if (it == ts.end()) [[unlikely]]
          {
-            uint32_t idx = _free_list.back();
-            _free_list.pop_back();
-            _locks[idx]->gen_ptr.store(uint64_t(-1), std::memory_order_relaxed);
-            return idx;
+            // drop the slots of registries that are gone
+            std::erase_if(ts, [](const auto& e)
+                          { return e.second.owner->closed.load(std::memory_order_relaxed); });
+            it = ts.try_emplace(_slots.get()).first;
+            it->second.attach(_slots);
          }
-         uint32_t idx = static_cast<uint32_t>(_locks.size());
-         _locks.push_back(std::make_unique<dwal_session_lock>());
-         return idx;
+         return *it->second.lock;
       }
 
-      /// Release a session lock slot back to the free list.
-      void release(uint32_t idx)
+      /// Broadcast a new generation to all sessions.
+      void broadcast_all(uint32_t gen)
       {
-         std::lock_guard<mutex_type> lk(_mu);
-         _locks[idx]->gen_ptr.store(uint64_t(-1), std::memory_order_relaxed);
-         _free_list.push_back(idx);
+         std::lock_guard<mutex_type> lk(_slots->mu);
+         _slots->broadcast(gen);
       }
 
-      /// Get the lock at an index.
-      dwal_session_lock& operator[](uint32_t idx) { return *_locks[idx]; }
+      /// The epoch new pins observe.
+      uint32_t epoch() const
+      {
+         std::lock_guard<mutex_type> lk(_slots->mu);
+         return _slots->epoch;
+      }
 
-      /// Broadcast a new generation to all sessions.
-      void broadcast_all(uint32_t gen)
+      /// Start the next epoch. Returns the epoch that ended: anything
+      /// retired before the call is free once min_pinned() exceeds it.
+      uint32_t advance()
       {
-         std::lock_guard<mutex_type> lk(_mu);
-         for (auto& lock : _locks)
-            lock->broadcast(gen);
+         std::lock_guard<mutex_type> lk(_slots->mu);
+         uint32_t ended = _slots->epoch;
+         _slots->broadcast(ended + 1);
+         return ended;
       }
 
       /// Return the minimum pinned generation across all sessions.
       /// Returns 0xFFFFFFFF if no session is pinned (all idle).
       uint32_t min_pinned() const
       {
+         // Pairs with the fence in dwal_session_lock::lock().  The mutex
+         // only guards the vector, which reader threads grow on first use;
+         // stale values are safe (conservative: may delay freeing, never
+         // premature).
+         std::atomic_thread_fence(std::memory_order_seq_cst);
+         std::lock_guard<mutex_type> lk(_slots->mu);
          uint32_t min_gen = dwal_session_lock::idle;
-         // No lock needed — reading atomic values. Stale reads are safe
-         // (conservative: may delay freeing, never premature).
-         for (size_t i = 0; i < _locks.size(); ++i)
+         for (auto& lock : _slots->locks)
          {
-            uint32_t g = _locks[i]->pinned_generation();
+            uint32_t g = lock->pinned_generation();
             if (g < min_gen)
                min_gen = g;
          }
@@ -107,14 +146,82 @@ namespace psitri::dwal
 
       size_t size() const
       {
-         std::lock_guard<mutex_type> lk(_mu);
-         return _locks.size();
+         std::lock_guard<mutex_type> lk(_slots->mu);
+         return _slots->locks.size();
       }
 
      private:
-      mutable mutex_type                              _mu;
-      std::vector<std::unique_ptr<dwal_session_lock>> _locks;
-      std::vector<uint32_t>                           _free_list;
+      /// Shared with the thread_slot of every thread that used the
+      /// registry, so a thread can release its slot after the registry
+      /// is gone.
+      struct slots
+      {
+         mutable mutex_type                              mu;
+         std::vector<std::unique_ptr<dwal_session_lock>> locks;
+         std::vector<uint32_t>                           free_list;
+         uint32_t                                        epoch = 0;
+         std::atomic<bool>                               closed{false};  ///< registry destroyed
+
+         uint32_t allocate()
+         {
+            std::lock_guard<mutex_type> lk(mu);
+            uint64_t idle_at_epoch = uint64_t(epoch) << 32 | dwal_session_lock::idle;
+            if (!free_list.empty())
+            {
+               uint32_t idx = free_list.back();
+               free_list.pop_back();
+               locks[idx]->gen_ptr.store(idle_at_epoch, std::memory_order_relaxed);
+               return idx;
+            }
+            uint32_t idx = static_cast<uint32_t>(locks.size());
+            locks.push_back(std::make_unique<dwal_session_lock>());
+            locks[idx]->gen_ptr.store(idle_at_epoch, std::memory_order_relaxed);
+            return idx;
+         }
+
+         void release(uint32_t idx)
+         {
+            std::lock_guard<mutex_type> lk(mu);
+            locks[idx]->gen_ptr.store(uint64_t(-1), std::memory_order_relaxed);
+            free_list.push_back(idx);
+         }
+
+         /// Requires mu.
+         void broadcast(uint32_t gen)
+         {
+            epoch = gen;
+            for (auto& lock : locks)
+               lock->broadcast(gen);
+         }
+      };
+
+      /// One thread's slot in one registry.
+      struct thread_slot
+      {
+         std::shared_ptr<slots> owner;
+         uint32_t               index = 0;
+         dwal_session_lock*     lock  = nullptr;
+
+         thread_slot()                              = default;
+         thread_slot(const thread_slot&)            = delete;
+         thread_slot& operator=(const thread_slot&) = delete;
+
+         void attach(const std::shared_ptr<slots>& s)
+         {
+            owner = s;
+            index = s->allocate();
+            std::lock_guard<mutex_type> lk(s->mu);
+            lock = s->locks[index].get();
+         }
+
+         ~thread_slot()
+         {
+            if (owner)
+               owner->release(index);
+         }
+      };
+
+      std::shared_ptr<slots> _slots;
    };
 
    using epoch_registry = basic_epoch_registry<std_lock_policy>;
@@ -16,8 +16,14 @@ namespace psitri::dwal
    /// key across all sources. Higher layers (RW > RO > Tri) shadow lower
    /// layers for the same key.
    ///
+   /// It is an ordered k-way merge: every step only compares the layer
+   /// iterators' current keys and advances them.  A key can only be
+   /// shadowed by a point tombstone at one of those positions, and a range
+   /// tombstone moves the layers below it past the whole range at once.
+   ///
    /// Layer pointers may be null to exclude layers (e.g., read_mode::buffered
-   /// omits RW, read_mode::trie omits RW+RO).
+   /// omits RW, read_mode::trie omits RW+RO).  A layer with neither entries
+   /// nor range tombstones when the cursor is positioned is left out too.
    class merge_cursor
    {
      public:
@@ -78,38 +84,57 @@ namespace psitri::dwal
       uint64_t count_keys(std::string_view lower = {}, std::string_view upper = {});
 
      private:
-      /// Advance the merge state to find the next live key >= current positions.
+      /// Take the smallest live key at or after the layers' positions.
       /// Returns false if all sources are exhausted (at end).
       bool advance_forward();
 
-      /// Retreat the merge state to find the previous live key.
+      /// Take the largest live key at or before the layers' positions.
       bool advance_backward();
 
-      /// Check if a key is shadowed by tombstones in higher layers.
-      bool is_tombstoned_by_rw(std::string_view k) const;
-      bool is_tombstoned_by_ro(std::string_view k) const;
+      /// Choose the layers that take part until the next repositioning.
+      void select_layers();
+
+      /// Position every layer at its first key, or its last.
+      void position_first();
+      void position_last();
+
+      /// Position every layer at its first key after @p k, or its last key
+      /// before it; used when the direction of iteration changes.
+      void position_after(std::string_view k);
+      void position_before(std::string_view k);
 
-      /// Skip the RO and/or Tri iterators past a key that was taken by a higher layer.
-      void skip_ro_past(std::string_view k);
-      void skip_tri_past(std::string_view k);
+      /// The range tombstone of @p layer (if any) covering @p k.
+      static const range_tombstone_list::range* deleted_range(const btree_layer* layer,
+                                                              std::string_view   k);
+
+      /// Move the Tri cursor to its first key at or after @p k, or its last
+      /// key before @p k, if it is not there already.
+      void tri_skip_to(std::string_view k);
+      void tri_skip_before(std::string_view k);
 
       // Layer pointers (null = excluded).
       const btree_layer* _rw = nullptr;
       const btree_layer* _ro = nullptr;
 
-      // Btree iterators.
+      // The layers merged since the last repositioning (null = skipped).
+      const btree_layer* _rw_live = nullptr;
+      const btree_layer* _ro_live = nullptr;
+
+      // Btree iterators; end() also stands for "before the first key".
       btree_iter _rw_it, _rw_end;
       btree_iter _ro_it, _ro_end;
 
       // PsiTri cursor (optional).
       std::optional<psitri::cursor> _tri;
 
-      // Current merged position.
+      // Current merged position.  Only the winning layer is still on
+      // _current_key; the others are already past it in _forward's direction.
       std::string  _current_key;
       btree_value  _current_value;
       source       _source  = source::none;
       bool         _at_end  = true;
       bool         _at_rend = true;
+      bool         _forward = true;
    };
 
    /// A merge cursor that owns its layer snapshots.
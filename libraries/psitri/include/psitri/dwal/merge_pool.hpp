@@ -1,15 +1,18 @@
 #pragma once
+#include <psitri/dwal/btree_value.hpp>
 #include <psitri/dwal/dwal_root.hpp>
 #include <psitri/dwal/epoch_lock.hpp>
+#include <psitri/dwal/merge_stats.hpp>
 #include <psitri/fwd.hpp>
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <cstdint>
 #include <filesystem>
+#include <functional>
 #include <memory>
 #include <mutex>
-#include <queue>
 #include <thread>
 #include <vector>
 
@@ -22,14 +25,33 @@ namespace psitri::dwal
    /// A pool thread wakes, picks up the root, and drains all entries from the
    /// RO btree into PsiTri via a transaction.
    ///
-   /// The queue mutex and condition_variable are OS-thread primitives: the
-   /// pool runs its own background std::threads and never yields a fiber
-   /// while holding them. LockPolicy therefore only parameterizes the types
-   /// that cross into user threads (dwal_root, epoch_registry, database).
+   /// A large RO btree is split by the Tri root's top-level branches into
+   /// partitions that the other pool threads merge in parallel, each into a
+   /// copy of its branches; the draining thread grafts the new branches into
+   /// the root and commits once.
+   ///
+   /// With a publish chunk size or interval, a drain instead commits every
+   /// chunk as it goes and advances the RO btree's merge_watermark, so
+   /// readers see the merged keys in the Tri before the drain ends.
+   ///
+   /// Scheduling takes no locks: pending roots are bits ranked when a thread
+   /// looks for work, and idle threads sleep on an atomic wait.  The pool
+   /// runs its own background std::threads, so LockPolicy only parameterizes
+   /// the types that cross into user threads (dwal_root, epoch_registry,
+   /// database).
    template <class LockPolicy = std_lock_policy>
    class basic_merge_pool
    {
      public:
+      /// RO btrees smaller than this are drained by a single thread.
+      static constexpr uint64_t default_partition_min_entries = 16384;
+
+      /// Entries applied per tree_context::upsert_batch() call while draining.
+      static constexpr size_t drain_batch_size = 1024;
+
+      /// Root indices the pool can schedule (matches dwal_database).
+      static constexpr uint32_t max_roots = 512;
+
       using database_type       = basic_database<LockPolicy>;
       using write_session_type  = basic_write_session<LockPolicy>;
       using dwal_root_type      = basic_dwal_root<LockPolicy>;
@@ -38,8 +60,14 @@ namespace psitri::dwal
       basic_merge_pool(std::shared_ptr<database_type> db,
                        uint32_t                       num_threads,
                        epoch_registry_type&           epochs,
-                       std::filesystem::path          wal_dir            = {},
-                       uint64_t                       target_arena_bytes = 0);
+                       std::filesystem::path          wal_dir               = {},
+                       uint64_t                       target_arena_bytes    = 0,
+                       uint64_t                       partition_min_entries =
+                           default_partition_min_entries,
+                       shared_wal*                    shared_log = nullptr,
+                       bool                           recycle_wal = false,
+                       uint64_t                       publish_entries = 0,
+                       std::chrono::milliseconds      publish_interval = {});
 
       ~basic_merge_pool();
 
@@ -57,34 +85,120 @@ namespace psitri::dwal
       /// check _shutdown on their next iteration.
       void request_stop();
 
-      /// Reclaim old RO pools. With shared_ptr this is automatic.
-      void try_reclaim();
+      /// Free the retired RO btrees that no reader's epoch still pins.
+      /// @return true if none are left waiting
+      bool try_reclaim();
+
+      /// Queue depth, queue wait and helper counters.  Per-root drain
+      /// latency is kept in each root's dwal_root::merge_latency.
+      merge_stats stats() const;
 
      private:
-      struct merge_request
+      /// A partition of a drain, run by whichever pool thread claims it.
+      using partition_task = std::function<void(write_session_type&)>;
+
+      /// A root waiting for its RO btree to be drained.  signal() fills the
+      /// slot and then sets the root's bit in _pending; the worker that
+      /// clears the bit owns the request.  A root is signaled again only
+      /// after its drain completes, so a slot never holds two requests.
+      struct pending_slot
       {
-         uint32_t        root_index;
-         dwal_root_type* root;
+         std::atomic<dwal_root_type*> root{nullptr};
+         std::atomic<uint64_t>        ro_entries{0};
+         std::atomic<int64_t>         signaled_ns{0};
       };
 
-      void worker_loop(uint32_t thread_index);
-      void drain_ro_btree(uint32_t thread_index, uint32_t root_index, dwal_root_type& root);
+      /// The partitions of the drain a thread is running.  Any thread claims
+      /// the next one by advancing @c state, which packs generation:32 |
+      /// count:16 | next:16, so a claim never applies to a later drain.
+      struct partition_board
+      {
+         std::atomic<uint64_t>       state{0};
+         std::atomic<uint32_t>       remaining{0};
+         std::vector<partition_task> tasks;
+      };
+
+      void     worker_loop(uint32_t thread_index);
+      void     drain_ro_btree(uint32_t thread_index, uint32_t root_index, dwal_root_type& root);
+      /// Merges the @p count RO entries from @p it into @p tx, advancing
+      /// @p it past them.
+      /// @return the number of partitions merged, or 0 (with @p it left
+      ///         alone) if the entries must be drained serially
+      uint32_t drain_partitioned(write_session_type&    ws,
+                                 uint32_t               thread_index,
+                                 psitri::transaction&   tx,
+                                 btree_layer::iterator& it,
+                                 uint64_t               count);
+      /// Waits for the partitions on this thread's board, running queued
+      /// partitions of any board meanwhile.
+      void     run_partitions(write_session_type& ws, uint32_t thread_index);
+      /// Claims and runs one queued partition, looking at this thread's
+      /// board first; @return false if none was queued.
+      bool     run_one_partition(write_session_type& ws, uint32_t thread_index);
+      /// Claims the pending root to drain next; @return false if none.
+      bool     pick_root(uint32_t thread_index, uint32_t& root_index);
+      void     wake_workers(bool all);
+      /// Queues an unpublished RO btree for try_reclaim() and advances
+      /// the epoch.
+      void     retire(std::shared_ptr<btree_layer> layer);
+      /// Appends the write of one RO btree entry to @p ops, with the first
+      /// @p strip key bytes removed; a subtree value takes a new reference.
+      static void add_batch_op(write_session_type&    ws,
+                               std::string_view       key,
+                               const btree_value&     val,
+                               size_t                 strip,
+                               std::vector<batch_op>& ops);
 
       std::shared_ptr<database_type> _db;
       epoch_registry_type&           _epochs;
       std::filesystem::path          _wal_dir;
-      uint64_t                       _target_arena_bytes = 0;
+      shared_wal*                    _shared_log = nullptr;
+      bool                           _recycle_wal = false;  ///< keep drained RO files as wal-free
+      uint64_t                       _target_arena_bytes    = 0;
+      uint64_t                       _partition_min_entries = default_partition_min_entries;
+      uint64_t                       _publish_entries       = 0;
+      std::chrono::milliseconds      _publish_interval{0};
 
       // Worker threads and their write sessions.
+      uint32_t                                         _num_threads;
       std::vector<std::thread>                         _threads;
       std::vector<std::shared_ptr<write_session_type>> _sessions;
 
-      // Work queue — std::mutex is intentional: the merge pool owns its own
-      // OS threads and does not participate in any fiber scheduler.
-      std::mutex                _queue_mu;
-      std::condition_variable   _queue_cv;
-      std::queue<merge_request> _queue;
-      std::atomic<bool>         _shutdown{false};
+      // Scheduling is lock-free.  Each root is homed on one worker (root
+      // index modulo thread count), which drains its home roots first and
+      // steals from the other workers' when it has none.  Across all of
+      // them, roots with a writer blocked in backpressure go first.  Idle
+      // workers sleep on _work_seq, which every signal bumps.
+      pending_slot                       _slots[max_roots];
+      std::atomic<uint64_t>              _pending[max_roots / 64]{};
+      std::atomic<uint32_t>              _work_seq{0};
+      std::unique_ptr<partition_board[]> _boards;
+      std::atomic<bool>                  _shutdown{false};
+
+      /// An RO btree freed once min_pinned() exceeds @c epoch.
+      struct retired_layer
+      {
+         std::shared_ptr<btree_layer> layer;
+         uint32_t                     epoch;
+      };
+      std::mutex                 _retired_mutex;
+      std::vector<retired_layer> _retired;
+
+      // Worker 0 sleeps here rather than on _work_seq, so that it can retry
+      // try_reclaim() with a growing interval while retired btrees stay
+      // pinned; wake_workers() wakes it too.
+      static constexpr std::chrono::microseconds min_reclaim_backoff{100};
+      static constexpr std::chrono::milliseconds max_reclaim_backoff{10};
+      std::mutex                                 _reclaim_mutex;
+      std::condition_variable                    _reclaim_cv;
+
+      std::atomic<uint32_t>    _queue_depth{0};
+      std::atomic<uint64_t>    _merges{0};
+      std::atomic<uint64_t>    _priority_merges{0};
+      std::atomic<uint64_t>    _steals{0};
+      std::atomic<uint64_t>    _helped_partitions{0};
+      std::atomic<uint64_t>    _publishes{0};
+      atomic_latency_histogram _queue_wait;
    };
 
    using merge_pool = basic_merge_pool<std_lock_policy>;
@@ -2,13 +2,18 @@
 #include <psitri/database_impl.hpp>
 #include <psitri/dwal/btree_layer.hpp>
 #include <psitri/dwal/merge_pool.hpp>
+#include <psitri/dwal/shared_wal.hpp>
 #include <psitri/write_session_impl.hpp>
 
 #include <algorithm>
+#include <bit>
+#include <cassert>
 #include <chrono>
 #include <cmath>
-#include <cstdio>
-#include <ctime>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <tuple>
 
 namespace psitri::dwal
 {
@@ -17,11 +22,23 @@ namespace psitri::dwal
                                                   uint32_t                       num_threads,
                                                   epoch_registry_type&           epochs,
                                                   std::filesystem::path          wal_dir,
-                                                  uint64_t target_arena_bytes)
+                                                  uint64_t target_arena_bytes,
+                                                  uint64_t partition_min_entries,
+                                                  shared_wal* shared_log,
+                                                  bool        recycle_wal,
+                                                  uint64_t    publish_entries,
+                                                  std::chrono::milliseconds publish_interval)
        : _db(std::move(db)),
          _epochs(epochs),
          _wal_dir(std::move(wal_dir)),
-         _target_arena_bytes(target_arena_bytes)
+         _shared_log(shared_log),
+         _recycle_wal(recycle_wal),
+         _target_arena_bytes(target_arena_bytes),
+         _partition_min_entries(partition_min_entries),
+         _publish_entries(publish_entries),
+         _publish_interval(publish_interval),
+         _num_threads(num_threads),
+         _boards(std::make_unique<partition_board[]>(num_threads))
    {
       // Sessions are created lazily on each worker thread (not here) because
       // allocator_sessions are thread-local — a session created on the main
@@ -42,25 +59,47 @@ namespace psitri::dwal
    template <class LockPolicy>
    void basic_merge_pool<LockPolicy>::signal(uint32_t root_index, dwal_root_type& root)
    {
+      assert(root_index < max_roots);
+      uint64_t ro_entries = root.buffered_owner ? root.buffered_owner->map.size() : 0;
+
+      auto& slot = _slots[root_index];
+      slot.root.store(&root, std::memory_order_relaxed);
+      slot.ro_entries.store(ro_entries, std::memory_order_relaxed);
+      slot.signaled_ns.store(std::chrono::steady_clock::now().time_since_epoch().count(),
+                             std::memory_order_relaxed);
+      _queue_depth.fetch_add(1, std::memory_order_relaxed);
+      _pending[root_index / 64].fetch_or(uint64_t(1) << (root_index % 64),
+                                         std::memory_order_release);
+      wake_workers(false);
+   }
+
+   template <class LockPolicy>
+   void basic_merge_pool<LockPolicy>::wake_workers(bool all)
+   {
+      _work_seq.fetch_add(1, std::memory_order_release);
+      if (all)
+         _work_seq.notify_all();
+      else
+         _work_seq.notify_one();
+      // worker 0 may be in a timed reclaim wait rather than on _work_seq
       {
-         std::lock_guard lk(_queue_mu);
-         _queue.push({root_index, &root});
+         std::lock_guard lk(_reclaim_mutex);
       }
-      _queue_cv.notify_one();
+      _reclaim_cv.notify_one();
    }
 
    template <class LockPolicy>
    void basic_merge_pool<LockPolicy>::request_stop()
    {
       _shutdown.store(true, std::memory_order_relaxed);
-      _queue_cv.notify_all();
+      wake_workers(true);
    }
 
    template <class LockPolicy>
    void basic_merge_pool<LockPolicy>::shutdown()
    {
       _shutdown.store(true, std::memory_order_relaxed);
-      _queue_cv.notify_all();
+      wake_workers(true);
       for (auto& t : _threads)
       {
          if (t.joinable())
@@ -68,6 +107,67 @@ namespace psitri::dwal
       }
       _threads.clear();
       _sessions.clear();
+
+      // Readers are done by now, so nothing pins what is left.
+      std::lock_guard lk(_retired_mutex);
+      _retired.clear();
+   }
+
+   template <class LockPolicy>
+   bool basic_merge_pool<LockPolicy>::pick_root(uint32_t thread_index, uint32_t& root_index)
+   {
+      const int64_t now = std::chrono::steady_clock::now().time_since_epoch().count();
+      for (;;)
+      {
+         // Rank: a blocked writer first, then this thread's home roots, then
+         // RO size weighted by the time waited, so small roots still age
+         // their way to the front.
+         int      best = -1;
+         bool     best_blocked = false, best_home = false;
+         double   best_weight = 0;
+         for (uint32_t w = 0; w < max_roots / 64; ++w)
+         {
+            for (uint64_t bits = _pending[w].load(std::memory_order_acquire); bits;
+                 bits &= bits - 1)
+            {
+               uint32_t idx  = w * 64 + std::countr_zero(bits);
+               auto&    slot = _slots[idx];
+               bool     blocked =
+                   slot.root.load(std::memory_order_relaxed)->merge_waiters.load(
+                       std::memory_order_relaxed) > 0;
+               bool   home    = idx % _num_threads == thread_index;
+               double wait_ms = (now - slot.signaled_ns.load(std::memory_order_relaxed)) / 1e6;
+               double weight  = double(slot.ro_entries.load(std::memory_order_relaxed) + 1) *
+                               (1 + std::max(wait_ms, 0.0));
+               if (best < 0 || std::tie(blocked, home, weight) >
+                                   std::tie(best_blocked, best_home, best_weight))
+               {
+                  best         = int(idx);
+                  best_blocked = blocked;
+                  best_home    = home;
+                  best_weight  = weight;
+               }
+            }
+         }
+         if (best < 0)
+            return false;
+
+         uint64_t mask = uint64_t(1) << (best % 64);
+         if (!(_pending[best / 64].fetch_and(~mask, std::memory_order_acq_rel) & mask))
+            continue;  // another thread claimed it first
+
+         root_index = uint32_t(best);
+         _queue_depth.fetch_sub(1, std::memory_order_relaxed);
+         _merges.fetch_add(1, std::memory_order_relaxed);
+         if (best_blocked)
+            _priority_merges.fetch_add(1, std::memory_order_relaxed);
+         if (!best_home)
+            _steals.fetch_add(1, std::memory_order_relaxed);
+         _queue_wait.record(std::chrono::steady_clock::duration(
+             std::chrono::steady_clock::now().time_since_epoch().count() -
+             _slots[best].signaled_ns.load(std::memory_order_relaxed)));
+         return true;
+      }
    }
 
    template <class LockPolicy>
@@ -77,117 +177,155 @@ namespace psitri::dwal
       // is bound to the correct thread-local storage.  The session must also be
       // destroyed on this thread (allocator_session has thread affinity).
       _sessions[thread_index] = _db->start_write_session();
+      auto& ws                = *_sessions[thread_index];
 
+      std::chrono::steady_clock::duration backoff = min_reclaim_backoff;
       while (!_shutdown.load(std::memory_order_relaxed))
       {
-         merge_request req;
+         uint32_t seq = _work_seq.load(std::memory_order_acquire);
+
+         // Partitions of another thread's drain come first: that thread
+         // is waiting on them.
+         if (run_one_partition(ws, thread_index))
+            continue;
+
+         uint32_t root_index;
+         if (pick_root(thread_index, root_index))
          {
-            std::unique_lock lk(_queue_mu);
-            _queue_cv.wait(lk, [this]
-                           { return !_queue.empty() || _shutdown.load(std::memory_order_relaxed); });
-            if (_shutdown.load(std::memory_order_relaxed) && _queue.empty())
-               break;
-            req = _queue.front();
-            _queue.pop();
+            drain_ro_btree(thread_index, root_index,
+                           *_slots[root_index].root.load(std::memory_order_relaxed));
+            // hand what is still pinned to worker 0
+            if (!try_reclaim() && thread_index != 0)
+               wake_workers(false);
+            continue;
+         }
+         if (thread_index != 0)
+         {
+            _work_seq.wait(seq, std::memory_order_acquire);
+            continue;
          }
 
-         drain_ro_btree(thread_index, req.root_index, *req.root);
-         try_reclaim();
+         // Most pins last one lookup, but a read session or cursor can hold
+         // one for as long as it likes.  Only worker 0 retries, less often
+         // the longer the pin lasts, and new work still wakes it at once.
+         const bool       clear = try_reclaim();
+         std::unique_lock lk(_reclaim_mutex);
+         auto             woken = [&]
+         {
+            return _work_seq.load(std::memory_order_acquire) != seq ||
+                   _shutdown.load(std::memory_order_relaxed);
+         };
+         if (clear)
+         {
+            backoff = min_reclaim_backoff;
+            _reclaim_cv.wait(lk, woken);
+         }
+         else if (!_reclaim_cv.wait_for(lk, backoff, woken))
+            backoff = std::min<std::chrono::steady_clock::duration>(2 * backoff,
+                                                                    max_reclaim_backoff);
       }
 
       // Destroy session on this thread to respect allocator_session thread affinity.
       _sessions[thread_index].reset();
    }
 
+   template <class LockPolicy>
+   merge_stats basic_merge_pool<LockPolicy>::stats() const
+   {
+      merge_stats s;
+      s.queue_depth     = _queue_depth.load(std::memory_order_relaxed);
+      s.merges          = _merges.load(std::memory_order_relaxed);
+      s.priority_merges = _priority_merges.load(std::memory_order_relaxed);
+      s.steals          = _steals.load(std::memory_order_relaxed);
+      s.partitions      = _helped_partitions.load(std::memory_order_relaxed);
+      s.publishes       = _publishes.load(std::memory_order_relaxed);
+      s.queue_wait      = _queue_wait.snapshot();
+      return s;
+   }
+
    template <class LockPolicy>
    void basic_merge_pool<LockPolicy>::drain_ro_btree(uint32_t        thread_index,
                                                      uint32_t        root_index,
                                                      dwal_root_type& root)
    {
-      // Grab a shared_ptr to the RO btree — keeps it alive during merge.
-      std::shared_ptr<btree_layer> ro;
-      {
-         std::lock_guard lk(root.buffered_mutex);
-         ro = root.buffered_ptr;
-      }
+      // The writer set buffered_owner before signaling and leaves it alone
+      // until merge_complete.
+      std::shared_ptr<btree_layer> ro = root.buffered_owner;
       if (!ro)
          return;
 
-      auto            wall_start = std::chrono::steady_clock::now();
-      struct timespec cpu_start_ts;
-      clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu_start_ts);
-
-      auto& ws               = *_sessions[thread_index];
-      auto  as               = ws.allocator_session();
-      auto  seg_count_before = as->seg_alloc_count();
-      auto  seg_ns_before    = as->seg_alloc_ns();
-      auto  tx               = ws.start_transaction(root_index);
-
-      // Drain all entries from the RO btree into PsiTri.
-      // Keys arrive in sorted order — use upsert_sorted to enable sibling
-      // prefetch, warming pages the next key will need.
-      //
-      // Per-entry timing: bucket each upsert into latency ranges to identify
-      // whether stalls come from a few very slow ops (segment alloc) or many
-      // moderately slow ones (page fault reads).
-      uint64_t entry_count    = 0;
-      uint64_t bucket_lt1us   = 0;  // < 1 us
-      uint64_t bucket_lt10us  = 0;  // 1-10 us
-      uint64_t bucket_lt100us = 0;  // 10-100 us
-      uint64_t bucket_lt1ms   = 0;  // 100us-1ms
-      uint64_t bucket_lt10ms  = 0;  // 1-10 ms
-      uint64_t bucket_ge10ms  = 0;  // >= 10 ms
-      double   max_entry_us   = 0;
-      double   sum_top_us     = 0;  // sum of entries >= 1ms
-      uint64_t count_top      = 0;
-
-      bool aborted = false;
-      for (auto it = ro->map.begin(); it != ro->map.end(); ++it)
+      auto wall_start = std::chrono::steady_clock::now();
+
+      auto& ws = *_sessions[thread_index];
+      std::optional<psitri::transaction> tx;
+      tx.emplace(ws.start_transaction(root_index));
+
+      // Range tombstones go first: a key written after its range was
+      // removed is in the map, and lands on top of the removal.  Every
+      // published chunk then has them applied as well.
+      for (const auto& range : ro->tombstones.ranges())
+         tx->remove_range(range.low, range.high);
+
+      // Drain all entries from the RO btree into PsiTri, a chunk at a time
+      // when publishing as it goes (the whole btree otherwise).
+      // Keys arrive in sorted order, so they are applied in batches: runs of
+      // keys that land in the same leaf share one rebuild of that leaf.
+      const uint64_t total         = ro->map.size();
+      const bool     chunked       = _publish_entries || _publish_interval.count();
+      const uint64_t chunk_entries = _publish_entries ? _publish_entries : total;
+      if (chunked && total)
+         ro->merged.reserve(total / std::min<uint64_t>(chunk_entries, drain_batch_size) + 1);
+
+      uint64_t              entry_count = 0;
+      bool                  aborted     = false;
+      std::vector<batch_op> batch;
+      batch.reserve(drain_batch_size);
+      auto it          = ro->map.begin();
+      auto chunk_start = wall_start;
+      while (it != ro->map.end())
       {
          if (_shutdown.load(std::memory_order_relaxed)) [[unlikely]]
          {
-            tx.abort();
+            tx->abort();
             aborted = true;
-            fprintf(stderr, "[MERGE] shutdown requested — aborting after %llu entries\n",
-                    (unsigned long long)entry_count);
             break;
          }
 
-         auto entry_start = std::chrono::steady_clock::now();
-
-         auto  key = it.key();
-         auto& val = it.value();
-         if (val.is_tombstone())
-         {
-            tx.remove(key_view(key.data(), key.size()));
-         }
-         else if (val.is_subtree())
-         {
-            auto subtree = ws.make_ptr(val.subtree, /*retain=*/true);
-            if (subtree)
-               tx.upsert_sorted(key, std::move(subtree));
-         }
-         else
-         {
-            tx.upsert_sorted(key, val.data);
-         }
-         ++entry_count;
-         double us = std::chrono::duration<double, std::micro>(
-                         std::chrono::steady_clock::now() - entry_start)
-                         .count();
-         if (us < 1)          ++bucket_lt1us;
-         else if (us < 10)    ++bucket_lt10us;
-         else if (us < 100)   ++bucket_lt100us;
-         else if (us < 1000)  ++bucket_lt1ms;
-         else if (us < 10000) ++bucket_lt10ms;
-         else                 ++bucket_ge10ms;
-         if (us > max_entry_us)
-            max_entry_us = us;
-         if (us >= 1000)
+         // Large chunks are split across the pool; the serial loop below
+         // handles the rest, and stops if a partitioned drain was cut short
+         // by shutdown.
+         const uint64_t chunk_end = entry_count + std::min(total - entry_count, chunk_entries);
+         uint32_t       parts     = 0;
+         if (_num_threads > 1 && chunk_end - entry_count >= _partition_min_entries)
+            parts = drain_partitioned(ws, thread_index, *tx, it, chunk_end - entry_count);
+         if (parts)
+            entry_count = chunk_end;
+         while (!parts && entry_count < chunk_end &&
+                !_shutdown.load(std::memory_order_relaxed))
          {
-            sum_top_us += us;
-            ++count_top;
+            batch.clear();
+            for (; entry_count + batch.size() < chunk_end && batch.size() < drain_batch_size; ++it)
+               add_batch_op(ws, it.key(), it.value(), 0, batch);
+            tx->upsert_batch(batch);
+            entry_count += batch.size();
+            if (_publish_interval.count() &&
+                std::chrono::steady_clock::now() - chunk_start >= _publish_interval)
+               break;
          }
+         if (it == ro->map.end() || _shutdown.load(std::memory_order_relaxed))
+            continue;
+
+         // Publish the chunk: readers that load the watermark afterwards
+         // find its keys in the Tri.
+         tx->commit();
+         if (auto new_root = ws.get_root(root_index))
+            root.tri_root.store(static_cast<uint32_t>(new_root.address()),
+                                std::memory_order_release);
+         ro->merged.publish(it.key());
+         _publishes.fetch_add(1, std::memory_order_relaxed);
+         tx.reset();
+         tx.emplace(ws.start_transaction(root_index));
+         chunk_start = std::chrono::steady_clock::now();
       }
       if (aborted)
       {
@@ -196,58 +334,12 @@ namespace psitri::dwal
          return;
       }
 
-      // Apply range tombstones.
-      for (const auto& range : ro->tombstones.ranges())
-         tx.remove_range(range.low, range.high);
-
-      auto            wall_pre_commit = std::chrono::steady_clock::now();
-      struct timespec cpu_pre_commit_ts;
-      clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu_pre_commit_ts);
-
-      tx.commit();
-
-      auto            wall_end = std::chrono::steady_clock::now();
-      struct timespec cpu_end_ts;
-      clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu_end_ts);
-
-      auto to_ms = [](struct timespec& a, struct timespec& b) -> double
-      { return (b.tv_sec - a.tv_sec) * 1000.0 + (b.tv_nsec - a.tv_nsec) / 1e6; };
-
-      double wall_drain_ms =
-          std::chrono::duration<double, std::milli>(wall_pre_commit - wall_start).count();
-      double wall_commit_ms =
-          std::chrono::duration<double, std::milli>(wall_end - wall_pre_commit).count();
-      double wall_total_ms = wall_drain_ms + wall_commit_ms;
-      double cpu_drain_ms  = to_ms(cpu_start_ts, cpu_pre_commit_ts);
-      double cpu_commit_ms = to_ms(cpu_pre_commit_ts, cpu_end_ts);
-      double cpu_total_ms  = cpu_drain_ms + cpu_commit_ms;
-      double syscall_pct =
-          wall_total_ms > 0 ? 100.0 * (1.0 - cpu_total_ms / wall_total_ms) : 0;
-
-      double entries_per_sec = wall_total_ms > 0 ? entry_count / (wall_total_ms / 1000.0) : 0;
-      double us_per_entry    = entry_count > 0 ? (wall_total_ms * 1000.0) / entry_count : 0;
-      double top_total_ms    = sum_top_us / 1000.0;
-
-      uint64_t seg_count = as->seg_alloc_count() - seg_count_before;
-      double   seg_ms    = (as->seg_alloc_ns() - seg_ns_before) / 1e6;
-
-      fprintf(stderr,
-              "[MERGE] root=%u entries=%llu  %.0f ms wall / %.0f ms cpu  "
-              "syscall=%.0f%%  %.0f entries/sec  %.2f us/entry  max=%.1f ms\n"
-              "        latency: <1us=%llu  <10us=%llu  <100us=%llu  <1ms=%llu  "
-              "<10ms=%llu  >=10ms=%llu  |  stalls(>=1ms): %llu entries, %.0f ms total (%.0f%% of wall)\n"
-              "        segments: %llu new segs, %.0f ms total (%.0f%% of wall)  "
-              "%.1f ms/seg\n",
-              root_index, (unsigned long long)entry_count, wall_total_ms, cpu_total_ms,
-              syscall_pct, entries_per_sec, us_per_entry, max_entry_us / 1000.0,
-              (unsigned long long)bucket_lt1us, (unsigned long long)bucket_lt10us,
-              (unsigned long long)bucket_lt100us, (unsigned long long)bucket_lt1ms,
-              (unsigned long long)bucket_lt10ms, (unsigned long long)bucket_ge10ms,
-              (unsigned long long)count_top, top_total_ms,
-              wall_total_ms > 0 ? 100.0 * top_total_ms / wall_total_ms : 0,
-              (unsigned long long)seg_count, seg_ms,
-              wall_total_ms > 0 ? 100.0 * seg_ms / wall_total_ms : 0,
-              seg_count > 0 ? seg_ms / seg_count : 0);
+      tx->commit();
+      auto wall_end = std::chrono::steady_clock::now();
+
+      // The latency distribution is in root.merge_latency; see merge_stats.
+      root.merge_latency.record(wall_end - wall_start);
+      root.swap_ctl.record_merge(entry_count, wall_end - wall_start);
 
       // Update the DWAL root's tri_root to reflect the new PsiTri root.
       auto new_root = ws.get_root(root_index);
@@ -255,34 +347,35 @@ namespace psitri::dwal
          root.tri_root.store(static_cast<uint32_t>(new_root.address()),
                              std::memory_order_release);
 
-      // Null the buffered shared_ptr — last reader holding a copy will free it.
-      {
-         std::lock_guard lk(root.buffered_mutex);
-         root.buffered_ptr.reset();
-      }
-
-      // Drop our local reference.
-      uint32_t gen = ro->generation;
+      // Readers that loaded the RO btree inside an epoch may still be in
+      // it, so it is freed by try_reclaim() once their epochs end.
+      retire(root.unpublish_buffered());
       ro.reset();
 
-      // Queue for epoch-based reclamation (in case readers still hold copies).
-      // Note: with shared_ptr this is handled automatically, but we keep the
-      // epoch tracking for generation ordering.
-
-      // Delete the RO WAL file — its data is now in PsiTri.
-      if (!_wal_dir.empty())
+      // Delete the RO WAL file — its data is now in PsiTri — or keep it as
+      // the root's spare for the next swap to reuse.  This happens before
+      // merge_complete is set, so the swap always finds the spare.  In a
+      // shared log, release the segments only this RO btree still needed.
+      if (_shared_log)
+         _shared_log->release_ro(static_cast<uint16_t>(root_index));
+      else if (!_wal_dir.empty())
       {
-         auto ro_wal =
-             _wal_dir / ("root-" + std::to_string(root_index)) / "wal-ro.dwal";
+         auto dir    = _wal_dir / ("root-" + std::to_string(root_index));
+         auto ro_wal = dir / "wal-ro.dwal";
          std::error_code ec;
-         std::filesystem::remove(ro_wal, ec);
+         if (_recycle_wal)
+            std::filesystem::rename(ro_wal, dir / "wal-free.dwal", ec);
+         else
+            std::filesystem::remove(ro_wal, ec);
       }
 
       // ── Adaptive throttle adjustment ──────────────────────────────
       // Record the current RW arena capacity so the writer can see how
       // far the arena grew while this merge was running.  Then adjust
       // the per-commit sleep to target the merge finishing before the
-      // arena reaches max_rw_arena_bytes.
+      // arena reaches max_rw_arena_bytes.  The swap controller, when
+      // enabled, paces the writer instead.
+      if (!root.swap_ctl.enabled())
       {
          uint32_t arena_cap = root.rw_layer ? root.rw_layer->map.arena_capacity() : 0;
          root.arena_at_merge_complete.store(arena_cap, std::memory_order_relaxed);
@@ -319,11 +412,219 @@ namespace psitri::dwal
    }
 
    template <class LockPolicy>
-   void basic_merge_pool<LockPolicy>::try_reclaim()
+   uint32_t basic_merge_pool<LockPolicy>::drain_partitioned(write_session_type&    ws,
+                                                            uint32_t               thread_index,
+                                                            psitri::transaction&   tx,
+                                                            btree_layer::iterator& it,
+                                                            uint64_t               count)
+   {
+      auto fan = tx.fanout();
+      if (fan.branches.size() < 2)
+         return 0;
+
+      // One run of consecutive RO entries per top-level branch they touch.
+      struct branch_run
+      {
+         uint32_t              branch;
+         btree_layer::iterator begin;
+         uint64_t              count      = 0;
+         sal::ptr_address      new_branch = sal::null_ptr_address;
+      };
+      std::vector<branch_run> runs;
+      auto                    end = it;
+      for (uint64_t n = 0; n < count; ++n, ++end)
+      {
+         auto key = end.key();
+         int  br  = fan.route(key_view(key.data(), key.size()));
+         // A key outside the root's prefix changes the root itself.
+         if (br < 0)
+            return 0;
+         if (runs.empty() || runs.back().branch != uint32_t(br))
+            runs.push_back({uint32_t(br), end});
+         ++runs.back().count;
+      }
+      if (runs.size() < 2)
+         return 0;
+
+      // Group the runs into partitions of about the same number of entries.
+      const uint64_t num_parts = std::min<uint64_t>(_num_threads, runs.size());
+      const uint64_t target    = (count + num_parts - 1) / num_parts;
+      std::vector<std::pair<size_t, size_t>> parts;  // [first run, end run)
+      size_t                                 first  = 0;
+      uint64_t                               filled = 0;
+      for (size_t r = 0; r < runs.size(); ++r)
+      {
+         filled += runs[r].count;
+         if (filled >= target && parts.size() + 1 < num_parts)
+         {
+            parts.emplace_back(first, r + 1);
+            first  = r + 1;
+            filled = 0;
+         }
+      }
+      if (first < runs.size())
+         parts.emplace_back(first, runs.size());
+
+      // Each partition copies its branches (the transaction's root still
+      // holds the originals) and applies its runs with the prefix stripped.
+      auto merge_part = [&](write_session_type& pws, size_t first_run, size_t end_run)
+      {
+         const size_t          plen = fan.prefix.size();
+         std::vector<batch_op> batch;
+         batch.reserve(drain_batch_size);
+         for (size_t r = first_run; r < end_run; ++r)
+         {
+            auto&        run = runs[r];
+            write_cursor wc(pws.make_ptr(fan.branches[run.branch], /*retain=*/true),
+                            fan.epoch_base);
+            wc.set_root_version(fan.root_version);
+
+            auto it = run.begin;
+            for (uint64_t n = 0; n < run.count;)
+            {
+               batch.clear();
+               for (; n < run.count && batch.size() < drain_batch_size; ++n, ++it)
+                  add_batch_op(pws, it.key(), it.value(), plen, batch);
+               wc.upsert_batch(batch);
+            }
+            run.new_branch = wc.take_root().take();
+         }
+         // The new branches are published by the draining thread's commit,
+         // which only syncs that thread's own segments.
+         pws.allocator_session()->sync(pws.get_sync());
+      };
+
+      // Post every partition on this thread's board; it runs them alongside
+      // whichever threads are idle.
+      auto& board = _boards[thread_index];
+      board.tasks.clear();
+      for (auto part : parts)
+         board.tasks.push_back([&merge_part, part](write_session_type& pws)
+                               { merge_part(pws, part.first, part.second); });
+      board.remaining.store(parts.size(), std::memory_order_relaxed);
+      uint64_t gen = (board.state.load(std::memory_order_relaxed) >> 32) + 1;
+      board.state.store(gen << 32 | uint64_t(parts.size()) << 16, std::memory_order_release);
+      wake_workers(true);
+      run_partitions(ws, thread_index);
+      board.tasks.clear();
+
+      auto as = ws.allocator_session();
+      bool emptied =
+          std::any_of(runs.begin(), runs.end(),
+                      [](const branch_run& run) { return run.new_branch == sal::null_ptr_address; });
+      if (emptied || _shutdown.load(std::memory_order_relaxed))
+      {
+         // Removing a whole branch reshapes the root, which the serial drain
+         // already knows how to do; redo the merge there.
+         for (auto& run : runs)
+            if (run.new_branch != sal::null_ptr_address)
+               as->release(run.new_branch);
+         return 0;
+      }
+
+      // Stitch the new branches into the root in one pass; later grafts find
+      // their branch by key even if an earlier one split the root.
+      for (auto& run : runs)
+      {
+         auto old_branch = fan.branches[run.branch];
+         if (run.new_branch == old_branch)
+            as->release(old_branch);  // unchanged, drop the partition's retain
+         else
+            tx.graft(fan.branch_key(run.branch), old_branch, run.new_branch);
+      }
+      it = end;
+      return parts.size();
+   }
+
+   template <class LockPolicy>
+   void basic_merge_pool<LockPolicy>::add_batch_op(write_session_type&    ws,
+                                                   std::string_view       key,
+                                                   const btree_value&     val,
+                                                   size_t                 strip,
+                                                   std::vector<batch_op>& ops)
+   {
+      key = key.substr(strip);
+      if (val.is_tombstone())
+         ops.push_back({key, value_type()});
+      else if (val.is_subtree())
+      {
+         auto subtree = ws.make_ptr(val.subtree, /*retain=*/true);
+         if (!subtree)
+            return;
+         auto tid = subtree.get_tree_id();
+         subtree.take();  // the reference passes to the tree
+         ops.push_back({key, value_type::make_subtree(tid)});
+      }
+      else
+         ops.push_back({key, value_type(val.data)});
+   }
+
+   template <class LockPolicy>
+   bool basic_merge_pool<LockPolicy>::run_one_partition(write_session_type& ws,
+                                                        uint32_t            thread_index)
+   {
+      for (uint32_t i = 0; i < _num_threads; ++i)
+      {
+         uint32_t b     = (thread_index + i) % _num_threads;
+         auto&    board = _boards[b];
+         uint64_t s     = board.state.load(std::memory_order_acquire);
+         while ((s & 0xffff) < ((s >> 16) & 0xffff))
+         {
+            if (!board.state.compare_exchange_weak(s, s + 1, std::memory_order_acq_rel,
+                                                   std::memory_order_acquire))
+               continue;
+            // The board's tasks stay put until every claimed one finishes.
+            board.tasks[s & 0xffff](ws);
+            if (b != thread_index)
+               _helped_partitions.fetch_add(1, std::memory_order_relaxed);
+            if (board.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+               board.remaining.notify_all();
+            return true;
+         }
+      }
+      return false;
+   }
+
+   template <class LockPolicy>
+   void basic_merge_pool<LockPolicy>::run_partitions(write_session_type& ws,
+                                                     uint32_t            thread_index)
+   {
+      // Help with queued partitions (ours or another drain's) rather than
+      // idling, so a drain finishes even when every other thread is busy.
+      auto& remaining = _boards[thread_index].remaining;
+      for (uint32_t left; (left = remaining.load(std::memory_order_acquire)) != 0;)
+         if (!run_one_partition(ws, thread_index))
+            remaining.wait(left, std::memory_order_acquire);
+   }
+
+   template <class LockPolicy>
+   void basic_merge_pool<LockPolicy>::retire(std::shared_ptr<btree_layer> layer)
+   {
+      if (!layer)
+         return;
+      uint32_t epoch = _epochs.advance();
+      std::lock_guard lk(_retired_mutex);
+      _retired.push_back({std::move(layer), epoch});
+   }
+
+   template <class LockPolicy>
+   bool basic_merge_pool<LockPolicy>::try_reclaim()
    {
-      // With shared_ptr-based RO pools, reclamation is automatic.
-      // The last shared_ptr holder (reader or merge thread) frees the btree_layer.
-      // We keep this method for future epoch-based optimizations.
+      // Freed after the mutex is released; a cursor or read session that
+      // took shared_from_this() keeps its btree until it lets go.
+      std::vector<retired_layer> ready;
+
+      std::lock_guard lk(_retired_mutex);
+      if (_retired.empty())
+         return true;
+
+      uint32_t min_pinned = _epochs.min_pinned();
+      auto     pinned     = std::partition(_retired.begin(), _retired.end(),
+                                           [&](const retired_layer& r)
+                                           { return r.epoch >= min_pinned; });
+      ready.assign(std::make_move_iterator(pinned), std::make_move_iterator(_retired.end()));
+      _retired.erase(pinned, _retired.end());
+      return _retired.empty();
    }
 
 }  // namespace psitri::dwal
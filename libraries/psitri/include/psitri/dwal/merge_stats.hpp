@@ -0,0 +1,151 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace psitri::dwal
+{
+   /// Latency distribution with power-of-two buckets: bucket 0 counts
+   /// samples under 1 us, bucket i counts samples in [2^(i-1), 2^i) us.
+   struct latency_histogram
+   {
+      static constexpr uint32_t num_buckets = 32;
+
+      std::array<uint64_t, num_buckets> buckets{};
+      uint64_t                          count  = 0;
+      uint64_t                          sum_us = 0;
+      uint64_t                          max_us = 0;
+
+      static uint32_t bucket_of(uint64_t us) noexcept
+      {
+         return std::min<uint32_t>(std::bit_width(us), num_buckets - 1);
+      }
+
+      double mean_us() const noexcept { return count ? double(sum_us) / count : 0; }
+
+      /// @return the upper bound (us) of the bucket holding quantile @p q
+      uint64_t percentile_us(double q) const noexcept
+      {
+         if (!count)
+            return 0;
+         uint64_t rank = std::max<uint64_t>(1, uint64_t(q * count + 0.5));
+         uint64_t seen = 0;
+         for (uint32_t b = 0; b < num_buckets; ++b)
+            if ((seen += buckets[b]) >= rank)
+               return std::min(max_us, (uint64_t(1) << b));
+         return max_us;
+      }
+
+      std::string to_string() const;
+   };
+
+   /// latency_histogram updated concurrently by the merge threads.
+   class atomic_latency_histogram
+   {
+     public:
+      void record(std::chrono::steady_clock::duration d) noexcept
+      {
+         uint64_t us =
+             std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+         _buckets[latency_histogram::bucket_of(us)].fetch_add(1, std::memory_order_relaxed);
+         _count.fetch_add(1, std::memory_order_relaxed);
+         _sum_us.fetch_add(us, std::memory_order_relaxed);
+         for (uint64_t m = _max_us.load(std::memory_order_relaxed);
+              us > m && !_max_us.compare_exchange_weak(m, us, std::memory_order_relaxed);)
+            ;
+      }
+
+      latency_histogram snapshot() const noexcept
+      {
+         latency_histogram h;
+         for (uint32_t b = 0; b < latency_histogram::num_buckets; ++b)
+            h.buckets[b] = _buckets[b].load(std::memory_order_relaxed);
+         h.count  = _count.load(std::memory_order_relaxed);
+         h.sum_us = _sum_us.load(std::memory_order_relaxed);
+         h.max_us = _max_us.load(std::memory_order_relaxed);
+         return h;
+      }
+
+     private:
+      std::array<std::atomic<uint64_t>, latency_histogram::num_buckets> _buckets{};
+      std::atomic<uint64_t>                                             _count{0};
+      std::atomic<uint64_t>                                             _sum_us{0};
+      std::atomic<uint64_t>                                             _max_us{0};
+   };
+
+   /// How one root's writes and merges are being paced; see swap_controller.
+   struct flow_stats
+   {
+      double   ingest_rate     = 0;  ///< entries/sec filling the RW btree
+      double   merge_rate      = 0;  ///< entries/sec drained from the RO btree
+      double   swap_scale      = 1;  ///< multiplier on the configured swap thresholds
+      uint64_t delayed_commits = 0;  ///< commits slowed down by the controller
+      uint64_t delay_us        = 0;  ///< total delay added to those commits
+
+      std::string to_string() const;
+   };
+
+   /// Merge scheduling statistics; see dwal_database::get_merge_stats().
+   struct merge_stats
+   {
+      uint32_t queue_depth     = 0;  ///< roots signaled but not yet picked up
+      uint64_t merges          = 0;  ///< RO btrees drained
+      uint64_t priority_merges = 0;  ///< drains of roots with a writer blocked on them
+      uint64_t steals          = 0;  ///< drains of roots homed on another merge thread
+      uint64_t partitions      = 0;  ///< partitions of split drains run by a helper thread
+      uint64_t publishes       = 0;  ///< chunks committed before the end of their drain
+
+      latency_histogram queue_wait;  ///< time from signal to the start of the drain
+      /// Drain latency of each root that has merged, by root index
+      std::vector<std::pair<uint32_t, latency_histogram>> root_latency;
+      /// Pacing of each root that has swapped, with dwal_config::adaptive_swap
+      std::vector<std::pair<uint32_t, flow_stats>> root_flow;
+
+      std::string to_string() const;
+   };
+
+   inline std::string latency_histogram::to_string() const
+   {
+      char buf[160];
+      snprintf(buf, sizeof(buf), "n=%llu mean=%.0fus p50<=%lluus p99<=%lluus max=%lluus",
+               (unsigned long long)count, mean_us(), (unsigned long long)percentile_us(0.5),
+               (unsigned long long)percentile_us(0.99), (unsigned long long)max_us);
+      return buf;
+   }
+
+   inline std::string flow_stats::to_string() const
+   {
+      char buf[160];
+      snprintf(buf, sizeof(buf),
+               "ingest=%.0f/s merge=%.0f/s scale=%.2f delayed=%llu delay=%.1fms",
+               ingest_rate, merge_rate, swap_scale, (unsigned long long)delayed_commits,
+               delay_us / 1000.0);
+      return buf;
+   }
+
+   inline std::string merge_stats::to_string() const
+   {
+      char buf[192];
+      snprintf(buf, sizeof(buf),
+               "queue_depth=%u merges=%llu priority=%llu steals=%llu partitions=%llu "
+               "publishes=%llu\n",
+               queue_depth, (unsigned long long)merges, (unsigned long long)priority_merges,
+               (unsigned long long)steals, (unsigned long long)partitions,
+               (unsigned long long)publishes);
+      std::string s = buf;
+      s += "  queue wait: " + queue_wait.to_string() + "\n";
+      for (auto& [root, h] : root_latency)
+         s += "  root " + std::to_string(root) + " merge: " + h.to_string() + "\n";
+      for (auto& [root, f] : root_flow)
+         s += "  root " + std::to_string(root) + " flow: " + f.to_string() + "\n";
+      return s;
+   }
+
+}  // namespace psitri::dwal
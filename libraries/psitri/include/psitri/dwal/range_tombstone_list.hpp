@@ -38,17 +38,20 @@ namespace psitri::dwal
       }
 
       /// O(log R) — binary search for range containing key.
-      bool is_deleted(std::string_view key) const noexcept
+      bool is_deleted(std::string_view key) const noexcept { return find(key) != nullptr; }
+
+      /// O(log R) — the range containing key, or nullptr.
+      const range* find(std::string_view key) const noexcept
       {
          if (_ranges.empty())
-            return false;
+            return nullptr;
          auto it = std::upper_bound(
              _ranges.begin(), _ranges.end(), key,
              [](std::string_view k, const range& r) { return k < r.low; });
          if (it == _ranges.begin())
-            return false;
+            return nullptr;
          --it;
-         return it->contains(key);
+         return it->contains(key) ? &*it : nullptr;
       }
 
       /// Add a range deletion [low, high). Merges with adjacent/overlapping ranges.
@@ -0,0 +1,119 @@
+#pragma once
+#include <psitri/dwal/wal_format.hpp>
+#include <sal/config.hpp>
+
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <vector>
+
+namespace psitri::dwal
+{
+   /// Segmented WAL stream shared by every root (dwal_config::shared_log).
+   ///
+   /// Each root's wal_writer still builds its own entries, but commits them
+   /// here instead of to a per-root file; the entries carry their root index
+   /// so recovery can demultiplex the stream.  Appends only copy into a
+   /// memory buffer.  flush_to() is a group commit: the first caller becomes
+   /// the leader, writes everything appended so far with one pwrite and one
+   /// fdatasync, and wakes the committers whose entries that covered, while
+   /// entries appended meanwhile wait for the next leader.  A transaction
+   /// touching N roots therefore costs one sync instead of N.
+   ///
+   /// Segments live in dir as seg-<number>.dwal.  A new one is started once
+   /// the active segment reaches segment_bytes.  A sealed segment is deleted
+   /// once every root whose entries it may hold has merged them into PsiTri,
+   /// tracked per root as the oldest segment its RW and RO btrees depend on.
+   ///
+   /// Thread safety: all methods may be called concurrently.
+   class shared_wal
+   {
+     public:
+      /// Start a new segment after any already in dir.  Existing segments
+      /// are left for recovery; they are retained until retire() finds no
+      /// root pinned to them.
+      shared_wal(std::filesystem::path dir, uint64_t segment_bytes, uint32_t max_roots);
+
+      ~shared_wal();
+
+      shared_wal(const shared_wal&)            = delete;
+      shared_wal& operator=(const shared_wal&) = delete;
+
+      /// Append one finalized entry (header, ops and hash) for root_index.
+      /// Returns the log position just past it, for flush_to().
+      uint64_t append(uint16_t root_index, const char* data, size_t len);
+
+      /// Make the log durable at least up to log position pos:
+      ///   fsync → fdatasync
+      ///   full  → fsync (F_FULLFSYNC on macOS)
+      ///   anything less → written to the OS, no sync
+      void flush_to(uint64_t pos, sal::sync_type sync);
+
+      /// flush_to() everything appended so far.
+      void flush(sal::sync_type sync);
+
+      /// The root's RW btree became its RO btree: its logged entries are
+      /// now needed until release_ro().
+      void swap_root(uint16_t root_index);
+
+      /// The root's RO btree has been merged into PsiTri; segments only it
+      /// still needed are deleted.
+      void release_ro(uint16_t root_index);
+
+      /// Recovery replayed entries of root_index from segment into its RW
+      /// btree; keep that segment until the root merges them.
+      void pin_recovered(uint16_t root_index, uint64_t segment);
+
+      /// Delete sealed segments that no root depends on.
+      void retire();
+
+      /// Write everything appended, mark the active segment cleanly closed
+      /// and sync it.  Only valid once every root's data is in PsiTri.
+      void close();
+
+      /// Number of the segment new entries are appended to.
+      uint64_t active_segment() const;
+
+      /// Number of syncs issued so far (group commits at fsync or above).
+      uint64_t sync_count() const;
+
+      /// Segment numbers present in dir, ascending.
+      static std::vector<uint64_t> list_segments(const std::filesystem::path& dir);
+
+      static std::filesystem::path segment_path(const std::filesystem::path& dir,
+                                                uint64_t                     segment);
+
+     private:
+      static constexpr uint64_t no_segment = ~uint64_t(0);
+
+      void open_segment(uint64_t segment);
+      void write_out(const std::vector<char>& buf);
+      void sync_fd(int level);
+      void retire_locked(std::vector<uint64_t>& doomed);
+      void remove_segments(const std::vector<uint64_t>& doomed);
+
+      std::filesystem::path _dir;
+      uint64_t              _segment_bytes;
+
+      mutable std::mutex      _mutex;
+      std::condition_variable _io_done;
+
+      // ── Guarded by _mutex ─────────────────────────────────────────
+      std::vector<char> _buf;                 ///< appended, not yet written
+      uint64_t          _appended       = 0;  ///< log position past the last append
+      uint64_t          _durable[3]     = {}; ///< positions written / fdatasync'd / fsync'd
+      bool              _io_active      = false;
+      uint64_t          _active_segment = 0;
+      uint64_t          _oldest_segment = 0;
+      uint64_t          _syncs          = 0;
+      std::vector<uint64_t> _rw_first;  ///< per root: oldest segment its RW btree needs
+      std::vector<uint64_t> _ro_first;  ///< per root: oldest segment its RO btree needs
+
+      // ── Owned by the I/O leader (or close) ────────────────────────
+      std::vector<char> _io_buf;
+      int               _fd          = -1;
+      uint64_t          _segment_pos = 0;
+   };
+
+}  // namespace psitri::dwal
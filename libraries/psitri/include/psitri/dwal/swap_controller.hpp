@@ -0,0 +1,85 @@
+#pragma once
+#include <psitri/dwal/merge_stats.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace psitri::dwal
+{
+   /// Feedback controller pacing one root's swaps against its merges
+   /// (dwal_config::adaptive_swap).
+   ///
+   /// It measures how fast the RW btree fills (ingest) and how fast the
+   /// merge pool drains the RO btree (merge), both in entries per second,
+   /// and drives two outputs:
+   ///
+   /// - scale(), a multiplier on max_rw_entries and max_wal_bytes.  When a
+   ///   merge takes under a quarter of the time its btree took to fill, the
+   ///   pool is mostly idle and swaps only cut batches short, so the
+   ///   thresholds grow (up to max_scale).  When it takes more than half
+   ///   of it, they shrink back toward the configured values.
+   ///
+   /// - commit_delay(), a per-commit sleep once a merge is running and the
+   ///   RW arena is past the soft limit.  It is sized so the arena reaches
+   ///   max_rw_arena_bytes no sooner than the merge is predicted to finish,
+   ///   and ramps in with the arena's fill between the two limits instead
+   ///   of blocking writers outright at the hard one.
+   ///
+   /// record_swap() and commit_delay() run on the root's writer,
+   /// record_merge() on a merge thread.
+   class swap_controller
+   {
+     public:
+      using clock = std::chrono::steady_clock;
+
+      struct options
+      {
+         bool                     enabled     = false;
+         double                   max_scale   = 8;
+         uint64_t                 arena_limit = 0;    ///< max_rw_arena_bytes
+         double                   soft_arena  = 0.5;  ///< fraction of arena_limit
+         std::chrono::nanoseconds max_delay{std::chrono::milliseconds(2)};
+      };
+
+      void configure(const options& opts) noexcept;
+
+      bool enabled() const noexcept { return _opts.enabled; }
+
+      /// Multiplier on the configured swap thresholds; 1 when disabled.
+      double scale() const noexcept { return _scale.load(std::memory_order_relaxed); }
+
+      /// The RW btree, holding entries, was just swapped to RO.
+      void record_swap(uint64_t entries, clock::time_point now) noexcept;
+
+      /// A merge drained entries in wall.
+      void record_merge(uint64_t entries, clock::duration wall) noexcept;
+
+      /// Count a commit and return how long its writer should pause, given
+      /// the RW arena's capacity and whether a merge is still running.
+      std::chrono::nanoseconds commit_delay(uint64_t          arena_bytes,
+                                            bool              merging,
+                                            clock::time_point now) noexcept;
+
+      flow_stats stats() const noexcept;
+
+     private:
+      static void blend(std::atomic<double>& avg, double sample) noexcept;
+
+      options _opts;
+
+      std::atomic<double>   _scale{1};
+      std::atomic<double>   _ingest_rate{0};
+      std::atomic<double>   _merge_rate{0};
+      std::atomic<int64_t>  _fill_ns{0};  // fill time of the RW btree last swapped
+      std::atomic<uint64_t> _delayed_commits{0};
+      std::atomic<uint64_t> _delay_ns{0};
+
+      // Writer-only: the RW btree being filled now.
+      clock::time_point _swap_time = clock::now();
+      uint64_t          _ro_entries = 0;
+      uint64_t          _commits    = 0;
+      clock::duration   _delayed{};
+   };
+
+}  // namespace psitri::dwal
@@ -5,8 +5,10 @@
 
 #include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <set>
 #include <stdexcept>
+#include <thread>
 
 namespace psitri::dwal
 {
@@ -220,6 +222,17 @@ namespace psitri::dwal
 
          for (auto idx : _write_roots)
             _txns.at(idx).commit_multi(tx_id, part_count, idx == last);
+
+         // One sync per root's WAL file, all in flight at once with an I/O
+         // engine; with a shared log the first call group-commits every
+         // participant's entry and the rest return.
+         if (auto sync = _db->config().commit_sync; sync != sal::sync_type::none)
+         {
+            for (auto idx : _write_roots)
+               _db->root(idx).wal->begin_flush(sync);
+            for (auto idx : _write_roots)
+               _db->root(idx).wal->wait_flush(sync);
+         }
       }
 
       for (auto& [idx, dtx] : _txns)
@@ -228,14 +241,23 @@ namespace psitri::dwal
             dtx.commit();
       }
 
+      // Single-root commits pace themselves in dwal_transaction::commit();
+      // here the writer pauses for the slowest root, once its locks are
+      // released.
+      std::chrono::nanoseconds delay{};
       for (auto idx : _write_roots)
       {
          auto& dr = _db->root(idx);
          if (dr.merge_complete.load(std::memory_order_acquire) && _db->should_swap(idx))
             _db->try_swap_rw_to_ro(idx);
+         if (_write_roots.size() > 1)
+            delay = std::max(delay, _db->commit_delay(idx));
       }
 
       release_locks();
+
+      if (delay.count() > 0)
+         std::this_thread::sleep_for(delay);
    }
 
    // ── abort ────────────────────────────────────────────────────────
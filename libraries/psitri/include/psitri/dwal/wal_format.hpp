@@ -16,7 +16,7 @@ namespace psitri::dwal
       uint64_t sequence_base     = 0;  // first sequence number in this file
       uint64_t created_timestamp = 0;  // nanoseconds since epoch (debug only)
       uint16_t root_index        = 0;  // which root this WAL belongs to
-      uint16_t flags             = 0;  // bit 0 = clean close
+      uint16_t flags             = 0;  // bit 0 = clean close, bit 1 = shared log
       char     reserved[36]      = {}; // zero-filled
    };
    static_assert(sizeof(wal_header) == 64);
@@ -39,13 +39,24 @@ namespace psitri::dwal
    ///   [23..25) uint16  multi_participant_count — 0 for single-root entries
    ///   [25..N-8)        operations[]
    ///   [N-8..N) uint64  xxh3_64    — covers bytes [0, N-8)
-   static constexpr size_t wal_entry_header_size_v1 = 14;
-   static constexpr size_t wal_entry_header_size    = 25;
-   static constexpr size_t wal_entry_hash_size      = 8;
+   ///
+   /// Entries in a shared-log segment (wal_flag_shared_log) carry the
+   /// owning root after the multi-tx fields:
+   ///   [25..27) uint16  root_index
+   static constexpr size_t wal_entry_header_size_v1     = 14;
+   static constexpr size_t wal_entry_header_size        = 25;
+   static constexpr size_t wal_entry_header_size_shared = 27;
+   static constexpr size_t wal_entry_hash_size          = 8;
 
    /// Flag bit for clean close in wal_header::flags.
    static constexpr uint16_t wal_flag_clean_close = 0x0001;
 
+   /// Flag bit in wal_header::flags marking a segment of the shared log
+   /// that all roots append to.  Its header's root_index is
+   /// wal_shared_root_index and sequence_base holds the segment number.
+   static constexpr uint16_t wal_flag_shared_log   = 0x0002;
+   static constexpr uint16_t wal_shared_root_index = 0xFFFF;
+
    /// Entry-level flags (in wal entry header, not file header).
    static constexpr uint8_t wal_entry_flag_multi_tx_commit = 0x01;
 
@@ -0,0 +1,147 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace psitri::dwal
+{
+   /// How a per-root wal_writer hands its buffer to the kernel
+   /// (dwal_config::wal_io).
+   enum class wal_io_mode : uint8_t
+   {
+      sync,         ///< pwrite / fdatasync on the committing thread
+      thread_pool,  ///< writes and syncs run on a small pool of I/O threads
+      io_uring,     ///< linked write + fdatasync submitted through io_uring;
+                    ///< thread_pool where the kernel offers no usable ring
+   };
+
+   /// Growable byte buffer on 4 KiB-aligned storage.  wal_writer encodes
+   /// entries straight into it, and the same memory is what gets written.
+   class wal_buffer
+   {
+     public:
+      static constexpr size_t alignment = 4096;
+
+      wal_buffer() = default;
+      ~wal_buffer();
+      wal_buffer(wal_buffer&& other) noexcept;
+      wal_buffer& operator=(wal_buffer&& other) noexcept;
+      wal_buffer(const wal_buffer&)            = delete;
+      wal_buffer& operator=(const wal_buffer&) = delete;
+
+      char*       data() noexcept { return _data; }
+      const char* data() const noexcept { return _data; }
+      size_t      size() const noexcept { return _size; }
+      bool        empty() const noexcept { return _size == 0; }
+
+      /// Extend by n bytes; returns where they start.  Invalidates
+      /// pointers into the buffer.
+      char* grow(size_t n)
+      {
+         if (_size + n > _capacity)
+            reserve(_size + n);
+         char* p = _data + _size;
+         _size  += n;
+         return p;
+      }
+
+      void append(const void* p, size_t n);
+
+      /// Shrink to n bytes (n <= size()).
+      void truncate(size_t n) noexcept { _size = n; }
+      void clear() noexcept { _size = 0; }
+
+      /// Drop the first n bytes, moving the rest to the front.
+      void consume(size_t n) noexcept;
+
+      void swap(wal_buffer& other) noexcept;
+
+     private:
+      void reserve(size_t n);
+
+      char*  _data     = nullptr;
+      size_t _size     = 0;
+      size_t _capacity = 0;
+   };
+
+   /// One write (optionally followed by fdatasync) on a wal_io_engine.
+   /// Each writer owns one and keeps at most one operation in flight.
+   class wal_io_request
+   {
+     public:
+      /// Whether an operation is in flight.
+      bool busy() const noexcept { return _busy.load(std::memory_order_acquire); }
+
+      /// Block until the operation completes.  Throws std::runtime_error
+      /// if it failed; returns immediately when idle.
+      void wait();
+
+     private:
+      friend class wal_io_engine;
+
+      std::atomic<bool> _busy{false};
+      int               _error = 0;
+
+      // The operation, for engines that finish it in pieces.
+      int         _fd     = -1;
+      const char* _data   = nullptr;
+      size_t      _len    = 0;
+      uint64_t    _offset = 0;
+      bool        _sync   = false;
+   };
+
+   /// Asynchronous WAL write path shared by every root of a dwal_database.
+   ///
+   /// Writers double-buffer: they keep encoding into one wal_buffer while
+   /// the engine writes the other, so a commit only waits for I/O when it
+   /// asks for durability or fills a buffer before the last one finished.
+   class wal_io_engine
+   {
+     public:
+      virtual ~wal_io_engine() = default;
+
+      /// Write len bytes of data to fd at offset, then fdatasync if sync
+      /// (len may be 0 for a sync alone).  req must be idle; it and data
+      /// stay in use until req.wait() returns.
+      virtual void submit(wal_io_request& req,
+                          int             fd,
+                          const char*     data,
+                          size_t          len,
+                          uint64_t        offset,
+                          bool            sync) = 0;
+
+      /// The mode actually running, after any fallback.
+      virtual wal_io_mode mode() const noexcept = 0;
+
+      /// Engine for mode, or nullptr for wal_io_mode::sync.  io_uring falls
+      /// back to a thread pool of io_threads when no ring can be set up.
+      static std::unique_ptr<wal_io_engine> create(wal_io_mode mode, uint32_t io_threads);
+
+     protected:
+      /// Record the operation in req and mark it busy.
+      static void start(wal_io_request& req,
+                        int             fd,
+                        const char*     data,
+                        size_t          len,
+                        uint64_t        offset,
+                        bool            sync) noexcept;
+
+      /// Note a failure of part of req's operation without completing it.
+      static void record_error(wal_io_request& req, int error) noexcept;
+
+      /// Mark req done.  error (an errno value, 0 on success) is reported
+      /// unless record_error() already noted one.
+      static void finish(wal_io_request& req, int error) noexcept;
+
+      static size_t length(const wal_io_request& req) noexcept { return req._len; }
+
+      /// Complete req's operation synchronously from byte done of the write
+      /// on; returns an errno value, 0 on success.
+      static int run(const wal_io_request& req, size_t done = 0) noexcept;
+   };
+
+   /// pwrite() all of data at offset; returns an errno value, 0 on success.
+   int write_fully(int fd, const char* data, size_t len, uint64_t offset) noexcept;
+
+}  // namespace psitri::dwal
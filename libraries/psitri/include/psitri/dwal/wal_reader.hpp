@@ -26,6 +26,10 @@ namespace psitri::dwal
       uint64_t                     sequence = 0;
       std::vector<wal_operation>   ops;
 
+      /// Root the entry belongs to: the file header's root_index, or the
+      /// entry's own in a shared-log segment.
+      uint16_t root_index = 0;
+
       /// Multi-root transaction fields (0 for single-root entries).
       uint8_t  entry_flags             = 0;
       uint64_t multi_tx_id             = 0;
@@ -41,14 +45,30 @@ namespace psitri::dwal
    /// Read-only WAL file reader for crash recovery.
    ///
    /// Reads the file sequentially, validates each entry's hash, and yields
-   /// decoded entries. Stops at the first invalid entry (torn write).
+   /// decoded entries. Stops at the first invalid entry (torn write), at
+   /// the zeroed tail of a preallocated file, and — in a per-root file — at
+   /// the first entry whose sequence doesn't advance, which is a leftover
+   /// from the file's previous life before it was recycled.
+   ///
+   /// The file is mapped read-only with sequential readahead, so decoded
+   /// keys and values point straight into the page cache; it falls back to
+   /// pread where mmap fails.  Either way, an entry's views stay valid
+   /// only until the next call to next().
    class wal_reader
    {
      public:
+      wal_reader() = default;
+      ~wal_reader();
+      wal_reader(const wal_reader&)            = delete;
+      wal_reader& operator=(const wal_reader&) = delete;
+
       /// Open a WAL file for reading. Returns false if file doesn't exist
       /// or has an invalid header.
       bool open(const std::filesystem::path& path);
 
+      /// Release the file; open() may be called again afterwards.
+      void close() noexcept;
+
       /// Read the file header. Must be called after open().
       const wal_header& header() const noexcept { return _header; }
 
@@ -73,23 +93,40 @@ namespace psitri::dwal
       /// The sequence number one past the last valid entry read.
       uint64_t end_sequence() const noexcept { return _end_seq; }
 
+      /// File offset just past the last valid entry read.
+      uint64_t end_offset() const noexcept { return _end_offset; }
+
+      /// Skip hash checks for entries that end at or before offset, which
+      /// another reader of the same file has already verified.  Used by
+      /// wal_replay to keep XXH3 off the apply threads.
+      void trust_through(uint64_t offset) noexcept { _trusted_end = offset; }
+
       /// Whether the file was cleanly closed.
       bool was_clean_close() const noexcept
       {
          return (_header.flags & wal_flag_clean_close) != 0;
       }
 
+      /// Whether the file is a shared-log segment holding entries of many roots.
+      bool is_shared_log() const noexcept
+      {
+         return (_header.flags & wal_flag_shared_log) != 0;
+      }
+
      private:
-      bool read_bytes(void* dst, size_t len);
-      bool read_entry_raw(std::vector<char>& buf);
-      bool decode_entry(const std::vector<char>& buf, wal_entry& entry);
-
-      int                   _fd       = -1;
-      uint64_t              _file_size = 0;
-      uint64_t              _read_pos  = 0;
-      uint64_t              _end_seq   = 0;
-      wal_header            _header    = {};
-      std::vector<char>     _raw_buf;   // reusable buffer for raw entry bytes
+      bool        read_bytes(void* dst, size_t len);
+      const char* read_entry_raw(uint32_t& entry_size);
+      bool        decode_entry(const char* p, size_t size, wal_entry& entry);
+
+      int               _fd          = -1;
+      const char*       _map         = nullptr;  // whole file, or null for pread
+      uint64_t          _file_size   = 0;
+      uint64_t          _read_pos    = 0;
+      uint64_t          _end_seq     = 0;
+      uint64_t          _end_offset  = 0;
+      uint64_t          _trusted_end = 0;
+      wal_header        _header      = {};
+      std::vector<char> _raw_buf;  // entry bytes on the pread path
    };
 
 }  // namespace psitri::dwal
@@ -0,0 +1,130 @@
+#pragma once
+#include <psitri/dwal/wal_reader.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+
+namespace psitri::dwal
+{
+   struct wal_replay_options
+   {
+      /// Files replayed at once.  Each gets a scan thread and an apply
+      /// thread while in progress.
+      uint32_t threads = 4;
+
+      /// Deliver nothing from files that were closed cleanly.
+      bool skip_clean_close = false;
+
+      /// Deliver a multi-root transaction's entries only if every
+      /// participant logged its entry and the commit marker was seen,
+      /// across all files of the run.
+      bool filter_multi_tx = false;
+   };
+
+   /// Decides, across all files of a replay, which multi-root transactions
+   /// are complete.  Scan threads record entries as they verify them; an
+   /// apply thread asking about a transaction waits until it completes or
+   /// every scan has finished without completing it.
+   class multi_tx_coordinator
+   {
+     public:
+      explicit multi_tx_coordinator(size_t scans) : _scans_left(scans) {}
+
+      void record(const wal_entry& entry);
+      void scan_finished();
+
+      /// Whether the transaction is to be applied; may block.
+      bool committed(uint64_t multi_tx_id);
+
+     private:
+      struct tx_info
+      {
+         uint16_t participant_count = 0;
+         uint16_t entries_found     = 0;
+         bool     commit_seen       = false;
+
+         bool complete() const noexcept
+         {
+            return commit_seen && entries_found == participant_count;
+         }
+      };
+
+      std::mutex                            _mutex;
+      std::condition_variable               _cv;
+      std::unordered_map<uint64_t, tx_info> _txs;
+      size_t                                _scans_left;
+   };
+
+   /// How far the scan of one file has verified it.
+   class wal_scan_progress
+   {
+     public:
+      static constexpr uint64_t done_bit = uint64_t(1) << 63;
+
+      void publish(uint64_t verified_end) noexcept;
+      void finish(uint64_t verified_end) noexcept;
+
+      /// Block until entries past offset are verified or the scan has
+      /// finished; returns the verified end.
+      uint64_t wait_past(uint64_t offset) const noexcept;
+
+     private:
+      std::atomic<uint64_t> _state{0};  // verified end | done_bit
+   };
+
+   /// The verified, filtered entries of one WAL file, in log order.
+   class wal_replay_source
+   {
+     public:
+      wal_replay_source(wal_reader&              reader,
+                        const wal_scan_progress& progress,
+                        multi_tx_coordinator*    coordinator)
+          : _reader(reader), _progress(progress), _coordinator(coordinator)
+      {
+      }
+
+      /// The next entry to apply; false once the file's valid entries are
+      /// exhausted.  Views in entry stay valid until the next call.
+      bool next(wal_entry& entry);
+
+      const wal_header& header() const noexcept { return _reader.header(); }
+
+      /// The sequence number one past the last entry read, applied or not.
+      uint64_t end_sequence() const noexcept { return _reader.end_sequence(); }
+
+     private:
+      wal_reader&              _reader;
+      const wal_scan_progress& _progress;
+      multi_tx_coordinator*    _coordinator;
+   };
+
+   /// Parallel, pipelined replay of per-root WAL files for
+   /// dwal_database::recover().
+   ///
+   /// Files are taken in order by two bounded sets of threads.  A scan
+   /// thread maps a file, verifies every entry's hash and records
+   /// multi-root transactions with the coordinator; the apply thread for
+   /// the same file follows behind it, decoding only entries the scan has
+   /// already verified.  Apply threads only ever wait on scans, and scans
+   /// never wait, so a transaction spanning files is resolved no matter
+   /// how the files are spread over the threads.
+   class wal_replay
+   {
+     public:
+      /// Called once per file with entries to deliver, on an apply thread;
+      /// different files run concurrently.
+      using apply_fn = std::function<void(size_t file_index, wal_replay_source& source)>;
+
+      /// Replay files; rethrows the first exception thrown by apply.
+      static void run(std::span<const std::filesystem::path> files,
+                      const wal_replay_options&              options,
+                      const apply_fn&                        apply);
+   };
+
+}  // namespace psitri::dwal
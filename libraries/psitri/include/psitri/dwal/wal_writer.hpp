@@ -1,21 +1,54 @@
 #pragma once
 #include <psitri/dwal/wal_format.hpp>
+#include <psitri/dwal/wal_io.hpp>
 #include <sal/config.hpp>
 #include <sal/numbers.hpp>
 
 #include <cstdint>
 #include <filesystem>
+#include <memory>
 #include <string_view>
-#include <vector>
 
 namespace psitri::dwal
 {
+   class shared_wal;
+
+   /// How a file-backed wal_writer lays out and writes its file.
+   struct wal_writer_options
+   {
+      /// fallocate a new file to this size, so appends don't change its
+      /// size and fdatasync has no inode to flush.  0 grows on append.
+      uint64_t preallocate_bytes = 0;
+
+      /// A retired WAL file to reuse: it is given a fresh header, synced,
+      /// then renamed to the writer's path.  Its blocks are already
+      /// allocated and written, so overwriting them changes no metadata.
+      /// Old entries past the new ones are ignored by wal_reader because
+      /// their sequence numbers precede the new header's sequence_base.
+      std::filesystem::path recycle_from;
+
+      /// Asynchronous write path; nullptr writes with pwrite on the caller.
+      wal_io_engine* io = nullptr;
+
+      /// Committed entries are handed to the OS (or io) once this many
+      /// bytes are buffered, and on flush().
+      uint32_t buffer_bytes = 256 * 1024;
+   };
+
    /// Buffered, append-only WAL writer.
    ///
-   /// Accumulates operations for the current transaction into an in-memory
-   /// buffer, then writes a complete entry (with trailing xxh3_64 hash) on
-   /// commit. No fsync per transaction — the caller invokes flush() when
-   /// durability is needed (periodic app-level flush).
+   /// Encodes each operation directly into an aligned write buffer and, on
+   /// commit, patches the entry header and appends the xxh3_64 hash in
+   /// place; the buffer is written as is.  No sync per transaction — the
+   /// caller invokes flush() when durability is needed (periodic app-level
+   /// flush, or dwal_config::commit_sync).
+   ///
+   /// With a wal_io_engine the writer double-buffers: a full buffer is
+   /// submitted and encoding continues in the other one.
+   ///
+   /// With dwal_config::shared_log, the writer owns no file: committed
+   /// entries, tagged with the root index, go to the shared_wal stream and
+   /// flush() waits for that stream's group commit.
    ///
    /// Thread safety: NOT thread-safe. The caller holds the per-root exclusive
    /// lock during transaction commit, so only one thread writes at a time.
@@ -27,7 +60,11 @@ namespace psitri::dwal
       /// valid entry. Otherwise creates a fresh file.
       explicit wal_writer(const std::filesystem::path& path,
                           uint16_t                     root_index,
-                          uint64_t                     sequence_base = 0);
+                          uint64_t                     sequence_base = 0,
+                          const wal_writer_options&    options       = {});
+
+      /// Commit this root's entries to a shared log instead of a file.
+      wal_writer(shared_wal& log, uint16_t root_index, uint64_t sequence_base = 0);
 
       ~wal_writer();
 
@@ -67,15 +104,25 @@ namespace psitri::dwal
       void flush();
 
       /// Flush with explicit sync level:
-      ///   fsync → regular fsync (data to drive controller)
-      ///   full  → F_FULLFSYNC on macOS (data to physical media)
+      ///   fsync → fdatasync (data to drive controller)
+      ///   full  → fsync, F_FULLFSYNC on macOS (data to physical media)
       ///   anything less → just flush the write buffer (no sync)
       void flush(sal::sync_type sync);
 
-      /// Mark the file as cleanly closed and flush.
+      /// flush(sync) in two halves: begin_flush() submits the write and
+      /// fdatasync to the I/O engine, wait_flush() waits for them.  Lets a
+      /// multi-root commit sync all its files at once.  Without an engine
+      /// begin_flush() does all the work.
+      void begin_flush(sal::sync_type sync);
+      void wait_flush(sal::sync_type sync);
+
+      /// Mark the file as cleanly closed and flush.  A shared-log writer
+      /// only detaches; the log is closed by its owner.
       void close();
 
-      /// Current write position (file size).
+      /// Current write position (bytes handed to the OS, which is less
+      /// than the size of a preallocated file); for a shared-log writer,
+      /// the bytes this root has committed to the log.
       uint64_t file_size() const noexcept { return _file_pos; }
 
       /// Next sequence number that will be assigned.
@@ -94,20 +141,32 @@ namespace psitri::dwal
       void write_u32(uint32_t v);
       void write_u64(uint64_t v);
       void write_string(std::string_view sv);
-      void flush_write_buffer();
+
+      /// Hand the committed entries to the OS or the engine, keeping an
+      /// entry still being built; sync adds an fdatasync.
+      void write_buffer(bool sync);
+      void wait_io();
 
       int                    _fd        = -1;
-      uint64_t               _file_pos  = 0;
+      uint64_t               _file_pos  = 0;  ///< where _write_buf goes in the file
       uint64_t               _next_seq  = 0;
       uint16_t               _op_count  = 0;
       bool                   _entry_active = false;
       std::filesystem::path  _path;
 
-      /// Per-entry buffer: accumulates a single transaction's operations.
-      std::vector<char>      _entry_buf;
+      shared_wal*            _log        = nullptr;
+      uint16_t               _root_index = 0;
+      uint64_t               _log_pos    = 0;  ///< log position past our last entry
+
+      /// Committed entries not yet written, followed by the entry being
+      /// built, which starts at _entry_start.
+      wal_buffer             _write_buf;
+      size_t                 _entry_start  = 0;
+      uint32_t               _buffer_bytes = 256 * 1024;
 
-      /// File write buffer: accumulates completed entries before OS write.
-      std::vector<char>      _write_buf;
+      wal_io_engine*                  _io = nullptr;
+      wal_buffer                      _io_buf;  ///< in flight on _io
+      std::unique_ptr<wal_io_request> _io_req;
    };
 
 }  // namespace psitri::dwal
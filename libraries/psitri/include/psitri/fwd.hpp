@@ -6,6 +6,7 @@ namespace psitri
    template <class LockPolicy> class basic_database;
    template <class LockPolicy> class basic_read_session;
    template <class LockPolicy> class basic_write_session;
+   struct batch_op;
    class tree;
    class transaction;
    class value_pin;
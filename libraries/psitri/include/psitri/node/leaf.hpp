@@ -1,4 +1,5 @@
 #pragma once
+#include <bit>
 #include <hash/xxhash.h>
 #include <psitri/node/node.hpp>
 #include <psitri/util.hpp>
@@ -73,8 +74,17 @@ namespace psitri
    *   2 valueoffset
    *   2 value size+checksum... 9 bytes per key (if inline), 7.25 bytes per key for nodes
    *
-   * On COW expand to 4096 bytes to maximize alloc space without having to copy it
+   * Allocated in power-of-two size classes (min_leaf_size..max_leaf_size)
+   * picked from the bytes the node will hold; an insert or update that
+   * overflows the class rebuilds the node into the class that fits, and
+   * every rebuild (COW, split, remove) drops to the class of what is left.
    * On compact... node gets optimized to smallest size...
+   *
+   * The header fills the first cacheline, so the metadata arrays start at
+   * byte 64 and the alloc area ends on the node's last cacheline; copies
+   * move whole lines of each.  The per-branch arrays have capacity() slots,
+   * which rebuilds set to num_branches() and in-place inserts grow a few
+   * slots at a time, so an insert shifts each array's tail on its own.
    */
    class leaf_node : public node
    {
@@ -98,51 +108,88 @@ namespace psitri
          friend class leaf_node;
       };
 
+      static constexpr uint32_t  min_leaf_size = 128;
       static constexpr uint32_t  max_leaf_size = 4096 / 2;
       static constexpr node_type type_id       = node_type::leaf;
-      inline static uint32_t     alloc_size(key_view key, const value_type& value) noexcept;
+
+      /// the smallest size class (a power of two from min_leaf_size to
+      /// max_leaf_size) that holds @p bytes; max_leaf_size if none does
+      static constexpr uint32_t size_class(uint32_t bytes) noexcept
+      {
+         if (bytes <= min_leaf_size)
+            return min_leaf_size;
+         if (bytes >= max_leaf_size)
+            return max_leaf_size;
+         return std::bit_ceil(bytes);
+      }
+      /// bytes an inserted key and value add to a node without versions:
+      /// key hash, key offset, value branch, key, and inline data or a new cline
+      static uint32_t insert_size(key_view k, const value_type& value) noexcept
+      {
+         uint32_t size = sizeof(uint8_t) + sizeof(key_offset) + sizeof(value_branch) +
+                         sizeof(leaf_node::key) + k.size();
+         if (value.is_view())
+            size += sizeof(value_data) + value.view().size();
+         else if (value.is_address())
+            size += sizeof(ptr_address);
+         return size;
+      }
+
+      inline static uint32_t alloc_size(key_view key, const value_type& value) noexcept;
       /// clone and optimize
       inline static uint32_t alloc_size(const leaf_node* clone) noexcept;
-      inline static uint32_t alloc_size(const leaf_node* clone,
-                                        const op::leaf_value_rewrite*) noexcept
+      inline static uint32_t alloc_size(const leaf_node*              clone,
+                                        const op::leaf_value_rewrite* rewrite) noexcept
       {
-         return max_leaf_size;
+         return size_class(clone->rebuilt_size(key_view(), branch_zero,
+                                               branch_number(clone->num_branches()), rewrite));
       }
-      inline static uint32_t alloc_size(const leaf_node* clone,
-                                        key_view         cprefix,
-                                        branch_number    start,
-                                        branch_number    end,
-                                        const op::leaf_value_rewrite* = nullptr)
+      inline static uint32_t alloc_size(const leaf_node*              clone,
+                                        key_view                      cprefix,
+                                        branch_number                 start,
+                                        branch_number                 end,
+                                        const op::leaf_value_rewrite* rewrite = nullptr)
       {
          assert(cprefix.size() <= 1024);
-         return max_leaf_size;
+         return size_class(clone->rebuilt_size(cprefix, start, end, rewrite));
       }
       inline static uint32_t alloc_size(const leaf_node* clone,
                                         branch_number    start,
                                         branch_number    end)
       {
-         return max_leaf_size;
+         return size_class(clone->rebuilt_size(key_view(), start, end, nullptr));
       }
       inline static uint32_t alloc_size(const leaf_node* src, const op::leaf_insert& ins)
       {
-         return max_leaf_size;
+         // Without versions or a rewrite the node is cloned as-is (dead space
+         // and all) and the entry inserted in place; see the constructor.
+         if (src->num_versions() || ins.created_at || ins.rewrite)
+            return size_class(src->rebuilt_size(ins));
+         return size_class(src->used_size() + insert_size(ins.key, ins.value));
+      }
+      inline static uint32_t alloc_size(const op::leaf_update& upd)
+      {
+         return size_class(upd.src.rebuilt_size(upd));
       }
-      inline static uint32_t alloc_size(const op::leaf_update& upd) { return max_leaf_size; }
       inline static uint32_t alloc_size(const op::leaf_remove& rm)
       {
          // Maintenance rewrites can move external values to new clines while
-         // removing a branch, so give the rebuild the normal edit workspace.
-         return rm.rewrite ? max_leaf_size : rm.src.size();
+         // removing a branch, so size the rebuild by what it will hold.
+         if (rm.src.num_versions() || rm.rewrite)
+            return size_class(rm.src.rebuilt_size(rm));
+         return size_class(rm.src.used_size());
       }
       inline static uint32_t alloc_size(const op::leaf_remove_range& rm)
       {
-         return rm.rewrite ? max_leaf_size : rm.src.size();
+         if (rm.src.num_versions() || rm.rewrite)
+            return size_class(rm.src.rebuilt_size(rm));
+         return size_class(rm.src.used_size());
       }
-      inline static uint32_t alloc_size(const op::leaf_prepend_prefix&) { return max_leaf_size; }
-      inline static uint32_t alloc_size(const struct op::leaf_from_visitor&)
+      inline static uint32_t alloc_size(const op::leaf_prepend_prefix& pp)
       {
-         return max_leaf_size;
+         return size_class(pp.src.rebuilt_size(pp));
       }
+      inline static uint32_t alloc_size(const struct op::leaf_from_visitor& vis);
 
       leaf_node(size_t alloc_size, ptr_address_seq seq, const op::leaf_update& upd);
       leaf_node(size_t alloc_size, ptr_address_seq seq, const op::leaf_remove& rm);
@@ -192,10 +239,21 @@ namespace psitri
       uint16_t           dead_space() const noexcept { return _dead_space; }
       uint32_t           clines_capacity() const noexcept { return _cline_cap; }
       bool               is_optimal_layout() const noexcept { return _optimal_layout; }
+      /// slots in each per-branch array, num_branches() or more
+      uint16_t           capacity() const noexcept { return _capacity; }
+
+      /// bytes from the start of the node through its metadata arrays plus the
+      /// alloc area, dead space included: what a clone_from() copy needs
+      uint32_t used_size() const noexcept
+      {
+         return uint32_t(meta_end() - (const char*)this) + _alloc_pos;
+      }
 
       uint32_t compact_size() const noexcept;
       void     compact_to(alloc_header* compact_dst) const noexcept;
-      uint32_t cow_size() const noexcept { return max_leaf_size; }  // TODO: make this config const
+      /// A COW copy keeps the size class; can_apply() only reports modify when
+      /// the edit fits in place, and growth beyond the class is a rebuild.
+      uint32_t cow_size() const noexcept { return size(); }
 
       /// Release value_node and subtree addresses held by this leaf.
       void destroy(const sal::allocator_session_ptr& session) const noexcept
@@ -293,6 +351,21 @@ namespace psitri
                              uint32_t max_size = max_leaf_size) const noexcept;
       //      can_apply_mode can_apply(const op::leaf_remove& ins) const noexcept;
 
+      /// Bytes a node rebuilt from the op holds: header, metadata arrays and
+      /// the keys and values without dead space.  rebuilt_overflow if the
+      /// rebuild would need more than 16 clines or 31 versions, or a key
+      /// longer than a leaf can store.
+      static constexpr uint32_t rebuilt_overflow = ~uint32_t(0);
+      uint32_t rebuilt_size(const op::leaf_insert& ins) const noexcept;
+      uint32_t rebuilt_size(const op::leaf_update& upd) const noexcept;
+      uint32_t rebuilt_size(const op::leaf_remove& rm) const noexcept;
+      uint32_t rebuilt_size(const op::leaf_remove_range& rm) const noexcept;
+      uint32_t rebuilt_size(const op::leaf_prepend_prefix& pp) const noexcept;
+      uint32_t rebuilt_size(key_view                      common_prefix,
+                            branch_number                 start,
+                            branch_number                 end,
+                            const op::leaf_value_rewrite* rewrite) const noexcept;
+
       /// determines whether there is enough space to insert the key
       /// @return the amount of free space after inserting the key,
       /// this will be negative if there is not enough space.
@@ -368,13 +441,13 @@ namespace psitri
       /// Add a version to the shared table if not already present.
       /// Returns the table index. Deduplicates: if version already exists, returns existing index.
       /// @pre _num_versions < 31 (or version already exists)
-      /// @pre caller must have ensured free_space() >= sizeof(version48) + num_branches()
+      /// @pre caller must have ensured free_space() >= sizeof(version48) + capacity()
       ///      (for first version, which allocates ver_indices + 1 version_table entry)
       uint8_t add_version(uint64_t version) noexcept
       {
          if (_num_versions == 0)
          {
-            // First version: allocate ver_indices (nb bytes) + first version_table entry.
+            // First version: allocate ver_indices (capacity bytes) + first version_table entry.
             // Caller must have verified free_space() is sufficient.
             init_ver_indices();
          }
@@ -389,41 +462,29 @@ namespace psitri
       }
 
       /// uses hash to find key
-      branch_number get(key_view key) const noexcept
-      {
-         //         SAL_INFO("get: key: {}", key);
-         uint8_t        khash     = calc_key_hash(key);
-         const uint8_t* khashes   = key_hashs().data();
-         uint32_t       reamining = num_branches();
-
-         /*
-         for (uint32_t i = 0; i < reamining; ++i)
-         {
-            SAL_INFO("get_key({}) : hash: {} found: {}", i, int(khashes[i]),
-                     get_key(branch_number(i)));
-         }
-*/
-
-         uint32_t total_idx = 0;
-         do
+      ///
+      /// Compares the hashes 32 at a time with no scalar tail: a leaf holds at
+      /// least 5 bytes of arrays per branch after its hashes and its size is a
+      /// multiple of 64, so a whole vector never reads past the node, and the
+      /// lanes past num_branches() are masked off.
+      PSITRI_NO_SANITIZE_ALIGNMENT branch_number get(key_view key) const noexcept
+      {
+         const uint8_t  khash = calc_key_hash(key);
+         const uint32_t nb    = num_branches();
+         for (uint32_t base = 0; base < nb; base += 32)
          {
-            auto idx = find_byte(khashes, reamining, khash);
-            //          SAL_INFO("get: idx: {} reamining: {}", idx, reamining);
-            if (idx == reamining)
+            uint32_t matches = match_byte_mask32(_key_hashs + base, khash);
+            if (nb - base < 32)
+               matches &= (uint32_t(1) << (nb - base)) - 1;
+            while (matches)
             {
-               ////            SAL_ERROR("not found");
-               return branch_number(num_branches());
+               uint32_t idx = base + std::countr_zero(matches);
+               if (get_key(branch_number(idx)) == key)
+                  return branch_number(idx);
+               matches &= matches - 1;
             }
-            total_idx += idx;
-            ////       SAL_INFO("rel idx: {} get_key({}) : found: {}", idx, total_idx,
-            //                get_key(branch_number(total_idx)));
-            if (get_key(branch_number(total_idx)) == key)
-               return branch_number(total_idx);
-            ++idx;
-            ++total_idx;
-            khashes += idx;
-            reamining -= idx;
-         } while (true);
+         }
+         return branch_number(nb);
       }
       /// uses binary search to find first key >= search key
       branch_number lower_bound(key_view key) const noexcept
@@ -476,7 +537,7 @@ namespace psitri
       std::span<const ptr_address> clines() const noexcept
       {
          return std::span<const ptr_address>(
-             reinterpret_cast<const ptr_address*>(value_offsets() + num_branches()), _cline_cap);
+             reinterpret_cast<const ptr_address*>(value_offsets() + _capacity), _cline_cap);
       }
 
       uint16_t num_branches() const noexcept { return _num_branches; }
@@ -484,7 +545,7 @@ namespace psitri
       std::span<ptr_address> clines() noexcept
       {
          return std::span<ptr_address>(
-             reinterpret_cast<ptr_address*>(value_offsets() + num_branches()), _cline_cap);
+             reinterpret_cast<ptr_address*>(value_offsets() + _capacity), _cline_cap);
       }
 
       uint8_t find_cline_index(ptr_address addr) const noexcept
@@ -496,6 +557,14 @@ namespace psitri
 
      private:
       void set_num_branches(uint16_t n) noexcept { _num_branches = n; }
+      /// size the per-branch arrays of a node being built for exactly n branches
+      void init_branches(uint16_t n) noexcept
+      {
+         _num_branches = n;
+         _capacity     = n;
+      }
+      /// move the arrays after the key hashes to give each capacity slots
+      void grow_capacity(uint16_t capacity) noexcept;
       void clone_from(const leaf_node* clone);
       void set_branch_version(branch_number bn, uint64_t version) noexcept;
       void copy_branch_version_from(const leaf_node& src,
@@ -510,13 +579,15 @@ namespace psitri
       uint32_t _num_branches : 9;
       uint32_t _num_versions : 5;  ///< number of shared version table entries (0-31)
       uint32_t _unused : 8;
-      uint8_t  _key_hashs[/*num_branches()*/];
-      // Dynamic arrays follow sequentially after _key_hashs:
-      //   uint8_t      key_hash[num_branch]
-      //   uint16_t     keys_offsets[num_branch]
-      //   value_branch value_offsets[num_branch]
+      uint16_t _capacity;  ///< slots in each per-branch array
+      uint8_t  _unused_header[42];  ///< pads the header to one cacheline
+      uint8_t  _key_hashs[/*_capacity*/];
+      // Dynamic arrays follow sequentially after _key_hashs, from byte 64:
+      //   uint8_t      key_hash[_capacity]
+      //   uint16_t     keys_offsets[_capacity]
+      //   value_branch value_offsets[_capacity]
       //   ptr_address  _clines[_cline_cap]
-      //   uint8_t      ver_indices[num_branch]   (0xFF = no version)
+      //   uint8_t      ver_indices[_capacity]   (0xFF = no version)
       //   version48    version_table[_num_versions]
       //   [free space]
       //   ← _alloc_pos (from tail)
@@ -541,13 +612,12 @@ namespace psitri
       PSITRI_NO_SANITIZE_ALIGNMENT std::span<key_offset> keys_offsets() noexcept
       {
          return std::span<key_offset>(
-             reinterpret_cast<key_offset*>(key_hashs().data() + num_branches()), num_branches());
+             reinterpret_cast<key_offset*>(_key_hashs + _capacity), num_branches());
       }
       PSITRI_NO_SANITIZE_ALIGNMENT std::span<const key_offset> keys_offsets() const noexcept
       {
          return std::span<const key_offset>(
-             reinterpret_cast<const key_offset*>(key_hashs().data() + num_branches()),
-             num_branches());
+             reinterpret_cast<const key_offset*>(_key_hashs + _capacity), num_branches());
       }
 
 #if PSITRI_PLATFORM_OPTIMIZATIONS
@@ -613,30 +683,6 @@ namespace psitri
       };  // class value_branch
       static_assert(sizeof(value_branch) == 2);
 
-      struct meta_arrays
-      {
-         char* khash;
-         char* khash_end;
-         char* koffs;
-         char* koffs_end;
-         char* voffs;
-         char* voffs_end;
-         char* clines;
-         char* clines_end;
-      };
-
-      meta_arrays get_meta_arrays() noexcept
-      {
-         return meta_arrays{(char*)_key_hashs,
-                            (char*)_key_hashs + num_branches(),
-                            (char*)_key_hashs + num_branches(),
-                            (char*)value_offsets(),
-                            (char*)value_offsets(),
-                            (char*)clines().data(),
-                            (char*)clines().data(),
-                            const_cast<char*>(meta_end())};
-      }
-
       ptr_address get_address(value_branch vb) const noexcept
       {
          return ptr_address(*(clines()[*vb.cline()]) + *vb.cline_idx());
@@ -644,19 +690,15 @@ namespace psitri
 
       value_branch* value_offsets() noexcept
       {
-         return reinterpret_cast<value_branch*>(keys_offsets().data() + num_branches());
+         return reinterpret_cast<value_branch*>(keys_offsets().data() + _capacity);
       }
       const value_branch* value_offsets() const noexcept
       {
-         return reinterpret_cast<const value_branch*>(keys_offsets().data() + num_branches());
-      }
-      const value_branch* value_offsets_end() const noexcept
-      {
-         return reinterpret_cast<const value_branch*>(value_offsets() + num_branches());
+         return reinterpret_cast<const value_branch*>(keys_offsets().data() + _capacity);
       }
       const char* clines_end() const noexcept
       {
-         return (const char*)(value_offsets() + num_branches()) + _cline_cap * sizeof(ptr_address);
+         return (const char*)(value_offsets() + _capacity) + _cline_cap * sizeof(ptr_address);
       }
 
       /// Per-branch version index — maps branch to version_table entry.
@@ -673,11 +715,11 @@ namespace psitri
       /// Shared version table — up to 31 unique version48 entries.
       version48* version_table() noexcept
       {
-         return reinterpret_cast<version48*>(ver_indices() + num_branches());
+         return reinterpret_cast<version48*>(ver_indices() + _capacity);
       }
       const version48* version_table() const noexcept
       {
-         return reinterpret_cast<const version48*>(ver_indices() + num_branches());
+         return reinterpret_cast<const version48*>(ver_indices() + _capacity);
       }
 
       /// End of all metadata (past version_table).
@@ -692,7 +734,16 @@ namespace psitri
       }
 
       /// Initialize ver_indices to 0xFF for all branches.
-      void init_ver_indices() noexcept { std::memset(ver_indices(), 0xFF, num_branches()); }
+      void init_ver_indices() noexcept { std::memset(ver_indices(), 0xFF, _capacity); }
+
+      /// Resize the cline table, moving the version arrays that follow it.
+      void set_cline_cap(uint32_t cline_cap) noexcept
+      {
+         if (_num_versions)
+            std::memmove((char*)(value_offsets() + _capacity) + cline_cap * sizeof(ptr_address),
+                         ver_indices(), _capacity + _num_versions * sizeof(version48));
+         _cline_cap = cline_cap;
+      }
 
       /// determine if addr is on an existing cline, or allocate a new one and
       /// return the value_branch for the new cline
@@ -799,16 +850,16 @@ namespace psitri
       char*       alloc_head() noexcept { return (char*)tail() - _alloc_pos; }
 
    } __attribute__((packed));
-   static_assert(sizeof(leaf_node) == 20);
+   static_assert(sizeof(leaf_node) == 64);
 
    inline uint32_t leaf_node::alloc_size(key_view key, const value_type& value) noexcept
    {
-      return max_leaf_size;  //ucc::round_up_multiple<64>(sizeof(leaf_node) + key.size() + value.size());
+      return size_class(sizeof(leaf_node) + insert_size(key, value));
    }
    /// clone and optimize
    inline uint32_t leaf_node::alloc_size(const leaf_node* clone) noexcept
    {
-      return clone->size();
+      return size_class(clone->used_size());
    }
 
    namespace op
@@ -819,9 +870,15 @@ namespace psitri
          init_fn  init;
          void*    ctx;
          uint16_t count;
+         uint32_t size = leaf_node::max_leaf_size;  ///< upper bound on the bytes init adds
       };
    }  // namespace op
 
+   inline uint32_t leaf_node::alloc_size(const op::leaf_from_visitor& vis)
+   {
+      return size_class(vis.size);
+   }
+
    template <typename T>
    concept is_leaf_node = std::same_as<std::remove_cvref_t<std::remove_pointer_t<T>>, leaf_node>;
 }  // namespace psitri
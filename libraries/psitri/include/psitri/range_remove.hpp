@@ -8,6 +8,7 @@ namespace psitri
 
    inline uint64_t tree_context::remove_range(key_view lower, key_view upper)
    {
+      drop_finger();
       if (!_root)
          return 0;
       if (lower >= upper && upper != max_key)
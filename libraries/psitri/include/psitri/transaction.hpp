@@ -8,6 +8,7 @@
 #include <psitri/tx_mode.hpp>
 #include <psitri/value_pin.hpp>
 #include <psitri/write_cursor.hpp>
+#include <span>
 #include <stdexcept>
 #include <utility>
 #include <vector>
@@ -80,6 +81,14 @@ namespace psitri
       int32_t get(key_view key, Buffer auto* buffer) const;
       bool    get(key_view key, std::invocable<value_view> auto&& lambda) const;
 
+      /// Batched get(key, lambda); see cursor::get_many().
+      size_t get_many(std::span<const key_view>                 keys,
+                      std::invocable<size_t, value_view> auto&& lambda) const;
+
+      /// Coroutine form of get<T>(key); see cursor::async_get().
+      template <ConstructibleBuffer T = std::string>
+      read_task<std::optional<T>> async_get(key_view key) const;
+
       cursor lower_bound(key_view key) const;
       cursor upper_bound(key_view key) const;
       bool   is_subtree(key_view key) const;
@@ -145,6 +154,10 @@ namespace psitri
       int32_t get(key_view key, Buffer auto* buffer) const;
       bool    get(key_view key, std::invocable<value_view> auto&& lambda) const;
 
+      /// Batched get(key, lambda); see cursor::get_many().
+      size_t get_many(std::span<const key_view>                 keys,
+                      std::invocable<size_t, value_view> auto&& lambda) const;
+
       /// Position a cursor at the first key >= query.
       cursor lower_bound(key_view key) const;
 
@@ -272,6 +285,48 @@ namespace psitri
          return do_remove_range(_primary_index, lower, upper);
       }
 
+      /// Apply writes sorted by strictly ascending key; a default-constructed
+      /// value removes its key.  Runs of keys that land in the same leaf are
+      /// applied with one rebuild of that leaf (see tree_context::upsert_batch()).
+      void upsert_batch(std::span<const batch_op> ops)
+      {
+         auto& cs = cs_at(_primary_index);
+         if (cs.buffer)
+         {
+            for (const auto& op : ops)
+            {
+               assert(!op.value.is_subtree() && "subtree upsert not supported in buffered mode");
+               if (op.value.is_remove())
+                  micro_remove(cs, op.key);
+               else
+                  micro_put(cs, op.key, op.value.view());
+            }
+         }
+         else
+            cs.cursor->upsert_batch(ops);
+         cs.dirty = true;
+      }
+
+      /// The top-level branches of the primary tree, so a batch of sorted
+      /// writes can be applied to each branch outside this transaction and
+      /// grafted back with graft().
+      tree_fanout fanout() const
+      {
+         auto f       = cs_at(_primary_index).cursor->fanout();
+         f.epoch_base = _epoch_base;
+         return f;
+      }
+
+      /// Replace top-level branch @p old_branch, which @p key routes to, with
+      /// @p new_branch; takes ownership of the reference to @p new_branch.
+      void graft(key_view key, sal::ptr_address old_branch, sal::ptr_address new_branch)
+      {
+         auto& cs = cs_at(_primary_index);
+         assert(_mode == tx_mode::expect_success && "graft not supported in buffered mode");
+         cs.cursor->graft(key, old_branch, new_branch);
+         cs.dirty = true;
+      }
+
       // ── Primary tree read access (backward-compatible) ────────────────
 
       cursor read_cursor() const { return cs_at(_primary_index).cursor->read_cursor(); }
@@ -294,6 +349,27 @@ namespace psitri
          return do_get(_primary_index, key, std::forward<decltype(lambda)>(lambda));
       }
 
+      /// Looks up every key in @p keys, calling @p lambda(index, value) for
+      /// each one found, in no particular order.  Keys the write buffer
+      /// settles are answered from it; the rest are looked up together
+      /// with cursor::get_many().
+      /// @return the number of keys found
+      size_t get_many(std::span<const key_view>                 keys,
+                      std::invocable<size_t, value_view> auto&& lambda) const
+      {
+         return do_get_many(_primary_index, keys, lambda);
+      }
+
+      /// Looks up @p key like get<T>(key), as a coroutine that suspends
+      /// while the pages it needs are read in; see cursor::async_get().
+      /// The write buffer is checked when the task starts, and the
+      /// transaction must outlive the task.
+      template <ConstructibleBuffer T = std::string>
+      read_task<std::optional<T>> async_get(key_view key) const
+      {
+         return do_async_get<T>(_primary_index, std::string(key));
+      }
+
       cursor lower_bound(key_view key) const { return do_bound(_primary_index, key, false); }
 
       cursor upper_bound(key_view key) const { return do_bound(_primary_index, key, true); }
@@ -632,6 +708,57 @@ namespace psitri
          return cs.cursor->get(key, std::forward<decltype(lambda)>(lambda));
       }
 
+      template <ConstructibleBuffer T>
+      read_task<std::optional<T>> do_async_get(uint32_t idx, std::string key) const
+      {
+         auto& cs = cs_at(idx);
+         if (cs.buffer)
+         {
+            if (const auto* entry = cs.buffer->get(key))
+            {
+               if (entry->is_tombstone())
+                  co_return std::nullopt;
+               auto val = entry->value();
+               T    result;
+               result.resize(val.size());
+               std::memcpy(result.data(), val.data(), val.size());
+               co_return result;
+            }
+         }
+         co_return co_await cs.cursor->read_cursor().async_get<T>(key);
+      }
+
+      size_t do_get_many(uint32_t                                  idx,
+                         std::span<const key_view>                 keys,
+                         std::invocable<size_t, value_view> auto&& lambda) const
+      {
+         auto& cs = cs_at(idx);
+         if (!cs.buffer)
+            return cs.cursor->read_cursor().get_many(keys, lambda);
+
+         size_t                found = 0;
+         std::vector<key_view> misses;
+         std::vector<size_t>   miss_index;
+         for (size_t i = 0; i < keys.size(); ++i)
+         {
+            if (const auto* entry = cs.buffer->get(keys[i]))
+            {
+               if (!entry->is_tombstone())
+               {
+                  lambda(i, entry->value());
+                  ++found;
+               }
+               continue;
+            }
+            misses.push_back(keys[i]);
+            miss_index.push_back(i);
+         }
+         if (!misses.empty())
+            found += cs.cursor->read_cursor().get_many(
+                misses, [&](size_t i, value_view v) { lambda(miss_index[i], v); });
+         return found;
+      }
+
       cursor do_bound(uint32_t idx, key_view key, bool is_upper) const
       {
          auto& cs = cs_at(idx);
@@ -979,6 +1106,18 @@ namespace psitri
       return _tx->do_get(_cs_index, key, std::forward<decltype(lambda)>(lambda));
    }
 
+   inline size_t tree_handle::get_many(std::span<const key_view>                 keys,
+                                       std::invocable<size_t, value_view> auto&& lambda) const
+   {
+      return _tx->do_get_many(_cs_index, keys, lambda);
+   }
+
+   template <ConstructibleBuffer T>
+   read_task<std::optional<T>> tree_handle::async_get(key_view key) const
+   {
+      return _tx->do_async_get<T>(_cs_index, std::string(key));
+   }
+
    inline cursor tree_handle::lower_bound(key_view key) const
    {
       return _tx->do_bound(_cs_index, key, false);
@@ -1088,6 +1227,13 @@ namespace psitri
       return _tx->get(key, std::forward<decltype(lambda)>(lambda));
    }
 
+   inline size_t transaction_frame_ref::get_many(
+       std::span<const key_view>                 keys,
+       std::invocable<size_t, value_view> auto&& lambda) const
+   {
+      return _tx->get_many(keys, lambda);
+   }
+
    inline bool transaction_frame_ref::is_subtree(key_view key) const
    {
       return _tx->is_subtree(key);
@@ -1167,6 +1313,16 @@ namespace psitri
          return _tx.get<T>(key);
       }
       int32_t get(key_view key, Buffer auto* buffer) const { return _tx.get(key, buffer); }
+      size_t  get_many(std::span<const key_view>                 keys,
+                       std::invocable<size_t, value_view> auto&& lambda) const
+      {
+         return _tx.get_many(keys, lambda);
+      }
+      template <ConstructibleBuffer T = std::string>
+      read_task<std::optional<T>> async_get(key_view key) const
+      {
+         return _tx.async_get<T>(key);
+      }
 
       psitri::cursor cursor() const { return _tx.read_cursor(); }
       psitri::cursor snapshot_cursor() const { return _tx.snapshot_cursor(); }
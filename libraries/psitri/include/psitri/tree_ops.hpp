@@ -1,4 +1,7 @@
 #pragma once
+#include <algorithm>
+#include <span>
+#include <string>
 #include <vector>
 #include <psitri/count_keys.hpp>
 #include <psitri/node/inner.hpp>
@@ -16,6 +19,56 @@ namespace psitri
    using sal::alloc_header;
    using sal::smart_ptr;
    using sal::smart_ref;
+
+   /**
+    * The top-level branches of a tree whose root is an inner node.  Inner
+    * nodes route on the first byte after their prefix without consuming it,
+    * so once @ref prefix is stripped from a key, the branch it routes to is a
+    * complete tree for that key.  This lets a batch of sorted writes be split
+    * by branch, applied to each branch independently, and the new branches
+    * grafted back with tree_context::graft().
+    */
+   struct tree_fanout
+   {
+      std::string              prefix;
+      std::string              dividers;  ///< branches.size() - 1 routing bytes
+      std::vector<ptr_address> branches;
+      uint64_t                 epoch_base   = 0;
+      uint64_t                 root_version = 0;  ///< version of the root's txn
+
+      /// @return the branch @p key belongs to, or -1 if it lacks the prefix
+      int route(key_view key) const noexcept
+      {
+         if (not key.starts_with(prefix))
+            return -1;
+         key = key.substr(prefix.size());
+         if (key.empty())
+            return 0;
+         return std::upper_bound(dividers.begin(), dividers.end(), key[0],
+                                 [](char a, char b) { return uint8_t(a) < uint8_t(b); }) -
+                dividers.begin();
+      }
+
+      /// @return a key that routes to branch @p br
+      std::string branch_key(uint32_t br) const
+      {
+         std::string key = prefix;
+         if (br > 0)
+            key.push_back(dividers[br - 1]);
+         return key;
+      }
+   };
+
+   /**
+    * One write of a sorted batch; see tree_context::upsert_batch().  A
+    * default-constructed value removes the key.
+    */
+   struct batch_op
+   {
+      key_view   key;
+      value_type value;
+   };
+
    class tree_context
    {
       value_type                   _new_value;
@@ -30,6 +83,53 @@ namespace psitri
       uint64_t                        _root_value_version = 0;
       std::vector<ptr_address>        _pending_releases;
 
+      /// Progress of upsert_batch(): the ops not yet applied, and the
+      /// exclusive upper bound of the keys that route to the current leaf.
+      struct batch_state
+      {
+         const batch_op* next;
+         const batch_op* end;
+         key_view        key;  ///< key of the op that started the descent
+         std::string     fence;
+         bool            bounded = false;
+      };
+      batch_state* _batch = nullptr;
+
+      /// The path the last upsert() took from the root to its leaf, so that
+      /// a following key routed to the same leaf (appends of increasing keys,
+      /// writes near the last one) starts at the leaf; see try_finger().
+      /// Valid while the root keeps its address, version and sole owner, the
+      /// epoch base is unchanged and no other kind of write has run since.
+      struct finger_state
+      {
+         /// An inner node on the path and the branch taken out of it.
+         struct level
+         {
+            ptr_address   adr;
+            branch_number br;
+            uint16_t      used;  ///< key bytes consumed by prefixes down to this node
+            int16_t       lo;    ///< least key[used] routed to br, -1 for branch 0
+            int16_t       hi;    ///< key[used] below which keys route to br, -1 for the last
+         };
+         enum class state : uint8_t
+         {
+            idle,
+            descending,  ///< recording the levels of a descent
+            reached      ///< the descent reached its leaf
+         };
+
+         std::vector<level> levels;
+         std::string        path;  ///< key bytes consumed by prefixes above the leaf
+         key_view           key;   ///< the key being descended for
+         ptr_address        root         = sal::null_ptr_address;
+         ptr_address        leaf         = sal::null_ptr_address;
+         uint64_t           root_version = 0;
+         uint64_t           epoch_base   = 0;
+         state              st           = state::idle;
+         bool               valid        = false;
+      };
+      finger_state _finger;
+
       sal::pending_release_list make_pending_release_list(std::size_t reserve_hint)
       {
          if (_pending_releases.capacity() < reserve_hint)
@@ -59,7 +159,11 @@ namespace psitri
          return needs_unique_refresh(last_unique_version, _epoch_base, _root_version);
       }
       sal::smart_ptr<alloc_header> get_root() const { return _root; }
-      sal::smart_ptr<alloc_header> take_root() { return std::move(_root); }
+      sal::smart_ptr<alloc_header> take_root()
+      {
+         drop_finger();
+         return std::move(_root);
+      }
 
       /// Per-txn version: read the version number from the working root's
       /// ver custom CB. Returns 0 if no ver is attached (no active txn /
@@ -210,11 +314,18 @@ namespace psitri
             // it onto _root via give() so the txn's _ver (set at
             // start_transaction by make_unique_root) travels through
             // unchanged.
+            drop_finger();
             auto leaf_addr = _session.alloc<leaf_node>(sal::alloc_hint(), key,
                                                        make_value(_new_value, sal::alloc_hint()));
             _root.give(leaf_addr);
             return -1;
          }
+         if (not _batch)
+         {
+            if (try_finger<mode>(key))
+               return _old_value_size;
+            start_finger(key);
+         }
          auto rref     = *_root;
          auto old_addr = _root.take();  // so it isn't released when it goes back...
 
@@ -225,6 +336,7 @@ namespace psitri
          }
          catch (...)
          {
+            drop_finger();
             _root.give(old_addr);  // restore root on exception
             throw;
          }
@@ -236,12 +348,15 @@ namespace psitri
          else
             _root.give(make_inner(result));
 
+         if (_finger.st != finger_state::state::idle)
+            finish_finger(old_addr);
          return _old_value_size;
       }
 
       /// @return the size of the prior value, or -1 if the value was not found.
       int remove(key_view key)
       {
+         drop_finger();
          if (not _root)
             return -1;
          _old_value_size         = -1;
@@ -260,10 +375,101 @@ namespace psitri
          return _old_value_size;
       }
 
+      /**
+       * Applies @p ops, which must be sorted by strictly ascending key.  Each
+       * descent keeps applying the following ops while they land in the same
+       * leaf, so a run of keys costs one leaf copy and one update of the
+       * inner nodes above it instead of one per key.  A run ends where the
+       * leaf splits or would become empty, or where upserts and removes
+       * alternate.  A subtree value passes one reference to the tree.
+       */
+      void upsert_batch(std::span<const batch_op> ops)
+      {
+         drop_finger();
+         batch_state batch{ops.data(), ops.data() + ops.size(), {}, {}, false};
+         _batch = &batch;
+         try
+         {
+            while (batch.next != batch.end)
+            {
+               assert(batch.next == ops.data() || batch.next[-1].key < batch.next->key);
+               const batch_op& op = *batch.next++;
+               batch.key          = op.key;
+               batch.bounded      = false;
+               if (op.value.is_remove())
+                  remove(op.key);
+               else
+                  upsert<upsert_mode{upsert_mode::unique_upsert | upsert_mode::sorted_f}>(
+                      op.key, op.value);
+            }
+         }
+         catch (...)
+         {
+            _batch = nullptr;
+            throw;
+         }
+         _batch = nullptr;
+      }
+
       /// Remove all keys in range [lower, upper).
       /// @return the number of keys removed.
       uint64_t remove_range(key_view lower, key_view upper);
 
+      /// @return the top-level branches of the tree, empty unless the root
+      /// is an inner node
+      tree_fanout fanout() const
+      {
+         tree_fanout f;
+         if (not _root)
+            return f;
+         sal::read_lock lock = _session.lock();
+         auto           ref  = _session.get_ref(_root.address());
+         auto           fill = [&f](const auto& in)
+         {
+            f.dividers = std::string(in->divs());
+            f.branches.reserve(in->num_branches());
+            for (uint16_t i = 0; i < in->num_branches(); ++i)
+               f.branches.push_back(in->get_branch(branch_number(i)));
+         };
+         switch (node_type(ref->type()))
+         {
+            case node_type::inner:
+               fill(ref.as<inner_node>());
+               break;
+            case node_type::inner_prefix:
+            {
+               auto ipn = ref.as<inner_prefix_node>();
+               f.prefix = std::string(ipn->prefix());
+               fill(ipn);
+               break;
+            }
+            default:
+               break;
+         }
+         f.root_version = txn_version();
+         return f;
+      }
+
+      /**
+       * Replaces the branch @p old_branch, found by routing @p key from the
+       * root, with @p new_branch.  Takes ownership of the caller's reference
+       * to @p new_branch and drops the tree's reference to @p old_branch.
+       * The branch may sit below the root if an earlier graft split it.
+       */
+      void graft(key_view key, ptr_address old_branch, ptr_address new_branch)
+      {
+         drop_finger();
+         sal::read_lock lock = _session.lock();
+         auto           rref = *_root;
+         _root.take();  // ownership moves to the grafted result
+
+         branch_set result = graft<upsert_mode::unique>({}, rref, key, old_branch, new_branch);
+         if (result.count() == 1)
+            _root.give(result.get_first_branch());
+         else
+            _root.give(make_inner(result));
+      }
+
       template <upsert_mode mode>
       branch_set range_remove(const sal::alloc_hint&   parent_hint,
                               smart_ref<alloc_header>& ref,
@@ -433,14 +639,19 @@ namespace psitri
 
          subtree_sizer(uint32_t max) : max_entries(max) {}
 
+         /// upper bound on the size of the collapsed leaf, counting a cline
+         /// for every address value
+         uint32_t leaf_size() const
+         {
+            return sizeof(leaf_node) + 5u * count + key_data_size +
+                   count * 2u  // sizeof(leaf_node::key) == 2
+                   + value_data_size + addr_values * sizeof(ptr_address);
+         }
          bool fits_in_leaf() const
          {
             if (overflow || count == 0)
                return false;
-            uint32_t data  = key_data_size + count * 2u  // sizeof(leaf_node::key) == 2
-                             + value_data_size + addr_values * sizeof(ptr_address);
-            uint32_t avail = leaf_node::max_leaf_size - sizeof(leaf_node) - 5u * count;
-            return data <= avail;
+            return leaf_size() <= leaf_node::max_leaf_size;
          }
       };
 
@@ -808,6 +1019,13 @@ namespace psitri
                         smart_ref<InnerNodeType>& in,
                         key_view                  key);
 
+      template <upsert_mode mode, any_inner_node_type InnerNodeType>
+      branch_set graft(const sal::alloc_hint&    parent_hint,
+                       smart_ref<InnerNodeType>& in,
+                       key_view                  key,
+                       ptr_address               old_branch,
+                       ptr_address               new_branch);
+
       /**
        * id type ref "divs"
        *   / 
@@ -1052,6 +1270,234 @@ namespace psitri
          }
       }
 
+      void drop_finger() noexcept
+      {
+         _finger.valid = false;
+         _finger.st    = finger_state::state::idle;
+      }
+
+      /// Begin recording the path upsert() takes for @p key.
+      void start_finger(key_view key)
+      {
+         _finger.valid = false;
+         _finger.st    = finger_state::state::descending;
+         _finger.key   = key;
+         _finger.leaf  = sal::null_ptr_address;
+         _finger.levels.clear();
+      }
+
+      /// Records that the descent took branch @p br of inner node @p adr,
+      /// @p key being what is left of the key after the node's prefix.
+      void record_finger(ptr_address adr, key_view key, key_view divs, branch_number br)
+      {
+         _finger.levels.push_back(
+             {adr, br, uint16_t(_finger.key.size() - key.size()),
+              int16_t(*br > 0 ? uint8_t(divs[*br - 1]) : -1),
+              int16_t(*br < divs.size() ? uint8_t(divs[*br]) : -1)});
+      }
+
+      /// True if writing to leaf @p leaf returned @p result, the leaf
+      /// itself.  A leaf can also return its own address remade into an
+      /// inner_prefix_node, which leaves the path above intact but ends it.
+      bool leaf_kept(ptr_address leaf, const branch_set& result)
+      {
+         return result.count() == 1 && result.get_first_branch() == leaf &&
+                node_type(_session.get_ref(leaf)->type()) == node_type::leaf;
+      }
+
+      /// Called with each leaf the recorded descent writes to: the first
+      /// one is the finger's leaf, kept only if every leaf written returned
+      /// itself, i.e. nothing above it changed.
+      void reach_finger(ptr_address leaf, key_view key, const branch_set& result)
+      {
+         const bool unchanged = result.count() == 1 && result.get_first_branch() == leaf;
+         if (_finger.st == finger_state::state::descending)
+         {
+            _finger.st    = finger_state::state::reached;
+            _finger.valid = unchanged && leaf_kept(leaf, result);
+            _finger.leaf  = leaf;
+            _finger.path.assign(_finger.key.data(), _finger.key.size() - key.size());
+         }
+         else if (!unchanged)
+            _finger.valid = false;
+      }
+
+      /// Ends the recorded descent of upsert(); the finger holds if the root
+      /// @p old_root is still the root, unchanged.
+      void finish_finger(ptr_address old_root)
+      {
+         _finger.valid = _finger.valid && _finger.st == finger_state::state::reached &&
+                         _root.address() == old_root;
+         _finger.st           = finger_state::state::idle;
+         _finger.root         = old_root;
+         _finger.root_version = _root_version;
+         _finger.epoch_base   = _epoch_base;
+         _finger.key          = {};
+      }
+
+      /// True if @p key routes to the finger's leaf: it shares the prefixes
+      /// consumed above the leaf and takes the recorded branch at each level.
+      bool finger_routes(key_view key) const noexcept
+      {
+         if (!key.starts_with(_finger.path))
+            return false;
+         for (const auto& l : _finger.levels)
+         {
+            if (key.size() == l.used)
+            {
+               if (l.lo >= 0)
+                  return false;  // an exhausted key takes branch 0
+               continue;
+            }
+            const int b = uint8_t(key[l.used]);
+            if (b < l.lo || (l.hi >= 0 && b >= l.hi))
+               return false;
+         }
+         return true;
+      }
+
+      /// The cachelines of the branches of inner node @p adr, the hint its
+      /// children are allocated with.
+      sal::alloc_hint branch_clines(ptr_address adr)
+      {
+         auto ref = _session.get_ref(adr);
+         if (node_type(ref->type()) == node_type::inner_prefix)
+            return ref.as<inner_prefix_node>()->get_branch_clines();
+         return ref.as<inner_node>()->get_branch_clines();
+      }
+
+      /**
+       * Writes @p key by starting at the finger's leaf when the key routes
+       * there and the recorded path still holds, skipping the descent from
+       * the root.  If the leaf splits, its branches are merged into the
+       * recorded ancestors bottom-up as the descent would have on its way
+       * back, and the finger is dropped.
+       * @return false if the finger did not apply; nothing was written
+       */
+      template <upsert_mode mode>
+      bool try_finger(key_view key)
+      {
+         if constexpr (!mode.is_unique() || mode.is_remove())
+            return false;
+         if (!_finger.valid || _root.address() != _finger.root ||
+             _root_version != _finger.root_version || _epoch_base != _finger.epoch_base ||
+             !finger_routes(key))
+            return false;
+         if ((*_root).ref() > 1)
+            return drop_finger(), false;
+         auto leaf = _session.get_ref(_finger.leaf);
+         if (leaf.ref() > 1)
+            return drop_finger(), false;
+
+         const auto& levels = _finger.levels;
+         auto        hint   = levels.empty() ? sal::alloc_hint() : branch_clines(levels.back().adr);
+         branch_set  result;
+         try
+         {
+            result = upsert<mode>(hint, leaf.as<leaf_node>(), key.substr(_finger.path.size()));
+         }
+         catch (...)
+         {
+            drop_finger();
+            throw;
+         }
+         ptr_address child = _finger.leaf;
+         if (leaf_kept(child, result))
+            return true;
+
+         drop_finger();
+         for (size_t i = levels.size(); i-- > 0;)
+         {
+            if (result.count() == 1 && result.get_first_branch() == child)
+               return true;
+            auto in = _session.get_ref(levels[i].adr);
+            hint    = i ? branch_clines(levels[i - 1].adr) : sal::alloc_hint();
+            if (node_type(in->type()) == node_type::inner_prefix)
+               result = merge_branches<mode.make_shared_or_unique_only()>(
+                   hint, in.as<inner_prefix_node>(), levels[i].br, result);
+            else
+               result = merge_branches<mode.make_shared_or_unique_only()>(
+                   hint, in.as<inner_node>(), levels[i].br, result);
+            child = levels[i].adr;
+         }
+         if (result.count() == 1 && result.get_first_branch() == child)
+            return true;
+         _root.take();  // the root's address is among the new branches
+         if (result.count() == 1)
+            _root.give(result.get_first_branch());
+         else
+            _root.give(make_inner(result));
+         return true;
+      }
+
+      /// Tightens the upsert_batch() fence to the keys that take the same
+      /// branch @p br of an inner node; @p key is what is left of the key
+      /// after the node's prefix, @p prefix_len the length of that prefix.
+      void narrow_batch_fence(key_view key, size_t prefix_len, key_view divs, branch_number br)
+      {
+         const size_t used = _batch->key.size() - key.size();
+         std::string  bound(_batch->key.data(), used);
+         if (*br < divs.size())
+            bound.push_back(divs[*br]);
+         else if (prefix_len)
+         {
+            // past the last divider the keys are bounded by the prefix
+            while (!bound.empty() && uint8_t(bound.back()) == 0xff)
+               bound.pop_back();
+            if (bound.empty())
+               return;
+            bound.back() = char(uint8_t(bound.back()) + 1);
+         }
+         else
+            return;
+         if (!_batch->bounded || bound < _batch->fence)
+         {
+            _batch->fence   = std::move(bound);
+            _batch->bounded = true;
+         }
+      }
+
+      /**
+       * Applies the following upsert_batch() ops that route to the leaf the
+       * current op was just written to, updating that leaf in place.  Stops
+       * at the first op that routes elsewhere or is of the other kind, and
+       * once the leaf has split, is shared, or would be emptied.
+       */
+      template <bool remove>
+      void continue_batch(const sal::alloc_hint& parent_hint, branch_set& result, key_view key)
+      {
+         const size_t   used = _batch->key.size() - key.size();
+         const key_view path = _batch->key.substr(0, used);
+         while (result.count() == 1 && _batch->next != _batch->end)
+         {
+            const batch_op& op = *_batch->next;
+            if (op.value.is_remove() != remove || !op.key.starts_with(path))
+               break;
+            if (_batch->bounded && op.key >= key_view(_batch->fence))
+               break;
+            auto node = _session.get_ref(result.get_first_branch());
+            if (node.ref() > 1 || node_type(node->type()) != node_type::leaf)
+               break;  // shared, or the leaf was split under a new prefix node
+            auto& leaf = node.as<leaf_node>();
+            if constexpr (remove)
+               if (leaf->num_branches() == 1)
+                  break;  // the parent has to drop the emptied leaf
+
+            // a split re-enters the dispatcher, which may carry on with the
+            // ops after this one under the nodes the split created
+            ++_batch->next;
+            _batch->key = op.key;
+            if constexpr (remove)
+               result = upsert<upsert_mode::unique_remove>(parent_hint, leaf, op.key.substr(used));
+            else
+            {
+               _new_value = op.value;
+               result     = upsert<upsert_mode{upsert_mode::unique_upsert | upsert_mode::sorted_f}>(
+                   parent_hint, leaf, op.key.substr(used));
+            }
+         }
+      }
+
       template <upsert_mode mode>
       branch_set upsert(const sal::alloc_hint&   parent_hint,
                         smart_ref<alloc_header>& r,
@@ -1059,7 +1505,10 @@ namespace psitri
       {
          if constexpr (mode.is_unique())
             if (r.ref() > 1)
+            {
+               _finger.st = finger_state::state::idle;  // the path is being copied
                return upsert<mode.make_shared()>(parent_hint, r, key);
+            }
 
          branch_set result;
          switch (node_type(r->type()))
@@ -1072,6 +1521,10 @@ namespace psitri
                break;
             case node_type::leaf:
                [[unlikely]] result = upsert<mode>(parent_hint, r.as<leaf_node>(), key);
+               if (_batch) [[unlikely]]
+                  continue_batch<mode.is_remove()>(parent_hint, result, key);
+               else if (_finger.st != finger_state::state::idle)
+                  reach_finger(r.address(), key, result);
                break;
             case node_type::value:
                //  [[unlikely]] return upsert<mode>(parent_hint, r.as<value_node>(), key);
@@ -1097,6 +1550,37 @@ namespace psitri
          return result;
       }
 
+      template <upsert_mode mode>
+      branch_set graft(const sal::alloc_hint&   parent_hint,
+                       smart_ref<alloc_header>& r,
+                       key_view                 key,
+                       ptr_address              old_branch,
+                       ptr_address              new_branch)
+      {
+         if constexpr (mode.is_unique())
+            if (r.ref() > 1)
+               return graft<mode.make_shared()>(parent_hint, r, key, old_branch, new_branch);
+
+         branch_set result;
+         switch (node_type(r->type()))
+         {
+            case node_type::inner:
+               result = graft<mode>(parent_hint, r.as<inner_node>(), key, old_branch, new_branch);
+               break;
+            case node_type::inner_prefix:
+               result = graft<mode>(parent_hint, r.as<inner_prefix_node>(), key, old_branch,
+                                    new_branch);
+               break;
+            default:
+               // the key routed to a leaf without passing old_branch
+               std::unreachable();
+         }
+         if constexpr (mode.is_shared())
+            if (not result.contains(r.address()))
+               r.release();
+         return result;
+      }
+
    };  // class tree_context
 
    /**
@@ -1168,6 +1652,47 @@ namespace psitri
       }
    }
 
+   /**
+    * Routes @p key down to the node holding @p old_branch and replaces it
+    * with @p new_branch, then merges the change back up like an upsert.
+    */
+   template <upsert_mode mode, any_inner_node_type InnerNodeType>
+   branch_set tree_context::graft(const sal::alloc_hint&    parent_hint,
+                                  smart_ref<InnerNodeType>& in,
+                                  key_view                  key,
+                                  ptr_address               old_branch,
+                                  ptr_address               new_branch)
+   {
+      if constexpr (is_inner_prefix_node<InnerNodeType>)
+      {
+         assert(key.starts_with(in->prefix()));
+         key = key.substr(in->prefix().size());
+      }
+
+      branch_number br   = in->lower_bound(key);
+      auto          badr = in->get_branch(br);
+
+      if constexpr (mode.is_shared())
+         retain_children(in);  // all children are copied to the new node
+
+      branch_set sub_branches;
+      if (badr == old_branch)
+         sub_branches = branch_set(new_branch);
+      else
+      {
+         auto bref    = _session.get_ref(badr);
+         sub_branches = graft<mode>(in->get_branch_clines(), bref, key, old_branch, new_branch);
+      }
+
+      auto result = merge_branches<mode.make_shared_or_unique_only()>(parent_hint, in, br,
+                                                                      sub_branches);
+      // the replaced branch is no longer referenced by this node (or by its
+      // copy, which received a retain for it above)
+      if (badr == old_branch)
+         _session.release(old_branch);
+      return result;
+   }
+
    template <upsert_mode mode, any_inner_node_type InnerNodeType>
    branch_set tree_context::merge_branches(const sal::alloc_hint&    parent_hint,
                                            smart_ref<InnerNodeType>& in,
@@ -1368,6 +1893,19 @@ namespace psitri
 	      branch_number br   = in->lower_bound(key);
       auto          badr = in->get_branch(br);
 
+      if (_batch) [[unlikely]]
+      {
+         if constexpr (is_inner_prefix_node<InnerNodeType>)
+            narrow_batch_fence(key, in->prefix().size(), in->divs(), br);
+         else
+            narrow_batch_fence(key, 0, in->divs(), br);
+      }
+      else if constexpr (mode.is_unique())
+      {
+         if (_finger.st == finger_state::state::descending)
+            record_finger(in.address(), key, in->divs(), br);
+      }
+
       // In sorted mode, prefetch the next sibling's node.  Sorted keys exhaust
       // the current subtree then move to the next branch — warming it early
       // hides page-fault latency for any linear scan beyond RAM.
@@ -1564,7 +2102,8 @@ namespace psitri
 
                      collapse_context cctx{_session, branches, nb, root_prefix};
                      (void)_session.realloc<leaf_node>(
-                         in, op::leaf_from_visitor{&collapse_visitor, &cctx, sizer.count});
+                         in, op::leaf_from_visitor{&collapse_visitor, &cctx, sizer.count,
+                                                   sizer.leaf_size()});
 
                      for (uint16_t i = 0; i < nb; ++i)
                         _session.release(branches[i]);
@@ -1720,7 +2259,8 @@ namespace psitri
                         collapse_context cctx{_session, remaining, rb_count, root_prefix};
                         auto             result = _session.alloc<leaf_node>(
                             parent_hint,
-                            op::leaf_from_visitor{&collapse_visitor, &cctx, sizer.count});
+                            op::leaf_from_visitor{&collapse_visitor, &cctx, sizer.count,
+                                                  sizer.leaf_size()});
 
                         // Release the remaining subtree nodes: retain_children(in) at
                         // the top of this function gave +1 to all of in's children.
@@ -1935,7 +2475,8 @@ namespace psitri
          std::unreachable();
       }
 
-      // Shared mode: clone into a new max_leaf_size leaf (defragments dead space).
+      // Shared mode: clone into a new leaf of the size class the result needs
+      // (defragments dead space).
       {
          bool old_has_address = leaf->get_value_type(br) >= leaf_node::value_type_flag::value_node;
 
@@ -2540,6 +3081,7 @@ namespace psitri
    // ─── try_upsert_at_version: stripe-lock-safe, no COW fallback ──────
    inline bool tree_context::try_upsert_at_version(key_view key, value_type value, uint64_t version)
    {
+      drop_finger();
       sal::read_lock lock = _session.lock();
 
       if (!_root)
@@ -2651,6 +3193,7 @@ namespace psitri
    // ─── try_remove_at_version: stripe-lock-safe, no COW fallback ──────
    inline bool tree_context::try_remove_at_version(key_view key, uint64_t version)
    {
+      drop_finger();
       if (!_root)
          return true;  // nothing to remove
 
@@ -2731,6 +3274,7 @@ namespace psitri
 
    inline void tree_context::upsert_at_version(key_view key, value_type value, uint64_t version)
    {
+      drop_finger();
       if (!_root)
       {
          sal::read_lock lock = _session.lock();
@@ -2844,6 +3388,7 @@ namespace psitri
    // ─── Defrag implementation ──────────────────────────────────────
    inline uint64_t tree_context::defrag()
    {
+      drop_finger();
       if (!_root || !_dead_snap)
          return 0;
 
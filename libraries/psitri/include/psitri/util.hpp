@@ -33,6 +33,9 @@
 #if defined(__SSE2__)
 #include <emmintrin.h>
 #endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
 
 namespace psitri
 {
@@ -267,4 +270,51 @@ namespace psitri
       return size;
    }
 
+   /**
+    * Compares 32 bytes against a value with one AVX2 compare (two SSE2 or
+    * NEON compares) and returns a mask with bit i set where arr[i] == value.
+    * All 32 bytes are read, so the caller must own them and mask off any
+    * lanes past the end of its array.
+    */
+   PSITRI_NO_SANITIZE_ALIGNMENT
+   inline uint32_t match_byte_mask32(const uint8_t* arr, uint8_t value) noexcept
+   {
+#if defined(__AVX2__)
+      const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(arr));
+      return uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(data, _mm256_set1_epi8(char(value)))));
+#elif defined(__ARM_NEON)
+      static constexpr uint8_t bit_weights[16] = {1, 2, 4, 8, 16, 32, 64, 128,
+                                                  1, 2, 4, 8, 16, 32, 64, 128};
+      const uint8x16_t         target          = vdupq_n_u8(value);
+      const uint8x16_t         weights         = vld1q_u8(bit_weights);
+      uint8x16_t               lo = vandq_u8(vceqq_u8(vld1q_u8(arr), target), weights);
+      uint8x16_t               hi = vandq_u8(vceqq_u8(vld1q_u8(arr + 16), target), weights);
+      // three pairwise adds fold each group of 8 weighted lanes into one byte
+      uint8x16_t sum = vpaddq_u8(lo, hi);
+      sum            = vpaddq_u8(sum, sum);
+      sum            = vpaddq_u8(sum, sum);
+      return vgetq_lane_u32(vreinterpretq_u32_u8(sum), 0);
+#elif defined(__SSE2__)
+      const __m128i target = _mm_set1_epi8(char(value));
+      const __m128i lo     = _mm_loadu_si128(reinterpret_cast<const __m128i*>(arr));
+      const __m128i hi     = _mm_loadu_si128(reinterpret_cast<const __m128i*>(arr + 16));
+      return uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(lo, target))) |
+             uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(hi, target))) << 16;
+#else
+      const uint64_t target = value * 0x0101010101010101ULL;
+      uint32_t       mask   = 0;
+      for (int i = 0; i < 32; i += 8)
+      {
+         uint64_t data;
+         std::memcpy(&data, arr + i, sizeof(data));
+         const uint64_t x = data ^ target;
+         // high bit of each byte set exactly where that byte of x is zero
+         const uint64_t zero = ~(((x & 0x7f7f7f7f7f7f7f7fULL) + 0x7f7f7f7f7f7f7f7fULL) | x |
+                                 0x7f7f7f7f7f7f7f7fULL);
+         mask |= uint32_t((zero * 0x0002040810204081ULL) >> 56) << i;
+      }
+      return mask;
+#endif
+   }
+
 }  // namespace psitri
\ No newline at end of file
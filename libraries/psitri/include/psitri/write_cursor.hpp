@@ -88,12 +88,22 @@ namespace psitri
       /// Remove key. Returns size of removed value, or -1 if not found.
       int remove(key_view key) { return _ctx.remove(key); }
 
+      /// Apply writes sorted by strictly ascending key, rebuilding each leaf
+      /// once per run of keys; see tree_context::upsert_batch()
+      void upsert_batch(std::span<const batch_op> ops) { _ctx.upsert_batch(ops); }
+
       /// Remove all keys in range [lower, upper). Returns number of keys removed.
       uint64_t remove_range(key_view lower, key_view upper)
       {
          return _ctx.remove_range(lower, upper);
       }
 
+      /// Replace a top-level branch built elsewhere; see tree_context::graft()
+      void graft(key_view key, ptr_address old_branch, ptr_address new_branch)
+      {
+         _ctx.graft(key, old_branch, new_branch);
+      }
+
       // -- Read access --
 
       /// Get a read cursor for the current tree state
@@ -163,6 +173,9 @@ namespace psitri
       /// Move root out — caller takes ownership, cursor is left empty
       sal::smart_ptr<sal::alloc_header> take_root() { return _ctx.take_root(); }
 
+      /// The top-level branches of the tree; see tree_fanout
+      tree_fanout fanout() const { return _ctx.fanout(); }
+
       /// Check if the tree is empty
       explicit operator bool() const { return static_cast<bool>(_ctx.get_root()); }
 
@@ -9,77 +9,31 @@ namespace psitri::dwal
                               std::optional<psitri::cursor>  tri)
        : _rw(rw), _ro(ro), _tri(std::move(tri))
    {
-      if (_rw)
-      {
-         _rw_it  = _rw->map.begin();
-         _rw_end = _rw->map.end();
-      }
-      if (_ro)
-      {
-         _ro_it  = _ro->map.begin();
-         _ro_end = _ro->map.end();
-      }
    }
 
    // ── Positioning ──────────────────────────────────────────────────
 
    bool merge_cursor::seek_begin()
    {
-      if (_rw)
-      {
-         _rw_it  = _rw->map.begin();
-         _rw_end = _rw->map.end();
-      }
-      if (_ro)
-      {
-         _ro_it  = _ro->map.begin();
-         _ro_end = _ro->map.end();
-      }
-      if (_tri)
-         _tri->seek_begin();
-
-      _at_end  = false;
-      _at_rend = false;
+      select_layers();
+      position_first();
       return advance_forward();
    }
 
    bool merge_cursor::seek_last()
    {
-      // Position all sources at their last element, then merge backward.
-      if (_rw)
-      {
-         _rw_end = _rw->map.end();
-         _rw_it  = _rw_end;
-         if (!_rw->map.empty())
-            --_rw_it;  // point at last element
-      }
-      if (_ro)
-      {
-         _ro_end = _ro->map.end();
-         _ro_it  = _ro_end;
-         if (!_ro->map.empty())
-            --_ro_it;
-      }
-      if (_tri)
-         _tri->seek_last();
-
-      _at_end  = false;
-      _at_rend = false;
+      select_layers();
+      position_last();
       return advance_backward();
    }
 
    bool merge_cursor::lower_bound(std::string_view key)
    {
-      if (_rw)
-      {
-         _rw_it  = _rw->map.lower_bound(key);
-         _rw_end = _rw->map.end();
-      }
-      if (_ro)
-      {
-         _ro_it  = _ro->map.lower_bound(key);
-         _ro_end = _ro->map.end();
-      }
+      select_layers();
+      if (_rw_live)
+         _rw_it = _rw_live->map.lower_bound(key);
+      if (_ro_live)
+         _ro_it = _ro_live->map.lower_bound(key);
       if (_tri)
          _tri->lower_bound(key);
 
@@ -90,26 +44,8 @@ namespace psitri::dwal
 
    bool merge_cursor::upper_bound(std::string_view key)
    {
-      if (_rw)
-      {
-         _rw_it  = _rw->map.upper_bound(key);
-         _rw_end = _rw->map.end();
-      }
-      if (_ro)
-      {
-         _ro_it  = _ro->map.upper_bound(key);
-         _ro_end = _ro->map.end();
-      }
-      if (_tri)
-      {
-         _tri->lower_bound(key);
-         // Skip past exact match to simulate upper_bound.
-         if (!_tri->is_end() && _tri->key() == key)
-            _tri->next();
-      }
-
-      _at_end  = false;
-      _at_rend = false;
+      select_layers();
+      position_after(key);
       return advance_forward();
    }
 
@@ -132,20 +68,16 @@ namespace psitri::dwal
    {
       if (_at_end)
          return false;
+      if (_at_rend)
+         return seek_begin();
 
-      // Advance the source(s) that produced the current key.
-      std::string_view cur = _current_key;
-
-      // Advance RW past current key.
-      if (_rw && _rw_it != _rw_end && _rw_it.key() == cur)
+      if (!_forward)
+         position_after(_current_key);
+      else if (_source == source::rw)
          ++_rw_it;
-
-      // Advance RO past current key.
-      if (_ro && _ro_it != _ro_end && _ro_it.key() == cur)
+      else if (_source == source::ro)
          ++_ro_it;
-
-      // Advance Tri past current key.
-      if (_tri && !_tri->is_end() && _tri->key() == cur)
+      else if (_source == source::tri)
          _tri->next();
 
       return advance_forward();
@@ -156,210 +88,206 @@ namespace psitri::dwal
       if (_at_rend)
          return false;
 
-      // When at end, position all sources at their last element.
       if (_at_end)
       {
-         if (_rw)
-         {
-            _rw_end = _rw->map.end();
-            _rw_it  = _rw_end;
-            if (_rw_it != _rw->map.begin())
-               --_rw_it;
-         }
-         if (_ro)
-         {
-            _ro_end = _ro->map.end();
-            _ro_it  = _ro_end;
-            if (_ro_it != _ro->map.begin())
-               --_ro_it;
-         }
-         if (_tri)
-            _tri->seek_last();
-
-         _at_end = false;
-         return advance_backward();
+         select_layers();
+         position_last();
       }
+      else if (_forward)
+         position_before(_current_key);
+      else if (_source == source::rw)
+         --_rw_it;
+      else if (_source == source::ro)
+         --_ro_it;
+      else if (_source == source::tri)
+         _tri->prev();
 
-      // Retreat the source(s) past the current key.
-      std::string_view cur = _current_key;
+      return advance_backward();
+   }
 
-      // Retreat RW.
-      if (_rw)
-      {
-         if (_rw_it != _rw_end)
-         {
-            if (_rw_it.key() >= cur)
-            {
-               --_rw_it;
-               if (_rw_it != _rw_end && _rw_it.key() == cur)
-                  --_rw_it;
-            }
-         }
-      }
+   // ── Helpers ──────────────────────────────────────────────────────
 
-      // Retreat RO (same logic).
-      if (_ro)
-      {
-         if (_ro_it != _ro_end)
-         {
-            if (_ro_it.key() >= cur)
-            {
-               --_ro_it;
-               if (_ro_it != _ro_end && _ro_it.key() == cur)
-                  --_ro_it;
-            }
-         }
-      }
+   void merge_cursor::select_layers()
+   {
+      _rw_live = _rw && !_rw->empty() ? _rw : nullptr;
+      _ro_live = _ro && !_ro->empty() ? _ro : nullptr;
+      if (_rw_live)
+         _rw_end = _rw_live->map.end();
+      if (_ro_live)
+         _ro_end = _ro_live->map.end();
+   }
 
-      // Retreat Tri.
-      if (_tri && !_tri->is_rend())
-      {
-         if (!_tri->is_end() && _tri->key() >= cur)
-            _tri->prev();
-         if (!_tri->is_rend() && _tri->key() == cur)
-            _tri->prev();
-      }
+   void merge_cursor::position_first()
+   {
+      if (_rw_live)
+         _rw_it = _rw_live->map.begin();
+      if (_ro_live)
+         _ro_it = _ro_live->map.begin();
+      if (_tri)
+         _tri->seek_begin();
 
-      return advance_backward();
+      _at_end  = false;
+      _at_rend = false;
    }
 
-   // ── Helpers ──────────────────────────────────────────────────────
+   void merge_cursor::position_last()
+   {
+      // Retreating from end() reaches the last key (or stays at end() when
+      // the map is empty).
+      if (_rw_live)
+         --(_rw_it = _rw_end);
+      if (_ro_live)
+         --(_ro_it = _ro_end);
+      if (_tri)
+         _tri->seek_last();
+
+      _at_end  = false;
+      _at_rend = false;
+   }
 
-   bool merge_cursor::is_tombstoned_by_rw(std::string_view k) const
+   void merge_cursor::position_after(std::string_view k)
    {
-      if (!_rw)
-         return false;
-      // Check point tombstone.
-      auto* v = _rw->map.get(k);
-      if (v && v->is_tombstone())
-         return true;
-      // Check range tombstone.
-      return _rw->tombstones.is_deleted(k);
+      if (_rw_live)
+         _rw_it = _rw_live->map.upper_bound(k);
+      if (_ro_live)
+         _ro_it = _ro_live->map.upper_bound(k);
+      if (_tri)
+         _tri->upper_bound(k);
+
+      _at_end  = false;
+      _at_rend = false;
    }
 
-   bool merge_cursor::is_tombstoned_by_ro(std::string_view k) const
+   void merge_cursor::position_before(std::string_view k)
    {
-      if (!_ro)
-         return false;
-      auto* v = _ro->map.get(k);
-      if (v && v->is_tombstone())
-         return true;
-      return _ro->tombstones.is_deleted(k);
+      // Retreating from the first key leaves an iterator at end(), which is
+      // "before the first key" while moving backward.
+      if (_rw_live)
+         --(_rw_it = _rw_live->map.lower_bound(k));
+      if (_ro_live)
+         --(_ro_it = _ro_live->map.lower_bound(k));
+      if (_tri)
+      {
+         _tri->lower_bound(k);
+         if (_tri->is_end())
+            _tri->seek_last();
+         else
+            _tri->prev();
+      }
+
+      _at_end  = false;
+      _at_rend = false;
    }
 
-   void merge_cursor::skip_ro_past(std::string_view k)
+   const range_tombstone_list::range* merge_cursor::deleted_range(const btree_layer* layer,
+                                                                  std::string_view   k)
    {
-      if (_ro && _ro_it != _ro_end && _ro_it.key() == k)
-         ++_ro_it;
+      return layer ? layer->tombstones.find(k) : nullptr;
    }
 
-   void merge_cursor::skip_tri_past(std::string_view k)
+   void merge_cursor::tri_skip_to(std::string_view k)
    {
-      if (_tri && !_tri->is_end() && _tri->key() == k)
-         _tri->next();
+      if (_tri && !_tri->is_end() && _tri->key() < k)
+         _tri->lower_bound(k);
+   }
+
+   void merge_cursor::tri_skip_before(std::string_view k)
+   {
+      if (!_tri || _tri->is_rend() || _tri->is_end() || _tri->key() < k)
+         return;
+      _tri->lower_bound(k);
+      if (_tri->is_end())
+         _tri->seek_last();
+      else
+         _tri->prev();
    }
 
    bool merge_cursor::advance_forward()
    {
-      // Find the smallest live key across all sources.
+      _forward = true;
       for (;;)
       {
-         // Gather candidates.
-         bool             have_rw = _rw && _rw_it != _rw_end;
-         bool             have_ro = _ro && _ro_it != _ro_end;
-         bool             have_tri = _tri && !_tri->is_end();
-
-         if (!have_rw && !have_ro && !have_tri)
-         {
-            _at_end = true;
-            _source = source::none;
-            return false;
-         }
-
-         // Find minimum key.
-         std::string_view min_key;
-         source           min_src = source::none;
+         bool have_rw  = _rw_live && _rw_it != _rw_end;
+         bool have_ro  = _ro_live && _ro_it != _ro_end;
+         bool have_tri = _tri && !_tri->is_end();
 
+         // Smallest key; a tie goes to the higher layer.
+         std::string_view k;
+         source           src = source::none;
          if (have_rw)
          {
-            min_key = _rw_it.key();
-            min_src = source::rw;
+            k   = _rw_it.key();
+            src = source::rw;
          }
-         if (have_ro)
+         if (have_ro && (src == source::none || _ro_it.key() < k))
          {
-            if (min_src == source::none || _ro_it.key() < min_key)
-            {
-               min_key = _ro_it.key();
-               min_src = source::ro;
-            }
+            k   = _ro_it.key();
+            src = source::ro;
          }
-         if (have_tri)
+         if (have_tri && (src == source::none || _tri->key() < k))
          {
-            if (min_src == source::none || _tri->key() < min_key)
-            {
-               min_key = _tri->key();
-               min_src = source::tri;
-            }
+            k   = _tri->key();
+            src = source::tri;
          }
 
-         // Determine the winning source (highest priority for ties).
-         // RW > RO > Tri priority.
-         source winner = source::none;
-         btree_value winner_val;
+         if (src == source::none)
+         {
+            _at_end = true;
+            _source = source::none;
+            return false;
+         }
 
-         // Check RW at this key.
-         if (have_rw && _rw_it.key() == min_key)
+         // A lower layer's key is shadowed by a point entry above it only
+         // if that entry is at the same position, so only the range
+         // tombstones of the layers above need looking up.
+         btree_value val;
+         if (src == source::rw)
          {
-            if (_rw_it.value().is_tombstone())
+            if (have_ro && _ro_it.key() == k)
+               ++_ro_it;
+            if (have_tri && _tri->key() == k)
+               _tri->next();
+            val = _rw_it.value();
+            if (val.is_tombstone())
             {
-               // RW tombstone shadows everything — skip this key in all sources.
                ++_rw_it;
-               skip_ro_past(min_key);
-               skip_tri_past(min_key);
                continue;
             }
-            winner     = source::rw;
-            winner_val = _rw_it.value();
-            // Skip duplicates in lower layers.
-            skip_ro_past(min_key);
-            skip_tri_past(min_key);
          }
-         else if (have_ro && _ro_it.key() == min_key)
+         else if (src == source::ro)
          {
-            // Check if RW range-tombstones this key.
-            if (_rw && _rw->tombstones.is_deleted(min_key))
+            if (auto* r = deleted_range(_rw_live, k))
             {
-               ++_ro_it;
-               skip_tri_past(min_key);
+               // RW deleted this range: skip RO and Tri past all of it.
+               tri_skip_to(r->high);
+               _ro_it = _ro_live->map.lower_bound(r->high);
                continue;
             }
-            if (_ro_it.value().is_tombstone())
+            if (have_tri && _tri->key() == k)
+               _tri->next();
+            val = _ro_it.value();
+            if (val.is_tombstone())
             {
-               // RO tombstone shadows Tri.
                ++_ro_it;
-               skip_tri_past(min_key);
                continue;
             }
-            winner     = source::ro;
-            winner_val = _ro_it.value();
-            skip_tri_past(min_key);
          }
          else
          {
-            // Tri is the source.
-            // Check if shadowed by RW or RO tombstones/range tombstones.
-            if (is_tombstoned_by_rw(min_key) || is_tombstoned_by_ro(min_key))
+            auto* r = deleted_range(_rw_live, k);
+            if (!r)
+               r = deleted_range(_ro_live, k);
+            if (r)
             {
-               _tri->next();
+               _tri->lower_bound(r->high);
                continue;
             }
-            winner     = source::tri;
-            winner_val = {};  // Tri values accessed through tri cursor.
+            // Tri values are accessed through the tri cursor.
          }
 
-         _current_key   = std::string(min_key);
-         _current_value = winner_val;
-         _source        = winner;
+         _current_key.assign(k);
+         _current_value = val;
+         _source        = src;
          _at_end        = false;
          _at_rend       = false;
          return true;
@@ -368,108 +296,85 @@ namespace psitri::dwal
 
    bool merge_cursor::advance_backward()
    {
-      // Find the largest live key across all sources (backward merge).
+      _forward = false;
       for (;;)
       {
-         bool have_rw  = _rw && _rw_it != _rw_end;
-         bool have_ro  = _ro && _ro_it != _ro_end;
+         bool have_rw  = _rw_live && _rw_it != _rw_end;
+         bool have_ro  = _ro_live && _ro_it != _ro_end;
          bool have_tri = _tri && !_tri->is_rend() && !_tri->is_end();
 
-         if (!have_rw && !have_ro && !have_tri)
-         {
-            _at_rend = true;
-            _source  = source::none;
-            return false;
-         }
-
-         // Find maximum key.
-         std::string_view max_key;
-         source           max_src = source::none;
-
+         // Largest key; a tie goes to the higher layer.
+         std::string_view k;
+         source           src = source::none;
          if (have_rw)
          {
-            max_key = _rw_it.key();
-            max_src = source::rw;
+            k   = _rw_it.key();
+            src = source::rw;
          }
-         if (have_ro)
+         if (have_ro && (src == source::none || _ro_it.key() > k))
          {
-            if (max_src == source::none || _ro_it.key() > max_key)
-            {
-               max_key = _ro_it.key();
-               max_src = source::ro;
-            }
+            k   = _ro_it.key();
+            src = source::ro;
          }
-         if (have_tri)
+         if (have_tri && (src == source::none || _tri->key() > k))
          {
-            if (max_src == source::none || _tri->key() > max_key)
-            {
-               max_key = _tri->key();
-               max_src = source::tri;
-            }
+            k   = _tri->key();
+            src = source::tri;
          }
 
-         // Determine winner (highest priority for ties).
-         source winner = source::none;
-         btree_value winner_val;
+         if (src == source::none)
+         {
+            _at_rend = true;
+            _source  = source::none;
+            return false;
+         }
 
-         // Check if RW has this key.
-         if (have_rw && _rw_it.key() == max_key)
+         btree_value val;
+         if (src == source::rw)
          {
-            if (_rw_it.value().is_tombstone())
+            if (have_ro && _ro_it.key() == k)
+               --_ro_it;
+            if (have_tri && _tri->key() == k)
+               _tri->prev();
+            val = _rw_it.value();
+            if (val.is_tombstone())
             {
-               // Skip — move all sources past this key backward.
                --_rw_it;
-               // Move RO backward past this key.
-               if (have_ro && _ro_it.key() == max_key)
-                  --_ro_it;
-               // Move Tri backward past this key.
-               if (have_tri && _tri->key() == max_key)
-                  _tri->prev();
                continue;
             }
-            winner     = source::rw;
-            winner_val = _rw_it.value();
-            // Skip duplicates in lower layers backward.
-            if (have_ro && _ro_it.key() == max_key)
-               --_ro_it;
-            if (have_tri && _tri->key() == max_key)
-               _tri->prev();
          }
-         else if (have_ro && _ro_it.key() == max_key)
+         else if (src == source::ro)
          {
-            if (_rw && _rw->tombstones.is_deleted(max_key))
+            if (auto* r = deleted_range(_rw_live, k))
             {
-               --_ro_it;
-               if (have_tri && _tri->key() == max_key)
-                  _tri->prev();
+               tri_skip_before(r->low);
+               --(_ro_it = _ro_live->map.lower_bound(r->low));
                continue;
             }
-            if (_ro_it.value().is_tombstone())
+            if (have_tri && _tri->key() == k)
+               _tri->prev();
+            val = _ro_it.value();
+            if (val.is_tombstone())
             {
                --_ro_it;
-               if (have_tri && _tri->key() == max_key)
-                  _tri->prev();
                continue;
             }
-            winner     = source::ro;
-            winner_val = _ro_it.value();
-            if (have_tri && _tri->key() == max_key)
-               _tri->prev();
          }
          else
          {
-            if (is_tombstoned_by_rw(max_key) || is_tombstoned_by_ro(max_key))
+            auto* r = deleted_range(_rw_live, k);
+            if (!r)
+               r = deleted_range(_ro_live, k);
+            if (r)
             {
-               _tri->prev();
+               tri_skip_before(r->low);
                continue;
             }
-            winner     = source::tri;
-            winner_val = {};
          }
 
-         _current_key   = std::string(max_key);
-         _current_value = winner_val;
-         _source        = winner;
+         _current_key.assign(k);
+         _current_value = val;
+         _source        = src;
          _at_end        = false;
          _at_rend       = false;
          return true;
@@ -0,0 +1,333 @@
+#include <psitri/dwal/shared_wal.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace psitri::dwal
+{
+   static uint64_t now_nanos()
+   {
+      auto tp = std::chrono::system_clock::now().time_since_epoch();
+      return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(tp).count());
+   }
+
+   /// Index into shared_wal::_durable for a requested sync level.
+   static int durability_level(sal::sync_type sync)
+   {
+      // sorts after full, but only hands the log to the OS at commit
+      if (sync == sal::sync_type::background_full)
+         return 0;
+      if (sync >= sal::sync_type::full)
+         return 2;
+      if (sync >= sal::sync_type::fsync)
+         return 1;
+      return 0;
+   }
+
+   shared_wal::shared_wal(std::filesystem::path dir, uint64_t segment_bytes, uint32_t max_roots)
+       : _dir(std::move(dir)),
+         _segment_bytes(segment_bytes),
+         _rw_first(max_roots, no_segment),
+         _ro_first(max_roots, no_segment)
+   {
+      std::filesystem::create_directories(_dir);
+
+      auto existing   = list_segments(_dir);
+      _oldest_segment = existing.empty() ? 1 : existing.front();
+      _active_segment = existing.empty() ? 1 : existing.back() + 1;
+      open_segment(_active_segment);
+   }
+
+   shared_wal::~shared_wal()
+   {
+      if (_fd >= 0)
+         ::close(_fd);
+   }
+
+   std::filesystem::path shared_wal::segment_path(const std::filesystem::path& dir,
+                                                  uint64_t                     segment)
+   {
+      char name[32];
+      std::snprintf(name, sizeof(name), "seg-%08llu.dwal", (unsigned long long)segment);
+      return dir / name;
+   }
+
+   std::vector<uint64_t> shared_wal::list_segments(const std::filesystem::path& dir)
+   {
+      std::vector<uint64_t> segments;
+      std::error_code       ec;
+      for (auto& entry : std::filesystem::directory_iterator(dir, ec))
+      {
+         auto name = entry.path().filename().string();
+         if (name.size() <= 9 || name.substr(0, 4) != "seg-" ||
+             name.substr(name.size() - 5) != ".dwal")
+            continue;
+         try
+         {
+            segments.push_back(std::stoull(name.substr(4, name.size() - 9)));
+         }
+         catch (...)
+         {
+         }
+      }
+      std::sort(segments.begin(), segments.end());
+      return segments;
+   }
+
+   void shared_wal::open_segment(uint64_t segment)
+   {
+      auto path = segment_path(_dir, segment);
+      int  fd   = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+      if (fd < 0)
+         throw std::runtime_error("shared_wal: cannot open " + path.string());
+
+      wal_header hdr;
+      hdr.sequence_base     = segment;
+      hdr.created_timestamp = now_nanos();
+      hdr.root_index        = wal_shared_root_index;
+      hdr.flags             = wal_flag_shared_log;
+      if (::pwrite(fd, &hdr, sizeof(hdr), 0) != sizeof(hdr))
+      {
+         ::close(fd);
+         throw std::runtime_error("shared_wal: failed to write header");
+      }
+
+      if (_fd >= 0)
+         ::close(_fd);
+      _fd          = fd;
+      _segment_pos = sizeof(wal_header);
+   }
+
+   // ── Appending and group commit ──────────────────────────────────────
+
+   uint64_t shared_wal::append(uint16_t root_index, const char* data, size_t len)
+   {
+      std::lock_guard lk(_mutex);
+      assert(root_index < _rw_first.size());
+      if (_rw_first[root_index] == no_segment)
+         _rw_first[root_index] = _active_segment;
+      _buf.insert(_buf.end(), data, data + len);
+      return _appended += len;
+   }
+
+   void shared_wal::flush(sal::sync_type sync)
+   {
+      uint64_t pos;
+      {
+         std::lock_guard lk(_mutex);
+         pos = _appended;
+      }
+      flush_to(pos, sync);
+   }
+
+   void shared_wal::flush_to(uint64_t pos, sal::sync_type sync)
+   {
+      int level = durability_level(sync);
+
+      std::unique_lock lk(_mutex);
+      while (_durable[level] < pos)
+      {
+         if (_io_active)
+         {
+            _io_done.wait(lk);
+            continue;
+         }
+
+         // Become the leader: take every entry appended so far.
+         _io_active = true;
+         _io_buf.swap(_buf);
+         uint64_t end = _appended;
+         lk.unlock();
+
+         bool     rolled = false;
+         uint64_t next   = 0;
+         try
+         {
+            // If the write throws, the taken entries go back in front of
+            // _buf and the segment position rewinds, so a later leader
+            // writes them again in order.
+            struct restore_unwritten
+            {
+               shared_wal* wal;
+               uint64_t    pos;
+               ~restore_unwritten()
+               {
+                  if (!wal)
+                     return;
+                  wal->_segment_pos = pos;
+                  std::lock_guard g(wal->_mutex);
+                  wal->_buf.insert(wal->_buf.begin(), wal->_io_buf.begin(), wal->_io_buf.end());
+                  wal->_io_buf.clear();
+               }
+            } unwritten{this, _segment_pos};
+            write_out(_io_buf);
+            unwritten.wal = nullptr;
+            _io_buf.clear();
+            if (level > 0)
+               sync_fd(level);
+
+            if (_segment_pos >= _segment_bytes)
+            {
+               // Seal the full segment durably before moving on, so a
+               // later sync of the new segment covers everything before it.
+               if (level == 0)
+                  sync_fd(1);
+               {
+                  std::lock_guard g(_mutex);
+                  next = _active_segment + 1;
+               }
+               open_segment(next);
+               rolled = true;
+            }
+         }
+         catch (...)
+         {
+            lk.lock();
+            _io_active = false;
+            _io_done.notify_all();
+            throw;
+         }
+
+         lk.lock();
+         _durable[0] = end;
+         for (int l = 1; l <= level; ++l)
+            _durable[l] = end;
+         if (rolled)
+         {
+            // Everything in the sealed segment was synced.
+            _durable[1]     = std::max(_durable[1], end);
+            _active_segment = next;
+         }
+         if (level > 0)
+            ++_syncs;
+         _io_active = false;
+         _io_done.notify_all();
+      }
+   }
+
+   void shared_wal::write_out(const std::vector<char>& buf)
+   {
+      const char* data      = buf.data();
+      size_t      remaining = buf.size();
+      while (remaining > 0)
+      {
+         auto n = ::pwrite(_fd, data, remaining, static_cast<off_t>(_segment_pos));
+         if (n <= 0)
+            throw std::runtime_error("shared_wal: write failed");
+         _segment_pos += static_cast<uint64_t>(n);
+         data         += n;
+         remaining    -= static_cast<size_t>(n);
+      }
+   }
+
+   void shared_wal::sync_fd(int level)
+   {
+      if (level >= 2)
+      {
+#ifdef __APPLE__
+         ::fcntl(_fd, F_FULLFSYNC);
+#else
+         ::fsync(_fd);
+#endif
+      }
+      else if (level == 1)
+      {
+#ifdef __APPLE__
+         ::fsync(_fd);
+#else
+         ::fdatasync(_fd);
+#endif
+      }
+   }
+
+   // ── Segment retention ───────────────────────────────────────────────
+
+   void shared_wal::swap_root(uint16_t root_index)
+   {
+      std::lock_guard lk(_mutex);
+      _ro_first[root_index] = std::min(_ro_first[root_index], _rw_first[root_index]);
+      _rw_first[root_index] = no_segment;
+   }
+
+   void shared_wal::release_ro(uint16_t root_index)
+   {
+      std::vector<uint64_t> doomed;
+      {
+         std::lock_guard lk(_mutex);
+         _ro_first[root_index] = no_segment;
+         retire_locked(doomed);
+      }
+      remove_segments(doomed);
+   }
+
+   void shared_wal::pin_recovered(uint16_t root_index, uint64_t segment)
+   {
+      std::lock_guard lk(_mutex);
+      _rw_first[root_index] = std::min(_rw_first[root_index], segment);
+   }
+
+   void shared_wal::retire()
+   {
+      std::vector<uint64_t> doomed;
+      {
+         std::lock_guard lk(_mutex);
+         retire_locked(doomed);
+      }
+      remove_segments(doomed);
+   }
+
+   void shared_wal::retire_locked(std::vector<uint64_t>& doomed)
+   {
+      uint64_t floor = _active_segment;
+      for (size_t i = 0; i < _rw_first.size(); ++i)
+         floor = std::min({floor, _rw_first[i], _ro_first[i]});
+      for (; _oldest_segment < floor; ++_oldest_segment)
+         doomed.push_back(_oldest_segment);
+   }
+
+   void shared_wal::remove_segments(const std::vector<uint64_t>& doomed)
+   {
+      std::error_code ec;
+      for (auto segment : doomed)
+         std::filesystem::remove(segment_path(_dir, segment), ec);
+   }
+
+   void shared_wal::close()
+   {
+      flush(sal::sync_type::none);
+
+      std::lock_guard lk(_mutex);
+      if (_fd < 0)
+         return;
+
+      uint16_t flags = wal_flag_shared_log | wal_flag_clean_close;
+      ::pwrite(_fd, &flags, sizeof(flags), offsetof(wal_header, flags));
+      sync_fd(2);
+      ::close(_fd);
+      _fd = -1;
+   }
+
+   // ── Accessors ───────────────────────────────────────────────────────
+
+   uint64_t shared_wal::active_segment() const
+   {
+      std::lock_guard lk(_mutex);
+      return _active_segment;
+   }
+
+   uint64_t shared_wal::sync_count() const
+   {
+      std::lock_guard lk(_mutex);
+      return _syncs;
+   }
+
+}  // namespace psitri::dwal
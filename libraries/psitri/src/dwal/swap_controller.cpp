@@ -0,0 +1,121 @@
+#include <psitri/dwal/swap_controller.hpp>
+
+#include <algorithm>
+
+namespace psitri::dwal
+{
+   namespace
+   {
+      /// Weight of the newest sample in the rate averages.
+      constexpr double rate_weight = 0.5;
+
+      /// Threshold steps per merge.
+      constexpr double grow_step   = 1.25;
+      constexpr double shrink_step = 0.8;
+
+      double seconds(std::chrono::steady_clock::duration d) noexcept
+      {
+         return std::chrono::duration<double>(d).count();
+      }
+   }  // namespace
+
+   void swap_controller::configure(const options& opts) noexcept
+   {
+      _opts = opts;
+      _scale.store(1, std::memory_order_relaxed);
+   }
+
+   void swap_controller::blend(std::atomic<double>& avg, double sample) noexcept
+   {
+      double old = avg.load(std::memory_order_relaxed);
+      avg.store(old > 0 ? rate_weight * sample + (1 - rate_weight) * old : sample,
+                std::memory_order_relaxed);
+   }
+
+   void swap_controller::record_swap(uint64_t entries, clock::time_point now) noexcept
+   {
+      auto fill = now - _swap_time;
+      _fill_ns.store(std::chrono::duration_cast<std::chrono::nanoseconds>(fill).count(),
+                     std::memory_order_relaxed);
+      if (entries && fill.count() > 0)
+         blend(_ingest_rate, entries / seconds(fill));
+
+      _swap_time  = now;
+      _ro_entries = entries;
+      _commits    = 0;
+      _delayed    = {};
+   }
+
+   void swap_controller::record_merge(uint64_t entries, clock::duration wall) noexcept
+   {
+      if (!entries || wall.count() <= 0)
+         return;
+      blend(_merge_rate, entries / seconds(wall));
+
+      if (!_opts.enabled)
+         return;
+      int64_t fill = _fill_ns.load(std::memory_order_relaxed);
+      if (fill <= 0)
+         return;
+
+      double  scale   = _scale.load(std::memory_order_relaxed);
+      int64_t wall_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(wall).count();
+      if (wall_ns * 4 < fill)
+         scale = std::min(scale * grow_step, _opts.max_scale);
+      else if (wall_ns * 2 > fill)
+         scale = std::max(scale * shrink_step, 1.0);
+      _scale.store(scale, std::memory_order_relaxed);
+   }
+
+   std::chrono::nanoseconds swap_controller::commit_delay(uint64_t          arena_bytes,
+                                                          bool              merging,
+                                                          clock::time_point now) noexcept
+   {
+      ++_commits;
+      if (!_opts.enabled || !merging || !_opts.arena_limit)
+         return {};
+
+      double limit = double(_opts.arena_limit);
+      double soft  = _opts.soft_arena * limit;
+      double rate  = _merge_rate.load(std::memory_order_relaxed);
+      if (double(arena_bytes) <= soft || rate <= 0)
+         return {};
+
+      double pressure = std::min(1.0, (arena_bytes - soft) / (limit - soft));
+      double headroom = limit - double(arena_bytes);
+      double left     = seconds(_swap_time - now) + _ro_entries / rate;
+      double max_ns   = double(_opts.max_delay.count());
+
+      // Spread the remaining arena over the time the merge still needs:
+      // commits may add headroom / per_commit more, over left seconds.
+      double delay_ns = max_ns;
+      if (headroom > 0 && left > 0)
+      {
+         double per_commit = double(arena_bytes) / _commits;
+         double target_ns  = left * 1e9 / (headroom / per_commit);
+         double natural_ns = seconds(now - _swap_time - _delayed) * 1e9 / _commits;
+         delay_ns          = std::max(0.0, target_ns - natural_ns);
+      }
+
+      auto delay = std::chrono::nanoseconds(int64_t(std::min(delay_ns * pressure, max_ns)));
+      if (delay.count() > 0)
+      {
+         _delayed += delay;
+         _delayed_commits.fetch_add(1, std::memory_order_relaxed);
+         _delay_ns.fetch_add(delay.count(), std::memory_order_relaxed);
+      }
+      return delay;
+   }
+
+   flow_stats swap_controller::stats() const noexcept
+   {
+      flow_stats f;
+      f.ingest_rate     = _ingest_rate.load(std::memory_order_relaxed);
+      f.merge_rate      = _merge_rate.load(std::memory_order_relaxed);
+      f.swap_scale      = scale();
+      f.delayed_commits = _delayed_commits.load(std::memory_order_relaxed);
+      f.delay_us        = _delay_ns.load(std::memory_order_relaxed) / 1000;
+      return f;
+   }
+
+}  // namespace psitri::dwal
@@ -0,0 +1,510 @@
+#include <psitri/dwal/wal_io.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#if __has_include(<linux/io_uring.h>) && defined(__NR_io_uring_setup)
+#include <linux/io_uring.h>
+#define PSITRI_HAVE_IO_URING 1
+#endif
+#endif
+
+namespace psitri::dwal
+{
+   // ── wal_buffer ──────────────────────────────────────────────────────
+
+   wal_buffer::~wal_buffer()
+   {
+      std::free(_data);
+   }
+
+   wal_buffer::wal_buffer(wal_buffer&& other) noexcept
+       : _data(std::exchange(other._data, nullptr)),
+         _size(std::exchange(other._size, 0)),
+         _capacity(std::exchange(other._capacity, 0))
+   {
+   }
+
+   wal_buffer& wal_buffer::operator=(wal_buffer&& other) noexcept
+   {
+      if (this != &other)
+      {
+         std::free(_data);
+         _data     = std::exchange(other._data, nullptr);
+         _size     = std::exchange(other._size, 0);
+         _capacity = std::exchange(other._capacity, 0);
+      }
+      return *this;
+   }
+
+   void wal_buffer::reserve(size_t n)
+   {
+      size_t cap = std::max(n, _capacity * 2);
+      cap        = (cap + alignment - 1) & ~(alignment - 1);
+      auto* p    = static_cast<char*>(std::aligned_alloc(alignment, cap));
+      if (!p)
+         throw std::bad_alloc();
+      if (_size)
+         std::memcpy(p, _data, _size);
+      std::free(_data);
+      _data     = p;
+      _capacity = cap;
+   }
+
+   void wal_buffer::append(const void* p, size_t n)
+   {
+      if (n)
+         std::memcpy(grow(n), p, n);
+   }
+
+   void wal_buffer::consume(size_t n) noexcept
+   {
+      if (n < _size)
+         std::memmove(_data, _data + n, _size - n);
+      _size -= std::min(n, _size);
+   }
+
+   void wal_buffer::swap(wal_buffer& other) noexcept
+   {
+      std::swap(_data, other._data);
+      std::swap(_size, other._size);
+      std::swap(_capacity, other._capacity);
+   }
+
+   // ── Requests ────────────────────────────────────────────────────────
+
+   void wal_io_request::wait()
+   {
+      _busy.wait(true, std::memory_order_acquire);
+      if (int err = std::exchange(_error, 0))
+         throw std::runtime_error(std::string("wal_writer: write failed: ") +
+                                  std::strerror(err));
+   }
+
+   void wal_io_engine::start(wal_io_request& req,
+                             int             fd,
+                             const char*     data,
+                             size_t          len,
+                             uint64_t        offset,
+                             bool            sync) noexcept
+   {
+      req._fd     = fd;
+      req._data   = data;
+      req._len    = len;
+      req._offset = offset;
+      req._sync   = sync;
+      req._error  = 0;
+      req._busy.store(true, std::memory_order_relaxed);
+   }
+
+   void wal_io_engine::record_error(wal_io_request& req, int error) noexcept
+   {
+      if (!req._error)
+         req._error = error;
+   }
+
+   void wal_io_engine::finish(wal_io_request& req, int error) noexcept
+   {
+      record_error(req, error);
+      req._busy.store(false, std::memory_order_release);
+      req._busy.notify_all();
+   }
+
+   static int datasync(int fd) noexcept
+   {
+#ifdef __APPLE__
+      return ::fsync(fd) < 0 ? errno : 0;
+#else
+      return ::fdatasync(fd) < 0 ? errno : 0;
+#endif
+   }
+
+   int write_fully(int fd, const char* data, size_t len, uint64_t offset) noexcept
+   {
+      while (len > 0)
+      {
+         auto n = ::pwrite(fd, data, len, static_cast<off_t>(offset));
+         if (n < 0 && errno == EINTR)
+            continue;
+         if (n <= 0)
+            return n < 0 ? errno : EIO;
+         data   += n;
+         len    -= static_cast<size_t>(n);
+         offset += static_cast<uint64_t>(n);
+      }
+      return 0;
+   }
+
+   int wal_io_engine::run(const wal_io_request& req, size_t done) noexcept
+   {
+      int err = write_fully(req._fd, req._data + done, req._len - done, req._offset + done);
+      if (!err && req._sync)
+         err = datasync(req._fd);
+      return err;
+   }
+
+   // ── Thread pool ─────────────────────────────────────────────────────
+
+   /// Runs each request with pwrite / fdatasync on one of a few threads.
+   /// Every writer has at most one request queued, so per-file order is
+   /// kept while different roots' files are written in parallel.
+   class thread_pool_engine final : public wal_io_engine
+   {
+     public:
+      explicit thread_pool_engine(uint32_t threads)
+      {
+         for (uint32_t i = 0; i < threads; ++i)
+            _threads.emplace_back([this] { work(); });
+      }
+
+      ~thread_pool_engine() override
+      {
+         {
+            std::lock_guard lk(_mutex);
+            _stop = true;
+         }
+         _cv.notify_all();
+         for (auto& t : _threads)
+            t.join();
+      }
+
+      void submit(wal_io_request& req,
+                  int             fd,
+                  const char*     data,
+                  size_t          len,
+                  uint64_t        offset,
+                  bool            sync) override
+      {
+         start(req, fd, data, len, offset, sync);
+         {
+            std::lock_guard lk(_mutex);
+            _queue.push_back(&req);
+         }
+         _cv.notify_one();
+      }
+
+      wal_io_mode mode() const noexcept override { return wal_io_mode::thread_pool; }
+
+     private:
+      void work()
+      {
+         for (;;)
+         {
+            wal_io_request* req;
+            {
+               std::unique_lock lk(_mutex);
+               _cv.wait(lk, [&] { return _stop || !_queue.empty(); });
+               if (_queue.empty())
+                  return;
+               req = _queue.front();
+               _queue.pop_front();
+            }
+            finish(*req, run(*req));
+         }
+      }
+
+      std::mutex                  _mutex;
+      std::condition_variable     _cv;
+      std::deque<wal_io_request*> _queue;
+      bool                        _stop = false;
+      std::vector<std::thread>    _threads;
+   };
+
+#ifdef PSITRI_HAVE_IO_URING
+   // ── io_uring ────────────────────────────────────────────────────────
+
+   /// Raw io_uring (no liburing): a request becomes a WRITE, linked to an
+   /// FSYNC(DATASYNC) when it syncs, submitted with one io_uring_enter.  A
+   /// reaper thread completes requests as their CQEs arrive.
+   class uring_engine final : public wal_io_engine
+   {
+     public:
+      /// nullptr when the kernel has no usable ring: too old for
+      /// IORING_OP_WRITE, or io_uring disabled by sysctl or seccomp.
+      static std::unique_ptr<uring_engine> open(unsigned entries)
+      {
+         std::unique_ptr<uring_engine> e(new uring_engine);
+         if (!e->setup(entries))
+            return nullptr;
+         e->_reaper = std::thread([p = e.get()] { p->reap(); });
+         return e;
+      }
+
+      ~uring_engine() override
+      {
+         if (_reaper.joinable())
+         {
+            // A NOP tagged 0 tells the reaper to exit once it is reached.
+            std::unique_lock lk(_mutex);
+            _space.wait(lk, [&] { return _inflight < _cq_entries; });
+            ++_inflight;
+            push(IORING_OP_NOP, -1, nullptr, 0, 0, 0, 0);
+            enter(1);
+            lk.unlock();
+            _reaper.join();
+         }
+         if (_sqes)
+            ::munmap(_sqes, _sqes_size);
+         if (_cq_ring && _cq_ring != _sq_ring)
+            ::munmap(_cq_ring, _cq_ring_size);
+         if (_sq_ring)
+            ::munmap(_sq_ring, _sq_ring_size);
+         if (_ring_fd >= 0)
+            ::close(_ring_fd);
+      }
+
+      void submit(wal_io_request& req,
+                  int             fd,
+                  const char*     data,
+                  size_t          len,
+                  uint64_t        offset,
+                  bool            sync) override
+      {
+         start(req, fd, data, len, offset, sync);
+         if (!len && !sync)
+         {
+            finish(req, 0);
+            return;
+         }
+
+         uint64_t tag = reinterpret_cast<uint64_t>(&req);
+         unsigned n   = (len ? 1 : 0) + (sync ? 1 : 0);
+
+         std::unique_lock lk(_mutex);
+         // Bound CQEs in flight by the CQ size so completions never overflow.
+         _space.wait(lk, [&] { return _inflight + n <= _cq_entries; });
+         _inflight += n;
+         if (len)
+            push(IORING_OP_WRITE, fd, data, len, offset, sync ? IOSQE_IO_LINK : 0,
+                 tag | (sync ? tag_linked_write : tag_write));
+         if (sync)
+         {
+            auto* sqe        = push(IORING_OP_FSYNC, fd, nullptr, 0, 0, 0,
+                                    tag | tag_fsync);
+            sqe->fsync_flags = IORING_FSYNC_DATASYNC;
+         }
+         enter(n);
+      }
+
+      wal_io_mode mode() const noexcept override { return wal_io_mode::io_uring; }
+
+     private:
+      // Low bits of user_data; requests are at least 8-byte aligned.
+      static constexpr uint64_t tag_write        = 1;  ///< write, nothing linked
+      static constexpr uint64_t tag_linked_write = 2;  ///< write, FSYNC follows
+      static constexpr uint64_t tag_fsync        = 3;
+      static constexpr uint64_t tag_mask         = 7;
+
+      uring_engine() = default;
+
+      bool setup(unsigned entries)
+      {
+         io_uring_params p;
+         std::memset(&p, 0, sizeof(p));
+         _ring_fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &p));
+         if (_ring_fd < 0)
+            return false;
+
+         _sq_ring_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+         _cq_ring_size = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+         bool single   = p.features & IORING_FEAT_SINGLE_MMAP;
+         if (single)
+            _sq_ring_size = _cq_ring_size = std::max(_sq_ring_size, _cq_ring_size);
+
+         _sq_ring = map(_sq_ring_size, IORING_OFF_SQ_RING);
+         if (!_sq_ring)
+            return false;
+         _cq_ring = single ? _sq_ring : map(_cq_ring_size, IORING_OFF_CQ_RING);
+         if (!_cq_ring)
+            return false;
+         _sqes_size = p.sq_entries * sizeof(io_uring_sqe);
+         _sqes      = static_cast<io_uring_sqe*>(map(_sqes_size, IORING_OFF_SQES));
+         if (!_sqes)
+            return false;
+
+         auto* sq    = static_cast<char*>(_sq_ring);
+         auto* cq    = static_cast<char*>(_cq_ring);
+         _sq_tail    = reinterpret_cast<unsigned*>(sq + p.sq_off.tail);
+         _sq_mask    = *reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask);
+         _sq_array   = reinterpret_cast<unsigned*>(sq + p.sq_off.array);
+         _cq_head    = reinterpret_cast<unsigned*>(cq + p.cq_off.head);
+         _cq_tail    = reinterpret_cast<unsigned*>(cq + p.cq_off.tail);
+         _cq_mask    = *reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask);
+         _cqes       = reinterpret_cast<io_uring_cqe*>(cq + p.cq_off.cqes);
+         _cq_entries = p.cq_entries;
+
+         // IORING_OP_WRITE needs Linux 5.6; ask rather than guess.
+         constexpr unsigned          probe_ops = 256;
+         std::vector<io_uring_probe_op> storage(probe_ops + 1);
+         auto*                       probe = reinterpret_cast<io_uring_probe*>(storage.data());
+         if (::syscall(__NR_io_uring_register, _ring_fd, IORING_REGISTER_PROBE, probe,
+                       probe_ops) < 0)
+            return false;
+         for (unsigned op : {IORING_OP_NOP, IORING_OP_WRITE, IORING_OP_FSYNC})
+            if (op > probe->last_op || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED))
+               return false;
+         return true;
+      }
+
+      void* map(size_t size, off_t offset)
+      {
+         void* p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                          _ring_fd, offset);
+         return p == MAP_FAILED ? nullptr : p;
+      }
+
+      /// Queue one SQE; _mutex held.  Without SQPOLL the kernel consumes
+      /// every queued SQE during enter(), so the ring always has room.
+      io_uring_sqe* push(uint8_t     opcode,
+                         int         fd,
+                         const char* data,
+                         size_t      len,
+                         uint64_t    offset,
+                         uint8_t     flags,
+                         uint64_t    user_data)
+      {
+         unsigned      tail = *_sq_tail;
+         unsigned      idx  = tail & _sq_mask;
+         io_uring_sqe* sqe  = &_sqes[idx];
+         std::memset(sqe, 0, sizeof(*sqe));
+         sqe->opcode    = opcode;
+         sqe->flags     = flags;
+         sqe->fd        = fd;
+         sqe->off       = offset;
+         sqe->addr      = reinterpret_cast<uint64_t>(data);
+         sqe->len       = static_cast<uint32_t>(len);
+         sqe->user_data = user_data;
+         _sq_array[idx] = idx;
+         std::atomic_ref<unsigned>(*_sq_tail).store(tail + 1, std::memory_order_release);
+         return sqe;
+      }
+
+      /// Submit n queued SQEs; _mutex held.
+      void enter(unsigned n)
+      {
+         while (n > 0)
+         {
+            long r = ::syscall(__NR_io_uring_enter, _ring_fd, n, 0, 0, nullptr, 0);
+            if (r < 0 && (errno == EINTR || errno == EAGAIN))
+               continue;
+            if (r < 0)
+               throw std::runtime_error(std::string("wal_io: io_uring_enter failed: ") +
+                                        std::strerror(errno));
+            n -= static_cast<unsigned>(r);
+         }
+      }
+
+      void reap()
+      {
+         for (;;)
+         {
+            unsigned head = *_cq_head;
+            unsigned tail = std::atomic_ref<unsigned>(*_cq_tail).load(std::memory_order_acquire);
+            if (head == tail)
+            {
+               ::syscall(__NR_io_uring_enter, _ring_fd, 0, 1, IORING_ENTER_GETEVENTS, nullptr,
+                         0);
+               continue;
+            }
+
+            bool     stop   = false;
+            unsigned reaped = tail - head;
+            for (; head != tail; ++head)
+            {
+               const io_uring_cqe& cqe = _cqes[head & _cq_mask];
+               if (cqe.user_data == 0)
+                  stop = true;
+               else
+                  complete(cqe.user_data, cqe.res);
+            }
+            std::atomic_ref<unsigned>(*_cq_head).store(head, std::memory_order_release);
+            {
+               std::lock_guard lk(_mutex);
+               _inflight -= reaped;
+            }
+            _space.notify_all();
+            if (stop)
+               return;
+         }
+      }
+
+      void complete(uint64_t user_data, int res)
+      {
+         auto& req = *reinterpret_cast<wal_io_request*>(user_data & ~tag_mask);
+         switch (user_data & tag_mask)
+         {
+            case tag_write:
+               if (res < 0)
+                  finish(req, -res);
+               else if (size_t(res) < length(req))
+                  finish(req, run(req, size_t(res)));
+               else
+                  finish(req, 0);
+               break;
+            case tag_linked_write:
+               // A failed or short write cancels the linked FSYNC, whose CQE
+               // still follows; the request completes there.
+               if (res < 0)
+                  record_error(req, -res);
+               else if (size_t(res) < length(req))
+                  record_error(req, run(req, size_t(res)));
+               break;
+            case tag_fsync:
+               finish(req, res < 0 && res != -ECANCELED ? -res : 0);
+               break;
+         }
+      }
+
+      int           _ring_fd      = -1;
+      void*         _sq_ring      = nullptr;
+      size_t        _sq_ring_size = 0;
+      void*         _cq_ring      = nullptr;
+      size_t        _cq_ring_size = 0;
+      io_uring_sqe* _sqes         = nullptr;
+      size_t        _sqes_size    = 0;
+      unsigned*     _sq_tail      = nullptr;
+      unsigned      _sq_mask      = 0;
+      unsigned*     _sq_array     = nullptr;
+      unsigned*     _cq_head      = nullptr;
+      unsigned*     _cq_tail      = nullptr;
+      unsigned      _cq_mask      = 0;
+      io_uring_cqe* _cqes         = nullptr;
+      unsigned      _cq_entries   = 0;
+
+      std::mutex              _mutex;
+      std::condition_variable _space;
+      unsigned                _inflight = 0;  ///< CQEs still to come; guarded by _mutex
+      std::thread             _reaper;
+   };
+#endif
+
+   std::unique_ptr<wal_io_engine> wal_io_engine::create(wal_io_mode mode, uint32_t io_threads)
+   {
+      if (mode == wal_io_mode::sync)
+         return nullptr;
+#ifdef PSITRI_HAVE_IO_URING
+      if (mode == wal_io_mode::io_uring)
+         if (auto engine = uring_engine::open(256))
+            return engine;
+#endif
+      return std::make_unique<thread_pool_engine>(std::max<uint32_t>(io_threads, 1));
+   }
+
+}  // namespace psitri::dwal
@@ -5,15 +5,31 @@
 #include <cstring>
 
 #include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
 namespace psitri::dwal
 {
-   bool wal_reader::open(const std::filesystem::path& path)
+   wal_reader::~wal_reader()
+   {
+      close();
+   }
+
+   void wal_reader::close() noexcept
    {
+      if (_map)
+         ::munmap(const_cast<char*>(_map), _file_size);
       if (_fd >= 0)
          ::close(_fd);
+      _map         = nullptr;
+      _fd          = -1;
+      _trusted_end = 0;
+   }
+
+   bool wal_reader::open(const std::filesystem::path& path)
+   {
+      close();
 
       _fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
       if (_fd < 0)
@@ -22,29 +38,38 @@ namespace psitri::dwal
       struct stat st;
       if (::fstat(_fd, &st) < 0 || st.st_size < static_cast<off_t>(sizeof(wal_header)))
       {
-         ::close(_fd);
-         _fd = -1;
+         close();
          return false;
       }
 
       _file_size = static_cast<uint64_t>(st.st_size);
 
-      if (::pread(_fd, &_header, sizeof(_header), 0) != sizeof(_header))
+      // Map the whole file and ask for aggressive readahead: recovery reads
+      // every byte once, front to back.  A preallocated file maps its
+      // zeroed tail too, but only the pages up to the last entry are read.
+      void* map = ::mmap(nullptr, _file_size, PROT_READ, MAP_PRIVATE, _fd, 0);
+      if (map != MAP_FAILED)
       {
-         ::close(_fd);
-         _fd = -1;
+         _map = static_cast<const char*>(map);
+         ::madvise(map, _file_size, MADV_SEQUENTIAL);
+         ::madvise(map, _file_size, MADV_WILLNEED);
+         std::memcpy(&_header, _map, sizeof(_header));
+      }
+      else if (::pread(_fd, &_header, sizeof(_header), 0) != sizeof(_header))
+      {
+         close();
          return false;
       }
 
       if (_header.magic != wal_magic || _header.version != wal_version)
       {
-         ::close(_fd);
-         _fd = -1;
+         close();
          return false;
       }
 
-      _read_pos = sizeof(wal_header);
-      _end_seq  = _header.sequence_base;
+      _read_pos   = sizeof(wal_header);
+      _end_offset = _read_pos;
+      _end_seq    = _header.sequence_base;
       return true;
    }
 
@@ -53,13 +78,27 @@ namespace psitri::dwal
       if (_fd < 0)
          return false;
 
-      if (!read_entry_raw(_raw_buf))
+      uint64_t    entry_pos  = _read_pos;
+      uint32_t    entry_size = 0;
+      const char* raw        = read_entry_raw(entry_size);
+      if (!raw)
          return false;
 
-      if (!decode_entry(_raw_buf, entry))
+      if (!decode_entry(raw, entry_size, entry))
+      {
+         _read_pos = entry_pos;
          return false;
+      }
 
-      _end_seq = entry.sequence + 1;
+      // Shared-log segments interleave roots, each with its own sequence.
+      if (!is_shared_log() && entry.sequence < _end_seq)
+      {
+         _read_pos = entry_pos;
+         return false;
+      }
+
+      _end_seq    = entry.sequence + 1;
+      _end_offset = _read_pos;
       return true;
    }
 
@@ -74,56 +113,67 @@ namespace psitri::dwal
       return true;
    }
 
-   bool wal_reader::read_entry_raw(std::vector<char>& buf)
+   const char* wal_reader::read_entry_raw(uint32_t& entry_size)
    {
       // Read entry_size (first 4 bytes).
-      uint32_t entry_size = 0;
-      uint64_t saved_pos  = _read_pos;
+      uint64_t saved_pos = _read_pos;
+      if (saved_pos + 4 > _file_size)
+         return nullptr;
 
-      if (!read_bytes(&entry_size, 4))
-         return false;
+      if (_map)
+         std::memcpy(&entry_size, _map + saved_pos, 4);
+      else if (!read_bytes(&entry_size, 4))
+         return nullptr;
 
       // Sanity: minimum entry is header + hash, maximum bounded by file.
       if (entry_size < wal_entry_header_size + wal_entry_hash_size ||
           saved_pos + entry_size > _file_size)
       {
          _read_pos = saved_pos;
-         return false;
+         return nullptr;
       }
 
-      // Read the full entry.
-      buf.resize(entry_size);
-      std::memcpy(buf.data(), &entry_size, 4);
-
-      // Read remaining bytes after entry_size.
-      if (!read_bytes(buf.data() + 4, entry_size - 4))
+      const char* p;
+      if (_map)
       {
-         _read_pos = saved_pos;
-         return false;
+         p         = _map + saved_pos;
+         _read_pos = saved_pos + entry_size;
+      }
+      else
+      {
+         _raw_buf.resize(entry_size);
+         std::memcpy(_raw_buf.data(), &entry_size, 4);
+         if (!read_bytes(_raw_buf.data() + 4, entry_size - 4))
+         {
+            _read_pos = saved_pos;
+            return nullptr;
+         }
+         p = _raw_buf.data();
       }
 
-      // Validate hash (last 8 bytes).
-      uint64_t stored_hash = 0;
-      std::memcpy(&stored_hash, buf.data() + entry_size - wal_entry_hash_size, 8);
-      uint64_t computed_hash = XXH3_64bits(buf.data(), entry_size - wal_entry_hash_size);
-
-      if (stored_hash != computed_hash)
+      // Validate hash (last 8 bytes), unless already verified.
+      if (_read_pos > _trusted_end)
       {
-         _read_pos = saved_pos;
-         return false;
+         uint64_t stored_hash = 0;
+         std::memcpy(&stored_hash, p + entry_size - wal_entry_hash_size, 8);
+         uint64_t computed_hash = XXH3_64bits(p, entry_size - wal_entry_hash_size);
+
+         if (stored_hash != computed_hash)
+         {
+            _read_pos = saved_pos;
+            return nullptr;
+         }
       }
 
-      return true;
+      return p;
    }
 
-   bool wal_reader::decode_entry(const std::vector<char>& buf, wal_entry& entry)
+   bool wal_reader::decode_entry(const char* p, size_t size, wal_entry& entry)
    {
       // Accept both v1 (14-byte) and v2 (25-byte) headers.
-      if (buf.size() < wal_entry_header_size_v1 + wal_entry_hash_size)
+      if (size < wal_entry_header_size_v1 + wal_entry_hash_size)
          return false;
 
-      const char* p = buf.data();
-
       // Parse header fields.
       // uint32_t entry_size at [0..4) — already validated.
       std::memcpy(&entry.sequence, p + 4, 8);
@@ -132,7 +182,18 @@ namespace psitri::dwal
 
       // Parse v2 multi-tx fields if present, otherwise zero them.
       size_t header_size;
-      if (buf.size() >= wal_entry_header_size + wal_entry_hash_size)
+      entry.root_index = _header.root_index;
+      if (is_shared_log())
+      {
+         if (size < wal_entry_header_size_shared + wal_entry_hash_size)
+            return false;
+         header_size = wal_entry_header_size_shared;
+         std::memcpy(&entry.entry_flags, p + 14, 1);
+         std::memcpy(&entry.multi_tx_id, p + 15, 8);
+         std::memcpy(&entry.multi_participant_count, p + 23, 2);
+         std::memcpy(&entry.root_index, p + 25, 2);
+      }
+      else if (size >= wal_entry_header_size + wal_entry_hash_size)
       {
          header_size = wal_entry_header_size;
          std::memcpy(&entry.entry_flags, p + 14, 1);
@@ -151,7 +212,7 @@ namespace psitri::dwal
       entry.ops.reserve(op_count);
 
       const char* cur = p + header_size;
-      const char* end = p + buf.size() - wal_entry_hash_size;
+      const char* end = p + size - wal_entry_hash_size;
 
       for (uint16_t i = 0; i < op_count; ++i)
       {
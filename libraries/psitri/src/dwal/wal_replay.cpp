@@ -0,0 +1,185 @@
+#include <psitri/dwal/wal_replay.hpp>
+
+#include <algorithm>
+#include <exception>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace psitri::dwal
+{
+   namespace
+   {
+      /// Verified bytes a scan accumulates before waking its apply thread.
+      constexpr uint64_t publish_bytes = 64 * 1024;
+   }  // namespace
+
+   // ── multi_tx_coordinator ─────────────────────────────────────────────
+
+   void multi_tx_coordinator::record(const wal_entry& entry)
+   {
+      std::lock_guard lk(_mutex);
+      auto&           info   = _txs[entry.multi_tx_id];
+      info.participant_count = entry.multi_participant_count;
+      info.entries_found++;
+      if (entry.is_multi_tx_commit())
+         info.commit_seen = true;
+      if (info.complete())
+         _cv.notify_all();
+   }
+
+   void multi_tx_coordinator::scan_finished()
+   {
+      std::lock_guard lk(_mutex);
+      if (--_scans_left == 0)
+         _cv.notify_all();
+   }
+
+   bool multi_tx_coordinator::committed(uint64_t multi_tx_id)
+   {
+      std::unique_lock lk(_mutex);
+      bool             complete = false;
+      _cv.wait(lk,
+               [&]
+               {
+                  auto it  = _txs.find(multi_tx_id);
+                  complete = it != _txs.end() && it->second.complete();
+                  return complete || _scans_left == 0;
+               });
+      return complete;
+   }
+
+   // ── wal_scan_progress ────────────────────────────────────────────────
+
+   void wal_scan_progress::publish(uint64_t verified_end) noexcept
+   {
+      _state.store(verified_end, std::memory_order_release);
+      _state.notify_all();
+   }
+
+   void wal_scan_progress::finish(uint64_t verified_end) noexcept
+   {
+      _state.store(verified_end | done_bit, std::memory_order_release);
+      _state.notify_all();
+   }
+
+   uint64_t wal_scan_progress::wait_past(uint64_t offset) const noexcept
+   {
+      uint64_t s = _state.load(std::memory_order_acquire);
+      while (!(s & done_bit) && s <= offset)
+      {
+         _state.wait(s, std::memory_order_acquire);
+         s = _state.load(std::memory_order_acquire);
+      }
+      return s & ~done_bit;
+   }
+
+   // ── wal_replay_source ────────────────────────────────────────────────
+
+   bool wal_replay_source::next(wal_entry& entry)
+   {
+      for (;;)
+      {
+         uint64_t pos      = _reader.end_offset();
+         uint64_t verified = _progress.wait_past(pos);
+         if (verified <= pos)
+            return false;
+
+         _reader.trust_through(verified);
+         if (!_reader.next(entry))
+            return false;
+
+         if (_coordinator && entry.is_multi_tx() && !_coordinator->committed(entry.multi_tx_id))
+            continue;
+         return true;
+      }
+   }
+
+   // ── wal_replay ───────────────────────────────────────────────────────
+
+   void wal_replay::run(std::span<const std::filesystem::path> files,
+                        const wal_replay_options&              options,
+                        const apply_fn&                        apply)
+   {
+      if (files.empty())
+         return;
+
+      auto progress = std::make_unique<wal_scan_progress[]>(files.size());
+      multi_tx_coordinator coordinator(files.size());
+      multi_tx_coordinator* filter = options.filter_multi_tx ? &coordinator : nullptr;
+
+      auto wanted = [&](const wal_reader& reader)
+      { return !(options.skip_clean_close && reader.was_clean_close()); };
+
+      std::atomic<size_t> next_scan{0};
+      auto                scan = [&]
+      {
+         wal_reader reader;
+         wal_entry  entry;
+         for (size_t i; (i = next_scan.fetch_add(1, std::memory_order_relaxed)) < files.size();)
+         {
+            uint64_t verified = 0;
+            if (reader.open(files[i]) && wanted(reader))
+            {
+               uint64_t published = reader.end_offset();
+               while (reader.next(entry))
+               {
+                  if (filter && entry.is_multi_tx())
+                     filter->record(entry);
+                  if (reader.end_offset() - published >= publish_bytes)
+                  {
+                     published = reader.end_offset();
+                     progress[i].publish(published);
+                  }
+               }
+               verified = reader.end_offset();
+            }
+            progress[i].finish(verified);
+            reader.close();
+            coordinator.scan_finished();
+         }
+      };
+
+      std::atomic<size_t> next_apply{0};
+      std::mutex          error_mutex;
+      std::exception_ptr  error;
+      auto                apply_files = [&]
+      {
+         for (size_t i; (i = next_apply.fetch_add(1, std::memory_order_relaxed)) < files.size();)
+         {
+            wal_reader reader;
+            if (!reader.open(files[i]) || !wanted(reader))
+               continue;
+            try
+            {
+               wal_replay_source source(reader, progress[i], filter);
+               apply(i, source);
+            }
+            catch (...)
+            {
+               std::lock_guard lk(error_mutex);
+               if (!error)
+                  error = std::current_exception();
+               next_apply.store(files.size(), std::memory_order_relaxed);
+            }
+         }
+      };
+
+      size_t threads = std::clamp<size_t>(options.threads, 1, files.size());
+
+      // The calling thread is one of the apply workers.
+      std::vector<std::thread> workers;
+      workers.reserve(threads * 2 - 1);
+      for (size_t t = 0; t < threads; ++t)
+         workers.emplace_back(scan);
+      for (size_t t = 1; t < threads; ++t)
+         workers.emplace_back(apply_files);
+      apply_files();
+      for (auto& w : workers)
+         w.join();
+
+      if (error)
+         std::rethrow_exception(error);
+   }
+
+}  // namespace psitri::dwal
@@ -1,11 +1,15 @@
+#include <psitri/dwal/shared_wal.hpp>
+#include <psitri/dwal/wal_reader.hpp>
 #include <psitri/dwal/wal_writer.hpp>
 
 #include <hash/xxhash.h>
 
+#include <algorithm>
 #include <cassert>
 #include <chrono>
 #include <cstring>
 #include <stdexcept>
+#include <string>
 #include <utility>
 
 #include <fcntl.h>
@@ -20,11 +24,73 @@ namespace psitri::dwal
       return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(tp).count());
    }
 
+   static void write_header(int fd, uint16_t root_index, uint64_t sequence_base)
+   {
+      wal_header hdr;
+      hdr.magic             = wal_magic;
+      hdr.version           = wal_version;
+      hdr.sequence_base     = sequence_base;
+      hdr.created_timestamp = now_nanos();
+      hdr.root_index        = root_index;
+      hdr.flags             = 0;
+      std::memset(hdr.reserved, 0, sizeof(hdr.reserved));
+
+      if (::pwrite(fd, &hdr, sizeof(hdr), 0) != sizeof(hdr))
+         throw std::runtime_error("wal_writer: failed to write header");
+   }
+
+   static void preallocate(int fd, uint64_t bytes)
+   {
+#ifdef __linux__
+      // Best effort: without fallocate support the file grows on append.
+      if (bytes)
+         ::fallocate(fd, 0, 0, static_cast<off_t>(bytes));
+#else
+      (void)fd;
+      (void)bytes;
+#endif
+   }
+
    wal_writer::wal_writer(const std::filesystem::path& path,
                           uint16_t                     root_index,
-                          uint64_t                     sequence_base)
-       : _next_seq(sequence_base), _path(path)
+                          uint64_t                     sequence_base,
+                          const wal_writer_options&    options)
+       : _next_seq(sequence_base),
+         _path(path),
+         _buffer_bytes(options.buffer_bytes),
+         _io(options.io)
    {
+      if (_io)
+         _io_req = std::make_unique<wal_io_request>();
+
+      if (!options.recycle_from.empty())
+      {
+         // Rewrite the retired file's header and make it durable before the
+         // rename, so a crash never leaves old entries under the RW name.
+         _fd = ::open(options.recycle_from.c_str(), O_RDWR | O_CLOEXEC);
+         if (_fd >= 0)
+         {
+            try
+            {
+               write_header(_fd, root_index, sequence_base);
+#ifdef __APPLE__
+               ::fsync(_fd);
+#else
+               ::fdatasync(_fd);
+#endif
+               std::filesystem::rename(options.recycle_from, path);
+            }
+            catch (...)
+            {
+               ::close(_fd);
+               _fd = -1;
+               throw;
+            }
+            _file_pos = sizeof(wal_header);
+            return;
+         }
+      }
+
       _fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
       if (_fd < 0)
          throw std::runtime_error("wal_writer: cannot open " + path.string());
@@ -39,44 +105,51 @@ namespace psitri::dwal
 
       if (st.st_size >= static_cast<off_t>(sizeof(wal_header)))
       {
-         // Existing file — validate header and seek to end.
-         wal_header hdr;
-         if (::pread(_fd, &hdr, sizeof(hdr), 0) == sizeof(hdr) && hdr.magic == wal_magic &&
-             hdr.version == wal_version)
+         // Existing file — append after the last valid entry.  The file may
+         // be preallocated or recycled, so its size says nothing.
+         wal_reader reader;
+         if (reader.open(path))
          {
-            _file_pos = static_cast<uint64_t>(st.st_size);
-            _next_seq = hdr.sequence_base;
-            // TODO: scan to find actual end sequence (for now, trust caller)
-            if (sequence_base > _next_seq)
-               _next_seq = sequence_base;
+            reader.replay_all([](const wal_entry&) {});
+            _file_pos = reader.end_offset();
+            _next_seq = std::max(reader.end_sequence(), sequence_base);
             return;
          }
          // Invalid header — truncate and rewrite.
          ::ftruncate(_fd, 0);
       }
 
-      // Write fresh header.
-      wal_header hdr;
-      hdr.magic             = wal_magic;
-      hdr.version           = wal_version;
-      hdr.sequence_base     = sequence_base;
-      hdr.created_timestamp = now_nanos();
-      hdr.root_index        = root_index;
-      hdr.flags             = 0;
-      std::memset(hdr.reserved, 0, sizeof(hdr.reserved));
-
-      auto written = ::pwrite(_fd, &hdr, sizeof(hdr), 0);
-      if (written != sizeof(hdr))
+      try
+      {
+         write_header(_fd, root_index, sequence_base);
+      }
+      catch (...)
       {
          ::close(_fd);
          _fd = -1;
-         throw std::runtime_error("wal_writer: failed to write header");
+         throw;
       }
+      preallocate(_fd, options.preallocate_bytes);
       _file_pos = sizeof(wal_header);
    }
 
+   wal_writer::wal_writer(shared_wal& log, uint16_t root_index, uint64_t sequence_base)
+       : _next_seq(sequence_base), _log(&log), _root_index(root_index)
+   {
+   }
+
    wal_writer::~wal_writer()
    {
+      if (_io_req && _io_req->busy())
+      {
+         try
+         {
+            _io_req->wait();
+         }
+         catch (...)
+         {
+         }
+      }
       if (_fd >= 0)
          ::close(_fd);
    }
@@ -88,8 +161,15 @@ namespace psitri::dwal
          _op_count(other._op_count),
          _entry_active(other._entry_active),
          _path(std::move(other._path)),
-         _entry_buf(std::move(other._entry_buf)),
-         _write_buf(std::move(other._write_buf))
+         _log(std::exchange(other._log, nullptr)),
+         _root_index(other._root_index),
+         _log_pos(other._log_pos),
+         _write_buf(std::move(other._write_buf)),
+         _entry_start(other._entry_start),
+         _buffer_bytes(other._buffer_bytes),
+         _io(std::exchange(other._io, nullptr)),
+         _io_buf(std::move(other._io_buf)),
+         _io_req(std::move(other._io_req))
    {
    }
 
@@ -97,6 +177,16 @@ namespace psitri::dwal
    {
       if (this != &other)
       {
+         if (_io_req && _io_req->busy())
+         {
+            try
+            {
+               _io_req->wait();
+            }
+            catch (...)
+            {
+            }
+         }
          if (_fd >= 0)
             ::close(_fd);
          _fd           = std::exchange(other._fd, -1);
@@ -105,8 +195,15 @@ namespace psitri::dwal
          _op_count     = other._op_count;
          _entry_active = other._entry_active;
          _path         = std::move(other._path);
-         _entry_buf    = std::move(other._entry_buf);
+         _log          = std::exchange(other._log, nullptr);
+         _root_index   = other._root_index;
+         _log_pos      = other._log_pos;
          _write_buf    = std::move(other._write_buf);
+         _entry_start  = other._entry_start;
+         _buffer_bytes = other._buffer_bytes;
+         _io           = std::exchange(other._io, nullptr);
+         _io_buf       = std::move(other._io_buf);
+         _io_req       = std::move(other._io_req);
       }
       return *this;
    }
@@ -116,13 +213,14 @@ namespace psitri::dwal
    void wal_writer::begin_entry()
    {
       assert(!_entry_active);
-      _entry_buf.clear();
       _op_count     = 0;
       _entry_active = true;
 
       // Reserve space for the entry header (written at commit time).
-      // Uses the v2 header size (25 bytes) which includes multi-tx fields.
-      _entry_buf.resize(wal_entry_header_size);
+      // Uses the v2 header size (25 bytes) which includes multi-tx fields,
+      // plus the root index in a shared log.
+      _entry_start = _write_buf.size();
+      _write_buf.grow(_log ? wal_entry_header_size_shared : wal_entry_header_size);
    }
 
    void wal_writer::add_upsert_data(std::string_view key, std::string_view value)
@@ -168,28 +266,34 @@ namespace psitri::dwal
       _entry_active = false;
 
       uint64_t seq        = _next_seq++;
-      uint32_t entry_size = static_cast<uint32_t>(_entry_buf.size() + wal_entry_hash_size);
+      size_t   body       = _write_buf.size() - _entry_start;
+      uint32_t entry_size = static_cast<uint32_t>(body + wal_entry_hash_size);
 
-      // Patch the entry header at the beginning of the buffer.
-      char* hdr = _entry_buf.data();
+      // Patch the entry header in place and append the hash of everything
+      // before it.
+      char* hdr = _write_buf.data() + _entry_start;
       std::memcpy(hdr + 0, &entry_size, 4);
       std::memcpy(hdr + 4, &seq, 8);
       std::memcpy(hdr + 12, &_op_count, 2);
       std::memcpy(hdr + 14, &entry_flags, 1);
       std::memcpy(hdr + 15, &multi_tx_id, 8);
       std::memcpy(hdr + 23, &multi_participant_count, 2);
+      if (_log)
+         std::memcpy(hdr + 25, &_root_index, 2);
 
-      // Compute hash over everything except the hash itself.
-      uint64_t hash = XXH3_64bits(_entry_buf.data(), _entry_buf.size());
+      uint64_t hash = XXH3_64bits(hdr, body);
+      _write_buf.append(&hash, sizeof(hash));
 
-      // Append the hash.
-      size_t pos = _entry_buf.size();
-      _entry_buf.resize(pos + wal_entry_hash_size);
-      std::memcpy(_entry_buf.data() + pos, &hash, 8);
-
-      // Append to the write buffer.
-      _write_buf.insert(_write_buf.end(), _entry_buf.begin(), _entry_buf.end());
+      if (_log)
+      {
+         _log_pos   = _log->append(_root_index, _write_buf.data(), entry_size);
+         _file_pos += entry_size;
+         _write_buf.clear();
+         return seq;
+      }
 
+      if (_write_buf.size() >= _buffer_bytes)
+         write_buffer(false);
       return seq;
    }
 
@@ -208,7 +312,7 @@ namespace psitri::dwal
    {
       assert(_entry_active);
       _entry_active = false;
-      _entry_buf.clear();
+      _write_buf.truncate(_entry_start);
       _op_count = 0;
    }
 
@@ -219,9 +323,30 @@ namespace psitri::dwal
 
    void wal_writer::flush(sal::sync_type sync)
    {
+      begin_flush(sync);
+      wait_flush(sync);
+   }
+
+   void wal_writer::begin_flush(sal::sync_type sync)
+   {
+      if (_log)
+      {
+         _log->flush_to(_log_pos, sync);
+         return;
+      }
       assert(_fd >= 0);
-      flush_write_buffer();
-      if (sync >= sal::sync_type::full)
+      // A preallocated file's size doesn't change on append, so fdatasync
+      // has no inode to write; a growing file's size is still flushed.
+      write_buffer(sync >= sal::sync_type::fsync && sync < sal::sync_type::full);
+   }
+
+   void wal_writer::wait_flush(sal::sync_type sync)
+   {
+      if (_log)
+         return;
+      wait_io();
+      // not background_full, which sorts after full but syncs nothing here
+      if (sync == sal::sync_type::full)
       {
 #ifdef __APPLE__
          ::fcntl(_fd, F_FULLFSYNC);
@@ -229,19 +354,17 @@ namespace psitri::dwal
          ::fsync(_fd);
 #endif
       }
-      else if (sync >= sal::sync_type::fsync)
-      {
-         ::fsync(_fd);
-      }
       // For msync_async or less, write buffer is flushed but no sync call
    }
 
    void wal_writer::close()
    {
+      _log = nullptr;
       if (_fd < 0)
          return;
 
-      flush_write_buffer();
+      write_buffer(false);
+      wait_io();
 
       // Set the clean-close flag in the header.
       uint16_t flags = wal_flag_clean_close;
@@ -261,13 +384,12 @@ namespace psitri::dwal
 
    void wal_writer::write_bytes(const void* data, size_t len)
    {
-      auto* p = static_cast<const char*>(data);
-      _entry_buf.insert(_entry_buf.end(), p, p + len);
+      _write_buf.append(data, len);
    }
 
    void wal_writer::write_u8(uint8_t v)
    {
-      _entry_buf.push_back(static_cast<char>(v));
+      *_write_buf.grow(1) = static_cast<char>(v);
    }
 
    void wal_writer::write_u16(uint16_t v)
@@ -291,25 +413,50 @@ namespace psitri::dwal
       write_bytes(sv.data(), sv.size());
    }
 
-   void wal_writer::flush_write_buffer()
+   void wal_writer::write_buffer(bool sync)
    {
-      if (_write_buf.empty() || _fd < 0)
+      if (_fd < 0)
          return;
 
-      const char* data     = _write_buf.data();
-      size_t      remaining = _write_buf.size();
+      size_t complete = _entry_active ? _entry_start : _write_buf.size();
 
-      while (remaining > 0)
+      if (!_io)
       {
-         auto n = ::pwrite(_fd, data, remaining, static_cast<off_t>(_file_pos));
-         if (n <= 0)
-            throw std::runtime_error("wal_writer: write failed");
-         _file_pos += static_cast<uint64_t>(n);
-         data      += n;
-         remaining -= static_cast<size_t>(n);
+         if (int err = write_fully(_fd, _write_buf.data(), complete, _file_pos))
+            throw std::runtime_error(std::string("wal_writer: write failed: ") +
+                                     std::strerror(err));
+         _file_pos += complete;
+         _write_buf.consume(complete);
+         _entry_start = 0;
+#ifdef __APPLE__
+         if (sync)
+            ::fsync(_fd);
+#else
+         if (sync)
+            ::fdatasync(_fd);
+#endif
+         return;
       }
 
-      _write_buf.clear();
+      // Double buffering: wait for the previous write, submit these entries
+      // from _io_buf, and keep encoding into the other buffer.
+      wait_io();
+      if (!complete && !sync)
+         return;
+      _io_buf.clear();
+      _io_buf.swap(_write_buf);
+      _write_buf.append(_io_buf.data() + complete, _io_buf.size() - complete);
+      _io_buf.truncate(complete);
+      _entry_start = 0;
+
+      _io->submit(*_io_req, _fd, _io_buf.data(), complete, _file_pos, sync);
+      _file_pos += complete;
+   }
+
+   void wal_writer::wait_io()
+   {
+      if (_io_req)
+         _io_req->wait();
    }
 
 }  // namespace psitri::dwal
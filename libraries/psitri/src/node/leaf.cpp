@@ -24,6 +24,9 @@ namespace psitri
          return src.get_value(bn);
       }
 
+      /// slots an in-place insert adds to full arrays when the node has room
+      constexpr uint32_t leaf_capacity_step = 8;
+
       struct leaf_rebuild_meter
       {
          uint16_t    branches;
@@ -62,7 +65,8 @@ namespace psitri
             return result;
          }
 
-         bool fits() const noexcept { return meta_size() + alloc_pos <= max_size; }
+         uint32_t size() const noexcept { return meta_size() + alloc_pos; }
+         bool     fits() const noexcept { return size() <= max_size; }
 
          bool add_key(key_view key) noexcept
          {
@@ -187,7 +191,7 @@ namespace psitri
          _optimal_layout(true)
    {
       _num_versions = 0;
-      set_num_branches(0);  // Must initialize before lower_bound reads it
+      init_branches(0);  // Must initialize before lower_bound reads it
       apply(op::leaf_insert{*this, lower_bound(key), key, value});
    }
    uint32_t leaf_node::compact_size() const noexcept
@@ -215,25 +219,28 @@ namespace psitri
          return;
       }
       // Different sizes: copy header+arrays forward, alloc area backward.
+      // compact_size() is the sum of both rounded to cachelines, so whole
+      // lines of each can be copied without overlapping in the destination.
       // Save the destination's alloc_header (size, address_seq set by allocator)
       auto saved_header = *compact_dst;
 
-      uint32_t head_bytes = meta_end() - (const char*)this;
+      uint32_t head_bytes  = ucc::round_up_multiple<64>(uint32_t(meta_end() - (const char*)this));
+      uint32_t alloc_bytes = ucc::round_up_multiple<64>(uint32_t(_alloc_pos));
       // Copy fixed header + dynamic arrays (everything from start to meta_end)
-      memcpy(compact_dst, this, head_bytes);
+      ucc::memcpy_aligned_64byte(compact_dst, this, head_bytes);
       // Restore the alloc_header fields
       memcpy(compact_dst, &saved_header, sizeof(alloc_header));
 
       // Copy alloc area (grows backward from tail)
       auto* dst = reinterpret_cast<leaf_node*>(compact_dst);
-      memcpy((char*)dst->tail() - _alloc_pos, (const char*)tail() - _alloc_pos, _alloc_pos);
+      ucc::memcpy_aligned_64byte((char*)dst->tail() - alloc_bytes,
+                                 (const char*)tail() - alloc_bytes, alloc_bytes);
    }
 
    void leaf_node::clone_from(const leaf_node* clone)
    {
       //    SAL_ERROR("cloning from {} {} to {} {}", clone->address(), clone, address(), this);
       PSITRI_ASSERT_INVARIANTS(clone->validate_invariants());
-      set_num_branches(clone->num_branches());
       // Rebuild from scratch when there is dead space to reclaim, or when the
       // cline table is full — rebuilding compacts clines by only keeping those
       // actually referenced, which frees slots for subsequent update_value().
@@ -251,6 +258,7 @@ namespace psitri
             _optimal_layout = true;
 
             const uint16_t nb = clone->num_branches();
+            init_branches(nb);
             /// copy the key hashes
             memcpy(_key_hashs, clone->_key_hashs, nb * sizeof(uint8_t));
 
@@ -294,6 +302,8 @@ namespace psitri
          }
       }
 
+      set_num_branches(clone->num_branches());
+      _capacity       = clone->_capacity;
       _alloc_pos      = clone->_alloc_pos;
       _cline_cap      = clone->_cline_cap;
       _dead_space     = clone->_dead_space;
@@ -302,25 +312,23 @@ namespace psitri
 
       assert(free_space() >= 0);
 
-      // We cannot use the faster aligned memcpy unless we are copying from a leaf node
-      // that has an optimal layout, otherwise we could end up copying data that is not
-      // aligned to the cacheline size.
-      // Copy everything from _key_hashs through meta_end (includes clines + ver_indices + version_table)
-      auto head_size = clone->meta_end() - (const char*)clone->_key_hashs;
-
-      memcpy(_key_hashs, clone->_key_hashs, head_size);
-
-      auto  apos = ucc::round_up_multiple<64>(_alloc_pos);
-      char* aptr = ((char*)tail()) - apos;
-      //SAL_ERROR(" this.size:{} clone.size:{}", size(), clone->size());
-      //SAL_ERROR(" memcpy_aligned_64byte( {}, {}, {})", aptr, ((char*)clone->tail()) - apos, apos);
-
-      // in order to use the faster, aligned memcpy we need to handle the case where this would
-      // overwrite the first 64 bytes of the node where the header info is stored. Using the slower
-      // memcpy to copy exactly what is needed solves the problem for now.
-      //ucc::memcpy_aligned_64byte(aptr, ((char*)clone->tail()) - apos, apos);
-
-      memcpy(alloc_head(), clone->alloc_head(), clone->_alloc_pos);
+      // The arrays start at byte 64 and the alloc area ends at tail(), so
+      // both are copied as whole cachelines unless their last lines would
+      // meet in this node; then copy exactly what is used.
+      uint32_t head_bytes =
+          ucc::round_up_multiple<64>(uint32_t(clone->meta_end() - (const char*)clone));
+      uint32_t alloc_bytes = ucc::round_up_multiple<64>(uint32_t(_alloc_pos));
+      if (head_bytes + alloc_bytes <= size())
+      {
+         ucc::memcpy_aligned_64byte(_key_hashs, clone->_key_hashs, head_bytes - sizeof(leaf_node));
+         ucc::memcpy_aligned_64byte((char*)tail() - alloc_bytes,
+                                    (const char*)clone->tail() - alloc_bytes, alloc_bytes);
+      }
+      else
+      {
+         memcpy(_key_hashs, clone->_key_hashs, clone->meta_end() - (const char*)clone->_key_hashs);
+         memcpy(alloc_head(), clone->alloc_head(), clone->_alloc_pos);
+      }
       PSITRI_ASSERT_INVARIANTS(validate_invariants());
    }
 
@@ -344,7 +352,7 @@ namespace psitri
          const uint16_t src_nb = clone->num_branches();
          const uint16_t dst_nb = src_nb + 1;
          const uint16_t ins_bn = *ins.lb;
-         set_num_branches(dst_nb);
+         init_branches(dst_nb);
 
          const uint8_t* seq_table = search_seq_table.data() + ((dst_nb - 1) * dst_nb) / 2;
          auto           kos       = keys_offsets();
@@ -412,7 +420,7 @@ namespace psitri
       const leaf_node* clone = &upd.src;
       PSITRI_ASSERT_INVARIANTS(clone->validate_invariants());
       const uint16_t nb = clone->num_branches();
-      set_num_branches(nb);
+      init_branches(nb);
 
       memcpy(_key_hashs, clone->_key_hashs, nb * sizeof(uint8_t));
 
@@ -464,7 +472,7 @@ namespace psitri
          const leaf_node& src    = rm.src;
          const uint16_t   src_nb = src.num_branches();
          const uint16_t   dst_nb = src_nb - 1;
-         set_num_branches(dst_nb);
+         init_branches(dst_nb);
          if (dst_nb == 0)
             return;
 
@@ -523,7 +531,7 @@ namespace psitri
       {
          const leaf_node& src    = rm.src;
          const uint16_t   dst_nb = src.num_branches() - (*rm.hi - *rm.lo);
-         set_num_branches(dst_nb);
+         init_branches(dst_nb);
          if (dst_nb == 0)
             return;
 
@@ -581,7 +589,7 @@ namespace psitri
       _num_versions        = 0;
       const leaf_node& src = pp.src;
       const uint16_t   nb  = src.num_branches();
-      set_num_branches(nb);
+      init_branches(nb);
 
       if (nb == 0)
          return;
@@ -683,7 +691,7 @@ namespace psitri
       _cline_cap      = 0;
       _num_versions   = 0;
       _optimal_layout = true;
-      set_num_branches(*end - *start);
+      init_branches(*end - *start);
       auto nb = num_branches();
 
       const uint8_t* aseq = search_seq_table.data() + ((nb - 1) * nb) / 2;
@@ -782,7 +790,7 @@ namespace psitri
          _optimal_layout(true)
    {
       _num_versions = 0;
-      set_num_branches(vis.count);
+      init_branches(vis.count);
       if (vis.count == 0)
          return;
 
@@ -797,19 +805,12 @@ namespace psitri
    {
       assert(ins.key.size() <= 1024);  // TODO: max key size constant
       assert(not ins.value.is_remove());
-      // key hash(1), key_offset(2), value_branch(2)
-      size_t size_required = sizeof(uint8_t) + sizeof(key_offset) + sizeof(value_branch);
-      if (ins.value.is_view())
-      {
-         assert(ins.value.view().size() <= 0xffff);
-         value_view data = ins.value.view();
-         size_required += data.size() + sizeof(value_data);
-      }
-      size_required += ins.key.size() + 2;
+      assert(not ins.value.is_view() or ins.value.view().size() <= 0xffff);
       /// this over-estimates assuming worst case we must add a cline, but
       /// the calculating whether address() is on an existing cline requires
       /// scanning all clines to see if we can re-use one or have to add a new one.
-      size_required += 4 * ins.value.is_address();
+      constexpr int slot_size = sizeof(uint8_t) + sizeof(key_offset) + sizeof(value_branch);
+      size_t        size_required = insert_size(ins.key, ins.value);
       if (_num_versions || ins.created_at)
       {
          size_required += 1;  // one ver_indices entry for the inserted branch
@@ -822,17 +823,15 @@ namespace psitri
             size_required += sizeof(version48);
       }
       int leftover = free_space() - size_required;
+      // Spare array slots: an insert in place fills one, a rebuild drops them all.
+      int slack = (_capacity - num_branches()) * (slot_size + (_num_versions != 0));
       // SAL_WARN("size_required: {}  free_space: {}  leftover: {}", size_required, free_space(),
       //          leftover);
-      if (leftover >= 0 && _num_versions == 0 && ins.created_at == 0)
+      if (leftover + (slack ? slot_size : 0) >= 0 && _num_versions == 0 && ins.created_at == 0)
          return can_apply_mode::modify;
-      if (leftover + int(dead_space()) + (int(leaf_node::cow_size()) - int(size())) >= 0)
-      {
-         // SAL_WARN("leftover: {}  dead_space: {}  cow_size: {}  size: {} == {}", leftover,
-         //          dead_space(), leaf_node::cow_size(), size(),
-         //          leftover + dead_space() + (leaf_node::cow_size() - size()));
+      // A rebuild reclaims the dead space and may grow into a larger size class.
+      if (leftover + slack + int(dead_space()) + (int(max_leaf_size) - int(size())) >= 0)
          return can_apply_mode::defrag;
-      }
       return can_apply_mode::none;
    }
    leaf_node::can_apply_mode leaf_node::can_apply(const op::leaf_update& upd) const noexcept
@@ -869,12 +868,14 @@ namespace psitri
       int leftover = free_space() - extra;
       if (leftover >= 0)
          return can_apply_mode::modify;
-      if (leftover + int(dead_space()) + (int(leaf_node::cow_size()) - int(size())) >= 0)
+      int slack = (_capacity - num_branches()) *
+                  (sizeof(uint8_t) + sizeof(key_offset) + sizeof(value_branch) + (_num_versions != 0));
+      if (leftover + slack + int(dead_space()) + (int(max_leaf_size) - int(size())) >= 0)
          return can_apply_mode::defrag;
       return can_apply_mode::none;
    }
 
-   bool leaf_node::rebuilt_size_fits(const op::leaf_insert& ins, uint32_t max_size) const noexcept
+   uint32_t leaf_node::rebuilt_size(const op::leaf_insert& ins) const noexcept
    {
       const leaf_node& src    = ins.src;
       const uint16_t   src_nb = src.num_branches();
@@ -883,7 +884,7 @@ namespace psitri
       assert(ins_bn <= src_nb);
 
       leaf_rebuild_meter meter(dst_nb,
-                               max_size,
+                               rebuilt_overflow,
                                sizeof(uint8_t) + sizeof(key_offset) + sizeof(value_branch),
                                sizeof(leaf_node::key),
                                sizeof(value_data));
@@ -895,7 +896,7 @@ namespace psitri
                  ? ins.key
                  : src.get_key(branch_number(dst_idx - (dst_idx > ins_bn)));
          if (!meter.add_key(dst_key))
-            return false;
+            return rebuilt_overflow;
       }
 
       for (uint16_t dst_idx = 0; dst_idx < dst_nb; ++dst_idx)
@@ -907,7 +908,7 @@ namespace psitri
                                               branch_number(dst_idx - (dst_idx > ins_bn)),
                                               ins.rewrite);
          if (!meter.add_value(val))
-            return false;
+            return rebuilt_overflow;
       }
 
       for (uint16_t dst_idx = 0; dst_idx < dst_nb; ++dst_idx)
@@ -917,26 +918,26 @@ namespace psitri
                  ? ins.created_at
                  : src.get_version(branch_number(dst_idx - (dst_idx > ins_bn)));
          if (!meter.add_version(version))
-            return false;
+            return rebuilt_overflow;
       }
-      return meter.fits();
+      return meter.size();
    }
 
-   bool leaf_node::rebuilt_size_fits(const op::leaf_update& upd, uint32_t max_size) const noexcept
+   uint32_t leaf_node::rebuilt_size(const op::leaf_update& upd) const noexcept
    {
       const leaf_node& src = upd.src;
       const uint16_t   nb  = src.num_branches();
       assert(upd.lb < nb);
 
       leaf_rebuild_meter meter(nb,
-                               max_size,
+                               rebuilt_overflow,
                                sizeof(uint8_t) + sizeof(key_offset) + sizeof(value_branch),
                                sizeof(leaf_node::key),
                                sizeof(value_data));
 
       for (uint16_t i = 0; i < nb; ++i)
          if (!meter.add_key(src.get_key(branch_number(i))))
-            return false;
+            return rebuilt_overflow;
 
       for (uint16_t i = 0; i < nb; ++i)
       {
@@ -944,26 +945,26 @@ namespace psitri
                               ? upd.value
                               : source_value_for_leaf_copy(src, branch_number(i), upd.rewrite);
          if (!meter.add_value(val))
-            return false;
+            return rebuilt_overflow;
       }
 
       for (uint16_t i = 0; i < nb; ++i)
          if (!meter.add_version(src.get_version(branch_number(i))))
-            return false;
-      return meter.fits();
+            return rebuilt_overflow;
+      return meter.size();
    }
 
-   bool leaf_node::rebuilt_size_fits(const op::leaf_remove& rm, uint32_t max_size) const noexcept
+   uint32_t leaf_node::rebuilt_size(const op::leaf_remove& rm) const noexcept
    {
       const leaf_node& src    = rm.src;
       const uint16_t   src_nb = src.num_branches();
       assert(rm.bn < src_nb);
       if (src_nb == 0)
-         return false;
+         return rebuilt_overflow;
 
       const uint16_t dst_nb = src_nb - 1;
       leaf_rebuild_meter meter(dst_nb,
-                               max_size,
+                               rebuilt_overflow,
                                sizeof(uint8_t) + sizeof(key_offset) + sizeof(value_branch),
                                sizeof(leaf_node::key),
                                sizeof(value_data));
@@ -972,7 +973,7 @@ namespace psitri
       {
          uint16_t src_idx = dst_idx + (dst_idx >= *rm.bn);
          if (!meter.add_key(src.get_key(branch_number(src_idx))))
-            return false;
+            return rebuilt_overflow;
       }
 
       for (uint16_t dst_idx = 0; dst_idx < dst_nb; ++dst_idx)
@@ -980,20 +981,19 @@ namespace psitri
          uint16_t src_idx = dst_idx + (dst_idx >= *rm.bn);
          if (!meter.add_value(
                  source_value_for_leaf_copy(src, branch_number(src_idx), rm.rewrite)))
-            return false;
+            return rebuilt_overflow;
       }
 
       for (uint16_t dst_idx = 0; dst_idx < dst_nb; ++dst_idx)
       {
          uint16_t src_idx = dst_idx + (dst_idx >= *rm.bn);
          if (!meter.add_version(src.get_version(branch_number(src_idx))))
-            return false;
+            return rebuilt_overflow;
       }
-      return meter.fits();
+      return meter.size();
    }
 
-   bool leaf_node::rebuilt_size_fits(const op::leaf_remove_range& rm,
-                                     uint32_t                    max_size) const noexcept
+   uint32_t leaf_node::rebuilt_size(const op::leaf_remove_range& rm) const noexcept
    {
       const leaf_node& src = rm.src;
       assert(rm.lo <= rm.hi);
@@ -1002,7 +1002,7 @@ namespace psitri
       const uint16_t dst_nb       = src.num_branches() - remove_count;
 
       leaf_rebuild_meter meter(dst_nb,
-                               max_size,
+                               rebuilt_overflow,
                                sizeof(uint8_t) + sizeof(key_offset) + sizeof(value_branch),
                                sizeof(leaf_node::key),
                                sizeof(value_data));
@@ -1012,26 +1012,25 @@ namespace psitri
 
       for (uint16_t dst_idx = 0; dst_idx < dst_nb; ++dst_idx)
          if (!meter.add_key(src.get_key(branch_number(src_index_for(dst_idx)))))
-            return false;
+            return rebuilt_overflow;
 
       for (uint16_t dst_idx = 0; dst_idx < dst_nb; ++dst_idx)
          if (!meter.add_value(source_value_for_leaf_copy(
                  src, branch_number(src_index_for(dst_idx)), rm.rewrite)))
-            return false;
+            return rebuilt_overflow;
 
       for (uint16_t dst_idx = 0; dst_idx < dst_nb; ++dst_idx)
          if (!meter.add_version(src.get_version(branch_number(src_index_for(dst_idx)))))
-            return false;
-      return meter.fits();
+            return rebuilt_overflow;
+      return meter.size();
    }
 
-   bool leaf_node::rebuilt_size_fits(const op::leaf_prepend_prefix& pp,
-                                     uint32_t                      max_size) const noexcept
+   uint32_t leaf_node::rebuilt_size(const op::leaf_prepend_prefix& pp) const noexcept
    {
       const leaf_node& src = pp.src;
       const uint16_t   nb  = src.num_branches();
       leaf_rebuild_meter meter(nb,
-                               max_size,
+                               rebuilt_overflow,
                                sizeof(uint8_t) + sizeof(key_offset) + sizeof(value_branch),
                                sizeof(leaf_node::key),
                                sizeof(value_data));
@@ -1040,34 +1039,31 @@ namespace psitri
       {
          auto key = src.get_key(branch_number(i));
          if (pp.prefix.size() + key.size() > 1024)
-            return false;
+            return rebuilt_overflow;
          meter.alloc_pos += uint32_t(pp.prefix.size()) + uint32_t(key.size()) +
                             meter.key_header_size;
-         if (!meter.fits())
-            return false;
       }
 
       for (uint16_t i = 0; i < nb; ++i)
          if (!meter.add_value(source_value_for_leaf_copy(src, branch_number(i), pp.rewrite)))
-            return false;
+            return rebuilt_overflow;
 
       for (uint16_t i = 0; i < nb; ++i)
          if (!meter.add_version(src.get_version(branch_number(i))))
-            return false;
-      return meter.fits();
+            return rebuilt_overflow;
+      return meter.size();
    }
 
-   bool leaf_node::rebuilt_size_fits(key_view                     common_prefix,
-                                     branch_number                start,
-                                     branch_number                end,
-                                     const op::leaf_value_rewrite* rewrite,
-                                     uint32_t max_size) const noexcept
+   uint32_t leaf_node::rebuilt_size(key_view                      common_prefix,
+                                    branch_number                 start,
+                                    branch_number                 end,
+                                    const op::leaf_value_rewrite* rewrite) const noexcept
    {
       assert(start <= end);
       assert(end <= num_branches());
       const uint16_t dst_nb = *end - *start;
       leaf_rebuild_meter meter(dst_nb,
-                               max_size,
+                               rebuilt_overflow,
                                sizeof(uint8_t) + sizeof(key_offset) + sizeof(value_branch),
                                sizeof(leaf_node::key),
                                sizeof(value_data));
@@ -1076,23 +1072,85 @@ namespace psitri
       {
          key_view key = get_key(branch_number(x));
          if (common_prefix.size() > key.size())
-            return false;
+            return rebuilt_overflow;
          if (!meter.add_key(key.substr(common_prefix.size())))
-            return false;
+            return rebuilt_overflow;
       }
 
       for (uint16_t x = *start; x < *end; ++x)
       {
          if (!meter.add_value(source_value_for_leaf_copy(*this, branch_number(x), rewrite)))
-            return false;
+            return rebuilt_overflow;
       }
 
       for (uint16_t x = *start; x < *end; ++x)
       {
          if (!meter.add_version(get_version(branch_number(x))))
-            return false;
+            return rebuilt_overflow;
+      }
+      return meter.size();
+   }
+
+   bool leaf_node::rebuilt_size_fits(const op::leaf_insert& ins, uint32_t max_size) const noexcept
+   {
+      return rebuilt_size(ins) <= max_size;
+   }
+   bool leaf_node::rebuilt_size_fits(const op::leaf_update& upd, uint32_t max_size) const noexcept
+   {
+      return rebuilt_size(upd) <= max_size;
+   }
+   bool leaf_node::rebuilt_size_fits(const op::leaf_remove& rm, uint32_t max_size) const noexcept
+   {
+      return rebuilt_size(rm) <= max_size;
+   }
+   bool leaf_node::rebuilt_size_fits(const op::leaf_remove_range& rm,
+                                     uint32_t                    max_size) const noexcept
+   {
+      return rebuilt_size(rm) <= max_size;
+   }
+   bool leaf_node::rebuilt_size_fits(const op::leaf_prepend_prefix& pp,
+                                     uint32_t                      max_size) const noexcept
+   {
+      return rebuilt_size(pp) <= max_size;
+   }
+   bool leaf_node::rebuilt_size_fits(key_view                      common_prefix,
+                                     branch_number                 start,
+                                     branch_number                 end,
+                                     const op::leaf_value_rewrite* rewrite,
+                                     uint32_t                      max_size) const noexcept
+   {
+      return rebuilt_size(common_prefix, start, end, rewrite) <= max_size;
+   }
+
+   void leaf_node::grow_capacity(uint16_t capacity) noexcept
+   {
+      assert(capacity > _capacity);
+      const uint32_t nb      = num_branches();
+      const uint32_t old_cap = _capacity;
+      assert(free_space() >= int((capacity - old_cap) * (sizeof(uint8_t) + sizeof(key_offset) +
+                                                          sizeof(value_branch) +
+                                                          (_num_versions != 0))));
+
+      char* old_kos = (char*)_key_hashs + old_cap;
+      char* old_vos = old_kos + old_cap * sizeof(key_offset);
+      char* old_cls = old_vos + old_cap * sizeof(value_branch);
+      char* old_vis = old_cls + _cline_cap * sizeof(ptr_address);
+
+      char* kos = (char*)_key_hashs + capacity;
+      char* vos = kos + capacity * sizeof(key_offset);
+      char* cls = vos + capacity * sizeof(value_branch);
+      char* vis = cls + _cline_cap * sizeof(ptr_address);
+
+      // Every array moves up, so move the last one first.
+      if (_num_versions)
+      {
+         memmove(vis + capacity, old_vis + old_cap, _num_versions * sizeof(version48));
+         memmove(vis, old_vis, nb);
       }
-      return meter.fits();
+      memmove(cls, old_cls, _cline_cap * sizeof(ptr_address));
+      memmove(vos, old_vos, nb * sizeof(value_branch));
+      memmove(kos, old_kos, nb * sizeof(key_offset));
+      _capacity = capacity;
    }
 
    void leaf_node::apply(const op::leaf_remove& rm) noexcept
@@ -1112,30 +1170,28 @@ namespace psitri
       assert(ins.lb == lower_bound(ins.key));
       assert(ins.lb == num_branches() or get_key(ins.lb) != ins.key);
 
-      int      tail_len = num_branches() - *ins.lb;
-      uint32_t bn       = *ins.lb;
-
+      const uint32_t nb = num_branches();
+      const uint32_t bn = *ins.lb;
+      if (nb == _capacity)
       {
-         constexpr const int move_size =
+         // Grow the arrays by a few slots while the node has room to spare,
+         // so the next inserts only shift the tails of their own arrays.
+         constexpr uint32_t slot_size =
              sizeof(uint8_t) + sizeof(key_offset) + sizeof(value_branch);
+         int spare = free_space() - int(insert_size(ins.key, ins.value));
+         grow_capacity(nb + 1 +
+                       std::min<uint32_t>(leaf_capacity_step - 1,
+                                          std::max(spare, 0) / (2 * slot_size)));
+      }
 
-         char*  vo_tail          = (char*)(value_offsets() + bn);
-         size_t vo_tail_size     = tail_len * sizeof(value_branch);
-         size_t clines_tail_size = _cline_cap * sizeof(ptr_address);
-         memmove(vo_tail + move_size, vo_tail, vo_tail_size + clines_tail_size);
-
-         char*  ko_tail      = (char*)(keys_offsets().data() + bn);
-         size_t ko_tail_size = tail_len * sizeof(key_offset);
-         size_t vo_head_size = bn * sizeof(value_branch);
-         memmove(ko_tail + move_size - sizeof(value_branch), ko_tail, ko_tail_size + vo_head_size);
-
-         char*  kh_tail      = (char*)(key_hashs().data() + bn);
-         size_t kh_tail_size = tail_len * sizeof(uint8_t);
-         size_t ko_head_size = bn * sizeof(key_offset);
-         memmove(kh_tail + move_size - sizeof(key_offset) - sizeof(value_branch), kh_tail,
-                 kh_tail_size + ko_head_size);
-
-         set_num_branches(num_branches() + 1);
+      {
+         const uint32_t tail_len = nb - bn;
+         memmove(_key_hashs + bn + 1, _key_hashs + bn, tail_len * sizeof(uint8_t));
+         key_offset* kos = keys_offsets().data();
+         memmove(kos + bn + 1, kos + bn, tail_len * sizeof(key_offset));
+         value_branch* vos = value_offsets();
+         memmove(vos + bn + 1, vos + bn, tail_len * sizeof(value_branch));
+         set_num_branches(nb + 1);
       }
 
       key_offset ko = alloc_key(ins.key);
@@ -1211,27 +1267,21 @@ namespace psitri
             // This was the last branch using this cline, mark it as free
             clines()[*cl_off] = sal::null_ptr_address;
             // if the last branch was removed, decrement the cline count
-            _cline_cap -= (*cl_off == _cline_cap - 1);
+            if (*cl_off == _cline_cap - 1)
+               set_cline_cap(_cline_cap - 1);
          }
       }
-      //
-      // | khash[bn+1] -> koff[bn]  move back -1 byte
-      // | koff[bn+1] -> voff[bn]  move back -3 byte
-      // | voff[bn+1] -> clines[_cline_cap]  move back -5 byte
-
-      auto meta = get_meta_arrays();
-      auto bn1  = *bn + 1;
-      // pointers to the start of the data to be moved
-      auto khash_bn1  = meta.khash + bn1;
-      auto koff_bn    = meta.koffs + *bn * sizeof(key_offset);
-      auto koff_bn1   = meta.koffs + bn1 * sizeof(key_offset);
-      auto voff_bn    = meta.voffs + *bn * sizeof(value_branch);
-      auto voff_bn1   = meta.voffs + bn1 * sizeof(value_branch);
-      auto clines_end = meta.clines_end;
-
-      memmove(khash_bn1 - 1, khash_bn1, koff_bn - khash_bn1);
-      memmove(koff_bn1 - 3, koff_bn1, voff_bn1 - koff_bn1);
-      memmove(voff_bn1 - 5, voff_bn1, clines_end - voff_bn1);
+
+      // 3. Close the slot: each array shifts its own tail back one entry and
+      //    keeps its capacity, so the arrays after it stay where they are.
+      const uint32_t tail_len = num_branches() - *bn - 1;
+      memmove(_key_hashs + *bn, _key_hashs + *bn + 1, tail_len * sizeof(uint8_t));
+      key_offset* kos = keys_offsets().data();
+      memmove(kos + *bn, kos + *bn + 1, tail_len * sizeof(key_offset));
+      value_branch* vos = value_offsets();
+      memmove(vos + *bn, vos + *bn + 1, tail_len * sizeof(value_branch));
+      if (_num_versions)
+         memmove(ver_indices() + *bn, ver_indices() + *bn + 1, tail_len);
       // 4. Decrement Branch Count
       set_num_branches(num_branches() - 1);
 
@@ -1273,40 +1323,28 @@ namespace psitri
             {
                // Access via raw pointer to avoid span bounds issues: _cline_cap must not
                // be shrunk mid-loop because a later branch may share the same cline index.
-               auto* cl_ptr    = reinterpret_cast<ptr_address*>(value_offsets() + num_branches());
+               auto* cl_ptr    = reinterpret_cast<ptr_address*>(value_offsets() + _capacity);
                cl_ptr[*cl_off] = sal::null_ptr_address;
             }
          }
       }
       // Trim _cline_cap: remove trailing null clines freed above.
       {
-         auto* cl_ptr = reinterpret_cast<ptr_address*>(value_offsets() + num_branches());
+         auto* cl_ptr = reinterpret_cast<ptr_address*>(value_offsets() + _capacity);
          while (_cline_cap > 0 && cl_ptr[_cline_cap - 1] == sal::null_ptr_address)
-            --_cline_cap;
-      }
-
-      // 2. Shift metadata arrays to close the gap
-      //    Layout: khash[0..nb) | koff[0..nb) | voff[0..nb) | clines[0.._cline_cap)
-      //    Removing [lo, hi) shifts 3 sub-arrays by different amounts
-      auto     meta = get_meta_arrays();
-      uint16_t nb   = num_branches();
-
-      // Pointers for the range being removed
-      auto khash_hi   = meta.khash + *hi;
-      auto koff_lo    = meta.koffs + *lo * sizeof(key_offset);
-      auto koff_hi    = meta.koffs + *hi * sizeof(key_offset);
-      auto voff_lo    = meta.voffs + *lo * sizeof(value_branch);
-      auto voff_hi    = meta.voffs + *hi * sizeof(value_branch);
-      auto clines_end = meta.clines_end;
-
-      // khash: shift [hi..nb) back by count bytes
-      memmove(khash_hi - count, khash_hi, koff_lo - khash_hi);
-      // koff: shift [hi..nb) back by count*3 bytes (count in khash + count*sizeof(key_offset))
-      uint16_t shift2 = count + count * sizeof(key_offset);
-      memmove(koff_hi - shift2, koff_hi, voff_lo - koff_hi);
-      // voff+clines: shift [hi..end) back by count*(1+2+2) = count*5 bytes
-      uint16_t shift3 = count + count * sizeof(key_offset) + count * sizeof(value_branch);
-      memmove(voff_hi - shift3, voff_hi, clines_end - voff_hi);
+            set_cline_cap(_cline_cap - 1);
+      }
+
+      // 2. Shift each array's [hi..nb) back to lo; capacities are unchanged
+      uint16_t       nb       = num_branches();
+      const uint32_t tail_len = nb - *hi;
+      memmove(_key_hashs + *lo, _key_hashs + *hi, tail_len * sizeof(uint8_t));
+      key_offset* kos = keys_offsets().data();
+      memmove(kos + *lo, kos + *hi, tail_len * sizeof(key_offset));
+      value_branch* vos = value_offsets();
+      memmove(vos + *lo, vos + *hi, tail_len * sizeof(value_branch));
+      if (_num_versions)
+         memmove(ver_indices() + *lo, ver_indices() + *hi, tail_len);
 
       set_num_branches(nb - count);
       _optimal_layout = false;
@@ -1445,7 +1483,7 @@ namespace psitri
          return value_branch(t, cline_offset(found_empty), cline_index(*addr & 0x0f));
       }
       assert(free_space() >= 4);
-      ++_cline_cap;
+      set_cline_cap(_cline_cap + 1);
       /// cls[] will assert in debug if we address beyond its old size
       cls.data()[cls.size()] = base_cline;
       assert(free_space() >= 0);
@@ -1482,13 +1520,14 @@ namespace psitri
       //_cline_cap -= (cl_off == _cline_cap - 1);
       while (_cline_cap > 0 && clines()[_cline_cap - 1] == sal::null_ptr_address)
       {
-         --_cline_cap;
+         set_cline_cap(_cline_cap - 1);
       }
    }
    void leaf_node::dump() const
    {
       SAL_INFO("leaf_node::dump()");
       SAL_INFO("  num_branches: {}", num_branches());
+      SAL_INFO("  capacity: {}", capacity());
       SAL_INFO("  clines_capacity: {}", clines_capacity());
       SAL_INFO("  dead_space: {}", dead_space());
       for (uint16_t i = 0; i < num_branches(); ++i)
@@ -1521,10 +1560,15 @@ namespace psitri
 
       uint16_t nb = num_branches();
 
-      // 0c. num_branches must fit within the node
-      if (nb > (size() - sizeof(leaf_node)) / 5)
+      // 0c. num_branches must fit the arrays, and the arrays the node
+      if (nb > _capacity)
+      {
+         SAL_ERROR("leaf validate: num_branches {} > capacity {}", nb, _capacity);
+         return false;
+      }
+      if (_capacity > (size() - sizeof(leaf_node)) / 5)
       {
-         SAL_ERROR("leaf validate: num_branches {} too large for size {}", nb, size());
+         SAL_ERROR("leaf validate: capacity {} too large for size {}", _capacity, size());
          return false;
       }
 
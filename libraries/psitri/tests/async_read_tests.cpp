@@ -0,0 +1,175 @@
+#include <catch2/catch_all.hpp>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <psitri/async_read.hpp>
+#include <psitri/database.hpp>
+#include <psitri/database_impl.hpp>
+#include <psitri/read_session_impl.hpp>
+#include <psitri/transaction.hpp>
+#include <psitri/write_session_impl.hpp>
+#include "point_lookups.hpp"
+
+using namespace psitri;
+
+namespace
+{
+   struct async_test_db
+   {
+      std::string                    dir;
+      std::shared_ptr<database>      db;
+      std::shared_ptr<write_session> ses;
+
+      explicit async_test_db(const std::string& name = "async_read_testdb") : dir(name)
+      {
+         std::filesystem::remove_all(dir);
+         std::filesystem::create_directories(dir + "/data");
+         db  = database::open(dir);
+         ses = db->start_write_session();
+      }
+
+      ~async_test_db() { std::filesystem::remove_all(dir); }
+   };
+
+   using point_lookups::make_key;
+   using point_lookups::make_value;
+
+   /// Parameters are copied into the frame, so the task may outlive the
+   /// caller's arguments.
+   read_task<> lookup(const cursor* c, std::string key, std::optional<std::string>* out)
+   {
+      *out = co_await c->async_get(key);
+   }
+
+   read_task<> tx_lookup(const transaction* tx, std::string key, std::optional<std::string>* out)
+   {
+      *out = co_await tx->async_get(key);
+   }
+
+   read_task<> fail_after(const cursor* c, std::string key)
+   {
+      co_await c->async_get(key);
+      throw std::runtime_error("lookup failed");
+   }
+}  // namespace
+
+TEST_CASE("async_get matches get for every key", "[async]")
+{
+   async_test_db t;
+   const int     N = 3000;
+   {
+      auto tx = t.ses->start_transaction(0);
+      point_lookups::build(
+          N, [&](const std::string& k, const std::string& v) { tx.upsert(k, v); },
+          [&](const std::string& k) { tx.remove(k); });
+      tx.commit();
+   }
+   auto keys = point_lookups::queries(N, 11);
+
+   auto   rs = t.db->start_read_session();
+   cursor c(rs->get_root(0));
+
+   std::vector<std::optional<std::string>> got(keys.size());
+   read_scheduler                          sched;
+   for (size_t i = 0; i < keys.size(); ++i)
+      sched.spawn(lookup(&c, keys[i], &got[i]));
+   sched.run();
+   REQUIRE(sched.parked() == 0);
+
+   for (size_t i = 0; i < keys.size(); ++i)
+   {
+      INFO("key " << keys[i]);
+      REQUIRE(got[i] == c.get<std::string>(keys[i]));
+   }
+}
+
+TEST_CASE("async_get finds paged-out nodes", "[async]")
+{
+   async_test_db t;
+   runtime_config cfg;
+   cfg.max_pinned_cache_size_mb = 0;
+   t.db->set_runtime_config(cfg);
+
+   const int N = 20000;
+   {
+      auto tx = t.ses->start_transaction(0);
+      for (int i = 0; i < N; ++i)
+         tx.upsert(make_key(i), make_value(i));
+      tx.commit();
+   }
+   const bool paged_out = t.db->page_out_unpinned() > 0;
+
+   auto   rs = t.db->start_read_session();
+   cursor c(rs->get_root(0));
+
+   std::vector<std::optional<std::string>> got(N);
+   read_scheduler                          sched;
+   for (int i = 0; i < N; ++i)
+      sched.spawn(lookup(&c, make_key(i), &got[i]));
+   sched.run();
+   REQUIRE(sched.parked() == 0);
+   // lookups suspended on the evicted pages instead of faulting on them
+   if (paged_out)
+      REQUIRE(sched.parks() > 0);
+   else
+      WARN("MADV_PAGEOUT is unavailable, so nothing was paged out");
+
+   for (int i = 0; i < N; ++i)
+   {
+      INFO("key " << make_key(i));
+      REQUIRE(got[i] == make_value(i));
+   }
+}
+
+TEST_CASE("transaction async_get sees its own writes", "[async]")
+{
+   async_test_db t;
+   {
+      auto tx = t.ses->start_transaction(0);
+      for (int i = 0; i < 100; ++i)
+         tx.upsert(make_key(i), "committed");
+      tx.commit();
+   }
+
+   auto tx = t.ses->start_transaction(0);
+   tx.upsert(make_key(1), "updated");
+   tx.remove(make_key(2));
+   tx.upsert(make_key(500), "added");
+
+   std::optional<std::string> updated, removed, added, kept, missing;
+   read_scheduler             sched;
+   sched.spawn(tx_lookup(&tx, make_key(1), &updated));
+   sched.spawn(tx_lookup(&tx, make_key(2), &removed));
+   sched.spawn(tx_lookup(&tx, make_key(500), &added));
+   sched.spawn(tx_lookup(&tx, make_key(3), &kept));
+   sched.spawn(tx_lookup(&tx, make_key(501), &missing));
+   sched.run();
+
+   CHECK(updated == "updated");
+   CHECK(!removed);
+   CHECK(added == "added");
+   CHECK(kept == "committed");
+   CHECK(!missing);
+}
+
+TEST_CASE("read_scheduler rethrows a task's exception", "[async]")
+{
+   async_test_db t;
+   {
+      auto tx = t.ses->start_transaction(0);
+      tx.upsert("a", "1");
+      tx.commit();
+   }
+   auto   rs = t.db->start_read_session();
+   cursor c(rs->get_root(0));
+
+   std::optional<std::string> got;
+   read_scheduler             sched;
+   sched.spawn(lookup(&c, "a", &got));
+   sched.spawn(fail_after(&c, "a"));
+   REQUIRE_THROWS_AS(sched.run(), std::runtime_error);
+   sched.run();
+   CHECK(got == "1");
+}
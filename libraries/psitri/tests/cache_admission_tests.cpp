@@ -0,0 +1,81 @@
+#include "segment_workload.hpp"
+
+using namespace psitri;
+using namespace psitri::segment_workload;
+
+namespace
+{
+   struct admission_db
+   {
+      // the sketch only promotes out of read-only segments, so the keys
+      // below fill the first one
+      static constexpr int num_keys = 40000;
+
+      std::string                    dir = "cache_admission_testdb";
+      std::shared_ptr<database>      db;
+      std::shared_ptr<write_session> ses;
+
+      explicit admission_db(sal::cache_admission_policy policy)
+      {
+         std::filesystem::remove_all(dir);
+         sal::runtime_config cfg;
+         cfg.cache_admission = policy;
+         // a budget below one segment sizes the sketch but pins nothing, so
+         // every key is a candidate whatever RLIMIT_MEMLOCK allows
+         cfg.max_pinned_cache_size_mb = 16;
+         db  = database::open(dir, open_mode::create_only, cfg);
+         ses = db->start_write_session();
+         fill(*ses, 0, num_keys);
+      }
+      ~admission_db()
+      {
+         ses.reset();
+         db.reset();
+         std::filesystem::remove_all(dir);
+      }
+   };
+}  // namespace
+
+TEST_CASE("frequency sketch admission promotes the hot set but not a scan", "[allocator][cache]")
+{
+   admission_db t(sal::cache_admission_policy::frequency_sketch);
+
+   // a small key range read over and over is sampled often enough to be
+   // admitted
+   auto before = t.db->get_stats();
+   REQUIRE(wait_for(
+       [&]
+       {
+          read_keys(*t.ses, 0, 200);
+          return t.db->get_stats().cache_promotions > before.cache_promotions + 10;
+       }));
+
+   // a one-pass scan of other keys samples each value once: those
+   // candidates are rejected, only the leaves the scan shares are admitted
+   before = t.db->get_stats();
+   read_keys(*t.ses, 1000, 30000);
+   REQUIRE(wait_for(
+       [&]
+       { return t.db->get_stats().cache_admission_rejects > before.cache_admission_rejects + 1000; }));
+   auto after = t.db->get_stats();
+   INFO(after.to_string());
+   CHECK(after.cache_admission_rejects - before.cache_admission_rejects >
+         2 * (after.cache_promotions - before.cache_promotions));
+}
+
+TEST_CASE("read bit admission promotes without the sketch", "[allocator][cache]")
+{
+   admission_db t(sal::cache_admission_policy::read_bits);
+   REQUIRE(wait_for(
+       [&]
+       {
+          read_keys(*t.ses, 0, 200);
+          return t.db->get_stats().cache_promotions > 0;
+       }));
+   auto stats = t.db->get_stats();
+   INFO(stats.to_string());
+   REQUIRE(stats.cache_admission == sal::cache_admission_policy::read_bits);
+   REQUIRE(stats.cache_sampled_reads > 0);
+   // read bits never consult the sketch
+   REQUIRE(stats.cache_admission_rejects == 0);
+}
@@ -0,0 +1,56 @@
+#include "segment_workload.hpp"
+
+using namespace psitri;
+using namespace psitri::segment_workload;
+
+TEST_CASE("cold tier receives aged segments and survives reopen", "[allocator][cold_tier]")
+{
+   const std::string dir  = "cold_tier_testdb";
+   const std::string cold = "cold_tier_testdb_cold";
+   std::filesystem::remove_all(dir);
+   std::filesystem::remove_all(cold);
+
+   sal::runtime_config cfg;
+   cfg.cold_tier_age_sec        = 0;  // every finished segment is old enough
+   cfg.max_pinned_cache_size_mb = 0;
+
+   // enough to finish one segment
+   const int num_keys = 40000;
+   {
+      auto db  = database::open(dir, open_mode::create_only, cfg, recovery_mode::none, cold);
+      auto ses = db->start_write_session();
+      fill(*ses, 0, num_keys);
+
+      database_stats stats;
+      wait_for(
+          [&]
+          {
+             stats = db->get_stats();
+             return stats.cold_segments_migrated > 0;
+          });
+      INFO(stats.to_string());
+      REQUIRE(stats.cold_tier_attached);
+      REQUIRE(stats.cold_segments_migrated > 0);
+      REQUIRE(stats.cold_segments > 0);
+      REQUIRE(stats.cold_live_bytes > 0);
+      REQUIRE(stats.cold_disk_bytes > 0);
+
+      read_keys(*ses, 0, num_keys);
+   }
+
+   // the cold directory is remembered by the database
+   REQUIRE(std::filesystem::is_symlink(std::filesystem::path(dir) / "cold"));
+   {
+      auto db = database::open(dir, open_mode::open_existing, cfg);
+      REQUIRE(db->get_stats().cold_segments > 0);
+      read_keys(*db->start_write_session(), 0, num_keys);
+   }
+
+   // a missing cold device must not open as a database full of holes
+   std::filesystem::rename(cold, cold + "_moved");
+   REQUIRE_THROWS_AS(database::open(dir, open_mode::open_existing, cfg), std::runtime_error);
+   std::filesystem::rename(cold + "_moved", cold);
+
+   std::filesystem::remove_all(dir);
+   std::filesystem::remove_all(cold);
+}
@@ -1,5 +1,6 @@
 #include <catch2/catch_all.hpp>
 #include <algorithm>
+#include <optional>
 #include <random>
 #include <string>
 #include <vector>
@@ -9,6 +10,7 @@
 #include <psitri/write_session_impl.hpp>
 #include <psitri/read_session_impl.hpp>
 #include <psitri/value_type.hpp>
+#include "point_lookups.hpp"
 
 using namespace psitri;
 
@@ -612,3 +614,143 @@ TEST_CASE("cursor: count_keys matches manual iteration for random ranges", "[cur
       REQUIRE(api_count == manual_count);
    }
 }
+
+// ============================================================
+// Batched point lookups
+// ============================================================
+
+TEST_CASE("cursor: get_many matches get for every key", "[cursor]")
+{
+   cursor_test_db t;
+   auto           cur = start_temp_edit(t);
+
+   const int N = 3000 / CURSOR_SCALE;
+   point_lookups::build(
+       N, [&](const std::string& k, const std::string& v)
+       { cur.upsert(to_key_view(k), to_value_view(v)); },
+       [&](const std::string& k) { cur.remove(to_key_view(k)); });
+   auto queries = point_lookups::queries(N, 7);
+
+   std::vector<key_view> keys(queries.begin(), queries.end());
+   auto                  rc = cur.snapshot_cursor();
+
+   std::vector<std::optional<std::string>> got(keys.size());
+   size_t found = rc.get_many(keys,
+                              [&](size_t i, value_view v)
+                              {
+                                 REQUIRE(!got[i]);
+                                 got[i].emplace(v.data(), v.size());
+                              });
+
+   size_t expected_found = 0;
+   for (size_t i = 0; i < keys.size(); ++i)
+   {
+      INFO("key " << queries[i]);
+      std::string buf;
+      if (rc.get(keys[i], &buf) >= 0)
+      {
+         ++expected_found;
+         REQUIRE(got[i]);
+         REQUIRE(*got[i] == buf);
+      }
+      else
+         REQUIRE(!got[i]);
+   }
+   REQUIRE(found == expected_found);
+   REQUIRE(rc.get_many({}, [](size_t, value_view) { FAIL(); }) == 0);
+}
+
+TEST_CASE("cursor: seeks near the current key match seeks from the root", "[cursor]")
+{
+   cursor_test_db t;
+   auto           cur = start_temp_edit(t);
+
+   const int N = 4000 / CURSOR_SCALE;
+   for (int i = 0; i < N; ++i)
+   {
+      cur.upsert(to_key_view(make_key(i)), to_value_view(make_value(i)));
+      if (i % 4 == 0)
+         cur.upsert(to_key_view("shared/prefix/" + make_key(i)), to_value_view(make_value(i)));
+   }
+   for (int i = 0; i < N; i += 3)
+      cur.remove(to_key_view(make_key(i)));
+
+   // A walk of mostly nearby keys, including ones between and past the
+   // stored keys, so seeks both resume in the current leaf and miss it.
+   auto         walk = cur.snapshot_cursor();
+   std::mt19937 rng(3);
+   int          pos = 0;
+   for (int step = 0; step < 20000 / CURSOR_SCALE; ++step)
+   {
+      pos = rng() % 50 == 0 ? int(rng() % N) : std::clamp(pos + int(rng() % 9) - 3, 0, N);
+      std::string q = make_key(pos);
+      switch (rng() % 4)
+      {
+         case 0:
+            q += "~";
+            break;
+         case 1:
+            q = "shared/prefix/" + q;
+            break;
+         default:
+            break;
+      }
+      INFO("step " << step << " key " << q);
+
+      auto fresh = cur.snapshot_cursor();
+      if (step % 2)
+      {
+         REQUIRE(walk.lower_bound(to_key_view(q)) == fresh.lower_bound(to_key_view(q)));
+         if (!fresh.is_end())
+         {
+            REQUIRE(walk.key() == fresh.key());
+            REQUIRE(walk.value<std::string>() == fresh.value<std::string>());
+            if (rng() % 3 == 0)
+               REQUIRE(walk.next() == fresh.next());
+         }
+      }
+      else
+      {
+         std::string a, b;
+         REQUIRE(walk.get(to_key_view(q), &a) == fresh.get(to_key_view(q), &b));
+         REQUIRE(a == b);
+      }
+   }
+}
+
+TEST_CASE("transaction: get_many sees the transaction's own writes", "[cursor]")
+{
+   cursor_test_db t;
+   auto           tx = t.ses->start_write_transaction(t.ses->create_temporary_tree());
+
+   const int N = 1000 / CURSOR_SCALE;
+   for (int i = 0; i < N; ++i)
+      tx.upsert(to_key_view(make_key(i)), to_value_view(make_value(i)));
+   for (int i = 0; i < N; i += 3)
+      tx.remove(to_key_view(make_key(i)));
+   for (int i = 1; i < N; i += 3)
+      tx.upsert(to_key_view(make_key(i)), to_value_view("updated"));
+
+   std::vector<std::string> queries;
+   for (int i = 0; i < N; ++i)
+      queries.push_back(make_key(i));
+   std::vector<key_view> keys(queries.begin(), queries.end());
+
+   std::vector<std::string> got(keys.size(), "<missing>");
+   size_t found = tx.get_many(keys,
+                              [&](size_t i, value_view v) { got[i].assign(v.data(), v.size()); });
+
+   size_t expected_found = 0;
+   for (int i = 0; i < N; ++i)
+   {
+      INFO("key " << queries[i]);
+      if (i % 3 == 0)
+         REQUIRE(got[i] == "<missing>");
+      else
+      {
+         ++expected_found;
+         REQUIRE(got[i] == (i % 3 == 1 ? std::string("updated") : make_value(i)));
+      }
+   }
+   REQUIRE(found == expected_found);
+}
@@ -1,4 +1,5 @@
 #include <catch2/catch_all.hpp>
+#include <fstream>
 #include <psitri/database.hpp>
 #include <psitri/database_impl.hpp>
 #include <psitri/read_session_impl.hpp>
@@ -78,3 +79,26 @@ TEST_CASE("database: independently built subtrees publish through one transactio
    REQUIRE(b3a_root.get<std::string>("block3a") == std::optional<std::string>("trx1"));
    REQUIRE(b3b_root.get<std::string>("block3b") == std::optional<std::string>("trx4"));
 }
+
+TEST_CASE("database: files from an older node format are refused", "[psitri][database]")
+{
+   database_test_dir tmp("database_node_format_testdb");
+   database::open(tmp.dir);
+
+   // a version 1 file carries the plain sal magic
+   {
+      std::fstream f(tmp.dir / "dbfile.bin", std::ios::in | std::ios::out | std::ios::binary);
+      REQUIRE(f);
+      uint32_t magic = sal::file_magic;
+      f.write(reinterpret_cast<const char*>(&magic), sizeof(magic));
+   }
+   try
+   {
+      database::open(tmp.dir);
+      FAIL("opened a database with an older node format");
+   }
+   catch (const std::runtime_error& e)
+   {
+      REQUIRE(std::string(e.what()).find("older node format") != std::string::npos);
+   }
+}
@@ -13,9 +13,12 @@
 #include <psitri/dwal/undo_log.hpp>
 #include <psitri/dwal/epoch_lock.hpp>
 #include <psitri/dwal/merge_pool.hpp>
+#include <psitri/dwal/shared_wal.hpp>
+#include <psitri/dwal/swap_controller.hpp>
 #include <psitri/dwal/transaction.hpp>
 #include <psitri/dwal/wal_format.hpp>
 #include <psitri/dwal/wal_reader.hpp>
+#include <psitri/dwal/wal_replay.hpp>
 #include <psitri/dwal/wal_writer.hpp>
 
 #include <chrono>
@@ -992,16 +995,13 @@ TEST_CASE("dwal_database swap_rw_to_ro", "[dwal]")
 
    // Now: RW is fresh (empty), buffered has the old data.
    CHECK(root.rw_layer->map.empty());
-   auto ro = root.buffered_ptr;
+   auto ro = root.buffered_owner;
    REQUIRE(ro != nullptr);
    CHECK(ro->map.get("pre_swap") != nullptr);
    CHECK(ro->map.get("pre_swap")->data == "data");
 
    // Clean up: simulate merge complete by clearing the buffered ptr.
-   {
-      std::unique_lock lk(root.buffered_mutex);
-      root.buffered_ptr.reset();
-   }
+   root.unpublish_buffered();
    root.merge_complete.store(true, std::memory_order_release);
 }
 
@@ -1323,6 +1323,73 @@ TEST_CASE("epoch_registry min_pinned across generations", "[dwal]")
    reg[s1].unlock();
 }
 
+TEST_CASE("epoch_registry advance and per-thread locks", "[dwal]")
+{
+   psitri::dwal::epoch_registry reg;
+
+   CHECK(reg.advance() == 0);
+   CHECK(reg.epoch() == 1);
+
+   // A slot allocated after the broadcast still pins the current epoch.
+   auto s0 = reg.allocate();
+   reg[s0].lock();
+   CHECK(reg[s0].pinned_generation() == 1);
+   reg[s0].unlock();
+   reg.release(s0);
+
+   // Each thread has its own lock, and an exiting thread gives it back.
+   auto& mine = reg.thread_lock();
+   CHECK(&mine == &reg.thread_lock());
+   psitri::dwal::dwal_session_lock* theirs = nullptr;
+   psitri::dwal::dwal_session_lock* next   = nullptr;
+   std::thread([&] { theirs = &reg.thread_lock(); }).join();
+   std::thread([&] { next = &reg.thread_lock(); }).join();
+   CHECK(theirs != &mine);
+   CHECK(next == theirs);
+   CHECK(reg.size() == 2);
+
+   {
+      std::lock_guard pin(mine);
+      CHECK(reg.min_pinned() == 1);
+
+      // Anything retired now waits for the pin.
+      CHECK(reg.advance() == 1);
+      CHECK_FALSE(reg.min_pinned() > 1);
+   }
+   CHECK(reg.min_pinned() > 1);
+}
+
+TEST_CASE("epoch_registry thread locks are per registry", "[dwal]")
+{
+   psitri::dwal::epoch_registry a;
+   psitri::dwal::epoch_registry b;
+   a.advance();
+
+   // Alternating between two registries keeps one lock in each.
+   auto& in_a = a.thread_lock();
+   auto& in_b = b.thread_lock();
+   CHECK(&a.thread_lock() == &in_a);
+   CHECK(&b.thread_lock() == &in_b);
+   CHECK(a.size() == 1);
+   CHECK(b.size() == 1);
+
+   // A pin in one registry survives a lookup in the other.
+   std::lock_guard pin(a.thread_lock());
+   CHECK(a.min_pinned() == 1);
+   b.thread_lock();
+   CHECK(a.min_pinned() == 1);
+   CHECK(b.min_pinned() == psitri::dwal::dwal_session_lock::idle);
+
+   // A registry created after one is destroyed gets a fresh lock.
+   {
+      psitri::dwal::epoch_registry gone;
+      gone.thread_lock();
+   }
+   psitri::dwal::epoch_registry c;
+   c.thread_lock();
+   CHECK(c.size() == 1);
+}
+
 // ── Merge Pool (integration) ──────────────────────────────────────
 
 TEST_CASE("merge_pool drains RO btree into PsiTri", "[dwal]")
@@ -1346,10 +1413,7 @@ TEST_CASE("merge_pool drains RO btree into PsiTri", "[dwal]")
    ro->generation = 1;
 
    // Set it as the buffered RO layer.
-   {
-      std::unique_lock lk(root.buffered_mutex);
-      root.buffered_ptr = ro;
-   }
+   root.publish_buffered(ro);
    root.merge_complete.store(false, std::memory_order_release);
 
    // Signal the merge pool.
@@ -1423,10 +1487,7 @@ TEST_CASE("merge_pool handles tombstones during drain", "[dwal]")
    ro->store_data("ddd", "val_d");
    ro->generation = 1;
 
-   {
-      std::unique_lock lk(root.buffered_mutex);
-      root.buffered_ptr = ro;
-   }
+   root.publish_buffered(ro);
    root.merge_complete.store(false, std::memory_order_release);
 
    pool.signal(0, root);
@@ -1464,6 +1525,165 @@ TEST_CASE("merge_pool handles tombstones during drain", "[dwal]")
    pool.shutdown();
 }
 
+namespace
+{
+   /// Drain an RO btree over a populated Tri root with a 4-thread pool that
+   /// partitions any drain, and compare the result with a std::map.  With
+   /// publish_entries, the drain commits in chunks of that many entries.
+   void check_partitioned_merge(bool empty_a_branch, uint64_t publish_entries = 0)
+   {
+      temp_dir tmp;
+      auto     db = psitri::database::create(tmp.path / "db");
+
+      // Keys spread over 26 first bytes so the root has many top-level branches.
+      auto make_key = [](int i) { return std::string(1, char('a' + i % 26)) + std::to_string(i); };
+
+      std::map<std::string, std::string> expect;
+      {
+         auto ws = db->start_write_session();
+         auto tx = ws->start_transaction(0);
+         for (int i = 0; i < 20000; ++i)
+         {
+            auto key = make_key(i);
+            tx.upsert(key, "old" + key);
+            expect[key] = "old" + key;
+         }
+         tx.commit();
+      }
+
+      // Overwrite, remove and add keys in every branch.
+      auto ro = std::make_shared<psitri::dwal::btree_layer>();
+      for (int i = 0; i < 30000; ++i)
+      {
+         auto key = make_key(i);
+         if (empty_a_branch && key[0] == 'q')
+         {
+            ro->store_tombstone(key);
+            expect.erase(key);
+         }
+         else if (i < 20000 && i % 5 == 0)
+         {
+            ro->store_tombstone(key);
+            expect.erase(key);
+         }
+         else if (i % 3 == 0 || i >= 20000)
+         {
+            ro->store_data(key, "new" + key);
+            expect[key] = "new" + key;
+         }
+      }
+      ro->generation       = 1;
+      const uint64_t total = ro->size();
+
+      psitri::dwal::epoch_registry epochs;
+      psitri::dwal::merge_pool     pool(db, 4, epochs, {}, 0, /*partition_min_entries=*/1000,
+                                        nullptr, false, publish_entries);
+      psitri::dwal::dwal_root      root;
+      root.publish_buffered(ro);
+      root.merge_complete.store(false, std::memory_order_release);
+      pool.signal(0, root);
+
+      auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+      while (!root.merge_complete.load(std::memory_order_acquire) &&
+             std::chrono::steady_clock::now() < deadline)
+         std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      REQUIRE(root.merge_complete.load());
+      CHECK(root.buffered_ptr == nullptr);
+      if (publish_entries)
+         CHECK(pool.stats().publishes == (total + publish_entries - 1) / publish_entries - 1);
+      pool.shutdown();
+
+      auto rs  = db->start_read_session();
+      auto cur = rs->snapshot_cursor(0);
+      cur.seek_begin();
+      for (auto& [key, value] : expect)
+      {
+         REQUIRE_FALSE(cur.is_end());
+         REQUIRE(cur.key() == key);
+         REQUIRE(cur.value<std::string>() == value);
+         cur.next();
+      }
+      CHECK(cur.is_end());
+   }
+}  // namespace
+
+TEST_CASE("merge_pool merges a large RO btree in parallel partitions", "[dwal]")
+{
+   check_partitioned_merge(false);
+}
+
+TEST_CASE("merge_pool falls back to a serial drain when a branch empties", "[dwal]")
+{
+   check_partitioned_merge(true);
+}
+
+TEST_CASE("merge_pool publishes a drain in chunks", "[dwal]")
+{
+   SECTION("partitioned chunks")
+   {
+      check_partitioned_merge(false, 4000);
+   }
+   SECTION("serial chunks")
+   {
+      check_partitioned_merge(true, 700);
+   }
+}
+
+TEST_CASE("merge_pool drains a root with a blocked writer first", "[dwal]")
+{
+   temp_dir tmp;
+   auto     db = psitri::database::create(tmp.path / "db");
+
+   psitri::dwal::epoch_registry epochs;
+   psitri::dwal::merge_pool     pool(db, 1, epochs);
+   psitri::dwal::dwal_root      roots[4];
+
+   auto fill = [&](uint32_t r, int entries)
+   {
+      auto ro = std::make_shared<psitri::dwal::btree_layer>();
+      for (int i = 0; i < entries; ++i)
+         ro->store_data("k" + std::to_string(r) + "-" + std::to_string(i), "v");
+      ro->generation = 1;
+      roots[r].publish_buffered(ro);
+      roots[r].merge_complete.store(false, std::memory_order_release);
+   };
+   for (uint32_t r = 0; r < 4; ++r)
+      fill(r, r == 0 ? 200000 : r == 3 ? 10 : 50000);
+
+   // Keep the only merge thread busy with root 0 while the others queue up.
+   pool.signal(0, roots[0]);
+   auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+   while (pool.stats().queue_depth != 0 && std::chrono::steady_clock::now() < deadline)
+      std::this_thread::yield();
+   REQUIRE_FALSE(roots[0].merge_complete.load());
+
+   // Root 3 is signaled last but has a writer blocked in backpressure.
+   roots[3].merge_waiters.store(1);
+   pool.signal(1, roots[1]);
+   pool.signal(2, roots[2]);
+   pool.signal(3, roots[3]);
+   CHECK(pool.stats().queue_depth == 3);
+
+   roots[3].merge_complete.wait(false);
+   CHECK_FALSE(roots[1].merge_complete.load());
+   CHECK_FALSE(roots[2].merge_complete.load());
+   roots[3].merge_waiters.store(0);
+
+   for (auto& root : roots)
+      root.merge_complete.wait(false);
+
+   auto stats = pool.stats();
+   INFO(stats.to_string());
+   CHECK(stats.queue_depth == 0);
+   CHECK(stats.merges == 4);
+   CHECK(stats.priority_merges == 1);
+   CHECK(stats.steals == 0);
+   CHECK(stats.queue_wait.count == 4);
+   for (auto& root : roots)
+      CHECK(root.merge_latency.snapshot().count == 1);
+   pool.shutdown();
+}
+
 TEST_CASE("epoch reclamation defers pool free until readers release", "[dwal]")
 {
    psitri::dwal::epoch_registry epochs;
@@ -1484,6 +1704,126 @@ TEST_CASE("epoch reclamation defers pool free until readers release", "[dwal]")
    epochs.release(s0);
 }
 
+TEST_CASE("merge_pool frees a merged RO btree once reader epochs end", "[dwal]")
+{
+   temp_dir tmp;
+   auto     db = psitri::database::create(tmp.path / "db");
+
+   psitri::dwal::epoch_registry epochs;
+   psitri::dwal::merge_pool     pool(db, 1, epochs);
+   psitri::dwal::dwal_root      root;
+
+   std::weak_ptr<psitri::dwal::btree_layer> weak;
+   {
+      auto ro = std::make_shared<psitri::dwal::btree_layer>();
+      ro->store_data("key", "val");
+      weak = ro;
+      root.publish_buffered(std::move(ro));
+   }
+   root.merge_complete.store(false, std::memory_order_release);
+
+   // A reader loads the RO btree inside its epoch and is still using it
+   // when the merge unpublishes it.
+   std::unique_lock pin(epochs.thread_lock());
+   auto*            seen = root.load_buffered();
+   REQUIRE(seen != nullptr);
+
+   pool.signal(0, root);
+   auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+   while (!root.merge_complete.load(std::memory_order_acquire) &&
+          std::chrono::steady_clock::now() < deadline)
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+   REQUIRE(root.merge_complete.load());
+   CHECK(root.buffered_ptr == nullptr);
+
+   std::this_thread::sleep_for(std::chrono::milliseconds(20));
+   CHECK_FALSE(weak.expired());
+   CHECK(seen->map.get("key")->data == "val");
+
+   pin.unlock();
+   deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+   while (!weak.expired() && std::chrono::steady_clock::now() < deadline)
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+   CHECK(weak.expired());
+
+   pool.shutdown();
+}
+
+TEST_CASE("dwal_database reads race RO btree swaps and merges", "[dwal]")
+{
+   temp_dir tmp;
+   auto     db = psitri::database::create(tmp.path / "db");
+
+   psitri::dwal::dwal_config dcfg;
+   dcfg.merge_threads  = 1;
+   dcfg.max_rw_entries = 200;
+   psitri::dwal::dwal_database dwal_db(db, tmp.path / "wal", dcfg);
+
+   constexpr int         total = 4000;
+   std::atomic<int>      written{0};
+   std::atomic<bool>     done{false};
+   std::atomic<uint64_t> found{0}, wrong{0};
+
+   std::vector<std::thread> readers;
+   for (int t = 0; t < 4; ++t)
+      readers.emplace_back(
+          [&, t]
+          {
+             auto         session = dwal_db.start_read_session();
+             std::mt19937 rng(t);
+             while (!done.load(std::memory_order_acquire))
+             {
+                int n = written.load(std::memory_order_acquire);
+                if (n == 0)
+                   continue;
+                int  i      = int(rng() % n);
+                auto key    = "k" + std::to_string(i);
+                auto expect = "v" + std::to_string(i);
+
+                // dwal_database::get pins an epoch per call; the session
+                // only on refresh.
+                auto r = dwal_db.get(0, key, psitri::dwal::read_mode::buffered);
+                if (r.found)
+                {
+                   found.fetch_add(1, std::memory_order_relaxed);
+                   if (std::string(r.value.data) != expect)
+                      wrong.fetch_add(1, std::memory_order_relaxed);
+                }
+                auto s = session.get(0, key, psitri::dwal::read_mode::buffered);
+                if (s.found)
+                {
+                   found.fetch_add(1, std::memory_order_relaxed);
+                   if (s.value != expect)
+                      wrong.fetch_add(1, std::memory_order_relaxed);
+                }
+             }
+          });
+
+   for (int i = 0; i < total; i += 50)
+   {
+      auto tx = dwal_db.start_write_transaction(0);
+      for (int j = i; j < i + 50; ++j)
+         tx.upsert("k" + std::to_string(j), "v" + std::to_string(j));
+      tx.commit();
+      written.store(i + 50, std::memory_order_release);
+      // Leave the merges time to finish, so commits keep swapping.
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+   }
+   std::this_thread::sleep_for(std::chrono::milliseconds(50));
+   done.store(true, std::memory_order_release);
+   for (auto& r : readers)
+      r.join();
+
+   CHECK(wrong.load() == 0);
+   CHECK(found.load() > 0);
+   CHECK(dwal_db.get_merge_stats().merges > 1);
+
+   auto session = dwal_db.start_read_session();
+   for (int i = 0; i < total; i += 97)
+      CHECK(session.get(0, "k" + std::to_string(i), psitri::dwal::read_mode::latest).value ==
+            "v" + std::to_string(i));
+}
+
 // ═══════════════════════════════════════════════════════════════════════
 // Allocation leak tests — verify COW trees are released after cursor refresh
 // ═══════════════════════════════════════════════════════════════════════
@@ -2003,6 +2343,104 @@ TEST_CASE("get_latest RW tombstone shadows RO and Tri", "[dwal]")
    CHECK_FALSE(r.found);
 }
 
+TEST_CASE("get_latest_many reads through RW, RO, and Tri layers", "[dwal]")
+{
+   temp_dir td;
+   auto     db = psitri::database::create(td.path / "db");
+
+   psitri::dwal::dwal_config dcfg;
+   dcfg.merge_threads  = 1;
+   dcfg.max_rw_entries = 5000;
+   psitri::dwal::dwal_database dwal_db(db, td.path / "wal", dcfg);
+
+   // Mirrors every write; the RO layer may merge while the test runs, but
+   // the results must not change (or dangle) when it does.
+   std::map<std::string, std::string> expected;
+   auto key = [](const char* layer, int i) { return std::string(layer) + std::to_string(i); };
+
+   // Tri: 300 keys.
+   {
+      auto tx = dwal_db.start_write_transaction(0);
+      for (int i = 0; i < 300; ++i)
+      {
+         tx.upsert(key("tri", i), "tri_val" + std::to_string(i));
+         expected[key("tri", i)] = "tri_val" + std::to_string(i);
+      }
+      tx.commit();
+   }
+   dwal_db.swap_rw_to_ro(0);
+   auto& root = dwal_db.root(0);
+   for (int i = 0; i < 100 && !root.merge_complete.load(); ++i)
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+   REQUIRE(root.merge_complete.load());
+
+   // RO: new keys, overwrites and deletes of Tri keys.
+   {
+      auto tx = dwal_db.start_write_transaction(0);
+      for (int i = 0; i < 100; ++i)
+      {
+         tx.upsert(key("ro", i), "ro_val");
+         expected[key("ro", i)] = "ro_val";
+      }
+      for (int i = 0; i < 300; i += 4)
+      {
+         tx.upsert(key("tri", i), "ro_over");
+         expected[key("tri", i)] = "ro_over";
+      }
+      for (int i = 1; i < 300; i += 4)
+      {
+         tx.remove(key("tri", i));
+         expected.erase(key("tri", i));
+      }
+      tx.commit();
+   }
+   dwal_db.swap_rw_to_ro(0);
+
+   // RW: shadows some of both.
+   {
+      auto tx = dwal_db.start_write_transaction(0);
+      for (int i = 0; i < 100; i += 2)
+      {
+         tx.remove(key("ro", i));
+         expected.erase(key("ro", i));
+      }
+      for (int i = 0; i < 300; i += 3)
+      {
+         tx.upsert(key("tri", i), "rw_over");
+         expected[key("tri", i)] = "rw_over";
+      }
+      tx.upsert("rw_only", "rw_val");
+      expected["rw_only"] = "rw_val";
+      tx.commit();
+   }
+
+   std::vector<std::string> owned;
+   for (int i = 0; i < 320; ++i)
+      owned.push_back(key("tri", i));
+   for (int i = 0; i < 110; ++i)
+      owned.push_back(key("ro", i));
+   owned.push_back("rw_only");
+   std::vector<std::string_view> keys(owned.begin(), owned.end());
+
+   auto many = dwal_db.get_latest_many(0, keys);
+
+   // Let the RO merge finish and its layer be freed before checking.
+   for (int i = 0; i < 100 && !root.merge_complete.load(); ++i)
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+   std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+   REQUIRE(many.size() == keys.size());
+   for (size_t i = 0; i < keys.size(); ++i)
+   {
+      INFO("key " << keys[i]);
+      auto it = expected.find(owned[i]);
+      REQUIRE(many[i].found == (it != expected.end()));
+      if (many[i].found)
+         CHECK(many[i].value.data == it->second);
+   }
+   CHECK(dwal_db.get_latest_many(0, {}).empty());
+}
+
 // ═══════════════════════════════════════════════════════════════════════
 // dwal_read_session — read mode semantics
 // ═══════════════════════════════════════════════════════════════════════
@@ -2101,10 +2539,7 @@ TEST_CASE("read_session refreshes on generation change", "[dwal]")
    // merge_complete is false (merge_threads=0), so swap won't fire via try_swap.
    // Force it by setting merge_complete manually.
    dwal_db.root(0).merge_complete.store(true, std::memory_order_release);
-   {
-      std::unique_lock lk(dwal_db.root(0).buffered_mutex);
-      dwal_db.root(0).buffered_ptr.reset();
-   }
+   dwal_db.root(0).unpublish_buffered();
 
    {
       auto tx = dwal_db.start_write_transaction(0);
@@ -2310,6 +2745,128 @@ TEST_CASE("merge_cursor prev across RW + RO + Tri", "[dwal]")
    CHECK(mc.is_rend());
 }
 
+TEST_CASE("merge_cursor matches a model across tombstones and direction changes", "[dwal]")
+{
+   temp_dir td;
+   auto     db = psitri::database::create(td.path / "db");
+
+   auto key = [](int i)
+   {
+      char buf[8];
+      snprintf(buf, sizeof(buf), "k%03d", i);
+      return std::string(buf);
+   };
+
+   {
+      auto ws = db->start_write_session();
+      auto tx = ws->start_transaction(0);
+      for (int i = 0; i < 300; i += 2)
+         tx.upsert(key(i), "tri");
+      tx.commit();
+   }
+
+   // Range tombstones first: map entries inside a range were written later.
+   psitri::dwal::btree_layer ro;
+   ro.tombstones.add(key(100), key(140));
+   for (int i = 0; i < 300; i += 3)
+   {
+      if (i % 7)
+         ro.store_data(key(i), "ro");
+      else
+         ro.store_tombstone(key(i));
+   }
+
+   psitri::dwal::btree_layer rw;
+   rw.tombstones.add(key(120), key(135));
+   rw.tombstones.add(key(200), key(260));
+   for (int i = 0; i < 300; i += 5)
+   {
+      if (i % 11)
+         rw.store_data(key(i), "rw");
+      else
+         rw.store_tombstone(key(i));
+   }
+
+   std::map<std::string, std::string> expect;
+   for (int i = 0; i < 300; ++i)
+   {
+      auto k = key(i);
+      if (auto* v = rw.map.get(k))
+      {
+         if (!v->is_tombstone())
+            expect[k] = "rw";
+      }
+      else if (rw.tombstones.is_deleted(k))
+         continue;
+      else if (auto* v = ro.map.get(k))
+      {
+         if (!v->is_tombstone())
+            expect[k] = "ro";
+      }
+      else if (!ro.tombstones.is_deleted(k) && i % 2 == 0)
+         expect[k] = "tri";
+   }
+
+   auto rs = db->start_read_session();
+   psitri::dwal::merge_cursor mc(&rw, &ro, rs->snapshot_cursor(0));
+
+   auto value = [&]
+   {
+      if (mc.current_source() == psitri::dwal::merge_cursor::source::tri)
+         return mc.tri_cursor()->value<std::string>().value_or("");
+      return std::string(mc.current_value().data);
+   };
+   auto check_at = [&](std::map<std::string, std::string>::iterator it)
+   {
+      REQUIRE_FALSE(mc.is_end());
+      REQUIRE_FALSE(mc.is_rend());
+      REQUIRE(std::string(mc.key()) == it->first);
+      REQUIRE(value() == it->second);
+   };
+
+   // Full scans in both directions.
+   mc.seek_begin();
+   for (auto it = expect.begin(); it != expect.end(); ++it, mc.next())
+      check_at(it);
+   CHECK(mc.is_end());
+   mc.seek_last();
+   for (auto it = expect.rbegin(); it != expect.rend(); ++it, mc.prev())
+      check_at(std::prev(it.base()));
+   CHECK(mc.is_rend());
+
+   // Random walks that turn around.
+   std::mt19937 rng(19);
+   for (int walk = 0; walk < 200; ++walk)
+   {
+      auto start = key(rng() % 310);
+      auto it    = expect.lower_bound(start);
+      mc.lower_bound(start);
+      if (it == expect.end())
+      {
+         CHECK(mc.is_end());
+         continue;
+      }
+      for (int step = 0; step < 20; ++step)
+      {
+         check_at(it);
+         if (rng() % 2)
+         {
+            if (std::next(it) == expect.end())
+               break;
+            ++it;
+            mc.next();
+         }
+         else
+         {
+            if (it == expect.begin())
+               break;
+            --it;
+            mc.prev();
+         }
+      }
+   }
+}
+
 // ═══════════════════════════════════════════════════════════════════════
 // dwal_transaction get() across layers
 // ═══════════════════════════════════════════════════════════════════════
@@ -4659,6 +5216,845 @@ TEST_CASE("multi-root transaction: remove across roots", "[dwal][multi-root]")
    CHECK_FALSE(r1.found);
 }
 
+// ═══════════════════════════════════════════════════════════════════════
+// Shared WAL tests
+// ═══════════════════════════════════════════════════════════════════════
+
+TEST_CASE("shared WAL: roots' entries round-trip through one segment", "[dwal][shared-wal]")
+{
+   temp_dir td;
+   auto     dir = td.path / "shared";
+
+   uint64_t segment = 0;
+   {
+      psitri::dwal::shared_wal log(dir, 64 * 1024 * 1024, 512);
+      segment = log.active_segment();
+
+      psitri::dwal::wal_writer w0(log, 0, 10);
+      psitri::dwal::wal_writer w3(log, 3, 20);
+
+      w0.begin_entry();
+      w0.add_upsert_data("a", "1");
+      w0.commit_entry();
+
+      w3.begin_entry();
+      w3.add_remove("b");
+      w3.commit_entry_multi(7, 2, false);
+      w0.begin_entry();
+      w0.add_upsert_data("c", "3");
+      w0.commit_entry_multi(7, 2, true);
+
+      // Every appended entry is covered by a single sync.
+      w3.flush(sal::sync_type::fsync);
+      w0.flush(sal::sync_type::fsync);
+      CHECK(log.sync_count() == 1);
+   }
+
+   psitri::dwal::wal_reader reader;
+   REQUIRE(reader.open(psitri::dwal::shared_wal::segment_path(dir, segment)));
+   CHECK(reader.is_shared_log());
+   CHECK_FALSE(reader.was_clean_close());
+
+   psitri::dwal::wal_entry entry;
+   REQUIRE(reader.next(entry));
+   CHECK(entry.root_index == 0);
+   CHECK(entry.sequence == 10);
+   CHECK(entry.ops[0].key == "a");
+
+   REQUIRE(reader.next(entry));
+   CHECK(entry.root_index == 3);
+   CHECK(entry.sequence == 20);
+   CHECK(entry.multi_tx_id == 7);
+   CHECK(entry.ops[0].type == psitri::dwal::wal_op_type::remove);
+
+   REQUIRE(reader.next(entry));
+   CHECK(entry.root_index == 0);
+   CHECK(entry.sequence == 11);
+   CHECK(entry.is_multi_tx_commit());
+
+   CHECK_FALSE(reader.next(entry));
+}
+
+TEST_CASE("shared WAL: recovery demultiplexes roots and retires merged segments",
+          "[dwal][shared-wal][recovery]")
+{
+   temp_dir td;
+   auto     db       = psitri::database::create(td.path / "db");
+   auto     wal_path = td.path / "wal";
+   auto     dir      = wal_path / "shared";
+
+   // Write two roots' entries plus an orphaned multi-tx entry, then
+   // "crash" without a clean close.
+   uint64_t segment = 0;
+   {
+      psitri::dwal::shared_wal log(dir, 64 * 1024 * 1024, 512);
+      segment = log.active_segment();
+
+      psitri::dwal::wal_writer w0(log, 0);
+      psitri::dwal::wal_writer w5(log, 5);
+      for (int i = 0; i < 100; ++i)
+      {
+         auto& w = (i % 2) ? w5 : w0;
+         w.begin_entry();
+         w.add_upsert_data("key" + std::to_string(i), "val" + std::to_string(i));
+         w.commit_entry();
+      }
+      w0.begin_entry();
+      w0.add_remove("key0");
+      w0.commit_entry();
+
+      w5.begin_entry();
+      w5.add_upsert_data("orphan", "x");
+      w5.commit_entry_multi(99, 2, false);
+      log.flush(sal::sync_type::none);
+   }
+
+   psitri::dwal::dwal_config dcfg;
+   dcfg.shared_log    = true;
+   dcfg.merge_threads = 1;
+   psitri::dwal::dwal_database dwal_db(db, wal_path, dcfg);
+
+   CHECK_FALSE(dwal_db.get_latest(0, "key0").found);
+   CHECK(dwal_db.get_latest(0, "key2").value.data == "val2");
+   CHECK_FALSE(dwal_db.get_latest(0, "key3").found);
+   CHECK(dwal_db.get_latest(5, "key3").value.data == "val3");
+   CHECK_FALSE(dwal_db.get_latest(5, "orphan").found);
+
+   // The recovered entries live only in the RW btrees, so the old segment
+   // stays until both roots have merged them.
+   auto old_segment = psitri::dwal::shared_wal::segment_path(dir, segment);
+   CHECK(std::filesystem::exists(old_segment));
+
+   for (uint32_t root : {0u, 5u})
+   {
+      dwal_db.swap_rw_to_ro(root);
+      dwal_db.root(root).merge_complete.wait(false);
+   }
+   CHECK_FALSE(std::filesystem::exists(old_segment));
+   CHECK(dwal_db.get_latest(5, "key99").value.data == "val99");
+}
+
+TEST_CASE("shared WAL: multi-root commit syncs once", "[dwal][shared-wal][multi-root]")
+{
+   temp_dir td;
+   auto     db = psitri::database::create(td.path / "db");
+
+   psitri::dwal::dwal_config dcfg;
+   dcfg.shared_log    = true;
+   dcfg.commit_sync   = sal::sync_type::fsync;
+   dcfg.merge_threads = 0;
+   psitri::dwal::dwal_database dwal_db(db, td.path / "wal", dcfg);
+   REQUIRE(dwal_db.shared_log());
+
+   uint64_t before = dwal_db.shared_log()->sync_count();
+   {
+      auto tx = dwal_db.start_transaction({0, 1, 2, 3});
+      for (uint32_t r = 0; r < 4; ++r)
+         tx.upsert(r, "k", "v" + std::to_string(r));
+      tx.commit();
+   }
+   CHECK(dwal_db.shared_log()->sync_count() == before + 1);
+
+   for (uint32_t r = 0; r < 4; ++r)
+      CHECK(dwal_db.get_latest(r, "k").value.data == "v" + std::to_string(r));
+}
+
+TEST_CASE("shared WAL: concurrent committers and clean reopen", "[dwal][shared-wal]")
+{
+   temp_dir td;
+   auto     db       = psitri::database::create(td.path / "db");
+   auto     wal_path = td.path / "wal";
+
+   psitri::dwal::dwal_config dcfg;
+   dcfg.shared_log               = true;
+   dcfg.shared_log_segment_bytes = 16 * 1024;  // force segment rolls
+   dcfg.commit_sync              = sal::sync_type::fsync;
+   dcfg.max_rw_entries           = 50;
+   dcfg.merge_threads            = 2;
+
+   constexpr int threads = 4;
+   constexpr int commits = 200;
+   {
+      psitri::dwal::dwal_database dwal_db(db, wal_path, dcfg);
+
+      std::vector<std::thread> writers;
+      for (int t = 0; t < threads; ++t)
+         writers.emplace_back(
+             [&, t]
+             {
+                for (int i = 0; i < commits; ++i)
+                {
+                   auto tx = dwal_db.start_write_transaction(t);
+                   tx.upsert("key" + std::to_string(i), "val" + std::to_string(i));
+                   tx.commit();
+                }
+             });
+      for (auto& w : writers)
+         w.join();
+
+      CHECK(dwal_db.shared_log()->sync_count() <= uint64_t(threads * commits));
+      for (int t = 0; t < threads; ++t)
+         CHECK(dwal_db.get_latest(t, "key" + std::to_string(commits - 1)).found);
+   }
+
+   // The clean close leaves nothing to replay.
+   dcfg.merge_threads = 0;
+   psitri::dwal::dwal_database dwal_db(db, wal_path, dcfg);
+   CHECK(psitri::dwal::shared_wal::list_segments(wal_path / "shared").size() == 1);
+   for (int t = 0; t < threads; ++t)
+   {
+      CHECK(dwal_db.root(t).rw_layer->empty());
+      CHECK(dwal_db.get_latest(t, "key0").value.data == "val0");
+   }
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+// WAL I/O engine tests
+// ═══════════════════════════════════════════════════════════════════════
+
+namespace
+{
+   /// Sequence and first op of one WAL entry, copied out of the reader.
+   struct wal_record
+   {
+      uint64_t                  sequence;
+      psitri::dwal::wal_op_type type;
+      std::string               key;
+   };
+
+   /// Read every valid entry of a per-root WAL file.
+   std::vector<wal_record> read_wal(const std::filesystem::path& path)
+   {
+      std::vector<wal_record>  out;
+      psitri::dwal::wal_reader reader;
+      if (reader.open(path))
+         reader.replay_all(
+             [&](const psitri::dwal::wal_entry& e)
+             { out.push_back({e.sequence, e.ops[0].type, std::string(e.ops[0].key)}); });
+      return out;
+   }
+}  // namespace
+
+TEST_CASE("wal_writer round-trips through each I/O engine", "[dwal][wal][wal-io]")
+{
+   using psitri::dwal::wal_io_mode;
+   for (auto mode : {wal_io_mode::sync, wal_io_mode::thread_pool, wal_io_mode::io_uring})
+   {
+      INFO("wal_io_mode " << int(mode));
+      temp_dir td;
+      auto     wal_path = td.path / "test.dwal";
+      auto     engine   = psitri::dwal::wal_io_engine::create(mode, 2);
+      CHECK((engine == nullptr) == (mode == wal_io_mode::sync));
+
+      psitri::dwal::wal_writer_options opts;
+      opts.io           = engine.get();
+      opts.buffer_bytes = 4096;  // many background writes
+      {
+         psitri::dwal::wal_writer w(wal_path, 0, 0, opts);
+         for (int i = 0; i < 500; ++i)
+         {
+            w.begin_entry();
+            w.add_upsert_data("key" + std::to_string(i), std::string(100, char('a' + i % 26)));
+            w.commit_entry();
+            if (i % 100 == 0)
+               w.flush(sal::sync_type::fsync);
+         }
+         // An aborted entry between committed ones leaves no trace.
+         w.begin_entry();
+         w.add_remove("gone");
+         w.discard_entry();
+         w.begin_entry();
+         w.add_remove("key0");
+         w.commit_entry();
+         w.close();
+      }
+
+      auto entries = read_wal(wal_path);
+      REQUIRE(entries.size() == 501);
+      for (int i = 0; i < 500; ++i)
+      {
+         CHECK(entries[i].sequence == uint64_t(i));
+         CHECK(entries[i].key == "key" + std::to_string(i));
+      }
+      CHECK(entries[500].type == psitri::dwal::wal_op_type::remove);
+      CHECK(entries[500].key == "key0");
+   }
+}
+
+TEST_CASE("wal_writer flush mid-entry writes only committed entries", "[dwal][wal][wal-io]")
+{
+   temp_dir td;
+   auto     wal_path = td.path / "test.dwal";
+   auto     engine   = psitri::dwal::wal_io_engine::create(psitri::dwal::wal_io_mode::thread_pool, 1);
+
+   psitri::dwal::wal_writer_options opts;
+   opts.io = engine.get();
+   psitri::dwal::wal_writer w(wal_path, 0, 0, opts);
+   w.begin_entry();
+   w.add_upsert_data("a", "1");
+   w.commit_entry();
+
+   w.begin_entry();
+   w.add_upsert_data("b", "2");
+   w.flush(sal::sync_type::fsync);
+   CHECK(read_wal(wal_path).size() == 1);
+
+   w.commit_entry();
+   w.flush(sal::sync_type::fsync);
+   auto entries = read_wal(wal_path);
+   REQUIRE(entries.size() == 2);
+   CHECK(entries[1].key == "b");
+}
+
+TEST_CASE("preallocated WAL file keeps its size and reopens at the last entry",
+          "[dwal][wal][wal-io]")
+{
+   temp_dir td;
+   auto     wal_path = td.path / "test.dwal";
+
+   psitri::dwal::wal_writer_options opts;
+   opts.preallocate_bytes = 1 << 20;
+   {
+      psitri::dwal::wal_writer w(wal_path, 0, 5, opts);
+      for (int i = 0; i < 10; ++i)
+      {
+         w.begin_entry();
+         w.add_upsert_data("k" + std::to_string(i), "v");
+         w.commit_entry();
+      }
+      w.flush(sal::sync_type::fsync);
+      CHECK(w.file_size() < opts.preallocate_bytes);
+   }
+#ifdef __linux__
+   CHECK(std::filesystem::file_size(wal_path) == opts.preallocate_bytes);
+#endif
+
+   // The zeroed tail ends the log; a reopened writer appends after entry 14.
+   {
+      psitri::dwal::wal_writer w(wal_path, 0, 0, opts);
+      CHECK(w.next_sequence() == 15);
+      w.begin_entry();
+      w.add_upsert_data("k10", "v");
+      w.commit_entry();
+      w.close();
+   }
+   auto entries = read_wal(wal_path);
+   REQUIRE(entries.size() == 11);
+   CHECK(entries.back().sequence == 15);
+   CHECK(entries.back().key == "k10");
+}
+
+TEST_CASE("recycled WAL file hides its old entries", "[dwal][wal][wal-io]")
+{
+   temp_dir td;
+   auto     spare    = td.path / "wal-free.dwal";
+   auto     wal_path = td.path / "wal-rw.dwal";
+
+   // A full file from the previous generation: sequences 0..99.
+   {
+      psitri::dwal::wal_writer w(spare, 0, 0);
+      for (int i = 0; i < 100; ++i)
+      {
+         w.begin_entry();
+         w.add_upsert_data("old" + std::to_string(i), "x");
+         w.commit_entry();
+      }
+      w.close();
+   }
+   auto old_size = std::filesystem::file_size(spare);
+
+   psitri::dwal::wal_writer_options opts;
+   opts.recycle_from = spare;
+   {
+      psitri::dwal::wal_writer w(wal_path, 0, 100, opts);
+      CHECK_FALSE(std::filesystem::exists(spare));
+      for (int i = 0; i < 3; ++i)
+      {
+         w.begin_entry();
+         w.add_upsert_data("new" + std::to_string(i), "y");
+         w.commit_entry();
+      }
+      w.flush(sal::sync_type::fsync);
+   }
+
+   // Written in place: the file didn't grow, and the reader stops at the
+   // first leftover entry, whose sequence precedes the new ones.
+   CHECK(std::filesystem::file_size(wal_path) == old_size);
+   auto entries = read_wal(wal_path);
+   REQUIRE(entries.size() == 3);
+   CHECK(entries[0].sequence == 100);
+   CHECK(entries[2].key == "new2");
+}
+
+TEST_CASE("dwal_database recycles preallocated WAL files across swaps",
+          "[dwal][wal-io][recovery]")
+{
+   temp_dir td;
+   auto     db       = psitri::database::create(td.path / "db");
+   auto     wal_path = td.path / "wal";
+   auto     root_dir = wal_path / "root-0";
+
+   psitri::dwal::dwal_config dcfg;
+   dcfg.wal_io          = psitri::dwal::wal_io_mode::io_uring;
+   dcfg.wal_preallocate = true;
+   dcfg.max_wal_bytes   = 256 * 1024;
+   dcfg.merge_threads   = 1;
+   {
+      psitri::dwal::dwal_database dwal_db(db, wal_path, dcfg);
+      REQUIRE(dwal_db.wal_io());
+
+      for (int round = 0; round < 3; ++round)
+      {
+         for (int i = 0; i < 50; ++i)
+         {
+            auto tx = dwal_db.start_write_transaction(0);
+            tx.upsert("key" + std::to_string(i), "r" + std::to_string(round));
+            tx.commit();
+         }
+         dwal_db.swap_rw_to_ro(0);
+         dwal_db.root(0).merge_complete.wait(false);
+         // The drained RO file is kept as the next RW file.
+         CHECK(std::filesystem::exists(root_dir / "wal-free.dwal"));
+         CHECK_FALSE(std::filesystem::exists(root_dir / "wal-ro.dwal"));
+      }
+
+      {
+         auto tx = dwal_db.start_write_transaction(0);
+         tx.upsert("last", "x");
+         tx.commit();
+      }
+      dwal_db.flush_wal(sal::sync_type::fsync);
+
+      // The RW file is a recycled one, still holding the entries it was
+      // written with two generations ago; recovery would replay only the
+      // new one.
+      auto entries = read_wal(root_dir / "wal-rw.dwal");
+      REQUIRE(entries.size() == 1);
+      CHECK(entries[0].key == "last");
+      CHECK(entries[0].sequence == 150);
+   }
+
+   // A clean close leaves the spare for the next run.
+   CHECK(std::filesystem::exists(root_dir / "wal-free.dwal"));
+   dcfg.merge_threads = 0;
+   psitri::dwal::dwal_database dwal_db(db, wal_path, dcfg);
+   CHECK(dwal_db.get_latest(0, "last").value.data == "x");
+   for (int i = 0; i < 50; ++i)
+      CHECK(dwal_db.get_latest(0, "key" + std::to_string(i)).value.data == "r2");
+}
+
+TEST_CASE("multi-root commit syncs every root's WAL through the I/O engine",
+          "[dwal][wal-io][multi-root]")
+{
+   temp_dir td;
+   auto     db = psitri::database::create(td.path / "db");
+
+   psitri::dwal::dwal_config dcfg;
+   dcfg.wal_io        = psitri::dwal::wal_io_mode::thread_pool;
+   dcfg.commit_sync   = sal::sync_type::fsync;
+   dcfg.merge_threads = 0;
+   psitri::dwal::dwal_database dwal_db(db, td.path / "wal", dcfg);
+   REQUIRE(dwal_db.wal_io());
+
+   for (int i = 0; i < 20; ++i)
+   {
+      auto tx = dwal_db.start_transaction({0, 1, 2, 3});
+      for (uint32_t r = 0; r < 4; ++r)
+         tx.upsert(r, "k" + std::to_string(i), "v" + std::to_string(r));
+      tx.commit();
+   }
+
+   // Each commit returned only after its entries were on disk.
+   for (uint32_t r = 0; r < 4; ++r)
+   {
+      auto entries = read_wal(td.path / "wal" / ("root-" + std::to_string(r)) / "wal-rw.dwal");
+      REQUIRE(entries.size() == 20);
+      CHECK(entries.back().key == "k19");
+   }
+}
+
+TEST_CASE("wal_replay resolves multi-root transactions across more files than threads",
+          "[dwal][wal][recovery]")
+{
+   temp_dir td;
+   constexpr int                      files = 6;
+   std::vector<std::filesystem::path> paths;
+   for (int f = 0; f < files; ++f)
+      paths.push_back(td.path / ("wal-" + std::to_string(f) + ".dwal"));
+
+   // Each file: enough single-root entries for the apply stage to trail the
+   // scan across several published chunks, with multi-root entries between.
+   auto write_file = [&](int f, auto&& multi)
+   {
+      psitri::dwal::wal_writer w(paths[f], uint16_t(f), 0);
+      for (int i = 0; i < 300; ++i)
+      {
+         w.begin_entry();
+         w.add_upsert_data("f" + std::to_string(f) + "-" + std::to_string(i),
+                           std::string(500, 'x'));
+         w.commit_entry();
+         if (i == 150)
+            multi(w);
+      }
+      w.flush();
+   };
+   auto part = [](uint64_t tx, uint16_t n, bool commit)
+   {
+      return [=](psitri::dwal::wal_writer& w)
+      {
+         w.begin_entry();
+         w.add_upsert_data("tx" + std::to_string(tx), "v");
+         w.commit_entry_multi(tx, n, commit);
+      };
+   };
+   // Complete: files 0 and 5.  Missing a participant: files 1 and 4 of
+   // three.  Never committed: files 2 and 3.
+   write_file(0, part(7, 2, false));
+   write_file(5, part(7, 2, true));
+   write_file(1, part(8, 3, false));
+   write_file(4, part(8, 3, true));
+   write_file(2, part(9, 2, false));
+   write_file(3, part(9, 2, false));
+
+   // A torn tail on one file ends its replay at the last whole entry.
+   {
+      std::ofstream out(paths[2], std::ios::binary | std::ios::app);
+      out << std::string(37, '\x7f');
+   }
+
+   for (uint32_t threads : {1u, 4u})
+   {
+      INFO("threads " << threads);
+      std::vector<std::vector<std::string>> keys(files);
+      std::vector<uint64_t>                 end_seq(files);
+
+      psitri::dwal::wal_replay_options opts;
+      opts.threads         = threads;
+      opts.filter_multi_tx = true;
+      psitri::dwal::wal_replay::run(paths, opts,
+                                    [&](size_t i, psitri::dwal::wal_replay_source& src)
+                                    {
+                                       CHECK(src.header().root_index == i);
+                                       psitri::dwal::wal_entry e;
+                                       while (src.next(e))
+                                          keys[i].emplace_back(e.ops[0].key);
+                                       end_seq[i] = src.end_sequence();
+                                    });
+
+      for (int f = 0; f < files; ++f)
+      {
+         bool applied = f == 0 || f == 5;
+         REQUIRE(keys[f].size() == (applied ? 301u : 300u));
+         CHECK(keys[f].front() == "f" + std::to_string(f) + "-0");
+         CHECK(keys[f].back() == "f" + std::to_string(f) + "-299");
+         if (applied)
+            CHECK(keys[f][151] == "tx7");
+         // Filtered entries still advance the sequence.
+         CHECK(end_seq[f] == 301);
+      }
+   }
+}
+
+TEST_CASE("dwal recover replays many roots in parallel", "[dwal][recovery]")
+{
+   temp_dir       td;
+   auto           db       = psitri::database::create(td.path / "db");
+   auto           wal_path = td.path / "wal";
+   constexpr auto roots    = 8u;
+
+   // Unclean RW files for every root, each ending in its half of a
+   // transaction with the root furthest away in replay order.  Roots 0
+   // and 7 never got their commit marker.  A few roots also left an
+   // unmerged RO file, which goes straight into Tri.
+   for (uint32_t r = 0; r < roots; ++r)
+   {
+      auto dir = wal_path / ("root-" + std::to_string(r));
+      std::filesystem::create_directories(dir);
+
+      psitri::dwal::wal_writer rw(dir / "wal-rw.dwal", uint16_t(r), 0);
+      for (int i = 0; i < 100; ++i)
+      {
+         rw.begin_entry();
+         rw.add_upsert_data("k" + std::to_string(i), "r" + std::to_string(r));
+         rw.commit_entry();
+      }
+      uint32_t peer = roots - 1 - r;
+      rw.begin_entry();
+      rw.add_upsert_data("multi", "yes");
+      rw.commit_entry_multi(1 + std::min(r, peer), 2, r > peer && r != roots - 1);
+      rw.flush();
+
+      if (r % 6 == 0)
+      {
+         psitri::dwal::wal_writer ro(dir / "wal-ro.dwal", uint16_t(r), 0);
+         ro.begin_entry();
+         ro.add_upsert_data("frozen", "f" + std::to_string(r));
+         ro.commit_entry();
+         ro.flush();
+      }
+   }
+
+   psitri::dwal::dwal_config dcfg;
+   dcfg.merge_threads    = 0;
+   dcfg.recovery_threads = 4;
+   psitri::dwal::dwal_database dwal_db(db, wal_path, dcfg);
+   for (uint32_t r = 0; r < roots; ++r)
+   {
+      auto rs = "root-" + std::to_string(r);
+      CHECK_FALSE(std::filesystem::exists(wal_path / rs / "wal-ro.dwal"));
+      CHECK(dwal_db.get_latest(r, "k99").value.data == "r" + std::to_string(r));
+      CHECK(dwal_db.get_latest(r, "multi").found == (r != 0 && r != roots - 1));
+      CHECK(dwal_db.get_latest(r, "frozen").found == (r % 6 == 0));
+      CHECK(dwal_db.root(r).next_wal_seq == 101);
+   }
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+// Swap controller tests
+// ═══════════════════════════════════════════════════════════════════════
+
+TEST_CASE("swap_controller scales thresholds with merge headroom", "[dwal][swap-controller]")
+{
+   using namespace std::chrono_literals;
+   psitri::dwal::swap_controller          ctl;
+   psitri::dwal::swap_controller::options opts;
+   opts.enabled   = true;
+   opts.max_scale = 4;
+   ctl.configure(opts);
+
+   auto t = std::chrono::steady_clock::now();
+
+   // Each RW btree takes a second to fill; merges take 100 ms.
+   for (int i = 0; i < 10; ++i)
+   {
+      t += 1s;
+      ctl.record_swap(10'000, t);
+      ctl.record_merge(10'000, 100ms);
+   }
+   CHECK(ctl.scale() == 4);
+   auto s = ctl.stats();
+   CHECK(s.ingest_rate > 9'000);
+   CHECK(s.merge_rate > 90'000);
+
+   // Merges now take most of the fill time: back to the configured size.
+   for (int i = 0; i < 10; ++i)
+   {
+      t += 1s;
+      ctl.record_swap(10'000, t);
+      ctl.record_merge(10'000, 800ms);
+   }
+   CHECK(ctl.scale() == 1);
+
+   // Disabled, it only measures.
+   psitri::dwal::swap_controller off;
+   off.configure({});
+   t += 1s;
+   off.record_swap(10'000, t);
+   off.record_merge(10'000, 1ms);
+   CHECK(off.scale() == 1);
+   CHECK(off.stats().merge_rate > 0);
+   CHECK(off.commit_delay(1ull << 40, true, t).count() == 0);
+}
+
+TEST_CASE("swap_controller delays commits in proportion to arena pressure",
+          "[dwal][swap-controller]")
+{
+   using namespace std::chrono_literals;
+   psitri::dwal::swap_controller          ctl;
+   psitri::dwal::swap_controller::options opts;
+   opts.enabled     = true;
+   opts.arena_limit = 1000 << 20;
+   opts.soft_arena  = 0.5;
+   opts.max_delay   = 2ms;
+   ctl.configure(opts);
+
+   // Merges drain 100k entries/sec; a 100k-entry RO btree was just swapped,
+   // so its merge should finish a second from now.
+   auto t = std::chrono::steady_clock::now();
+   ctl.record_merge(100'000, 1s);
+   ctl.record_swap(100'000, t);
+
+   // 1000 commits in 10 ms filled 600 MB: at that pace the arena hits the
+   // limit long before the merge finishes.
+   std::chrono::nanoseconds delay{};
+   for (int i = 0; i < 1000; ++i)
+      delay = ctl.commit_delay(600 << 20, true, t + 10ms);
+   CHECK(delay.count() > 0);
+   CHECK(delay <= 2ms);
+
+   // More pressure, longer delay; none below the soft limit or once the
+   // merge has completed.
+   auto higher = ctl.commit_delay(900 << 20, true, t + 10ms);
+   CHECK(higher >= delay);
+   CHECK(ctl.commit_delay(400 << 20, true, t + 10ms).count() == 0);
+   CHECK(ctl.commit_delay(900 << 20, false, t + 10ms).count() == 0);
+
+   // At the limit, or past the predicted end of the merge, the full delay.
+   CHECK(ctl.commit_delay(1000 << 20, true, t + 10ms) == 2ms);
+   CHECK(ctl.commit_delay(1000 << 20, true, t + 5s) == 2ms);
+   CHECK(ctl.stats().delayed_commits > 0);
+}
+
+TEST_CASE("dwal_database with adaptive_swap paces swaps and reports flow",
+          "[dwal][swap-controller]")
+{
+   temp_dir td;
+   auto     db = psitri::database::create(td.path / "db");
+
+   psitri::dwal::dwal_config dcfg;
+   dcfg.merge_threads  = 1;
+   dcfg.max_rw_entries = 200;
+   dcfg.adaptive_swap  = true;
+   psitri::dwal::dwal_database dwal_db(db, td.path / "wal", dcfg);
+
+   // Slow trickle: merges of a few hundred entries finish far sooner than
+   // the next batch arrives, so the threshold grows.
+   for (int burst = 0; burst < 8; ++burst)
+   {
+      for (int i = 0; i < 300; ++i)
+      {
+         auto tx = dwal_db.start_write_transaction(0);
+         tx.upsert("k" + std::to_string(burst * 300 + i), "v");
+         tx.commit();
+         if (i % 50 == 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+      }
+      dwal_db.root(0).merge_complete.wait(false);
+   }
+
+   // Static thresholds would have swapped every 200 entries.
+   auto stats = dwal_db.get_merge_stats();
+   CHECK(dwal_db.root(0).swap_ctl.scale() > 1);
+   CHECK(stats.merges < 2400 / 200);
+   REQUIRE(stats.root_flow.size() == 1);
+   CHECK(stats.root_flow[0].second.ingest_rate > 0);
+   CHECK(stats.root_flow[0].second.merge_rate > 0);
+   for (int i = 0; i < 2400; i += 97)
+      CHECK(dwal_db.get_latest(0, "k" + std::to_string(i)).found);
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+// Chunked merge publication tests
+// ═══════════════════════════════════════════════════════════════════════
+
+TEST_CASE("merge_watermark covers keys below the last publication", "[dwal][publish]")
+{
+   psitri::dwal::merge_watermark wm;
+   wm.reserve(2);
+   CHECK(wm.load() == 0);
+   CHECK_FALSE(wm.covers(wm.load(), "a"));
+
+   wm.publish("m");
+   uint32_t seen = wm.load();
+   CHECK(seen == 1);
+   CHECK(wm.covers(seen, "a"));
+   CHECK(wm.covers(seen, "lzz"));
+   CHECK_FALSE(wm.covers(seen, "m"));
+   CHECK_FALSE(wm.covers(seen, "z"));
+
+   wm.publish("t");
+   CHECK(wm.covers(wm.load(), "s"));
+   CHECK(wm.covers(seen, "a"));
+   CHECK_FALSE(wm.covers(seen, "s"));  // not by the earlier view
+
+   wm.publish("z");  // past the reserved room
+   CHECK(wm.load() == 2);
+   CHECK_FALSE(wm.covers(wm.load(), "u"));
+}
+
+TEST_CASE("readers look up published keys in the Tri", "[dwal][publish]")
+{
+   temp_dir td;
+   auto     db = psitri::database::create(td.path / "db");
+
+   psitri::dwal::dwal_config dcfg;
+   dcfg.merge_threads = 0;  // the test plays the merge
+   psitri::dwal::dwal_database dwal_db(db, td.path / "wal", dcfg);
+
+   {
+      auto tx = dwal_db.start_write_transaction(0);
+      tx.upsert("a", "ro");
+      tx.upsert("z", "ro");
+      tx.commit();
+   }
+   dwal_db.swap_rw_to_ro(0);
+
+   auto reader = dwal_db.start_read_session();
+   CHECK(reader.get(0, "a").value == "ro");
+
+   // Commit a first chunk with a value that shows which layer answered.
+   {
+      auto ws = db->start_write_session();
+      auto tx = ws->start_transaction(0);
+      tx.upsert("a", "tri");
+      tx.commit();
+   }
+   dwal_db.root(0).buffered_owner->merged.reserve(1);
+   dwal_db.root(0).buffered_owner->merged.publish("m");
+
+   CHECK(reader.get(0, "a").value == "tri");
+   CHECK(reader.get(0, "a", psitri::dwal::read_mode::trie).value == "tri");
+   CHECK(reader.get(0, "z").value == "ro");
+   CHECK(std::string(dwal_db.get_latest(0, "a").value.data) == "tri");
+   CHECK(std::string(dwal_db.get_latest(0, "z").value.data) == "ro");
+
+   auto tx = dwal_db.start_write_transaction(0);
+   CHECK(std::string(tx.get("a").value.data) == "tri");
+   CHECK(std::string(tx.get("z").value.data) == "ro");
+   tx.abort();
+}
+
+TEST_CASE("dwal_database publishes a merge in chunks", "[dwal][publish]")
+{
+   temp_dir td;
+   auto     db = psitri::database::create(td.path / "db");
+
+   psitri::dwal::dwal_config dcfg;
+   dcfg.merge_threads         = 1;
+   dcfg.merge_publish_entries = 500;
+   psitri::dwal::dwal_database dwal_db(db, td.path / "wal", dcfg);
+
+   auto key = [](int i)
+   {
+      char buf[16];
+      snprintf(buf, sizeof(buf), "k%04d", i);
+      return std::string(buf);
+   };
+
+   {
+      auto tx = dwal_db.start_write_transaction(0);
+      for (int i = 0; i < 3000; ++i)
+         tx.upsert(key(i), "old");
+      tx.commit();
+   }
+   dwal_db.swap_rw_to_ro(0);
+   dwal_db.root(0).merge_complete.wait(false);
+   auto before = dwal_db.get_merge_stats().publishes;
+   CHECK(before == 5);
+
+   // A key written back into a removed range outlives the removal.
+   {
+      auto tx = dwal_db.start_write_transaction(0);
+      tx.remove_range(key(1000), key(2000));
+      tx.upsert(key(1500), "back");
+      for (int i = 2000; i < 3000; ++i)
+         tx.upsert(key(i), "new");
+      tx.commit();
+   }
+   dwal_db.swap_rw_to_ro(0);
+   dwal_db.root(0).merge_complete.wait(false);
+   CHECK(dwal_db.get_merge_stats().publishes - before == 2);
+
+   auto reader = dwal_db.start_read_session();
+   for (auto mode : {psitri::dwal::read_mode::trie, psitri::dwal::read_mode::buffered})
+   {
+      CHECK(reader.get(0, key(500), mode).value == "old");
+      CHECK_FALSE(reader.get(0, key(1200), mode).found);
+      CHECK(reader.get(0, key(1500), mode).value == "back");
+      CHECK(reader.get(0, key(2500), mode).value == "new");
+   }
+}
+
 // ═══════════════════════════════════════════════════════════════════════
 // Psibase integration feature tests
 // ═══════════════════════════════════════════════════════════════════════
@@ -5107,7 +6503,7 @@ TEST_CASE("psibase block production pattern: write-commit-swap-read cycle",
 
    // Manually merge block 1 RO → Tri (since merge_threads=0).
    {
-      auto ro = dwal_db.root(0).buffered_ptr;
+      auto ro = dwal_db.root(0).buffered_owner;
       if (ro)
       {
          auto ws = db->start_write_session();
@@ -5120,8 +6516,7 @@ TEST_CASE("psibase block production pattern: write-commit-swap-read cycle",
                        psitri::value_view(v.data.data(), v.data.size()));
          }
          tx.commit();
-         std::unique_lock lk(dwal_db.root(0).buffered_mutex);
-         dwal_db.root(0).buffered_ptr = nullptr;
+         dwal_db.root(0).unpublish_buffered();
       }
       dwal_db.root(0).merge_complete.store(true, std::memory_order_release);
    }
@@ -5228,7 +6623,7 @@ TEST_CASE("psibase fork resolution via stored snapshots", "[dwal][psibase][fork]
       dwal_db.try_swap_rw_to_ro(0);
 
       // Manual merge: drain RO into PsiTri.
-      auto ro = dwal_db.root(0).buffered_ptr;
+      auto ro = dwal_db.root(0).buffered_owner;
       if (ro)
       {
          auto ws = db->start_write_session();
@@ -5246,8 +6641,7 @@ TEST_CASE("psibase fork resolution via stored snapshots", "[dwal][psibase][fork]
          tx.commit();
 
          // Clear RO layer.
-         std::unique_lock lk(dwal_db.root(0).buffered_mutex);
-         dwal_db.root(0).buffered_ptr = nullptr;
+         dwal_db.root(0).unpublish_buffered();
       }
       dwal_db.root(0).merge_complete.store(true, std::memory_order_release);
 
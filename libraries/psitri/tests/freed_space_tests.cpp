@@ -5,6 +5,7 @@
 #include <psitri/write_session_impl.hpp>
 #include <sal/allocator.hpp>
 #include <string>
+#include <thread>
 
 using namespace psitri;
 
@@ -181,3 +182,110 @@ TEST_CASE("no leaked references after many small commits", "[allocator]")
 
    std::filesystem::remove_all(dir);
 }
+
+TEST_CASE("parallel compactor workers preserve data", "[allocator][compactor]")
+{
+   const std::string dir = "parallel_compactor_testdb";
+   std::filesystem::remove_all(dir);
+
+   {
+      sal::runtime_config cfg;
+      cfg.compactor_threads                    = 4;
+      cfg.compact_pinned_unused_threshold_mb   = 1;
+      cfg.compact_unpinned_unused_threshold_mb = 1;
+
+      auto db  = database::create(dir, cfg);
+      auto ses = db->start_write_session();
+
+      const int num_keys = 50000;
+      const int rounds   = 8;
+
+      // Rewrite every key several times so many segments become mostly free
+      // and land in different worker partitions.
+      for (int r = 0; r < rounds; ++r)
+      {
+         for (int base = 0; base < num_keys; base += 1000)
+         {
+            auto tx = ses->start_transaction(0);
+            for (int i = base; i < base + 1000; ++i)
+               tx.upsert(to_key_view(make_key(i)), to_value_view(encode_u64(i * rounds + r)));
+            tx.commit();
+         }
+      }
+
+      db->wait_for_compactor();
+
+      auto d = db->dump();
+      REQUIRE(d.compactor_workers.size() == 4);
+      uint64_t compacted = 0;
+      for (const auto& w : d.compactor_workers)
+      {
+         WARN("compactor worker " << w.worker << ": segments=" << w.segments_compacted
+              << " relocated=" << w.bytes_relocated << " MB/s=" << w.throughput_mb_sec());
+         compacted += w.segments_compacted;
+      }
+      WARN("total segments compacted: " << compacted);
+
+      auto tx = ses->start_transaction(0);
+      for (int i = 0; i < num_keys; ++i)
+      {
+         auto v = tx.get<std::string>(to_key_view(make_key(i)));
+         REQUIRE(v);
+         REQUIRE(decode_u64(*v) == uint64_t(i) * rounds + rounds - 1);
+      }
+      tx.abort();
+   }
+
+   std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("sharded release workers drain dropped subtrees", "[allocator][release]")
+{
+   const std::string dir = "sharded_release_testdb";
+   std::filesystem::remove_all(dir);
+
+   {
+      sal::runtime_config cfg;
+      cfg.release_threads = 4;
+
+      auto db = database::create(dir, cfg);
+
+      // Several writers so releases land in queues owned by different workers
+      const int                num_writers = 4;
+      const int                num_keys    = 20000;
+      std::vector<std::thread> writers;
+      for (int w = 0; w < num_writers; ++w)
+      {
+         writers.emplace_back(
+             [&, w]
+             {
+                auto ses = db->start_write_session();
+                {
+                   auto tx = ses->start_transaction(w);
+                   for (int i = 0; i < num_keys; ++i)
+                      tx.upsert(to_key_view(make_key(i)), to_value_view(encode_u64(i)));
+                   tx.commit();
+                }
+                auto tx = ses->start_transaction(w);
+                tx.remove_range(to_key_view(make_key(0)), to_key_view(make_key(num_keys)));
+                tx.commit();
+             });
+      }
+      for (auto& t : writers)
+         t.join();
+
+      REQUIRE(db->wait_for_compactor());
+
+      auto stats = db->get_stats();
+      CHECK(stats.pending_releases == 0);
+      CHECK(stats.release_backlog_age_ms == 0);
+      CHECK(stats.total_released > 0);
+      WARN("released " << stats.total_released << " objects at " << stats.release_rate()
+                       << " obj/s");
+
+      auto d = db->dump();
+      CHECK(d.release_workers.size() == 4);
+   }
+
+   std::filesystem::remove_all(dir);
+}
@@ -1718,3 +1718,145 @@ TEST_CASE("leaf_node get_split_pos", "[psitri][leaf_node]")
    REQUIRE(sp.less_than_count > 0);
    REQUIRE(sp.greater_eq_count > 0);
 }
+
+TEST_CASE("leaf_node alloc sizes follow the content", "[psitri][leaf_node]")
+{
+   using namespace psitri;
+
+   REQUIRE(leaf_node::size_class(1) == leaf_node::min_leaf_size);
+   REQUIRE(leaf_node::size_class(128) == 128);
+   REQUIRE(leaf_node::size_class(129) == 256);
+   REQUIRE(leaf_node::size_class(1025) == 2048);
+   REQUIRE(leaf_node::size_class(5000) == leaf_node::max_leaf_size);
+
+   // header(64) + hash(1) + key offset(2) + value branch(2) + key(2+3) + value(2+3)
+   REQUIRE(leaf_node::alloc_size(key_view("k00"), value_type("v00")) == 128);
+
+   LeafNodePtr node_ptr = create_leaf_node("k000", value_type("v000"));
+   leaf_node&  node     = *node_ptr;
+   for (int i = 1; i < 40; ++i)
+   {
+      char buf[8];
+      snprintf(buf, sizeof(buf), "k%03d", i);
+      std::string     k(buf);
+      op::leaf_insert ins{.src = node, .lb = node.lower_bound(k), .key = k, .value = value_type(k)};
+      REQUIRE(node.can_apply(ins) == leaf_node::can_apply_mode::modify);
+      node.apply(ins);
+   }
+   // 40 entries of 5 + (2+4) + (2+4) bytes; the arrays grew 8 slots at a time
+   REQUIRE(node.capacity() == 40);
+   REQUIRE(node.used_size() == 64 + 40 * 17);
+   REQUIRE(leaf_node::alloc_size(&node) == 1024);
+
+   // A rebuild holding fewer entries drops to a smaller class.
+   REQUIRE(node.rebuilt_size(key_view(), branch_zero, branch_number(10), nullptr) ==
+           64 + 10 * 17);
+   REQUIRE(leaf_node::alloc_size(&node, key_view(), branch_zero, branch_number(10)) == 256);
+   REQUIRE(leaf_node::alloc_size(&node, key_view("k0"), branch_zero, branch_number(3)) == 128);
+
+   // Removing entries leaves their bytes as dead space until the next rebuild.
+   node.remove(branch_zero);
+   REQUIRE(node.dead_space() == 12);
+   REQUIRE(leaf_node::alloc_size(op::leaf_remove{.src = node, .bn = branch_zero}) == 1024);
+
+   // An insert that needs more than the class holds is sized for the new entry.
+   std::string     big_key(600, 'z');
+   op::leaf_insert ins{.src = node, .lb = node.lower_bound(big_key), .key = big_key,
+                       .value = value_type("v")};
+   REQUIRE(leaf_node::alloc_size(&node, ins) == 2048);
+}
+
+TEST_CASE("leaf_node arrays keep spare slots for in-place inserts", "[psitri][leaf_node]")
+{
+   using namespace psitri;
+   static_assert(sizeof(leaf_node) == 64);  // arrays start on the second cacheline
+
+   LeafNodePtr node_ptr = create_leaf_node("k00", value_type("v00"));
+   leaf_node&  node     = *node_ptr;
+   REQUIRE(node.capacity() == 8);
+
+   std::vector<std::string> keys = {"k00"};
+   for (int i = 1; i < 12; ++i)
+   {
+      // insert at the front so every array tail shifts
+      std::string     k = "j" + std::to_string(20 - i);
+      op::leaf_insert ins{.src = node, .lb = node.lower_bound(k), .key = k, .value = value_type(k)};
+      REQUIRE(node.can_apply(ins) == leaf_node::can_apply_mode::modify);
+      node.apply(ins);
+      keys.push_back(k);
+   }
+   REQUIRE(node.num_branches() == 12);
+   REQUIRE(node.capacity() == 16);
+
+   node.remove(branch_number(3));
+   node.remove_range(branch_number(0), branch_number(2));
+   REQUIRE(node.num_branches() == 9);
+   REQUIRE(node.capacity() == 16);
+   REQUIRE(node.validate_invariants());
+
+   // a copy keeps the slots, a rebuild sizes them to the branches
+   constexpr size_t node_size = leaf_node::max_leaf_size;
+   void*            buf       = std::aligned_alloc(64, node_size);
+   ptr_address_seq  seq       = {ptr_address(1), 0};
+   const bool       compacts  = node.dead_space() != 0;
+   leaf_node*       copy      = new (buf) leaf_node(node_size, seq, &node);
+   REQUIRE(copy->capacity() == (compacts ? 9 : 16));
+
+   void*      buf2 = std::aligned_alloc(64, node_size);
+   leaf_node* rebuilt =
+       new (buf2) leaf_node(node_size, seq, &node, key_view(), branch_zero, branch_number(9));
+   REQUIRE(rebuilt->capacity() == 9);
+
+   for (auto* n : {&node, copy, rebuilt})
+      for (uint16_t i = 0; i < n->num_branches(); ++i)
+      {
+         key_view k = n->get_key(branch_number(i));
+         REQUIRE(n->get(k) == branch_number(i));
+         REQUIRE(n->get_value(branch_number(i)) == value_type(k == "k00" ? "v00" : k));
+      }
+   REQUIRE(node.get("j19x") == branch_number(node.num_branches()));
+
+   copy->~leaf_node();
+   rebuilt->~leaf_node();
+   std::free(buf);
+   std::free(buf2);
+}
+
+TEST_CASE("leaf_node in-place removes keep branch versions", "[psitri][leaf_node]")
+{
+   using namespace psitri;
+
+   LeafNodePtr node_ptr = create_leaf_node("a", value_type::make_subtree(ptr_address(64)));
+   leaf_node&  src      = *node_ptr;
+
+   // a rebuild that records versions, then removes in place
+   constexpr size_t node_size = leaf_node::max_leaf_size;
+   void*            buf       = std::aligned_alloc(64, node_size);
+   ptr_address_seq  seq       = {ptr_address(1), 0};
+   leaf_node*       node      = new (buf) leaf_node(
+       node_size, seq, &src,
+       op::leaf_insert{.src = src, .lb = src.lower_bound("b"), .key = "b",
+                       .value = value_type("vb"), .created_at = 7});
+   for (std::string k : {"c", "d", "e"})
+   {
+      op::leaf_insert ins{.src = *node, .lb = node->lower_bound(k), .key = k,
+                          .value = value_type::make_value_node(ptr_address(128)), .created_at = 9};
+      void*      next_buf = std::aligned_alloc(64, node_size);
+      leaf_node* next     = new (next_buf) leaf_node(node_size, seq, node, ins);
+      std::free(node);
+      node = next;
+   }
+   REQUIRE(node->num_versions() == 2);
+   REQUIRE(node->clines_capacity() == 2);
+
+   node->remove(branch_zero);
+   node->remove_range(branch_number(1), branch_number(3));
+   REQUIRE(node->validate_invariants());
+
+   REQUIRE(node->num_branches() == 2);
+   REQUIRE(node->get_key(branch_number(0)) == "b");
+   REQUIRE(node->get_version(branch_number(0)) == 7);
+   REQUIRE(node->get_key(branch_number(1)) == "e");
+   REQUIRE(node->get_version(branch_number(1)) == 9);
+   std::free(node);
+}
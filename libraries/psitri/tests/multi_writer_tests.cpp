@@ -20,12 +20,13 @@ namespace
       std::string               dir;
       std::shared_ptr<database> db;
 
-      multi_writer_db(const std::string& name = "multi_writer_testdb")
+      multi_writer_db(const std::string& name = "multi_writer_testdb",
+                      const runtime_config& cfg = {})
           : dir(name)
       {
          std::filesystem::remove_all(dir);
          std::filesystem::create_directories(dir + "/data");
-         db = database::open(dir);
+         db = database::open(dir, open_mode::create_or_open, cfg);
       }
 
       ~multi_writer_db() { std::filesystem::remove_all(dir); }
@@ -465,3 +466,56 @@ TEST_CASE("multi-writer insert then remove all", "[multi-writer][remove-all]")
    ses.reset();
    require_no_leaks(t, num_writers);
 }
+
+TEST_CASE("multi-writer durable commits share flushes", "[multi-writer][group-commit]")
+{
+   runtime_config cfg;
+   cfg.sync_mode             = sal::sync_type::fsync;
+   cfg.group_commit_delay_us = 1000;  // give every writer time to join each flush
+   multi_writer_db t("mw_group_commit_test", cfg);
+
+   const uint32_t num_writers = 4;
+   const uint32_t commits     = 25;
+   const uint32_t per_commit  = 16;
+
+   std::atomic<bool>        start_flag{false};
+   std::vector<std::thread> writers;
+   for (uint32_t w = 0; w < num_writers; ++w)
+   {
+      writers.emplace_back(
+          [&, w]()
+          {
+             auto ws = t.db->start_write_session();
+             ws->set_sync(sal::sync_type::fsync);
+             std::vector<char> key_buf;
+             std::vector<char> val(64, 'v');
+             value_view        vv(val.data(), val.size());
+
+             while (!start_flag.load(std::memory_order_relaxed))
+                ;
+
+             for (uint32_t c = 0; c < commits; ++c)
+             {
+                auto tx = ws->start_transaction(w + 1);
+                for (uint32_t i = 0; i < per_commit; ++i)
+                   tx.insert(to_be_key(uint64_t(c) * per_commit + i, key_buf), vv);
+                tx.commit();
+             }
+          });
+   }
+
+   start_flag.store(true, std::memory_order_relaxed);
+   for (auto& thr : writers)
+      thr.join();
+
+   auto stats = t.db->get_stats();
+   INFO("requests: " << stats.group_commit_requests << " flushes: " << stats.group_commit_flushes);
+   // each commit syncs its segments and then its root
+   REQUIRE(stats.group_commit_requests >= 2ull * num_writers * commits);
+   CHECK(stats.group_commit_flushes < stats.group_commit_requests);
+   CHECK(stats.commits_per_flush() > 1.0);
+
+   auto ses = t.db->start_write_session();
+   for (uint32_t w = 0; w < num_writers; ++w)
+      REQUIRE(count_keys(ses, w + 1) == uint64_t(commits) * per_commit);
+}
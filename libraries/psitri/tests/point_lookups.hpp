@@ -0,0 +1,60 @@
+#pragma once
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * The data set shared by the batched (get_many) and async (async_get) point
+ * lookup tests: inline, empty and value_node values, a group under a long
+ * shared prefix so lookups also descend through inner_prefix nodes, and
+ * every fifth plain key removed again.
+ */
+namespace psitri::point_lookups
+{
+   inline std::string make_key(int i)
+   {
+      char buf[32];
+      snprintf(buf, sizeof(buf), "key-%08d", i);
+      return buf;
+   }
+
+   inline std::string make_value(int i)
+   {
+      if (i % 3 == 0)
+         return "";
+      if (i % 3 == 1)
+         return "value-" + std::to_string(i);
+      return std::string(100 + i % 50, static_cast<char>('a' + i % 26));  // value_node
+   }
+
+   /// Writes the @p n key set through @p upsert(key, value) and @p remove(key).
+   template <typename Upsert, typename Remove>
+   void build(int n, Upsert&& upsert, Remove&& remove)
+   {
+      for (int i = 0; i < n; ++i)
+      {
+         upsert(make_key(i), make_value(i));
+         upsert("shared/prefix/" + make_key(i), make_value(i));
+      }
+      for (int i = 0; i < n; i += 5)
+         remove(make_key(i));
+   }
+
+   /// Hits, removed keys, misses past the end, a prefix that is not a key,
+   /// the empty key and a duplicate, shuffled by @p seed.
+   inline std::vector<std::string> queries(int n, unsigned seed)
+   {
+      std::vector<std::string> q;
+      for (int i = 0; i < n + n / 10; ++i)
+         q.push_back(make_key(i));
+      for (int i = 0; i < n; i += 7)
+         q.push_back("shared/prefix/" + make_key(i));
+      q.push_back("shared/prefix/");
+      q.push_back("");
+      q.push_back(make_key(42));
+      std::shuffle(q.begin(), q.end(), std::mt19937(seed));
+      return q;
+   }
+}  // namespace psitri::point_lookups
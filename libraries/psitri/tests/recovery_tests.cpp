@@ -7,6 +7,7 @@
 #include <sal/alloc_header.hpp>
 #include <sal/mapped_memory/segment.hpp>
 #include <fstream>
+#include <thread>
 
 using namespace psitri;
 
@@ -355,6 +356,66 @@ TEST_CASE("power_loss recovery with multiple roots", "[recovery][power_loss]")
    std::filesystem::remove_all(dir);
 }
 
+TEST_CASE("parallel recovery keeps the newest copy of every object", "[recovery][power_loss]")
+{
+   const std::string dir = "recovery_testdb";
+   std::filesystem::remove_all(dir);
+   std::filesystem::create_directories(dir + "/data");
+
+   auto cfg             = synced_config();
+   cfg.recovery_threads = 4;
+
+   {
+      auto db  = database::open(dir, open_mode::create_or_open, cfg);
+      auto ses = db->start_write_session();
+      // Overwrite every key several times so older copies of the same
+      // objects are spread across segments scanned by different threads.
+      for (int round = 0; round < 4; ++round)
+      {
+         for (uint32_t r = 0; r < 2; ++r)
+         {
+            auto tx = ses->start_transaction(r);
+            for (int i = 0; i < 5000; ++i)
+               tx.upsert(to_key(i), to_value(i * 4 + round));
+            tx.commit();
+         }
+      }
+   }
+
+   auto verify = [&](recovery_mode mode)
+   {
+      corrupt_shutdown_flag(dir);
+      auto db  = database::open(dir, open_mode::create_or_open, cfg, mode);
+      auto ses = db->start_read_session();
+      for (uint32_t r = 0; r < 2; ++r)
+      {
+         auto root = ses->get_root(r);
+         REQUIRE(root);
+         cursor c(root);
+         for (int i = 0; i < 5000; ++i)
+         {
+            REQUIRE(c.seek(to_key(i)));
+            REQUIRE(c.value<std::string>().value_or("") == to_value(i * 4 + 3));
+         }
+      }
+   };
+
+   SECTION("app_crash")
+   {
+      verify(recovery_mode::app_crash);
+   }
+   SECTION("power_loss")
+   {
+      verify(recovery_mode::power_loss);
+   }
+   SECTION("full_verify")
+   {
+      verify(recovery_mode::full_verify);
+   }
+
+   std::filesystem::remove_all(dir);
+}
+
 TEST_CASE("corruption flag halts writes", "[recovery]")
 {
    const std::string dir = "recovery_testdb";
@@ -603,3 +664,184 @@ TEST_CASE("writes work with stale ref counts", "[recovery][deferred_cleanup]")
 
    std::filesystem::remove_all(dir);
 }
+
+TEST_CASE("deferred_cleanup reclaims leaked subtrees in the background",
+          "[recovery][deferred_cleanup]")
+{
+   const std::string dir = "recovery_testdb";
+   std::filesystem::remove_all(dir);
+   std::filesystem::create_directories(dir + "/data");
+
+   {
+      auto db  = database::open(dir);
+      auto ses = db->start_write_session();
+      for (uint32_t r = 0; r < 2; ++r)
+      {
+         auto tx = ses->start_transaction(r);
+         for (int i = 0; i < 2000; ++i)
+            tx.upsert(to_key(i), to_value(i));
+         tx.commit();
+      }
+
+      // Leak root 1's tree the way a crash would: an extra reference on its
+      // root node that nobody will ever release.
+      {
+         auto root = db->start_read_session()->get_root(1);
+         REQUIRE(root);
+         db->underlying_allocator().get_session()->retain(root.address());
+      }
+      {
+         auto tx = ses->start_transaction(1);
+         tx.remove_range(to_key(0), to_key(2000));
+         tx.commit();
+      }
+      REQUIRE(db->wait_for_compactor());
+   }
+
+   corrupt_shutdown_flag(dir);
+
+   {
+      auto db = database::open(dir);
+      REQUIRE(db->ref_counts_stale());
+
+      // Writers are not blocked while the pass runs
+      {
+         auto ses = db->start_write_session();
+         auto tx  = ses->start_transaction(0);
+         for (int i = 2000; i < 2100; ++i)
+            tx.upsert(to_key(i), to_value(i));
+         tx.commit();
+      }
+
+      for (int i = 0; i < 500 && db->leak_reclamation_active(); ++i)
+         std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      REQUIRE_FALSE(db->leak_reclamation_active());
+
+      auto d = db->dump();
+      CHECK(d.leak_reclaim_phase == "done");
+      CHECK(d.leak_reclaim_freed > 1);
+      CHECK(d.leak_reclaim_freed_bytes > 0);
+
+      // Only reachable objects were marked live, and none of them were freed
+      auto rses = db->start_read_session();
+      auto root = rses->get_root(0);
+      REQUIRE(root);
+      cursor c(root);
+      for (int i = 0; i < 2100; ++i)
+         REQUIRE(c.seek(to_key(i)));
+      CHECK_FALSE(rses->get_root(1));
+
+      // Counts of reachable objects are not rebuilt by the online pass
+      CHECK(db->ref_counts_stale());
+   }
+
+   std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("background_full power_loss rolls back to the durable snapshot",
+          "[recovery][power_loss][background_full]")
+{
+   const std::string dir  = "recovery_testdb";
+   const std::string copy = "recovery_testdb_copy";
+   std::filesystem::remove_all(dir);
+   std::filesystem::remove_all(copy);
+   std::filesystem::create_directories(dir + "/data");
+
+   runtime_config cfg;
+   cfg.sync_mode             = sal::sync_type::background_full;
+   cfg.max_durability_lag_ms = 60000;  // only explicit waits make commits durable
+
+   {
+      auto db  = database::open(dir, open_mode::create_or_open, cfg);
+      auto ses = db->start_write_session();
+      ses->set_sync(sal::sync_type::background_full);
+      {
+         auto tx = ses->start_transaction(0);
+         for (int i = 0; i < 1000; ++i)
+            tx.upsert(to_key(i), to_value(i));
+         tx.commit();
+      }
+      REQUIRE(db->wait_for_durability(std::chrono::seconds(10)));
+      CHECK(db->get_stats().durability_syncs > 0);
+
+      // committed and visible, but not yet covered by a durable snapshot
+      {
+         auto tx = ses->start_transaction(0);
+         for (int i = 1000; i < 2000; ++i)
+            tx.upsert(to_key(i), to_value(i));
+         tx.commit();
+      }
+      {
+         auto tx = ses->start_transaction(1);
+         tx.upsert("other", "value");
+         tx.commit();
+      }
+
+      // the copy stands in for the disk at the moment power is lost
+      std::filesystem::copy(dir, copy, std::filesystem::copy_options::recursive);
+   }
+
+   {
+      auto db   = database::open(copy, open_mode::open_existing, cfg, recovery_mode::power_loss);
+      auto ses  = db->start_read_session();
+      auto root = ses->get_root(0);
+      REQUIRE(root);
+      cursor c(root);
+      for (int i = 0; i < 1000; ++i)
+      {
+         REQUIRE(c.seek(to_key(i)));
+         REQUIRE(c.value<std::string>().value_or("") == to_value(i));
+      }
+      for (int i = 1000; i < 2000; ++i)
+         REQUIRE_FALSE(c.seek(to_key(i)));
+      CHECK_FALSE(ses->get_root(1));
+   }
+
+   std::filesystem::remove_all(dir);
+   std::filesystem::remove_all(copy);
+}
+
+TEST_CASE("background_full snapshot only stays active in background_full mode",
+          "[recovery][background_full]")
+{
+   const std::string dir = "recovery_testdb";
+   std::filesystem::remove_all(dir);
+   std::filesystem::create_directories(dir + "/data");
+
+   runtime_config bg;
+   bg.sync_mode             = sal::sync_type::background_full;
+   bg.max_durability_lag_ms = 60000;
+   {
+      auto db  = database::open(dir, open_mode::create_or_open, bg);
+      auto ses = db->start_write_session();
+      ses->set_sync(sal::sync_type::background_full);
+      auto tx = ses->start_transaction(0);
+      tx.upsert(to_key(0), to_value(0));
+      tx.commit();
+      REQUIRE(db->wait_for_durability(std::chrono::seconds(10)));
+      CHECK(db->dump().durability_active);
+   }
+
+   // reopened in another mode, the old snapshot no longer holds back
+   // recycling or makes synchronous commits refresh it
+   runtime_config other;
+   other.sync_mode = sal::sync_type::msync_async;
+   {
+      auto db = database::open(dir, open_mode::open_existing, other);
+      CHECK_FALSE(db->dump().durability_active);
+
+      // a session asking for background_full has no durability thread to
+      // flush for it, so its commit syncs fully and is never left pending
+      auto ses = db->start_write_session();
+      ses->set_sync(sal::sync_type::background_full);
+      auto tx = ses->start_transaction(0);
+      tx.upsert(to_key(1), to_value(1));
+      tx.commit();
+      CHECK(db->get_stats().durability_lag_ms == 0);
+      CHECK(db->get_stats().durability_syncs == 0);
+      CHECK(db->wait_for_durability(std::chrono::milliseconds(0)));
+      CHECK_FALSE(db->dump().durability_active);
+   }
+
+   std::filesystem::remove_all(dir);
+}
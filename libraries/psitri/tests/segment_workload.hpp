@@ -0,0 +1,69 @@
+#pragma once
+#include <catch2/catch_all.hpp>
+#include <psitri/database.hpp>
+#include <psitri/database_impl.hpp>
+#include <psitri/transaction.hpp>
+#include <psitri/write_session_impl.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+/**
+ * Data sets for tests that need finished segments: each key carries about
+ * 1 KB, so 40000 keys fill a little more than one 32 MB segment.
+ */
+namespace psitri::segment_workload
+{
+   inline std::string make_key(int i)
+   {
+      char buf[32];
+      snprintf(buf, sizeof(buf), "key_%08d", i);
+      return buf;
+   }
+
+   inline std::string make_value(int i)
+   {
+      return std::string(1000, char('a' + i % 26)) + make_key(i);
+   }
+
+   /// Upserts keys [begin, end) into root 0.
+   inline void fill(write_session& ses, int begin, int end)
+   {
+      for (int base = begin; base < end; base += 10000)
+      {
+         auto tx = ses.start_transaction(0);
+         for (int i = base; i < std::min(end, base + 10000); ++i)
+            tx.upsert(to_key_view(make_key(i)), to_value_view(make_value(i)));
+         tx.commit();
+      }
+   }
+
+   /// Reads keys [begin, end) and checks their values.
+   inline void read_keys(write_session& ses, int begin, int end)
+   {
+      auto tx = ses.start_transaction(0);
+      for (int i = begin; i < end; ++i)
+      {
+         auto v = tx.get<std::string>(to_key_view(make_key(i)));
+         REQUIRE(v);
+         REQUIRE(*v == make_value(i));
+      }
+      tx.abort();
+   }
+
+   /// Polls @p done until it returns true or 10 s pass; returns its last result.
+   template <typename Fn>
+   bool wait_for(Fn&& done)
+   {
+      auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+      while (not done())
+      {
+         if (std::chrono::steady_clock::now() >= deadline)
+            return false;
+         std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      }
+      return true;
+   }
+}  // namespace psitri::segment_workload
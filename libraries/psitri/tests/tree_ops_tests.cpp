@@ -6,6 +6,9 @@
 #include <psitri/read_session_impl.hpp>
 #include <psitri/tree_ops.hpp>
 #include <psitri/value_type.hpp>
+#include <map>
+#include <optional>
+#include <random>
 
 
 using namespace psitri;
@@ -1473,3 +1476,241 @@ TEST_CASE("tree_ops: unique Phase 3 collapse through inner_prefix subtree", "[tr
    }
    wc->validate();
 }
+
+TEST_CASE("tree_ops: upsert_batch matches per-key writes", "[tree_ops][batch]")
+{
+   // Sorted batches of upserts and removes, each over a snapshot of the
+   // previous state so leaves are rebuilt in both shared and unique mode.
+   test_db                            env("tree_ops_upsert_batch_db");
+   std::map<std::string, std::string> model;
+   std::mt19937                       rng(42);
+
+   auto batch_key = [&](uint32_t i)
+   {
+      // a few shared prefixes of different lengths produce inner_prefix nodes
+      static const char* prefixes[] = {"", "a", "user/", "user/profile/", "zz\xff\xff"};
+      return std::string(prefixes[i % 5]) + tkey(i / 5);
+   };
+
+   tree snapshot;
+   for (int round = 0; round < 12 * OPS_SCALE; ++round)
+   {
+      std::map<std::string, std::optional<std::string>> writes;
+      const uint32_t span  = round < 4 ? 200 : 20000;
+      const int      count = round % 3 == 2 ? 50 : 3000;
+      for (int i = 0; i < count; ++i)
+      {
+         auto key = batch_key(rng() % span);
+         if (rng() % 4 == 0)
+            writes[key] = std::nullopt;
+         else
+            writes[key] = round % 2 ? big_val(i, 80) : small_val(i);
+      }
+
+      std::vector<batch_op> ops;
+      for (auto& [key, val] : writes)
+      {
+         if (val)
+         {
+            ops.push_back({key_view(key), value_type(value_view(*val))});
+            model[key] = *val;
+         }
+         else
+         {
+            ops.push_back({key_view(key), value_type()});
+            model.erase(key);
+         }
+      }
+
+      auto tx = env.ses->start_transaction(0);
+      tx.upsert_batch(ops);
+      tx.commit();
+
+      snapshot = env.ses->get_root(0);
+      auto c   = snapshot.snapshot_cursor();
+      c.seek_begin();
+      auto it = model.begin();
+      for (; !c.is_end() && it != model.end(); c.next(), ++it)
+      {
+         REQUIRE(c.key() == key_view(it->first));
+         REQUIRE(c.value<std::string>() == it->second);
+      }
+      REQUIRE(c.is_end());
+      REQUIRE(it == model.end());
+   }
+}
+
+TEST_CASE("tree_ops: upsert_batch empties and refills the tree", "[tree_ops][batch]")
+{
+   test_db env("tree_ops_upsert_batch_empty_db");
+   auto    wc = env.ses->create_write_cursor();
+
+   std::vector<std::string> keys, vals;
+   for (int i = 0; i < 5000; ++i)
+   {
+      keys.push_back(tkey(i));
+      vals.push_back(small_val(i));
+   }
+
+   std::vector<batch_op> ops;
+   for (int i = 0; i < 5000; ++i)
+      ops.push_back({key_view(keys[i]), value_type(value_view(vals[i]))});
+   wc->upsert_batch(ops);
+   CHECK(wc->get_stats().total_keys == 5000);
+   wc->validate();
+
+   for (auto& op : ops)
+      op.value = value_type();
+   wc->upsert_batch(ops);
+   CHECK_FALSE(wc->get<std::string>(tkey(0)).has_value());
+   CHECK_FALSE(wc->get<std::string>(tkey(4999)).has_value());
+
+   ops.resize(10);
+   for (int i = 0; i < 10; ++i)
+      ops[i].value = value_type(value_view(vals[i]));
+   wc->upsert_batch(ops);
+   CHECK(wc->get_stats().total_keys == 10);
+   CHECK(wc->get<std::string>(tkey(9)) == small_val(9));
+   wc->validate();
+}
+
+TEST_CASE("tree_ops: writes near the last key match per-key descents", "[tree_ops][finger]")
+{
+   // Appends of increasing keys start at the leaf the previous write took;
+   // mixing in snapshots, removes, rewrites of older keys and value_nodes
+   // must invalidate or carry that path correctly.
+   test_db                            env("tree_ops_finger_db");
+   auto                               wc = env.ses->create_write_cursor();
+   std::map<std::string, std::string> model;
+   std::mt19937                       rng(7);
+
+   auto be_key = [](const std::string& prefix, uint64_t seq)
+   {
+      std::string k = prefix;
+      for (int b = 7; b >= 0; --b)
+         k.push_back(char(seq >> (8 * b)));
+      return k;
+   };
+   static const char* prefixes[] = {"log/", "ts/a/", "ts/b/"};
+
+   std::optional<sal::smart_ptr<sal::alloc_header>> snapshot;
+   for (uint64_t seq = 0; seq < 60000; ++seq)
+   {
+      auto key = be_key(prefixes[(seq / 5000) % 3], seq);
+      auto val = seq % 97 == 0 ? big_val(int(seq)) : small_val(int(seq));
+      wc->upsert(key, val);
+      model[key] = val;
+
+      switch (rng() % 64)
+      {
+         case 0:  // a snapshot shares the path, forcing copies
+            snapshot = wc->root();
+            break;
+         case 1:
+            snapshot.reset();
+            break;
+         case 2:
+         {
+            auto it = model.lower_bound(be_key(prefixes[rng() % 3], rng() % (seq + 1)));
+            if (it != model.end())
+            {
+               REQUIRE(wc->remove(it->first) >= 0);
+               model.erase(it);
+            }
+            break;
+         }
+         case 3:
+         {
+            auto old  = be_key(prefixes[rng() % 3], rng() % (seq + 1));
+            auto oval = big_val(int(seq), 70 + rng() % 40);
+            wc->upsert(old, oval);
+            model[old] = oval;
+            break;
+         }
+         default:
+            break;
+      }
+   }
+   snapshot.reset();
+   wc->validate();
+   CHECK(wc->get_stats().total_keys == model.size());
+
+   auto c = wc->read_cursor();
+   c.seek_begin();
+   auto it = model.begin();
+   for (; !c.is_end() && it != model.end(); c.next(), ++it)
+   {
+      REQUIRE(c.key() == key_view(it->first));
+      REQUIRE(c.value<std::string>() == it->second);
+   }
+   REQUIRE(c.is_end());
+   REQUIRE(it == model.end());
+}
+
+TEST_CASE("tree_ops: leaves are sized by what they hold", "[tree_ops][leaf_size]")
+{
+   // A leaf starts in the smallest size class that holds its entries and
+   // grows a class at a time; growing, rewriting and sharing leaves must
+   // keep every entry.
+   test_db                            env("tree_ops_leaf_size_db");
+   auto                               wc = env.ses->create_write_cursor();
+   std::map<std::string, std::string> model;
+   std::mt19937                       rng(11);
+
+   wc->upsert(tkey(0), small_val(0));
+   model[tkey(0)] = small_val(0);
+   CHECK(wc->get_stats().total_leaf_size == leaf_node::min_leaf_size);
+   for (int i = 1; i < 10; ++i)
+   {
+      wc->upsert(tkey(i), small_val(i));
+      model[tkey(i)] = small_val(i);
+   }
+   auto s = wc->get_stats();
+   REQUIRE(s.leaf_nodes == 1);
+   CHECK(s.total_leaf_size == 512);  // 10 entries of 34 bytes after the header
+
+   for (int i = 0; i < 3000; ++i)
+   {
+      auto key = std::to_string(rng() % 997) + "/" + tkey(i);
+      auto val = i % 50 == 0 ? big_val(i) : small_val(i);
+      wc->upsert(key, val);
+      model[key] = val;
+   }
+   s = wc->get_stats();
+   CHECK(s.total_leaf_size < s.leaf_nodes * leaf_node::max_leaf_size);
+
+   // Grow one leaf through every size class, then rewrite and shrink it
+   // while a snapshot forces copies.
+   for (int i = 0; i < 400; ++i)
+   {
+      auto key = "grow/" + tkey(i);
+      wc->upsert(key, small_val(i));
+      model[key] = small_val(i);
+   }
+   auto snapshot = wc->root();
+   for (int i = 0; i < 400; i += 3)
+   {
+      auto key = "grow/" + tkey(i);
+      wc->upsert(key, big_val(i, 40));
+      model[key] = big_val(i, 40);
+   }
+   for (int i = 1; i < 400; i += 3)
+   {
+      auto key = "grow/" + tkey(i);
+      REQUIRE(wc->remove(key) >= 0);
+      model.erase(key);
+   }
+   wc->validate();
+   CHECK(wc->get_stats().total_keys == model.size());
+
+   auto c = wc->read_cursor();
+   c.seek_begin();
+   auto it = model.begin();
+   for (; !c.is_end() && it != model.end(); c.next(), ++it)
+   {
+      REQUIRE(c.key() == key_view(it->first));
+      REQUIRE(c.value<std::string>() == it->second);
+   }
+   REQUIRE(c.is_end());
+   REQUIRE(it == model.end());
+}
@@ -23,6 +23,7 @@
 #include <psitri/transaction.hpp>
 #include <psitri/write_session_impl.hpp>
 
+#include <algorithm>
 #include <cstdint>
 #include <exception>
 #include <filesystem>
@@ -34,6 +35,7 @@
 #include <thread>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 namespace leveldb {
 
@@ -156,18 +158,29 @@ class PsitriDB : public DB {
         // tx.commit() under the runtime config in effect.
         if (!updates || updates->Empty()) return Status::OK();
         try {
-            auto& ws = write_session_for_thread();
-            auto tx = ws->start_transaction(kPrimaryRoot);
-            size_t n = 0;
+            // Sort the batch so runs of keys that land in the same leaf are
+            // applied with one rebuild of that leaf. The stable sort keeps
+            // batch order among writes to one key, and only the last counts.
+            std::vector<psitri::batch_op> ops;
             updates->ForEach(
                 [&](const Slice& k, const Slice& v) {
-                    tx.upsert(to_sv(k), to_sv(v));
-                    ++n;
+                    ops.push_back({to_sv(k), psitri::value_type(to_sv(v))});
                 },
-                [&](const Slice& k) {
-                    tx.remove(to_sv(k));
-                    ++n;
-                });
+                [&](const Slice& k) { ops.push_back({to_sv(k), psitri::value_type()}); });
+            const size_t n = ops.size();
+            std::stable_sort(ops.begin(), ops.end(),
+                             [](const psitri::batch_op& a, const psitri::batch_op& b) {
+                                 return a.key < b.key;
+                             });
+            auto last = std::unique(ops.rbegin(), ops.rend(),
+                                    [](const psitri::batch_op& a, const psitri::batch_op& b) {
+                                        return a.key == b.key;
+                                    });
+            ops.erase(ops.begin(), last.base());
+
+            auto& ws = write_session_for_thread();
+            auto tx = ws->start_transaction(kPrimaryRoot);
+            tx.upsert_batch(ops);
             tx.commit();
             // Distribution of batch sizes — see record_batch_size for why.
             record_batch_size(n);
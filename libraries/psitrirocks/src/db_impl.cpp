@@ -308,12 +308,7 @@ namespace rocksdb
                                    const std::vector<Slice>& keys,
                                    std::vector<std::string>* values) override
       {
-         std::vector<Status> statuses;
-         statuses.reserve(keys.size());
-         values->resize(keys.size());
-         for (size_t i = 0; i < keys.size(); i++)
-            statuses.push_back(GetImpl(options, 0, keys[i], &(*values)[i]));
-         return statuses;
+         return MultiGetImpl(options, 0, keys, values);
       }
 
       // ── Iterator (uses COW snapshot for ordered traversal) ──
@@ -547,6 +542,51 @@ namespace rocksdb
          return Status::OK();
       }
 
+      /// Looks the keys up together so their tree descents overlap (see
+      /// psitri::cursor::get_many), with the same visibility as GetImpl.
+      std::vector<Status> MultiGetImpl(const ReadOptions& options, uint32_t root_idx,
+                                       const std::vector<Slice>& keys,
+                                       std::vector<std::string>* values)
+      {
+         std::vector<Status> statuses(keys.size(), Status::NotFound());
+         values->resize(keys.size());
+
+         std::vector<std::string_view> kv;
+         kv.reserve(keys.size());
+         for (const auto& k : keys)
+            kv.emplace_back(k.data(), k.size());
+
+         if (options.snapshot)
+         {
+            auto* snap = static_cast<const PsiTriSnapshot*>(options.snapshot);
+            auto  root = snap->root();
+            if (!root)
+               return statuses;
+            psitri::cursor c(std::move(root));
+            c.get_many(kv,
+                       [&](size_t i, psitri::value_view v)
+                       {
+                          (*values)[i].assign(v.data(), v.size());
+                          statuses[i] = Status::OK();
+                       });
+            return statuses;
+         }
+
+         auto results = dwal_db_->get_latest_many(root_idx, kv);
+         for (size_t i = 0; i < results.size(); i++)
+         {
+            auto& result = results[i];
+            if (!result.found)
+               continue;
+            if (!result.owned_data.empty())
+               (*values)[i] = std::move(result.owned_data);
+            else
+               (*values)[i].assign(result.value.data.data(), result.value.data.size());
+            statuses[i] = Status::OK();
+         }
+         return statuses;
+      }
+
       Iterator* NewIteratorImpl(const ReadOptions& options, uint32_t root_idx)
       {
          // Snapshot reads: COW cursor only (consistent point-in-time view)
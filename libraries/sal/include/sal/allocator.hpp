@@ -4,12 +4,16 @@
 #include <functional>
 #include <memory>
 #include <new>
+#include <span>
+#include <ucc/circular_buffer.hpp>
 #include <ucc/padded_atomic.hpp>
 #include <stdexcept>
 #include <sal/alloc_header.hpp>
 #include <sal/block_allocator.hpp>
+#include <sal/compaction_index.hpp>
 #include <sal/control_block_alloc.hpp>
 #include <sal/debug/free_range_tracker.hpp>
+#include <sal/frequency_sketch.hpp>
 #include <sal/mapped_memory/allocator_state.hpp>
 #include <sal/seg_alloc_dump.hpp>
 #include <sal/segment_thread.hpp>
@@ -22,6 +26,7 @@ namespace sal
    class allocator_session;
    class allocator_session_ptr;
    class read_lock;
+   class smart_ref_base;
 
    /**
     * Indicates the nature of an unclean shutdown to guide recovery strategy.
@@ -44,6 +49,8 @@ namespace sal
       using std::runtime_error::runtime_error;
    };
 
+   class leak_reclaimer;
+
    /**
     * A thread-safe smart allocator that manages objects derived from
     * sal::alloc_header.  Objects returned are reference counted and
@@ -72,8 +79,13 @@ namespace sal
       /// 64 bits for session id
       static constexpr uint32_t max_session_count = 64;
 
+      /**
+       * @param cold_dir optional directory for the cold tier.  It is
+       *        remembered as the `cold` symlink in @p dir, so later opens find
+       *        it without being told; see runtime_config::cold_tier_age_sec.
+       */
       allocator(std::filesystem::path dir, runtime_config cfg = runtime_config(),
-                bool start_threads_now = true);
+                bool start_threads_now = true, std::filesystem::path cold_dir = {});
       ~allocator();
 
       template <typename T>
@@ -155,6 +167,42 @@ namespace sal
       /// Total pending releases across all session queues
       inline uint64_t total_pending_releases() const;
 
+      /**
+       * Block until every release queue is empty and no release worker is in
+       * the middle of a batch, or until timeout expires.  Release workers
+       * notify when they go idle, so callers do not need to poll.
+       *
+       * @return true if the release backlog drained before the timeout
+       */
+      bool wait_for_releases(std::chrono::milliseconds timeout);
+
+      /// Milliseconds since the release workers last saw an empty backlog,
+      /// 0 when nothing is pending.  Bounds the age of the oldest queued release.
+      uint64_t release_backlog_age_ms() const;
+
+      /**
+       * Block until everything committed before this call is durable, or
+       * until timeout expires.  Asks the durability thread for an immediate
+       * snapshot rather than waiting for the next interval, so commits made
+       * with sync_type::background_full are on physical media when this
+       * returns true.
+       *
+       * @return true if a durability snapshot started after this call completed
+       */
+      bool wait_for_durability(std::chrono::milliseconds timeout);
+
+      /// Milliseconds since the oldest background_full commit that is not yet
+      /// durable, 0 when every such commit is covered by a durable snapshot.
+      uint64_t durability_lag_ms() const noexcept;
+
+      /// Ask the kernel to reclaim the pages of every unpinned segment
+      /// (MADV_PAGEOUT), writing dirty ones back first, so the next read of
+      /// them faults from storage one page at a time (MADV_RANDOM).  Lets
+      /// benchmarks start beyond-RAM reads cold without dropping the whole
+      /// page cache.
+      /// @return the number of segments advised
+      uint32_t page_out_unpinned() noexcept;
+
       /// Truncate trailing free segments from the segment file to reclaim disk space.
       /// Must be called after background threads are stopped and compaction is complete.
       void truncate_free_tail();
@@ -225,6 +273,26 @@ namespace sal
        */
       void recover_from_power_loss();
 
+      /**
+       * Online leak reclamation: reclaim objects orphaned by an unclean
+       * shutdown without stopping the world.
+       *
+       * Pins the current roots (and any releases still queued from before
+       * the restart) and starts an incremental mark-and-sweep on a background
+       * thread, rate limited by runtime_config::leak_reclaim_objects_per_sec.
+       * Control blocks allocated after this call are never candidates, so
+       * writers proceed normally. Unlike reset_reference_counts() this does
+       * not correct counts that are too high on reachable objects.
+       *
+       * Must be called before any session holds references, i.e. while
+       * opening and before start_background_threads(). on_complete is called
+       * from the reclaim thread with the number of control blocks freed.
+       */
+      void begin_leak_reclamation(std::function<void(uint64_t freed)> on_complete = {});
+
+      /// True while a pass started by begin_leak_reclamation() is running
+      bool leak_reclamation_active() const noexcept;
+
       /**
        * 
        * Forwards to the thread-local allocator_session::lock() method, it is faster
@@ -246,25 +314,36 @@ namespace sal
        * Syncs the root object to disk.
        * 
        * @param st The sync type to use.
+       * @param ranges segment pages the caller wrote since its last sync and
+       *        left for this call to flush, see group_commit()
        */
-      void sync(sync_type st) noexcept
+      void sync(sync_type st, std::span<const mapped_memory::sync_range> ranges = {}) noexcept
       {
-         if (st < sync_type::msync_sync)
+         // the durability thread makes this commit durable within
+         // max_durability_lag_ms, see durability_sync().  It only runs when
+         // the database is opened with sync_mode background_full; otherwise
+         // nothing would ever flush the commit, so it syncs fully instead.
+         if (st == sync_type::background_full)
+         {
+            if (_background_durability.load(std::memory_order_relaxed)) [[likely]]
+            {
+               mark_undurable();
+               return;
+            }
+            st = sync_type::full;
+         }
+
+         if (st >= sync_type::msync_sync)
+         {
+            group_commit(st, ranges);
             return;
+         }
 
-         // we don't msync() the _block_alloc because that is done
-         // on a session-by-session basis, but we still need to fsync() it
-         // because that applies to the entire file. But we don't want to
-         // fsync(full=true) because _root_object_file also need to be synced
-         // and it will do a full (computer-wide) sync if needed and implicitly
-         // grab data synced by _block_alloc.
-         if (st >= sync_type::fsync)
-            _block_alloc.fsync(false);
-         _root_object_file.sync(st);
-
-         // we don't sync _ptr_alloc because that data can be recovered from data
-         // that is being synced. We also don't sync _mapped_state because it also
-         // can be recovered from data that is being synced.
+         // a commit synced by the caller must not be rolled back to an older
+         // background snapshot by power-loss recovery, so take a new one
+         if (st >= sync_type::msync_async &&
+             _durability_active.load(std::memory_order_relaxed)) [[unlikely]]
+            durability_sync();
       }
 
      private:
@@ -503,6 +582,7 @@ namespace sal
       uint32_t                        _allocator_index;
       mapping                         _seg_alloc_state_file;
       mapping                         _root_object_file;
+      mapping                         _durable_file;
       root_object_array*              _root_objects;
       std::array<const object_type_ops*, 128> _type_ops;
       std::mutex                      _sync_mutex;
@@ -532,7 +612,14 @@ namespace sal
       inline bool config_update_checksum_on_modify() const;
 
       void mlock_pinned_segments();
-      void recursive_retain_all(ptr_address addr, void* visited);
+      /// Number of threads recover(), recover_from_power_loss() and
+      /// reset_reference_counts() split their work across.
+      uint32_t recovery_thread_count() const noexcept;
+      /// Retain every object reachable from a root exactly once per reference,
+      /// walking the trees on recovery_thread_count() work-stealing threads.
+      void retain_all_reachable(void* visited);
+      /// Store the newest location found by the segment scan in each control block.
+      void install_recovered_locations(const void* location_index);
       // Implementation helper for reachable_size(); defined in allocator.cpp
       void recursive_sum_size(ptr_address addr, uint64_t& total, void* visited);
       /// Reconstruct custom control blocks from root slots during recovery.
@@ -577,32 +664,312 @@ namespace sal
        */
       //@{
       /**
-       * Main loop for the compactor thread that processes and compacts segments
+       * Main loop for a compactor worker that processes and compacts segments
        * 
        * @param thread Reference to the segment_thread running this function
+       * @param worker Index of this worker, worker 0 also promotes rcache data
        */
-      void compactor_loop(segment_thread& thread);
-
-      void compact_segment(allocator_session& ses,
-                           segment_number     seg_num,
-                           const segment_thread* thread = nullptr);
-      bool compact_pinned_segment(allocator_session& ses, const segment_thread* thread = nullptr);
-      bool compact_unpinned_segment(allocator_session& ses, const segment_thread* thread = nullptr);
+      void compactor_loop(segment_thread& thread, uint32_t worker = 0);
+
+      void compact_segment(allocator_session&    ses,
+                           segment_number        seg_num,
+                           const segment_thread* thread = nullptr,
+                           uint32_t              worker = 0);
+      bool compact_pinned_segment(allocator_session&    ses,
+                                  const segment_thread* thread = nullptr,
+                                  uint32_t              worker = 0);
+      bool compact_unpinned_segment(allocator_session&    ses,
+                                    const segment_thread* thread = nullptr,
+                                    uint32_t              worker = 0);
       bool compactor_promote_rcache_data(allocator_session& ses);
+      bool compactor_promote_object(allocator_session&        ses,
+                                    const smart_ref_base&     obj_ref,
+                                    std::vector<ptr_address>& pending_storage);
+
+      /// each worker only selects segments from its own partition; the
+      /// cold tier thread crosses partitions, so compact_segment() also
+      /// claims its source segment
+      bool compactor_owns(segment_number seg, uint32_t worker) const noexcept
+      {
+         return *seg % _compactor_workers == worker;
+      }
 
-      // segment_thread implementation for the compactor
+      /// process-local counters for one compactor worker, reported by dump()
+      struct compactor_worker_stats
+      {
+         std::atomic<uint64_t> segments_compacted{0};
+         std::atomic<uint64_t> bytes_relocated{0};
+         std::atomic<uint64_t> busy_ns{0};
+      };
+
+      // segment_thread implementation for the compactor (worker 0)
       std::optional<segment_thread> _compactor_thread;
+
+      // additional workers, only started when this process owns _compactor_thread
+      std::array<std::optional<segment_thread>, max_compactor_threads - 1> _compactor_helpers;
+      std::array<mapped_memory::segment_thread_state, max_compactor_threads - 1>
+          _compactor_helper_states;
+
+      std::array<compactor_worker_stats, max_compactor_threads> _compactor_stats;
+      uint32_t                                                  _compactor_workers = 1;
+
+      /// compact_segment() worker index of the cold tier thread
+      static constexpr uint32_t cold_tier_worker = max_compactor_threads;
+
+      /// the recycled segment queue has a single producer, workers take turns
+      std::mutex _recycle_mutex;
+
+      /// segments whose freed space reached the lower of the two compaction
+      /// thresholds, so candidate selection does not walk every segment
+      compaction_index<max_segment_count> _compact_index;
+
+      /// rebuilds _compact_index when the configured thresholds changed
+      void refresh_compaction_index();
+
+      /// read-only segments the cold tier may migrate, inserted when a
+      /// segment is finalized; stale entries (recycled, cold) are dropped
+      /// lazily by cold_tier_pass()
+      compaction_index<max_segment_count> _aged_index;
+
+      /**
+       * Calls @p fn for each segment in the index that this worker owns and
+       * that is compactable with at least @p min_freed bytes free. Entries
+       * that no longer qualify are dropped from the index.
+       */
+      template <typename Fn>
+      void for_each_compaction_candidate(uint32_t worker, uint32_t min_freed, Fn&& fn);
+
+     public:
+      /// Must follow every change to a segment's freed space or compactable
+      /// state, otherwise the compactor will not see the segment.
+      void update_compaction_index(segment_number seg) noexcept
+      {
+         _compact_index.update(*seg, _mapped_state->_segment_data.get_freed_space(seg));
+      }
+
+      /// Must follow making a segment read only, otherwise the cold tier
+      /// will not see it.
+      void update_aged_index(segment_number seg) noexcept { _aged_index.insert(*seg); }
+
+     private:
       //@}
 
       /**
-       * Release Thread Methods — dedicated thread for processing deferred object releases.
+       * Release Thread Methods — dedicated workers for processing deferred object releases.
        * Frees the compactor from release processing so it can focus on space reclamation.
-       * Uses fine-grained read locks to avoid blocking the compactor.
+       * Uses batched read locks to avoid blocking the compactor.
+       *
+       * Every release queue is single-consumer: worker w drains its own session's
+       * queue plus every non-worker session where session % workers == w.
        */
       ///@{
-      void release_loop(segment_thread& thread);
+      void release_loop(segment_thread& thread, uint32_t worker = 0);
+      bool release_backlog_drained() const;
+
+      /// process-local counters for one release worker, reported by dump()
+      struct release_worker_stats
+      {
+         std::atomic<uint64_t> released{0};
+         std::atomic<uint64_t> busy_ns{0};
+         /// steady clock ms of the last pass that found all owned queues empty
+         std::atomic<int64_t> last_drained_ms{0};
+         /// true while the worker has no popped releases in flight
+         std::atomic<bool> idle{true};
+      };
 
+      // segment_thread implementation for the release thread (worker 0)
       std::optional<segment_thread> _release_thread;
+
+      // additional workers, only started when this process owns _release_thread
+      std::array<std::optional<segment_thread>, max_release_threads - 1> _release_helpers;
+      std::array<mapped_memory::segment_thread_state, max_release_threads - 1>
+          _release_helper_states;
+
+      std::array<release_worker_stats, max_release_threads> _release_stats;
+      uint32_t                                              _release_workers = 1;
+
+      /// one bit per session owned by a release worker, stable once all are ready
+      std::atomic<uint64_t> _release_worker_sessions{0};
+      std::atomic<uint32_t> _release_workers_ready{0};
+
+      std::mutex              _release_idle_mutex;
+      std::condition_variable _release_idle_cv;
+      ///@}
+
+      /**
+       * Leak reclamation thread, see begin_leak_reclamation()
+       */
+      ///@{
+      void leak_reclaim_loop(segment_thread& thread);
+      void leak_reclaim_mark(leak_reclaimer& reclaimer, uint64_t budget);
+      void leak_reclaim_sweep(allocator_session& ses, leak_reclaimer& reclaimer, uint64_t budget);
+      void leak_reclaim_free(allocator_session& ses, leak_reclaimer& reclaimer, ptr_address addr);
+
+      std::unique_ptr<leak_reclaimer>     _leak_reclaimer;
+      std::optional<segment_thread>       _leak_reclaim_thread;
+      mapped_memory::segment_thread_state _leak_reclaim_thread_state;
+      ///@}
+
+      /**
+       * Background durability for sync_type::background_full.
+       *
+       * Commits only write protect their pages; the durability thread
+       * periodically records the committed roots and the append position
+       * of every writable segment in the "durable" file after fsyncing the
+       * segment file.  Power-loss recovery rolls back to that snapshot.
+       * Recycled segments are held back by the provider until a snapshot
+       * taken after they were recycled is durable, so the data the last
+       * durable snapshot refers to is never overwritten.
+       */
+      ///@{
+      struct durable_snapshot;
+
+      /// a recycled segment waiting for snapshot generation `needed` to complete
+      struct deferred_segment
+      {
+         segment_number seg;
+         uint64_t       needed;
+      };
+
+      void durability_loop(segment_thread& thread);
+      bool durability_sync() noexcept;
+      void invalidate_durable_snapshot_locked() noexcept;
+      void load_durable_snapshot();
+      const durable_snapshot* find_durable_snapshot() const noexcept;
+      void mark_undurable() noexcept;
+      void throttle_durability_lag() noexcept;
+      void free_recycled_segment(segment_number seg);
+      void provider_release_deferred_segments();
+
+      std::optional<segment_thread>       _durability_thread;
+      mapped_memory::segment_thread_state _durability_thread_state;
+
+      /// serializes snapshot writes, held across the fsyncs
+      std::mutex                        _durability_mutex;
+      std::unique_ptr<durable_snapshot> _durable_scratch;
+
+      /// orders snapshot generations against the provider's deferral decision
+      /// and wakes wait_for_durability() and throttled writers
+      mutable std::mutex      _durability_state_mutex;
+      std::condition_variable _durability_cv;
+
+      /// background_full commits published, and how many a durable snapshot covers
+      std::atomic<uint64_t> _background_commits{0};
+      std::atomic<uint64_t> _durable_commits{0};
+      /// steady ms no pending commit is older than: when the last durable
+      /// snapshot read the commit count, or the first commit after it
+      std::atomic<int64_t>  _durable_as_of_ms{0};
+
+      std::atomic<uint64_t> _durability_started{0};
+      std::atomic<uint64_t> _durability_completed{0};
+      std::atomic<bool>     _durability_requested{false};
+      /// the durability thread runs: runtime_config::sync_mode is background_full
+      std::atomic<bool>     _background_durability{false};
+      /// a valid or in-progress snapshot exists and recycling must wait for it
+      std::atomic<bool>     _durability_active{false};
+      std::atomic<uint64_t> _durability_syncs{0};
+      std::atomic<uint64_t> _last_durability_sync_us{0};
+
+      /// owned by the segment provider thread
+      std::vector<deferred_segment> _durability_deferred;
+      std::atomic<uint32_t>         _durability_deferred_count{0};
+      ///@}
+
+      /**
+       * Group commit for sync_mode >= msync_sync.
+       *
+       * Every committer queues the pages it wrote and takes a ticket.  The
+       * first one to find no flush in progress becomes the leader: it takes
+       * everything queued so far, issues one flush for all of it, and wakes
+       * every committer whose ticket that flush covered.  Commits that
+       * arrive while a flush is running are batched into the next one.
+       */
+      ///@{
+      void group_commit(sync_type st, std::span<const mapped_memory::sync_range> ranges) noexcept;
+      void group_flush(sync_type st, std::vector<mapped_memory::sync_range>& ranges) noexcept;
+
+      mutable std::mutex                      _group_mutex;
+      std::condition_variable                 _group_cv;
+      std::vector<mapped_memory::sync_range> _group_queued;   ///< waiting for the next flush
+      std::vector<mapped_memory::sync_range> _group_flushing; ///< owned by the leader
+      sync_type _group_queued_sync = sync_type::none;  ///< strongest sync type queued
+      uint64_t  _group_requested   = 0;                ///< last ticket handed out
+      uint64_t  _group_flushed     = 0;                ///< last ticket made durable
+      bool      _group_leader      = false;            ///< a flush is in progress
+
+      std::atomic<uint64_t> _group_flushes{0};
+      std::atomic<uint64_t> _group_flush_ns{0};
+      std::atomic<uint64_t> _group_flush_max_ns{0};
+      ///@}
+
+      /**
+       * @name Huge pages
+       *
+       * With runtime_config::huge_pages, pinned segments are advised
+       * MADV_HUGEPAGE while they are mlock'd and advised back to normal
+       * pages when they are unpinned, so cold data stays reclaimable at 4 KB
+       * granularity. The first rejected advice turns the mode off.
+       */
+      ///@{
+      void advise_segment_huge_pages(segment_number seg_num, bool huge) noexcept;
+
+      std::atomic<bool>    _huge_pages{false};
+      std::atomic<int64_t> _huge_page_segments{0};  ///< pinned segments currently advised
+      ///@}
+
+      /**
+       * @name Cold tier
+       *
+       * When a cold directory is attached, its `segs` file is the block
+       * allocator's tier file.  The cold tier thread copies the live objects
+       * of unpinned segments older than runtime_config::cold_tier_age_sec
+       * into segments backed by that file and compacts those segments among
+       * themselves; the hot compactors leave them alone.  Locations need no
+       * tier bit: both files share one address range.
+       */
+      ///@{
+      void cold_tier_loop(segment_thread& thread);
+      bool cold_tier_pass(allocator_session& ses, const segment_thread& thread);
+      void provider_populate_cold_segments();
+
+      std::optional<segment_thread>       _cold_tier_thread;
+      mapped_memory::segment_thread_state _cold_tier_thread_state;
+      compactor_worker_stats              _cold_tier_stats;
+      std::atomic<uint64_t>               _cold_segments_migrated{0};
+      std::atomic<uint64_t>               _cold_bytes_migrated{0};
+      ///@}
+
+      /**
+       * @name Read cache admission
+       *
+       * One read in sal::read_sample_rate is sampled into the reading session's
+       * slot: it counts toward the pinned hit rate and, under
+       * cache_admission_policy::frequency_sketch, its address is queued for
+       * the promoting compactor.  That compactor feeds the addresses to the
+       * sketch and promotes an object once its estimated frequency beats the
+       * objects in the pinned segment that would be unpinned next.  The
+       * slots and the sketch are process memory and start empty on open.
+       */
+      ///@{
+      struct read_sample_slot
+      {
+         std::atomic<uint64_t>                       sampled_reads{0};
+         std::atomic<uint64_t>                       pinned_hits{0};
+         ucc::circular_buffer<ptr_address, 1024 * 4> accesses;
+      };
+
+      bool     compactor_admit_sampled_reads(allocator_session&        ses,
+                                             std::vector<ptr_address>& pending_storage);
+      uint32_t compactor_victim_frequency(allocator_session& ses);
+
+      std::unique_ptr<read_sample_slot[]> _read_samples;
+      frequency_sketch                    _sketch;  ///< promoting compactor only
+      uint64_t                            _sketch_budget_mb = 0;
+      segment_number                      _victim_segment = segment_number(-1);
+      uint32_t                            _victim_checks  = 0;
+      std::atomic<uint32_t>               _victim_frequency{0};
+      std::atomic<uint64_t>               _cache_promotions{0};
+      std::atomic<uint64_t>               _cache_admission_rejects{0};
       ///@}
 
       /**
@@ -614,7 +981,9 @@ namespace sal
        */
       ///@{
       void                          provider_munlock_excess_segments();
-      void                          provider_prepare_segment(segment_number seg_num, bool pin_it);
+      void                          provider_prepare_segment(segment_number seg_num,
+                                                             bool           pin_it,
+                                                             bool           cold = false);
       void                          provider_process_recycled_segments();
       void                          provider_populate_pinned_segments();
       void                          provider_populate_unpinned_segments();
@@ -740,10 +1109,16 @@ namespace sal
        * @return A pair containing the segment number and the segment header
        */
       std::pair<segment_number, mapped_memory::segment*> get_new_segment(
-          bool alloc_to_pinned = true)
+          bool alloc_to_pinned = true, bool alloc_to_cold = false)
       {
          segment_number segnum;
-         if (alloc_to_pinned)
+         if (alloc_to_cold)
+         {
+            // only sessions of the cold tier thread, which exists when the
+            // provider fills this queue
+            segnum = _mapped_state->_segment_provider.ready_cold_segments.pop();
+         }
+         else if (alloc_to_pinned)
          {
             // takes the highest priority pinned segment available, and if not pinned
             // then it will ack the segment provider who will get it pinned right-quick
@@ -757,9 +1132,11 @@ namespace sal
          }
          auto shp = get_segment(segnum);
          shp->age_accumulator.reset(*sal::get_current_time_msec());
-         shp->_provider_sequence = _mapped_state->_segment_provider._next_alloc_seq.fetch_add(
-             1, std::memory_order_relaxed);
          _mapped_state->_segment_data.allocated_by_session(segnum);
+         // flagged active first: a durability snapshot that reads the counter
+         // past this segment must also see it as writable
+         shp->_provider_sequence = _mapped_state->_segment_provider._next_alloc_seq.fetch_add(
+             1, std::memory_order_acq_rel);
          // Drop any tracker entries from the segment's prior life so a fresh
          // session starts with a clean accounting.
          SAL_TRACK_SEG_RESET(shp, segment_size);
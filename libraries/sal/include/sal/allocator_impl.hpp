@@ -24,5 +24,6 @@ namespace sal
       // alloc_pos is read INSIDE add_freed_space under SAL_TRACK_LOCK to
       // avoid a race with concurrent main-thread allocation.
       _mapped_state->_segment_data.add_freed_space(seg_num, seg, obj, tag);
+      update_compaction_index(seg_num);
    }
 }  // namespace sal
\ No newline at end of file
@@ -14,6 +14,7 @@
 #include <sal/time.hpp>
 #include "ucc/round.hpp"
 #include <thread>
+#include <vector>
 
 namespace sal
 {
@@ -188,6 +189,9 @@ namespace sal
       [[nodiscard]] smart_ref<T> get_ref(ptr_address adr) noexcept;
 
       inline void prefetch(ptr_address adr) const noexcept;
+      inline void prefetch_control(ptr_address adr) const noexcept;
+      inline bool is_resident(ptr_address adr) const noexcept;
+      inline void will_need(ptr_address adr) const noexcept;
       inline bool is_read_only(ptr_address adr) const noexcept;
 
       template <typename UserData>
@@ -225,6 +229,7 @@ namespace sal
       friend class smart_ptr;
       template <typename T>
       friend class smart_ref;
+      friend class smart_ref_base;
       template <typename T>
       friend class modify_guard;
 
@@ -269,6 +274,17 @@ namespace sal
        */
       inline bool should_cache(uint32_t size) noexcept;
 
+      /**
+       * Samples a read of the object at @p loc for the read cache: counts it
+       * toward the pinned hit rate and offers it for promotion under the
+       * configured cache_admission_policy. Readers reach this through
+       * smart_ref_base::maybe_update_read_stats().
+       */
+      inline void record_read(ptr_address    adr,
+                              control_block& cb,
+                              location       loc,
+                              uint32_t       size) noexcept;
+
       /**
        * Generate a random number for cache decisions
        * @return A random 64-bit number
@@ -293,6 +309,9 @@ namespace sal
        */
       void set_alloc_to_pinned(bool alloc_to_pinned) { _alloc_to_pinned = alloc_to_pinned; }
 
+      /// allocate from segments backed by the cold tier file, see allocator
+      void set_alloc_to_cold(bool alloc_to_cold) { _alloc_to_cold = alloc_to_cold; }
+
       /// Position the most frequently used members at the beginning of the class
       /// to reduce cache misses since the session is queiried for every dereference
       /// of an address or locaiton.
@@ -315,8 +334,11 @@ namespace sal
       lehmer64_rng _session_rng;  // 32 bytes..
 
       mapped_memory::dirty_segment_queue& _dirty_segments;
+      /// pages written since the last sync, flushed by the group commit leader
+      std::vector<mapped_memory::sync_range> _sync_ranges;
       segment_number                      _alloc_seg_num   = segment_number(-1);
       bool                                _alloc_to_pinned = true;
+      bool                                _alloc_to_cold   = false;
 
       // ── Segment allocation stats (for profiling merge drain) ───────
       uint64_t _seg_alloc_count   = 0;  ///< Number of init_active_segment() calls.
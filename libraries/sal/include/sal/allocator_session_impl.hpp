@@ -1,4 +1,5 @@
 #pragma once
+#include <sys/mman.h>
 #include <sal/alloc_header.hpp>
 #include <sal/allocator.hpp>
 #include <sal/allocator_impl.hpp>
@@ -232,6 +233,50 @@ namespace sal
       __builtin_prefetch(ptr, 0, 3);
    }
 
+   /// Issue a hardware prefetch for the control block of the given address.
+   /// Computing its location needs no load, so this never stalls; prefetch()
+   /// the same address a step later to fetch the node itself.
+   inline void allocator_session::prefetch_control(ptr_address adr) const noexcept
+   {
+      if (adr == null_ptr_address) [[unlikely]]
+         return;
+      __builtin_prefetch(&_ptr_alloc.get(adr), 0, 3);
+   }
+
+   /// True if reading the node at the given address will not fault from
+   /// storage: its segment is pinned, or the page holding its header is in
+   /// the page cache.  Unpinned nodes cost a mincore() call, so only ask on
+   /// paths that expect to go beyond RAM.
+   inline bool allocator_session::is_resident(ptr_address adr) const noexcept
+   {
+      if (adr == null_ptr_address) [[unlikely]]
+         return true;
+      auto loc = _ptr_alloc.get(adr).load(std::memory_order_relaxed).loc();
+      if (_sega._mapped_state->_segment_data.is_pinned(loc.segment()))
+         return true;
+      const auto    page_size = system_config::os_page_size();
+      auto          addr      = reinterpret_cast<uintptr_t>(_block_base_ptr + *loc.offset());
+      unsigned char vec       = 0;
+      // a failed call cannot be waited on, so report it as resident
+      return ::mincore(reinterpret_cast<void*>(addr & ~(page_size - 1)), page_size, &vec) != 0 ||
+             (vec & 1);
+   }
+
+   /// Start reading the node at the given address into the page cache
+   /// (MADV_WILLNEED) without waiting for it; pair with is_resident().
+   inline void allocator_session::will_need(ptr_address adr) const noexcept
+   {
+      if (adr == null_ptr_address) [[unlikely]]
+         return;
+      auto       loc       = _ptr_alloc.get(adr).load(std::memory_order_relaxed).loc();
+      const auto page_size = system_config::os_page_size();
+      auto       addr      = reinterpret_cast<uintptr_t>(_block_base_ptr + *loc.offset());
+      // the header's page, and the next one if the header straddles it
+      auto first = addr & ~(page_size - 1);
+      auto last  = (addr + sizeof(alloc_header) - 1) & ~(page_size - 1);
+      ::madvise(reinterpret_cast<void*>(first), last - first + page_size, MADV_WILLNEED);
+   }
+
    inline bool allocator_session::is_read_only(ptr_address adr) const noexcept
    {
       assert(adr != null_ptr_address);
@@ -290,6 +335,44 @@ namespace sal
    {
       return _sega._mapped_state->_cache_difficulty_state.should_cache(get_random(), size);
    }
+
+   inline void allocator_session::record_read(ptr_address    adr,
+                                              control_block& cb,
+                                              location       loc,
+                                              uint32_t       size) noexcept
+   {
+      const auto& cfg = _sega._mapped_state->_config;
+      if (not cfg.enable_read_cache)
+         return;
+
+      const uint64_t random = get_random();
+      if (random % read_sample_rate == 0)
+      {
+         // only this session writes its slot
+         auto& slot = _sega._read_samples[*_session_num];
+         slot.sampled_reads.store(slot.sampled_reads.load(std::memory_order_relaxed) + 1,
+                                  std::memory_order_relaxed);
+         if (_sega._mapped_state->_segment_data.is_pinned(loc.segment()))
+            slot.pinned_hits.store(slot.pinned_hits.load(std::memory_order_relaxed) + 1,
+                                   std::memory_order_relaxed);
+         if (cfg.cache_admission == cache_admission_policy::frequency_sketch)
+            slot.accesses.try_push(adr);
+      }
+
+      if (cfg.cache_admission != cache_admission_policy::read_bits)
+         return;
+      // the second hit sets pending_cache, which the compactor clears when
+      // it pops the address
+      if (_sega._mapped_state->_cache_difficulty_state.should_cache(random, size) and
+          cb.try_inc_activity() and cb.pending_cache())
+         if (not _rcache_queue.try_push(adr))
+            cb.try_end_pending_cache();
+   }
+
+   inline void smart_ref_base::maybe_update_read_stats(uint32_t size) const noexcept
+   {
+      _asession->record_read(_obj->address(), _control, _cached.loc(), size);
+   }
    inline ptr_address allocator_session::alloc_custom_cb(uint64_t user_value) noexcept
    {
       assert(check_thread_ownership());
@@ -420,6 +503,8 @@ namespace sal
                                                    smart_ptr<T>       ptr,
                                                    sync_type          st) noexcept
    {
+      if (st == sync_type::background_full) [[unlikely]]
+         _sega.throttle_durability_lag();
       auto new_tid = ptr.take_tree_id();
       auto root_info = make_sync_root_info(*this, ro, new_tid);
       sync(st, _sega._mapped_state->_config, root_info);
@@ -433,6 +518,8 @@ namespace sal
                                                    smart_ptr<U>       desired,
                                                    sync_type          st) noexcept
    {
+      if (st == sync_type::background_full) [[unlikely]]
+         _sega.throttle_durability_lag();
       auto expect_tid  = expect.get_tree_id();
       auto desired_tid = desired.get_tree_id();
       auto root_info   = make_sync_root_info(*this, ro, desired_tid);
@@ -465,6 +552,8 @@ namespace sal
        smart_ptr<alloc_header> desired,
                                                    sync_type               st) noexcept
    {
+      if (st == sync_type::background_full) [[unlikely]]
+         _sega.throttle_durability_lag();
       auto new_tid = desired.take_tree_id();
       auto root_info = make_sync_root_info(*this, ro, new_tid);
       sync(st, _sega._mapped_state->_config, root_info);
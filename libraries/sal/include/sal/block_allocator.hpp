@@ -1,5 +1,6 @@
 #pragma once
 #include <filesystem>
+#include <memory>
 #include <mutex>
 #include <utility>
 
@@ -198,6 +199,70 @@ namespace sal
        */
       bool punch_hole(block_number block, uint32_t count = 1) noexcept;
 
+      /**
+       * Advise the kernel to back [addr, addr + size) with transparent huge
+       * pages, or to stop doing so when @p huge is false.
+       *
+       * @return false if the kernel rejected the advice or the platform has
+       *         no THP support; the range keeps using normal pages.
+       */
+      static bool advise_huge_pages(void* addr, uint64_t size, bool huge = true) noexcept;
+
+      /**
+       * Advise all currently mapped blocks, and every block mapped by later
+       * reserve() calls, to use huge pages. If the kernel rejects the advice
+       * a warning is logged once and huge pages stay disabled.
+       *
+       * @return true if huge pages are enabled for this file
+       */
+      bool enable_huge_pages() noexcept;
+      bool huge_pages() const noexcept { return _huge_pages.load(std::memory_order_relaxed); }
+
+      /**
+       * @name Tier file
+       *
+       * A second file, usually on a different device, that individual blocks
+       * can be moved into. It is mapped into the same reservation as the
+       * primary file, so a block keeps its address and file offset whichever
+       * file backs it. A block lives in the tier file when the tier file
+       * holds data in its range; the file a block leaves has that range
+       * punched out. The file extents are therefore the only record of which
+       * file backs a block and survive crashes with the data itself.
+       */
+      ///@{
+      /**
+       * Opens (creating if needed) @p file as the tier file and maps every
+       * block whose range holds data in it from the tier file.
+       *
+       * @throws std::runtime_error if the file cannot be opened or its
+       *         filesystem cannot punch holes
+       */
+      void attach_tier_file(std::filesystem::path file);
+      bool has_tier_file() const noexcept { return _tier_fd >= 0; }
+
+      /// true if @p block is currently backed by the tier file
+      bool in_tier_file(block_number block) const noexcept
+      {
+         return _tier_fd >= 0 &&
+                (_tier_bits[*block / 64].load(std::memory_order_relaxed) >> (*block % 64)) & 1;
+      }
+
+      /**
+       * Maps @p block from the tier file, or back from the primary file, and
+       * punches its range out of the file it left. The contents of the block
+       * are not preserved, so only blocks without live data may be moved.
+       *
+       * @return false if the block could not be moved and stays where it was
+       */
+      bool move_block(block_number block, bool to_tier) noexcept;
+
+      /// number of blocks currently backed by the tier file
+      uint64_t tier_blocks() const noexcept { return _tier_blocks.load(std::memory_order_relaxed); }
+
+      /// bytes the primary file (or the tier file) occupies on disk
+      uint64_t disk_usage(bool tier = false) const noexcept;
+      ///@}
+
       /**
        * Helper method to determine if a value is a power of 2
        *
@@ -224,6 +289,13 @@ namespace sal
       }
 
      private:
+      // caller holds _resize_mutex
+      void advise_mapped_huge_pages(void* addr, uint64_t size) noexcept;
+      // caller holds _resize_mutex; maps @p block from @p fd at its own offset
+      bool map_block_from(int fd, uint64_t block) noexcept;
+      // deallocates [offset, offset+len) of @p fd and drops its cached pages
+      bool punch_range(int fd, off_t offset, off_t len) noexcept;
+
       std::filesystem::path _filename;
       uint64_t              _block_size;
       uint8_t               _log2_block_size;  // log2 of block_size for fast bit shifting
@@ -241,6 +313,15 @@ namespace sal
       // Cached RLIMIT_MEMLOCK value (bytes). Set once in constructor.
       // RLIM_INFINITY (~0ULL) means no limit.
       uint64_t _mlock_limit_bytes;
+
+      std::atomic<bool> _huge_pages{false};
+
+      // Tier file, see attach_tier_file()
+      int                                      _tier_fd = -1;
+      std::filesystem::path                    _tier_filename;
+      uint64_t                                 _tier_file_size = 0;  // guarded by _resize_mutex
+      std::unique_ptr<std::atomic<uint64_t>[]> _tier_bits;
+      std::atomic<uint64_t>                    _tier_blocks{0};
    };
 
 }  // namespace sal
@@ -0,0 +1,160 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <limits>
+
+namespace sal
+{
+   /**
+    * Incrementally maintained set of segments whose freed space has reached
+    * the compaction threshold.
+    *
+    * The compactor used to find candidates by walking every segment on every
+    * pass, which is O(max segments) even when nothing qualifies.  Instead,
+    * the paths that add freed space (and the path that makes a segment read
+    * only) insert the segment here once it crosses the threshold, and the
+    * compactor only visits set bits.
+    *
+    * The set is a two level atomic bitmap: level 0 holds one bit per segment
+    * and level 1 holds one bit per non-empty level 0 word, so an empty or
+    * sparse index is walked in O(NumBits / 4096) word loads.  Any thread may
+    * insert; entries are removed lazily by the compactor when a segment no
+    * longer qualifies (compacted, recycled, or reset by a new session).
+    *
+    * Membership is conservative: a set bit means "worth checking", the
+    * compactor always re-validates the segment before using it.  A missing
+    * bit for a qualifying segment is the only real error, which is why
+    * erase() is followed by a re-check and re-insert by the caller.
+    *
+    * The index is process-local and starts unbuilt (threshold max), so no
+    * insert happens until the compactor calls rebuild() on its first pass.
+    *
+    * @tparam NumBits maximum number of segments, multiple of 4096
+    */
+   template <uint64_t NumBits>
+   class compaction_index
+   {
+     public:
+      static_assert(NumBits % 4096 == 0, "NumBits must be a multiple of 4096");
+      static constexpr uint32_t unbuilt = std::numeric_limits<uint32_t>::max();
+
+      compaction_index() noexcept
+      {
+         for (auto& w : _level0)
+            w.store(0, std::memory_order_relaxed);
+         for (auto& w : _level1)
+            w.store(0, std::memory_order_relaxed);
+      }
+
+      /// freed bytes at which a segment becomes a candidate
+      uint32_t threshold() const noexcept { return _threshold.load(); }
+
+      /// called after freed space of @p seg changed to @p freed bytes
+      void update(uint32_t seg, uint32_t freed) noexcept
+      {
+         if (freed >= threshold())
+            insert(seg);
+      }
+
+      bool contains(uint32_t seg) const noexcept
+      {
+         return _level0[seg / 64].load(std::memory_order_relaxed) & bit(seg);
+      }
+
+      void insert(uint32_t seg) noexcept
+      {
+         auto& w = _level0[seg / 64];
+         // fast path: already a candidate, avoid the RMW on a shared line
+         if (w.load(std::memory_order_relaxed) & bit(seg))
+            return;
+         if (w.fetch_or(bit(seg)) == 0)
+            _level1[seg / 4096].fetch_or(bit(seg / 64));
+      }
+
+      /// removes @p seg; the caller must re-check the segment afterwards and
+      /// re-insert it if it qualifies, to close the race with update()
+      void erase(uint32_t seg) noexcept { _level0[seg / 64].fetch_and(~bit(seg)); }
+
+      /**
+       * Calls @p fn(seg) for every candidate below @p end.  Entries inserted
+       * or erased during the walk may or may not be visited.  Level 1 bits of
+       * words found empty are cleared here rather than in erase().
+       */
+      template <typename Fn>
+      void for_each(uint64_t end, Fn&& fn)
+      {
+         const uint64_t top = (std::min<uint64_t>(end, NumBits) + 4095) / 4096;
+         for (uint64_t hi = 0; hi < top; ++hi)
+         {
+            uint64_t summary = _level1[hi].load(std::memory_order_relaxed);
+            while (summary)
+            {
+               const uint64_t wi = hi * 64 + std::countr_zero(summary);
+               summary &= summary - 1;
+
+               uint64_t word = _level0[wi].load(std::memory_order_relaxed);
+               if (word == 0)
+               {
+                  _level1[hi].fetch_and(~bit(wi));
+                  // an insert may have raced the clear, restore its summary bit
+                  if (_level0[wi].load() != 0)
+                     _level1[hi].fetch_or(bit(wi));
+                  continue;
+               }
+               while (word)
+               {
+                  const uint64_t seg = wi * 64 + std::countr_zero(word);
+                  word &= word - 1;
+                  if (seg >= end)
+                     return;
+                  fn(uint32_t(seg));
+               }
+            }
+         }
+      }
+
+      /**
+       * Installs a new threshold and re-populates the index from @p freed_of
+       * for segments [0, end).  Entries below the new threshold are left for
+       * lazy removal.  Returns false if another thread already installed
+       * @p new_threshold.
+       */
+      template <typename FreedOf>
+      bool rebuild(uint32_t new_threshold, uint64_t end, FreedOf&& freed_of)
+      {
+         uint32_t cur = threshold();
+         do
+         {
+            if (cur == new_threshold)
+               return false;
+         } while (not _threshold.compare_exchange_weak(cur, new_threshold));
+
+         end = std::min<uint64_t>(end, NumBits);
+         for (uint64_t seg = 0; seg < end; ++seg)
+            if (freed_of(uint32_t(seg)) >= new_threshold)
+               insert(uint32_t(seg));
+         return true;
+      }
+
+      /// forces the next rebuild(), used after recovery rewrote the segment metadata
+      void invalidate() noexcept { _threshold.store(unbuilt); }
+
+      /// number of candidates, O(NumBits / 64)
+      uint64_t count() const noexcept
+      {
+         uint64_t n = 0;
+         for (const auto& w : _level0)
+            n += std::popcount(w.load(std::memory_order_relaxed));
+         return n;
+      }
+
+     private:
+      static constexpr uint64_t bit(uint64_t i) noexcept { return uint64_t(1) << (i % 64); }
+
+      std::atomic<uint32_t> _threshold{unbuilt};
+      std::atomic<uint64_t> _level1[NumBits / 4096];
+      std::atomic<uint64_t> _level0[NumBits / 64];
+   };
+}  // namespace sal
@@ -41,6 +41,12 @@ namespace sal
       {
          return ((arg + os_page_size() - 1) / os_page_size()) * os_page_size();
       }
+
+      /**
+       * PMD-level transparent huge page size on x86-64 and 4K-page aarch64.
+       * Mappings that should be eligible for huge pages are aligned to this.
+       */
+      constexpr std::size_t huge_page_size = 2 * 1024 * 1024;
    }  // namespace system_config
 
    /**
@@ -49,27 +55,35 @@ namespace sal
     * Each level adds progressively stronger guarantees at the cost of
     * write latency and SSD wear. Choose based on your failure model:
     *
-    * | Level        | App crash | OS crash  | Power loss | Write latency     |
-    * |--------------|-----------|-----------|------------|-------------------|
-    * | none         | No        | No        | No         | Zero (no syscall) |
-    * | mprotect     | Yes       | No        | No         | ~microseconds     |
-    * | msync_async  | Yes       | Probably  | Probably   | ~microseconds     |
-    * | msync_sync   | Yes       | Mostly    | Mostly     | ~milliseconds     |
-    * | fsync        | Yes       | Yes       | Mostly*    | ~milliseconds     |
-    * | full         | Yes       | Yes       | Yes        | ~10s of ms        |
+    * | Level           | App crash | OS crash  | Power loss | Write latency     |
+    * |-----------------|-----------|-----------|------------|-------------------|
+    * | none            | No        | No        | No         | Zero (no syscall) |
+    * | mprotect        | Yes       | No        | No         | ~microseconds     |
+    * | msync_async     | Yes       | Probably  | Probably   | ~microseconds     |
+    * | msync_sync      | Yes       | Mostly    | Mostly     | ~milliseconds     |
+    * | fsync           | Yes       | Yes       | Mostly*    | ~milliseconds     |
+    * | full            | Yes       | Yes       | Yes        | ~10s of ms        |
+    * | background_full | Yes       | Bounded** | Bounded**  | ~microseconds     |
     *
     * *fsync flushes to the drive controller but the drive may still cache
     * data in its volatile write buffer. full (F_FULLFSYNC on macOS) asks
     * the drive to flush its cache to physical media.
+    *
+    * **background_full commits like mprotect and a background thread makes
+    * everything committed durable at least every
+    * runtime_config::max_durability_lag_ms. Power-loss recovery rolls back
+    * to the last durable snapshot, so at most that window of commits is lost.
     */
    enum class sync_type
    {
-      none        = 0,  ///< No sync. Data persists when the OS flushes dirty pages (process exit, memory pressure).
-      mprotect    = 1,  ///< Write-protect committed pages via mprotect(PROT_READ). Stray writes cause SIGSEGV.
-      msync_async = 2,  ///< msync(MS_ASYNC): hint to OS to flush soon, non-blocking. No hard guarantee.
-      msync_sync  = 3,  ///< msync(MS_SYNC): block until OS has written pages to its disk cache.
-      fsync       = 4,  ///< fsync(): block until OS has sent data to the drive controller.
-      full        = 5,  ///< F_FULLFSYNC (macOS) / fsync + drive cache flush: data on physical media.
+      none            = 0,  ///< No sync. Data persists when the OS flushes dirty pages (process exit, memory pressure).
+      mprotect        = 1,  ///< Write-protect committed pages via mprotect(PROT_READ). Stray writes cause SIGSEGV.
+      msync_async     = 2,  ///< msync(MS_ASYNC): hint to OS to flush soon, non-blocking. No hard guarantee.
+      msync_sync      = 3,  ///< msync(MS_SYNC): block until OS has written pages to its disk cache.
+      fsync           = 4,  ///< fsync(): block until OS has sent data to the drive controller.
+      full            = 5,  ///< F_FULLFSYNC (macOS) / fsync + drive cache flush: data on physical media.
+      background_full = 6,  ///< mprotect at commit; a background thread syncs fully within max_durability_lag_ms.
+                            ///< Sorts last but costs like mprotect per commit: test it explicitly, not with >=.
       default_sync_type = msync_sync
    };
    inline std::ostream& operator<<(std::ostream& os, sync_type st)
@@ -88,6 +102,8 @@ namespace sal
             return os << "fsync";
          case sync_type::full:
             return os << "full";
+         case sync_type::background_full:
+            return os << "background_full";
          default:
             return os << "unknown";
       }
@@ -109,11 +125,30 @@ namespace sal
          st = sync_type::fsync;
       else if (str == "full")
          st = sync_type::full;
+      else if (str == "background_full")
+         st = sync_type::background_full;
       else
          is.setstate(std::ios::failbit);
       return is;
    }
 
+   /**
+    * @brief How read-hot objects are chosen for promotion into pinned segments.
+    *
+    * - read_bits: a read sets the object's active bit with a probability set
+    *   by the self-tuning cache difficulty; a second such read queues the
+    *   object for promotion.  No per-object history beyond two bits.
+    * - frequency_sketch: sampled reads feed a count-min sketch (TinyLFU).  An
+    *   object is promoted only when its estimated frequency beats that of
+    *   the objects in the pinned segment that would be unpinned next, so a
+    *   scan of one-time reads cannot displace the hot set.
+    */
+   enum class cache_admission_policy : uint8_t
+   {
+      read_bits        = 0,
+      frequency_sketch = 1
+   };
+
    enum class access_mode
    {
       read_only  = 0,
@@ -179,6 +214,40 @@ namespace sal
        */
       bool enable_read_cache = true;
 
+      /**
+       * @brief Admission policy for the MFU read cache.
+       *
+       * See cache_admission_policy. The sketch costs the compactor a few MB
+       * of process memory sized from max_pinned_cache_size_mb; it is built
+       * when the policy is first selected and forgotten on restart.
+       * `database_stats` reports the pinned hit rate and the promotion rate
+       * under either policy so the two can be compared.
+       *
+       * Default: read_bits.
+       */
+      cache_admission_policy cache_admission = cache_admission_policy::read_bits;
+
+      /**
+       * @brief Back pinned segments and the control-block arrays with
+       * transparent huge pages.
+       *
+       * Random lookups touch a new 4 KB page on nearly every node, so a
+       * large hot set misses the TLB constantly. With this enabled, pinned
+       * segments and the control-block zones are advised MADV_HUGEPAGE,
+       * letting the kernel map them with 2 MB pages and cutting TLB misses
+       * on the hot path.
+       *
+       * Whether huge pages are actually used is up to the kernel: THP must
+       * be set to `madvise` or `always`, and the filesystem holding the
+       * database must support large folios for shared file mappings (e.g.
+       * tmpfs with shmem_enabled=advise, or recent XFS/ext4). When the
+       * advice is rejected the database logs a warning once and carries on
+       * with normal pages. Only read when the database is opened.
+       *
+       * Default: false.
+       */
+      bool huge_pages = false;
+
       ///@}
 
       /** @name Durability & Write Protection */
@@ -192,7 +261,9 @@ namespace sal
        * full (slowest, survives power loss).
        *
        * This is the default for the database; individual write sessions can
-       * override it via write_session::set_sync().
+       * override it via write_session::set_sync().  The background_full
+       * durability thread only runs when this is background_full; sessions
+       * that pick it under another mode sync each commit fully.
        *
        * Default: sync_type::none (data persists at OS discretion).
        */
@@ -216,6 +287,46 @@ namespace sal
        */
       bool write_protect_on_commit = true;
 
+      /**
+       * @brief Upper bound on how far durable state may trail commits when
+       * sync_mode is background_full.
+       *
+       * A background thread snapshots the roots and fsyncs the database
+       * about twice per interval, so a power loss loses at most this many
+       * milliseconds of commits. Segments freed by the compactor are not
+       * reused until a later snapshot is durable, so the last durable
+       * snapshot always stays intact on disk.
+       *
+       * If the disk falls behind and the durable state is more than twice
+       * this old, committing writers wait for the background sync to catch
+       * up. This keeps the bound even under sustained write load.
+       *
+       * Lower values shrink the loss window but cost more fsyncs. Has no
+       * effect in other sync modes.
+       *
+       * Default: 1000 (one second).
+       */
+      uint32_t max_durability_lag_ms = 1000;
+
+      /**
+       * @brief Longest a group commit leader waits for more committers
+       * before flushing, in microseconds.
+       *
+       * With sync_mode msync_sync or higher, commits from all write
+       * sessions share flushes: one committer becomes the leader and
+       * issues a single flush covering every commit queued by then, while
+       * the others wait for it. Commits that arrive during a flush are
+       * batched into the next one, so concurrent writers coalesce even
+       * with no delay.
+       *
+       * A delay lets the leader gather more commits per flush at the cost
+       * of that much latency on every commit. It only pays off with many
+       * concurrent writers on a device with slow flushes.
+       *
+       * Default: 0 (flush immediately).
+       */
+      uint32_t group_commit_delay_us = 0;
+
       ///@}
 
       /** @name Checksums & Integrity */
@@ -288,7 +399,7 @@ namespace sal
 
       ///@}
 
-      /** @name Compaction Thresholds */
+      /** @name Compaction */
       ///@{
 
       /**
@@ -325,6 +436,114 @@ namespace sal
        */
       uint8_t compact_unpinned_unused_threshold_mb = 16;
 
+      /**
+       * @brief Virtual age in seconds before unpinned data moves to the cold tier.
+       *
+       * Only used when the database was opened with a cold tier directory.
+       * The cold tier thread copies the live objects of unpinned segments
+       * whose virtual age is older than this into segments stored in the
+       * cold directory, which can be on cheaper, slower storage. Data read
+       * often enough to be promoted comes back through the read cache.
+       *
+       * - Too low: recently written data lands on slow storage and is
+       *   copied twice.
+       * - Too high: the fast device holds data nobody reads.
+       *
+       * Default: 86400 (one day).
+       */
+      uint32_t cold_tier_age_sec = 86400;
+
+      /**
+       * @brief Number of background threads that compact segments.
+       *
+       * Each compactor worker owns a disjoint partition of the segment
+       * space (segment number modulo the worker count), so two workers
+       * never select the same source segment. Every worker runs its own
+       * allocator session and therefore copies into its own destination
+       * segment without contending on a shared write cursor.
+       *
+       * Only the first worker promotes MFU read-cache data, because the
+       * per-session rcache queues have a single consumer.
+       *
+       * - Raise this when sustained writes free space faster than one
+       *   thread can reclaim it (file keeps growing while the compactor
+       *   is always busy).
+       * - Each worker uses a core and one of the max_threads sessions.
+       *
+       * Clamped to [1, sal::max_compactor_threads]. Takes effect the next
+       * time the background threads are started.
+       *
+       * Default: 1.
+       */
+      uint8_t compactor_threads = 1;
+
+      /**
+       * @brief Number of background threads that process deferred releases.
+       *
+       * Dropping the last reference to a large subtree (remove_range, a
+       * released snapshot) queues releases that cascade through every
+       * child. Release workers shard the per-session release queues by
+       * session number; each worker also drains the queue of its own
+       * session, which is where the cascading children of its releases
+       * land. Releases queued by different writers therefore proceed in
+       * parallel, while a single giant cascade stays on one worker.
+       *
+       * Clamped to [1, sal::max_release_threads]. Takes effect the next
+       * time the background threads are started.
+       *
+       * Default: 1.
+       */
+      uint8_t release_threads = 1;
+
+      ///@}
+
+      /** @name Recovery */
+      ///@{
+
+      /**
+       * @brief Number of threads used to rebuild control blocks after an
+       * unclean shutdown.
+       *
+       * Recovery time scales with the size of the database: every segment
+       * is scanned to find the newest copy of each object, then every
+       * object reachable from a root is visited to rebuild its reference
+       * count. Both passes are split across this many threads; segments
+       * are handed out one at a time during the scan and the reachability
+       * walk balances subtrees between threads by work stealing.
+       *
+       * - 0 uses one thread per hardware core.
+       * - 1 reproduces the single-threaded recovery of earlier versions.
+       *
+       * Clamped to [1, sal::max_threads]. Only read while recovering, so
+       * it must be set in the config passed to open().
+       *
+       * Default: 0 (hardware concurrency).
+       */
+      uint8_t recovery_threads = 0;
+
+      /**
+       * @brief Rate limit for background leak reclamation after a
+       * deferred_cleanup restart.
+       *
+       * A deferred_cleanup restart skips the reference count rebuild, so
+       * objects orphaned by the crash stay allocated. While the reference
+       * counts are marked stale, a background thread marks everything
+       * reachable from the roots as of the restart and then sweeps the
+       * control block zones, freeing whatever the mark did not reach. It
+       * does this incrementally while the database serves traffic, so
+       * there is no stop-the-world reclaim_leaked_memory() pause.
+       *
+       * One unit of work is one object visited while marking or one
+       * control block examined while sweeping.
+       *
+       * - Lower this to leave more I/O and CPU to foreground work.
+       * - 0 pauses the pass; leaks are then only reclaimed by
+       *   reclaim_leaked_memory().
+       *
+       * Default: 1,000,000 per second.
+       */
+      uint32_t leak_reclaim_objects_per_sec = 1'000'000;
+
       ///@}
 
       /** @name Virtual Address Space */
@@ -383,6 +602,10 @@ namespace sal
    // in at most 1 cache miss for the large object followed by sequential reads.
    static constexpr const uint32_t max_cacheable_object_size = 4096;
 
+   // one read in this many is sampled for the pinned hit rate and, under
+   // cache_admission_policy::frequency_sketch, for the admission sketch
+   static constexpr const uint32_t read_sample_rate = 16;
+
    /**
     *  Certain parameters depend upon reserving space for eventual growth
     *  of the database. 
@@ -407,6 +630,12 @@ namespace sal
     */
    static constexpr const uint32_t max_threads = 64;
 
+   /// upper bound for runtime_config::compactor_threads, each worker holds a session
+   static constexpr const uint32_t max_compactor_threads = 8;
+
+   /// upper bound for runtime_config::release_threads, each worker holds a session
+   static constexpr const uint32_t max_release_threads = 8;
+
    // the maximum object size that can be allocated in a segment
    // generally limited to half the segment size (16MB)
    static constexpr const uint64_t max_object_size = segment_size / 2;
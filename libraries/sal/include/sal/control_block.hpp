@@ -280,7 +280,9 @@ namespace sal
 
       /**
        *  Clears the pending cache bit, returns false if it is already cleared
-       * 
+       *  or the block no longer holds the queued object: freed, or reused as
+       *  a custom CB {active=0, pending_cache=1}, whose marker is preserved.
+       *
        * @return true if the pending cache bit was cleared, false otherwise
        */
       bool try_end_pending_cache() noexcept
@@ -290,7 +292,7 @@ namespace sal
          do
          {
             updated.from_int(expected);
-            if (updated.pending_cache == false)
+            if (updated.pending_cache == false or updated.active == false or updated.ref == 0)
                return false;
             updated.set_pending_cache(false);
          } while (not _data.compare_exchange_weak(expected, updated.to_int(),
@@ -180,8 +180,9 @@ namespace sal
      public:
       /**
        *  @param dir the directory to store the page table and pages
+       *  @param huge_pages back the zones and free lists with transparent huge pages
        */
-      control_block_alloc(const std::filesystem::path& dir);
+      control_block_alloc(const std::filesystem::path& dir, bool huge_pages = false);
       ~control_block_alloc();
 
       /**
@@ -453,6 +454,13 @@ namespace sal
       // set all refs > 1 to 1, leave 0 alone
       void reset_all_refs();
 
+      // allocated addresses in [word * 64, word * 64 + 64) as a bitmask,
+      // word must be below current_max_address_count() / 64
+      uint64_t allocated_bits(uint32_t word) const noexcept
+      {
+         return ~_free_list_base[word].load(std::memory_order_relaxed);
+      }
+
       /// @brief Returns the total number of used pointers across all regions
       /// @return The sum of all region use counts
       uint64_t used() const
@@ -472,6 +480,9 @@ namespace sal
          return _header_ptr->allocated_zones.load(std::memory_order_relaxed);
       }
 
+      /// true if the control-block zones are advised to use huge pages
+      bool huge_pages() const noexcept { return _zone_allocator->huge_pages(); }
+
       /// the maximum address that could be allocated without
       /// resizing the file.
       uint32_t current_max_address_count() const
@@ -0,0 +1,115 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <memory>
+
+namespace sal
+{
+   /**
+    * Count-min sketch of 4-bit counters used to estimate how often an
+    * object has been read recently (the TinyLFU admission filter).
+    *
+    * Each 64-bit word holds sixteen counters.  A key selects one word per
+    * row and one counter within it, so an increment touches four words and
+    * the estimate is the minimum of those four counters.  Counters saturate
+    * at 15; once the number of increments reaches ten times the number of
+    * words every counter is halved, so old popularity decays and the sketch
+    * follows a shifting working set.
+    *
+    * Not thread safe: only the compactor thread that admits objects into
+    * the pinned cache touches it.
+    */
+   class frequency_sketch
+   {
+     public:
+      static constexpr uint32_t max_frequency = 15;
+
+      /// @param capacity the number of distinct objects the sketch should
+      ///                 tell apart, rounded up to a power of 2
+      explicit frequency_sketch(uint64_t capacity = 0) { resize(capacity); }
+
+      /// drops all counts and sizes the table for @p capacity objects
+      void resize(uint64_t capacity)
+      {
+         _words       = std::bit_ceil(std::clamp<uint64_t>(capacity, min_words, max_words));
+         _mask        = _words - 1;
+         _sample_size = _words * 10;
+         _additions   = 0;
+         _table       = std::make_unique<uint64_t[]>(_words);
+      }
+
+      uint64_t capacity() const noexcept { return _words; }
+      uint64_t sample_size() const noexcept { return _sample_size; }
+
+      /// number of increments since the last aging pass
+      uint64_t additions() const noexcept { return _additions; }
+
+      void increment(uint64_t key) noexcept
+      {
+         const uint64_t h     = spread(key);
+         const uint32_t start = (h & 3) << 2;
+         bool           added = false;
+         for (uint32_t row = 0; row < 4; ++row)
+         {
+            uint64_t&      word  = _table[index_of(h, row)];
+            const uint32_t shift = (start + row) << 2;
+            if (((word >> shift) & 0xf) != max_frequency)
+            {
+               word += uint64_t(1) << shift;
+               added = true;
+            }
+         }
+         if (added and ++_additions >= _sample_size)
+            age();
+      }
+
+      /// estimated number of increments of @p key, at most max_frequency
+      uint32_t frequency(uint64_t key) const noexcept
+      {
+         const uint64_t h     = spread(key);
+         const uint32_t start = (h & 3) << 2;
+         uint32_t       freq  = max_frequency;
+         for (uint32_t row = 0; row < 4; ++row)
+         {
+            const uint32_t shift = (start + row) << 2;
+            freq = std::min<uint32_t>(freq, (_table[index_of(h, row)] >> shift) & 0xf);
+         }
+         return freq;
+      }
+
+      /// halves every counter
+      void age() noexcept
+      {
+         for (uint64_t i = 0; i < _words; ++i)
+            _table[i] = (_table[i] >> 1) & 0x7777777777777777ull;
+         _additions /= 2;
+      }
+
+     private:
+      static constexpr uint64_t min_words = 64;
+      static constexpr uint64_t max_words = uint64_t(1) << 24;
+
+      static uint64_t spread(uint64_t x) noexcept
+      {
+         x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+         x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+         return x ^ (x >> 31);
+      }
+
+      uint64_t index_of(uint64_t h, uint32_t row) const noexcept
+      {
+         static constexpr uint64_t seeds[4] = {0xc3a5c85c97cb3127ull, 0xb492b66fbe98f273ull,
+                                               0x9ae16a3b2f90404full, 0xcbf29ce484222325ull};
+         uint64_t x = (h + seeds[row]) * seeds[row];
+         x += x >> 32;
+         return x & _mask;
+      }
+
+      std::unique_ptr<uint64_t[]> _table;
+      uint64_t                    _words       = 0;
+      uint64_t                    _mask        = 0;
+      uint64_t                    _sample_size = 0;
+      uint64_t                    _additions   = 0;
+   };
+}  // namespace sal
@@ -52,6 +52,7 @@ namespace sal
             pending   = 1 << 3,  // segment compacted, waiting on read lock release
             free      = 1 << 4,  // segment free and ready for reuse
             queued    = 1 << 5,  // segment in provider queue waiting for session to claim
+            compacting = 1 << 6,  // claimed by a compactor, cleared when queued for recycling
          };
 
          /// tracks if the segment is read only, set by the session thread when the
@@ -149,7 +150,29 @@ namespace sal
          {
             return (flags.load(std::memory_order_relaxed) & ~pinned) == read_only;
          }
+         /// claims a compactable segment so that only one compactor copies it
+         bool try_claim_compaction()
+         {
+            auto f = flags.load(std::memory_order_relaxed);
+            do
+            {
+               if ((f & ~pinned) != read_only)
+                  return false;
+            } while (not flags.compare_exchange_weak(f, f | compacting, std::memory_order_acquire,
+                                                     std::memory_order_relaxed));
+            return true;
+         }
+         /// gives up a claim without recycling the segment
+         void release_compaction_claim()
+         {
+            flags.fetch_and(~compacting, std::memory_order_release);
+         }
          bool     is_read_only() const { return flags.load(std::memory_order_relaxed) & read_only; }
+         /// queued for or held by a session, which may still append to it
+         bool     is_writable() const
+         {
+            return flags.load(std::memory_order_relaxed) & (active | queued);
+         }
          bool     is_pinned() const { return flags.load(std::memory_order_relaxed) & pinned; }
          uint32_t get_freed_space() const { return _freed_space_LOCKED.load(std::memory_order_relaxed); }
          uint32_t get_flags() const { return flags.load(std::memory_order_relaxed); }
@@ -163,6 +186,14 @@ namespace sal
       {
         public:
          bool may_compact(segment_number segment) const { return meta[*segment].may_compact(); }
+         bool try_claim_compaction(segment_number segment)
+         {
+            return meta[*segment].try_claim_compaction();
+         }
+         void release_compaction_claim(segment_number segment)
+         {
+            meta[*segment].release_compaction_claim();
+         }
          void added_to_free_segments(segment_number segment)
          {
             //            ARBTRIE_INFO("free: ", segment);
@@ -225,6 +256,7 @@ namespace sal
          }
          uint64_t get_vage(segment_number segment) const { return meta[*segment].get_vage(); }
          bool is_read_only(segment_number segment) const { return meta[*segment].is_read_only(); }
+         bool is_writable(segment_number segment) const { return meta[*segment].is_writable(); }
          bool is_pinned(segment_number segment) const { return meta[*segment].is_pinned(); }
          void set_pinned(segment_number segment, bool pinned) { meta[*segment].set_pinned(pinned); }
          uint32_t get_flags(segment_number segment) const { return meta[*segment].get_flags(); }
@@ -235,6 +267,14 @@ namespace sal
 
       static constexpr size_t segment_footer_size = 64;
 
+      /// page aligned bytes of a segment written since its previous sync,
+      /// handed to the group commit leader to flush
+      struct sync_range
+      {
+         char*    data;
+         uint32_t size;
+      };
+
       /**
        * The main unit of memory allocation, can be thought of as a "super page" because
        * it is at this resolution that memory is mlocked, madvised, and it determines the
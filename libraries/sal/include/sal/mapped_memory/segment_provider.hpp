@@ -17,6 +17,8 @@ namespace sal
       {
          ucc::poly_buffer<segment_number> ready_pinned_segments;
          ucc::poly_buffer<segment_number> ready_unpinned_segments;
+         /// segments backed by the cold tier file, only filled when one is attached
+         ucc::poly_buffer<segment_number> ready_cold_segments;
 
          /** 
           * bitmap of segments that are free to be recycled pushed into
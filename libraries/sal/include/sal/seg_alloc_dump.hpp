@@ -31,6 +31,7 @@ namespace sal
          bool           hdr_read_only = false;  // segment header _first_writable_page check
          bool           is_finalized  = false;  // segment header close time set
          bool           is_free       = false;
+         bool           is_cold       = false;  // backed by the cold tier file
          uint64_t       age           = 0;
          uint32_t       read_nodes    = 0;  // Count of valid objects in segment
          uint64_t       read_bytes    = 0;  // Total size of valid objects
@@ -46,6 +47,28 @@ namespace sal
          uint64_t                 total_bytes_written{0};  // Total bytes written by this session
       };
 
+      struct compactor_worker_info
+      {
+         uint32_t worker             = 0;
+         uint64_t segments_compacted = 0;
+         uint64_t bytes_relocated    = 0;  // live bytes copied out of source segments
+         uint64_t busy_ns            = 0;  // wall time spent inside compact_segment
+
+         double throughput_mb_sec() const
+         {
+            return busy_ns ? (bytes_relocated / double(1024 * 1024)) / (busy_ns / 1e9) : 0.0;
+         }
+      };
+
+      struct release_worker_info
+      {
+         uint32_t worker   = 0;
+         uint64_t released = 0;  // objects passed to final_release
+         uint64_t busy_ns  = 0;  // wall time spent releasing
+
+         double objects_per_sec() const { return busy_ns ? released / (busy_ns / 1e9) : 0.0; }
+      };
+
       struct pending_segment
       {
          uint64_t index       = 0;
@@ -68,6 +91,14 @@ namespace sal
       uint32_t cache_difficulty     = 0;  // Current cache difficulty setting
       uint64_t total_promoted_bytes = 0;  // Total bytes promoted through the cache
 
+      // Read cache admission, process-local since open
+      uint8_t  cache_admission         = 0;  // runtime_config::cache_admission
+      uint64_t cache_sampled_reads     = 0;  // reads sampled (1 in read_sample_rate)
+      uint64_t cache_sampled_hits      = 0;  // sampled reads served from pinned segments
+      uint64_t cache_promotions        = 0;  // objects promoted into pinned segments
+      uint64_t cache_admission_rejects = 0;  // sketch candidates not more frequent than the victims
+      uint32_t cache_victim_frequency  = 0;  // sketch estimate for the next pinned segment to unpin
+
       // Segment queue state
       uint64_t alloc_ptr       = 0;
       uint64_t end_ptr         = 0;
@@ -80,14 +111,56 @@ namespace sal
       uint64_t recycled_queue_depth    = 0;
       uint64_t recycled_queue_capacity = 0;
 
+      // Deferred release backlog
+      uint64_t pending_releases       = 0;  // Objects waiting in session release queues
+      uint64_t release_backlog_age_ms = 0;  // Time since release workers last saw no backlog
+
+      // Online leak reclamation (deferred_cleanup restarts)
+      std::string leak_reclaim_phase;            // "mark", "sweep", "done", empty if no pass ran
+      uint64_t    leak_reclaim_marked      = 0;  // Objects reached from the pinned roots
+      uint64_t    leak_reclaim_freed       = 0;  // Leaked control blocks freed so far
+      uint64_t    leak_reclaim_freed_bytes = 0;  // Segment bytes returned to the compactor
+
+      // Background durability (sync_type::background_full)
+      bool     durability_active            = false;  // a durable snapshot holds back recycling
+      uint64_t durability_generation        = 0;      // newest snapshot known to be durable
+      uint64_t durability_syncs             = 0;      // snapshots written by this process
+      uint64_t durability_lag_ms            = 0;      // age of the oldest commit not yet durable
+      uint64_t last_durability_sync_us      = 0;      // duration of the last snapshot
+      uint32_t durability_deferred_segments = 0;      // recycled segments waiting on a snapshot
+
+      // Group commit (sync_mode >= msync_sync)
+      uint64_t group_commit_requests = 0;  // syncs that went through group commit
+      uint64_t group_commit_flushes  = 0;  // flushes issued by group commit leaders
+      uint64_t group_flush_total_us  = 0;  // time spent flushing
+      uint64_t group_flush_max_us    = 0;  // slowest single flush
+
+      // Huge pages (runtime_config::huge_pages)
+      bool     huge_pages_segments = false;  // pinned segments are advised MADV_HUGEPAGE
+      bool     huge_pages_control  = false;  // control block zones are advised MADV_HUGEPAGE
+      uint64_t huge_page_segments  = 0;      // pinned segments currently advised
+
+      // Cold tier (database opened with a cold directory)
+      bool     cold_tier_attached     = false;
+      uint64_t hot_segments           = 0;  // allocated segments backed by the primary file
+      uint64_t cold_segments          = 0;  // allocated segments backed by the cold tier file
+      uint64_t hot_live_bytes         = 0;  // alloc_pos - freed space over hot segments
+      uint64_t cold_live_bytes        = 0;  // alloc_pos - freed space over cold segments
+      uint64_t hot_disk_bytes         = 0;  // disk space of the primary segment file
+      uint64_t cold_disk_bytes        = 0;  // disk space of the cold tier file
+      uint64_t cold_segments_migrated = 0;  // hot segments copied into the cold tier
+      uint64_t cold_bytes_migrated    = 0;  // live bytes those copies moved
+
       // Control block stats
       uint32_t control_block_zones    = 0;  // Number of allocated control block zones
       uint64_t control_block_capacity = 0;  // Max number of control blocks that can be allocated
 
       // Detailed info per component
-      std::vector<segment_info>    segments;
-      std::vector<session_info>    sessions;
-      std::vector<pending_segment> pending_segments;
+      std::vector<segment_info>          segments;
+      std::vector<session_info>          sessions;
+      std::vector<pending_segment>       pending_segments;
+      std::vector<compactor_worker_info> compactor_workers;
+      std::vector<release_worker_info>   release_workers;
 
       // ANSI terminal color codes
       static constexpr const char* COLOR_RESET    = "\033[0m";
@@ -829,6 +902,23 @@ namespace sal
                << " MB (total since startup)\n";
          }
 
+         if (cache_sampled_reads > 0)
+         {
+            os << std::left << std::setw(label_width) << "Cache admission:" << std::right
+               << std::setw(value_width) << (cache_admission ? "frequency_sketch" : "read_bits")
+               << "\n";
+            os << std::left << std::setw(label_width) << "Pinned hit rate:" << std::right
+               << std::setw(value_width) << std::fixed << std::setprecision(2)
+               << (cache_sampled_hits * 100.0) / cache_sampled_reads << "% of "
+               << cache_sampled_reads << " sampled reads\n";
+            os << std::left << std::setw(label_width) << "Promoted objects:" << std::right
+               << std::setw(value_width) << cache_promotions << "\n";
+            if (cache_admission)
+               os << std::left << std::setw(label_width) << "Sketch rejects:" << std::right
+                  << std::setw(value_width) << cache_admission_rejects
+                  << " (victim frequency " << cache_victim_frequency << ")\n";
+         }
+
          os << "----------------------------------------------------------------\n\n";
 
          // Print segment queue state
@@ -866,6 +956,113 @@ namespace sal
          os << "--------------------------\n";
          os << "free release +/- = " << free_release_count << "\n";
 
+         if (!release_workers.empty())
+         {
+            os << "\n--- release workers ---\n";
+            os << "pending releases: " << pending_releases
+               << "  backlog age: " << format_time_with_units(release_backlog_age_ms / 1000.0)
+               << "\n";
+            const int worker_width   = 8;
+            const int released_width = 14;
+            const int busy_width     = 12;
+            const int rate_width     = 14;
+
+            os << std::left << std::setw(worker_width) << "Worker" << std::right
+               << std::setw(released_width) << "Released" << std::setw(busy_width) << "Busy"
+               << std::setw(rate_width) << "Objects/sec" << "\n";
+            os << std::string(worker_width + released_width + busy_width + rate_width, '-')
+               << "\n";
+            for (const auto& w : release_workers)
+            {
+               os << std::left << std::setw(worker_width) << w.worker << std::right
+                  << std::setw(released_width) << w.released << std::setw(busy_width)
+                  << format_time_with_units(w.busy_ns / 1e9) << std::setw(rate_width)
+                  << std::fixed << std::setprecision(0) << w.objects_per_sec() << "\n";
+            }
+         }
+
+         if (!leak_reclaim_phase.empty())
+         {
+            os << "\n--- leak reclamation ---\n";
+            os << "phase: " << leak_reclaim_phase << "  marked: " << leak_reclaim_marked
+               << "  freed: " << leak_reclaim_freed << " ("
+               << format_bytes(leak_reclaim_freed_bytes) << ")\n";
+         }
+
+         if (durability_active || durability_syncs > 0)
+         {
+            os << "\n--- background durability ---\n";
+            os << "generation: " << durability_generation << "  syncs: " << durability_syncs
+               << "  lag: " << durability_lag_ms << " ms  last sync: "
+               << last_durability_sync_us / 1000.0 << " ms  deferred segments: "
+               << durability_deferred_segments << "\n";
+         }
+
+         if (group_commit_flushes > 0)
+         {
+            os << "\n--- group commit ---\n";
+            os << "requests: " << group_commit_requests << "  flushes: " << group_commit_flushes
+               << "  per flush: " << double(group_commit_requests) / group_commit_flushes
+               << "  avg flush: " << group_flush_total_us / 1000.0 / group_commit_flushes
+               << " ms  max flush: " << group_flush_max_us / 1000.0 << " ms\n";
+         }
+
+         if (huge_pages_segments || huge_pages_control)
+         {
+            os << "\n--- huge pages ---\n";
+            os << "pinned segments: " << (huge_pages_segments ? "on" : "off") << " ("
+               << huge_page_segments << " advised)  control blocks: "
+               << (huge_pages_control ? "on" : "off") << "\n";
+         }
+
+         if (cold_tier_attached)
+         {
+            os << "\n--- tiers ---\n";
+            os << "hot:  " << hot_segments << " segments  live: " << format_bytes(hot_live_bytes)
+               << "  disk: " << format_bytes(hot_disk_bytes) << "\n";
+            os << "cold: " << cold_segments << " segments  live: " << format_bytes(cold_live_bytes)
+               << "  disk: " << format_bytes(cold_disk_bytes) << "\n";
+            os << "migrated to cold: " << cold_segments_migrated << " segments ("
+               << format_bytes(cold_bytes_migrated) << ")\n";
+         }
+
+         if (!compactor_workers.empty())
+         {
+            os << "\n--- compactor workers ---\n";
+            const int worker_width = 8;
+            const int segs_width   = 12;
+            const int bytes_width  = 12;
+            const int busy_width   = 12;
+            const int rate_width   = 12;
+
+            os << std::left << std::setw(worker_width) << "Worker" << std::right
+               << std::setw(segs_width) << "Segments" << std::setw(bytes_width) << "Relocated"
+               << std::setw(busy_width) << "Busy" << std::setw(rate_width) << "MB/sec" << "\n";
+            os << std::string(worker_width + segs_width + bytes_width + busy_width + rate_width,
+                              '-')
+               << "\n";
+
+            compactor_worker_info total;
+            for (const auto& w : compactor_workers)
+            {
+               os << std::left << std::setw(worker_width) << w.worker << std::right
+                  << std::setw(segs_width) << w.segments_compacted << std::setw(bytes_width)
+                  << format_bytes(w.bytes_relocated) << std::setw(busy_width)
+                  << format_time_with_units(w.busy_ns / 1e9) << std::setw(rate_width)
+                  << std::fixed << std::setprecision(1) << w.throughput_mb_sec() << "\n";
+               total.segments_compacted += w.segments_compacted;
+               total.bytes_relocated += w.bytes_relocated;
+               total.busy_ns += w.busy_ns;
+            }
+            os << std::string(worker_width + segs_width + bytes_width + busy_width + rate_width,
+                              '-')
+               << "\n";
+            os << std::left << std::setw(worker_width) << "TOTAL" << std::right
+               << std::setw(segs_width) << total.segments_compacted << std::setw(bytes_width)
+               << format_bytes(total.bytes_relocated) << std::setw(busy_width)
+               << format_time_with_units(total.busy_ns / 1e9) << "\n";
+         }
+
          // Print session information in a table format if there are any sessions with data
          if (!sessions.empty())
          {
@@ -280,8 +280,10 @@ namespace sal
 
       control_block& control() const noexcept { return _control; }
 
-     protected:
+      /// samples this read for the MFU read cache, see allocator_session::record_read()
       void maybe_update_read_stats(uint32_t size) const noexcept;
+
+     protected:
       friend class read_lock;
       template <typename T>
       friend class modify_guard;
@@ -1,9 +1,16 @@
 #include <sys/mman.h>
 #include <algorithm>
 #include <array>
+#include <bit>
 #include <cassert>
 #include <cstring>
+#include <deque>
+#include <exception>
 #include <filesystem>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <thread>
 #include <unordered_set>
 #include <vector>
 #include <sal/alloc_header.hpp>
@@ -15,6 +22,11 @@
 
 namespace sal
 {
+   /**
+    * One bit per address, set the first time the reachability walk expands an
+    * object.  Shared by all walk threads; exactly one caller sees true for each
+    * address.
+    */
    class recovery_visit_set
    {
      public:
@@ -27,70 +39,289 @@ namespace sal
          if (word >= _bits.size())
             return false;
 
-         uint64_t mask  = uint64_t(1) << (index & 63);
-         bool     first = (_bits[word] & mask) == 0;
-         _bits[word] |= mask;
-         return first;
+         uint64_t mask = uint64_t(1) << (index & 63);
+         return (_bits[word].fetch_or(mask, std::memory_order_relaxed) & mask) == 0;
       }
 
      private:
-      std::vector<uint64_t> _bits;
+      std::vector<std::atomic<uint64_t>> _bits;
    };
 
+   /**
+    * Newest copy of each address found by the recovery segment scan.
+    *
+    * Segments are scanned concurrently, so each slot packs the candidate's
+    * sequence and location into one word and should_store() installs it with a
+    * CAS only if it beats the current holder: the newer allocation sequence
+    * wins, then the newer segment (by provider sequence), then the later offset
+    * within the same segment.  This is the order the single-threaded
+    * newest-to-oldest scan resolved duplicates in, and it does not depend on
+    * which thread scans which segment first.
+    */
    class recovery_location_index
    {
      public:
-      explicit recovery_location_index(uint64_t address_count)
-          : _seen((address_count + 63) / 64), _sequence(address_count), _location(address_count)
+      /// segment_rank[seg] is larger for segments written more recently
+      recovery_location_index(uint64_t address_count, std::vector<uint32_t> segment_rank)
+          : _slots(address_count), _segment_rank(std::move(segment_rank))
       {
       }
 
       bool should_store(ptr_address addr, uint16_t sequence, location new_loc) noexcept
       {
          uint64_t index = *addr;
-         uint64_t word  = index >> 6;
-         if (word >= _seen.size())
+         if (index >= _slots.size())
             return false;
 
-         uint64_t mask = uint64_t(1) << (index & 63);
-         if ((_seen[word] & mask) == 0)
+         const uint64_t candidate = pack(sequence, new_loc);
+         auto&          slot      = _slots[index];
+         uint64_t       current   = slot.load(std::memory_order_relaxed);
+         do
          {
-            _seen[word] |= mask;
-            _sequence[index] = sequence;
-            _location[index] = new_loc;
-            return true;
-         }
+            if (current != 0 && !newer(candidate, current))
+               return false;
+         } while (!slot.compare_exchange_weak(current, candidate, std::memory_order_relaxed));
+         return true;
+      }
+
+      /// The winning location of the address at index, if the scan found one.
+      /// Only valid once every scanning thread has finished.
+      std::optional<location> find(uint64_t index) const noexcept
+      {
+         uint64_t slot = _slots[index].load(std::memory_order_relaxed);
+         if (slot == 0)
+            return std::nullopt;
+         return location::from_absolute_address(uint64_t(segment_of(slot)) * segment_size +
+                                                offset_of(slot) * 64);
+      }
+
+      uint64_t size() const noexcept { return _slots.size(); }
+
+     private:
+      static constexpr uint64_t seen_bit       = uint64_t(1) << 63;
+      static constexpr int      sequence_shift = 40;
+      static constexpr int      segment_shift  = 19;
+      static constexpr uint64_t offset_mask    = (uint64_t(1) << segment_shift) - 1;
+      static constexpr uint64_t segment_mask =
+          (uint64_t(1) << (sequence_shift - segment_shift)) - 1;
+      static_assert(segment_size / 64 <= offset_mask + 1);
+      static_assert(max_segment_count <= segment_mask + 1);
+
+      static uint64_t pack(uint16_t sequence, location loc) noexcept
+      {
+         return seen_bit | (uint64_t(sequence) << sequence_shift) |
+                (uint64_t(*loc.segment()) << segment_shift) | (loc.segment_offset() / 64);
+      }
+      static uint16_t sequence_of(uint64_t slot) noexcept { return uint16_t(slot >> sequence_shift); }
+      static uint32_t segment_of(uint64_t slot) noexcept
+      {
+         return uint32_t((slot >> segment_shift) & segment_mask);
+      }
+      static uint64_t offset_of(uint64_t slot) noexcept { return slot & offset_mask; }
+
+      bool newer(uint64_t candidate, uint64_t current) const noexcept
+      {
+         uint16_t candidate_seq = sequence_of(candidate);
+         uint16_t current_seq   = sequence_of(current);
+         if (candidate_seq != current_seq)
+            return static_cast<int16_t>(candidate_seq - current_seq) > 0;
+
+         uint32_t candidate_seg = segment_of(candidate);
+         uint32_t current_seg   = segment_of(current);
+         if (candidate_seg != current_seg)
+            return _segment_rank[candidate_seg] > _segment_rank[current_seg];
+
+         return offset_of(candidate) > offset_of(current);
+      }
+
+      std::vector<std::atomic<uint64_t>> _slots;
+      std::vector<uint32_t>              _segment_rank;
+   };
+
+   /**
+    * Per-thread work deques for the parallel reachability walk.  A worker pushes
+    * and pops at the back of its own deque, so it walks depth first and keeps
+    * its working set small; an idle worker steals the older half of another
+    * deque from the front, which is where the large unexplored subtrees are.
+    * `_pending` counts addresses pushed but not yet expanded, so the walk is
+    * done when it reaches zero.
+    */
+   class recovery_work_queues
+   {
+     public:
+      explicit recovery_work_queues(uint32_t workers) : _queues(workers) {}
+
+      void push(uint32_t worker, ptr_address addr)
+      {
+         _pending.fetch_add(1, std::memory_order_relaxed);
+         auto&                       q = _queues[worker];
+         std::lock_guard<std::mutex> lock(q.mutex);
+         q.items.push_back(addr);
+      }
 
-         uint16_t current_sequence = _sequence[index];
-         if (sequence_newer(sequence, current_sequence))
+      /// Next address for worker, stealing when its own deque is empty.
+      /// Returns false once all work is done or the walk was aborted.
+      bool pop(uint32_t worker, ptr_address& addr)
+      {
+         while (!_aborted.load(std::memory_order_relaxed))
          {
-            _sequence[index] = sequence;
-            _location[index] = new_loc;
-            return true;
+            if (pop_local(worker, addr) || (steal(worker) && pop_local(worker, addr)))
+               return true;
+            if (_pending.load(std::memory_order_acquire) == 0)
+               return false;
+            std::this_thread::yield();
          }
+         return false;
+      }
+
+      /// The address last popped has been expanded and its children pushed.
+      void done() noexcept { _pending.fetch_sub(1, std::memory_order_release); }
+
+      /// Stop every worker, used when one of them fails.
+      void abort() noexcept { _aborted.store(true, std::memory_order_relaxed); }
+
+     private:
+      struct alignas(ucc::hardware_cacheline_size) worker_queue
+      {
+         std::mutex              mutex;
+         std::deque<ptr_address> items;
+      };
 
-         if (sequence != current_sequence)
+      bool pop_local(uint32_t worker, ptr_address& addr)
+      {
+         auto&                       q = _queues[worker];
+         std::lock_guard<std::mutex> lock(q.mutex);
+         if (q.items.empty())
             return false;
+         addr = q.items.back();
+         q.items.pop_back();
+         return true;
+      }
 
-         const auto current_loc = _location[index];
-         if (new_loc.segment() != current_loc.segment() ||
-             new_loc.segment_offset() <= current_loc.segment_offset())
+      bool steal(uint32_t thief)
+      {
+         std::vector<ptr_address> loot;
+         for (uint32_t i = 1; i < _queues.size() && loot.empty(); ++i)
+         {
+            auto&                       victim = _queues[(thief + i) % _queues.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            auto                        half = (victim.items.size() + 1) / 2;
+            loot.assign(victim.items.begin(), victim.items.begin() + half);
+            victim.items.erase(victim.items.begin(), victim.items.begin() + half);
+         }
+         if (loot.empty())
             return false;
 
-         _location[index] = new_loc;
+         auto&                       mine = _queues[thief];
+         std::lock_guard<std::mutex> lock(mine.mutex);
+         mine.items.insert(mine.items.end(), loot.begin(), loot.end());
          return true;
       }
 
-     private:
-      static bool sequence_newer(uint16_t candidate, uint16_t current) noexcept
+      std::vector<worker_queue> _queues;
+      std::atomic<uint64_t>     _pending{0};
+      std::atomic<bool>         _aborted{false};
+   };
+
+   /**
+    * Run fn(worker) for worker in [0, threads), the calling thread acting as
+    * worker 0, and rethrow the first exception any worker raised.
+    */
+   template <typename Fn>
+   static void run_recovery_workers(uint32_t threads, Fn&& fn)
+   {
+      std::exception_ptr error;
+      std::mutex         error_mutex;
+      auto               guarded = [&](uint32_t worker)
+      {
+         try
+         {
+            fn(worker);
+         }
+         catch (...)
+         {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (!error)
+               error = std::current_exception();
+         }
+      };
+
+      std::vector<std::thread> workers;
+      workers.reserve(threads - 1);
+      for (uint32_t worker = 1; worker < threads; ++worker)
+         workers.emplace_back(guarded, worker);
+      guarded(0);
+      for (auto& t : workers)
+         t.join();
+
+      if (error)
+         std::rethrow_exception(error);
+   }
+
+   /**
+    * State of one online leak reclamation pass, see
+    * allocator::begin_leak_reclamation().  Only the reclaim thread touches it
+    * after construction, except for the counters reported by dump().
+    *
+    * `candidates` starts as the set of control blocks allocated when the pass
+    * began.  Marking clears the bit of every object reachable from the pinned
+    * addresses, so once the mark stack drains the bits still set are exactly
+    * the leaked objects.  Nothing outside the pass can reach a leaked object,
+    * so the set does not change while it is swept, and control blocks
+    * allocated after the pass began are never in it.
+    */
+   class leak_reclaimer
+   {
+     public:
+      enum class phase : uint8_t
+      {
+         mark,
+         sweep,
+         done
+      };
+
+      explicit leak_reclaimer(uint64_t words) : candidates(words) {}
+
+      bool is_candidate(ptr_address addr) const noexcept
+      {
+         uint64_t index = *addr;
+         return (index >> 6) < candidates.size() &&
+                (candidates[index >> 6] & (uint64_t(1) << (index & 63)));
+      }
+
+      /// clear the candidate bit, returning true if it was set
+      bool take_candidate(ptr_address addr) noexcept
+      {
+         if (!is_candidate(addr))
+            return false;
+         candidates[*addr >> 6] &= ~(uint64_t(1) << (*addr & 63));
+         return true;
+      }
+
+      static const char* phase_name(phase p) noexcept
       {
-         return candidate != current &&
-                static_cast<int16_t>(candidate - current) > 0;
+         switch (p)
+         {
+            case phase::mark:
+               return "mark";
+            case phase::sweep:
+               return "sweep";
+            case phase::done:
+               return "done";
+         }
+         return "";
       }
 
-      std::vector<uint64_t> _seen;
-      std::vector<uint16_t> _sequence;
-      std::vector<location> _location;
+      std::vector<uint64_t>         candidates;
+      std::vector<ptr_address>      mark_stack;
+      std::vector<ptr_address>      pinned;
+      uint64_t                      sweep_word = 0;
+      std::function<void(uint64_t)> on_complete;
+
+      std::atomic<phase>    state{phase::mark};
+      std::atomic<uint64_t> marked{0};
+      std::atomic<uint64_t> freed{0};
+      std::atomic<uint64_t> freed_bytes{0};
    };
 
    static constexpr std::size_t passive_relocation_release_capacity = 1024;
@@ -117,7 +348,12 @@ namespace sal
          if (index >= _versions.size())
             return;
 
-         _versions[index] = std::max(_versions[index], info.root_version);
+         auto& slot    = _versions[index];
+         auto  current = slot.load(std::memory_order_relaxed);
+         while (current < info.root_version &&
+                !slot.compare_exchange_weak(current, info.root_version, std::memory_order_relaxed))
+         {
+         }
       }
 
       uint64_t version_for(ptr_address addr) const noexcept
@@ -128,13 +364,59 @@ namespace sal
          uint64_t index = *addr;
          if (index >= _versions.size())
             return 0;
-         return _versions[index];
+         return _versions[index].load(std::memory_order_relaxed);
       }
 
      private:
-      std::vector<uint64_t> _versions;
+      std::vector<std::atomic<uint64_t>> _versions;
    };
 
+   /**
+    * Offer every object in seg[0, end_pos) to the location index, when
+    * locations is non-null.  When versions is non-null the root info embedded
+    * in sync headers is recorded too.  Touches no shared state other than the
+    * two indexes, so segments can be scanned concurrently.
+    */
+   static void scan_segment_objects(const mapped_memory::segment* seg,
+                                    uint32_t                      seg_idx,
+                                    uint32_t                      end_pos,
+                                    recovery_location_index*      locations,
+                                    recovery_version_index*       versions)
+   {
+      auto* obj_ptr = reinterpret_cast<const alloc_header*>(seg->data);
+      auto* seg_end = reinterpret_cast<const alloc_header*>(
+          seg->data +
+          std::min<uint32_t>(segment_size - mapped_memory::segment_footer_size, end_pos));
+
+      while (obj_ptr < seg_end && obj_ptr->address() != null_ptr_address)
+      {
+         if (obj_ptr->size() == 0)
+            break;
+
+         if (obj_ptr->type() == header_type::sync_head)
+         {
+            if (versions)
+            {
+               auto* sync = reinterpret_cast<const sync_header*>(obj_ptr);
+               if (auto info = sync->get_root_info())
+                  versions->record(*info);
+            }
+            obj_ptr = obj_ptr->next();
+            continue;
+         }
+
+         if (locations)
+         {
+            uint64_t abs_addr = uint64_t(seg_idx) * segment_size +
+                                (reinterpret_cast<const char*>(obj_ptr) - seg->data);
+            locations->should_store(obj_ptr->address(), obj_ptr->sequence(),
+                                    location::from_absolute_address(abs_addr));
+         }
+
+         obj_ptr = obj_ptr->next();
+      }
+   }
+
    static constexpr uint64_t recovered_custom_cb_latest_version =
       control_block::max_cacheline_offset - 1;
 
@@ -142,6 +424,71 @@ namespace sal
    /// When false, all instrumentation is compiled out by the optimizer.
    static constexpr bool debug_compactor = false;
 
+   /// Number of final_release calls made under one read lock by a release worker.
+   /// Bounds how long a worker can delay segment recycling while amortizing the
+   /// cost of publishing the session lock.
+   static constexpr uint32_t release_lock_batch = 64;
+
+   static int64_t steady_now_ms() noexcept
+   {
+      return std::chrono::duration_cast<std::chrono::milliseconds>(
+                 std::chrono::steady_clock::now().time_since_epoch())
+          .count();
+   }
+
+   /**
+    * One slot of the "durable" file written by durability_sync().  Two slots
+    * alternate so a write torn by power loss leaves the previous snapshot
+    * readable; a slot is valid when both its magic and checksum match.
+    *
+    * Only positions and root ids are recorded, never timestamps: sync header
+    * timestamps come from the steady clock and cannot be compared across a
+    * reboot, while the provider sequence and append positions can.
+    */
+   struct allocator::durable_snapshot
+   {
+      static constexpr uint64_t valid_magic       = 0x6c62617275646c61ull;
+      static constexpr uint32_t max_open_segments = 1024;
+
+      struct root_entry
+      {
+         uint64_t tree;
+         uint64_t version;
+      };
+
+      /// a segment a session could still append to, and its last sync header
+      struct open_segment
+      {
+         uint32_t seg;
+         uint32_t sync_pos;
+      };
+
+      uint64_t     magic;
+      uint64_t     checksum;
+      uint64_t     generation;
+      uint32_t     next_provider_seq;
+      uint32_t     open_count;
+      root_entry   roots[std::tuple_size_v<root_object_array>];
+      open_segment open[max_open_segments];
+
+      static size_t slot_size() noexcept
+      {
+         return system_config::round_to_page(sizeof(durable_snapshot));
+      }
+
+      uint64_t compute_checksum() const noexcept
+      {
+         auto begin = reinterpret_cast<const char*>(&generation);
+         return XXH3_64bits(begin, reinterpret_cast<const char*>(this + 1) - begin);
+      }
+
+      bool valid() const noexcept
+      {
+         return magic == valid_magic && open_count <= max_open_segments &&
+                checksum == compute_checksum();
+      }
+   };
+
    /**
        * These methods assign a unique number to each instance of allocator so
        * that the thread-local allocator_session can be associated with a specific
@@ -253,17 +600,52 @@ namespace sal
       return requested;
    }
 
-   allocator::allocator(std::filesystem::path dir, runtime_config cfg, bool start_threads_now)
-       : _ptr_alloc(dir / "ptrs"),
+   allocator::allocator(std::filesystem::path dir,
+                        runtime_config        cfg,
+                        bool                  start_threads_now,
+                        std::filesystem::path cold_dir)
+       : _ptr_alloc(dir / "ptrs", cfg.huge_pages),
          _block_alloc(dir / "segs", segment_size,
                       static_cast<uint32_t>(
                           cap_to_disk_space(dir,
                               std::min<int64_t>(cfg.max_database_size, sal::max_database_size)) /
                           segment_size)),
          _seg_alloc_state_file(dir / "header", access_mode::read_write, true),
-         _root_object_file(dir / "roots", access_mode::read_write, true)
+         _root_object_file(dir / "roots", access_mode::read_write, true),
+         _durable_file(dir / "durable", access_mode::read_write)
    {
       _type_ops.fill(&default_object_type_ops<alloc_header>());
+      _read_samples = std::make_unique<read_sample_slot[]>(max_session_count);
+
+      // Attach the cold tier before anything reads a segment: blocks that
+      // moved to it read as holes through the primary file.
+      {
+         // exists() follows the link, so test the link itself: a database
+         // that had a cold tier must not open without it, or every block
+         // moved there would read back as zeros.
+         auto       cold_link = dir / "cold";
+         const bool had_tier  = std::filesystem::is_symlink(cold_link);
+         if (had_tier && not std::filesystem::exists(cold_link / "segs"))
+            throw std::runtime_error("database " + dir.native() + " has a cold tier at " +
+                                     std::filesystem::read_symlink(cold_link).native() +
+                                     " that is missing");
+         if (not cold_dir.empty())
+         {
+            std::filesystem::create_directories(cold_dir);
+            auto target = std::filesystem::canonical(cold_dir);
+            if (had_tier)
+            {
+               if (std::filesystem::canonical(cold_link) != target)
+                  throw std::runtime_error("database " + dir.native() +
+                                           " already has a cold tier at " +
+                                           std::filesystem::canonical(cold_link).native());
+            }
+            else
+               std::filesystem::create_directory_symlink(target, cold_link);
+         }
+         if (std::filesystem::is_symlink(cold_link))
+            _block_alloc.attach_tier_file(cold_link / "segs");
+      }
 
       _allocator_index = alloc_allocator_index();
       if (_seg_alloc_state_file.size() == 0)
@@ -343,6 +725,8 @@ namespace sal
       }
 
       _mapped_state->_config = cfg;
+      _huge_pages.store(cfg.huge_pages, std::memory_order_relaxed);
+      load_durable_snapshot();
 
       // Reset all session read locks — no sessions are active at construction
       // time.  Stale locks from a previous crash would otherwise block the
@@ -350,10 +734,15 @@ namespace sal
       // causing a circular_buffer overflow in the compactor.
       _mapped_state->_read_lock_queue.reset_all_session_locks();
 
+      // Likewise for compaction claims of a compactor that crashed mid-segment.
+      for (uint32_t i = 0; i < _block_alloc.num_blocks(); ++i)
+         _mapped_state->_segment_data.release_compaction_claim(segment_number(i));
+
       mlock_pinned_segments();
 
       provider_populate_pinned_segments();
       provider_populate_unpinned_segments();
+      provider_populate_cold_segments();
       if (start_threads_now)
          start_background_threads();
    }
@@ -367,11 +756,13 @@ namespace sal
       {
          segment_number seg_num(seg);
          auto*          segment_ptr = get_segment(seg_num);
+         advise_segment_huge_pages(seg_num, true);
          if (mlock(segment_ptr, segment_size) != 0)
          {
             SAL_WARN("mlock failed for segment: ", seg, " error: ", strerror(errno));
 
             // Clear both the bitmap and the meta bit using the helper
+            advise_segment_huge_pages(seg_num, false);
             update_segment_pinned_state(seg_num, false);
             return;
          }
@@ -397,6 +788,8 @@ namespace sal
          provider_state.free_segments.set(*(*seg));
       while (auto seg = provider_state.ready_unpinned_segments.try_pop())
          provider_state.free_segments.set(*(*seg));
+      while (auto seg = provider_state.ready_cold_segments.try_pop())
+         provider_state.free_segments.set(*(*seg));
 
       uint32_t num_segs  = _block_alloc.num_blocks();
       uint32_t new_count = num_segs;
@@ -438,6 +831,7 @@ namespace sal
       // Re-populate provider queues from remaining free segments and restart threads
       provider_populate_pinned_segments();
       provider_populate_unpinned_segments();
+      provider_populate_cold_segments();
       start_background_threads();
    }
 
@@ -546,34 +940,102 @@ namespace sal
                objects_copied, bytes_copied);
    }
 
-   void allocator::recursive_retain_all(ptr_address addr, void* visited_ptr)
+   uint32_t allocator::recovery_thread_count() const noexcept
    {
-      if (addr == null_ptr_address)
-         return;
+      uint32_t threads = _mapped_state->_config.recovery_threads;
+      if (threads == 0)
+         threads = std::thread::hardware_concurrency();
+      return std::clamp<uint32_t>(threads, 1, max_threads);
+   }
 
-      auto* cb = _ptr_alloc.try_get(addr);
-      if (!cb || cb->ref() == 0)
-         return;
+   void allocator::retain_all_reachable(void* visited_ptr)
+   {
+      auto&                visited = *static_cast<recovery_visit_set*>(visited_ptr);
+      const uint32_t       threads = recovery_thread_count();
+      recovery_work_queues queues(threads);
 
-      auto prev = cb->retain();
-      auto& visited = *static_cast<recovery_visit_set*>(visited_ptr);
-      if (!visited.first_visit(addr))
-         return;
+      // Every reference is retained once, including the one held by the root slot
+      uint32_t next = 0;
+      for (uint32_t i = 0; i < _root_objects->size(); ++i)
+      {
+         auto tid = _root_objects->at(i).load(std::memory_order_relaxed);
+         if (tid.root != null_ptr_address)
+            queues.push(next++ % threads, tid.root);
+         if (tid.ver != null_ptr_address)
+            queues.push(next++ % threads, tid.ver);
+      }
 
-      // Custom control blocks: retained but not dereferenced (no segment data)
-      if (allocator_session::is_custom_cb(prev))
-         return;
+      auto expand = [&](uint32_t worker, ptr_address addr)
+      {
+         auto* cb = _ptr_alloc.try_get(addr);
+         if (!cb || cb->ref() == 0)
+            return;
 
-      auto  loc    = cb->loc();
-      auto  seg    = loc.segment();
-      auto* segptr = get_segment(seg);
-      auto* obj    = reinterpret_cast<const alloc_header*>(segptr->data + loc.segment_offset());
+         auto prev = cb->retain();
+         if (!visited.first_visit(addr))
+            return;
 
-      if (obj->address() != addr)
-         return;
+         // Custom control blocks: retained but not dereferenced (no segment data)
+         if (allocator_session::is_custom_cb(prev))
+            return;
 
-      type_ops(obj).visit_children(
-          obj, [this, visited_ptr](ptr_address child) { recursive_retain_all(child, visited_ptr); });
+         auto  loc    = cb->loc();
+         auto* segptr = get_segment(loc.segment());
+         auto* obj    = reinterpret_cast<const alloc_header*>(segptr->data + loc.segment_offset());
+
+         if (obj->address() != addr)
+            return;
+
+         type_ops(obj).visit_children(obj,
+                                      [&](ptr_address child)
+                                      {
+                                         if (child != null_ptr_address)
+                                            queues.push(worker, child);
+                                      });
+      };
+
+      run_recovery_workers(threads,
+                           [&](uint32_t worker)
+                           {
+                              try
+                              {
+                                 ptr_address addr;
+                                 while (queues.pop(worker, addr))
+                                 {
+                                    expand(worker, addr);
+                                    queues.done();
+                                 }
+                              }
+                              catch (...)
+                              {
+                                 queues.abort();
+                                 throw;
+                              }
+                           });
+   }
+
+   void allocator::install_recovered_locations(const void* location_index_ptr)
+   {
+      const auto& index = *static_cast<const recovery_location_index*>(location_index_ptr);
+
+      // Threads claim disjoint address ranges, so no two threads ever
+      // get_or_alloc the same control block.
+      constexpr uint64_t    chunk = 64 * 1024;
+      std::atomic<uint64_t> next{0};
+      run_recovery_workers(
+          recovery_thread_count(),
+          [&](uint32_t)
+          {
+             for (uint64_t begin; (begin = next.fetch_add(chunk)) < index.size();)
+             {
+                uint64_t end = std::min(begin + chunk, index.size());
+                for (uint64_t i = begin; i < end; ++i)
+                   if (auto loc = index.find(i))
+                      _ptr_alloc.get_or_alloc(ptr_address(uint32_t(i)))
+                          .store(control_block_data().set_loc(*loc).set_ref(1),
+                                 std::memory_order_relaxed);
+             }
+          });
    }
 
    void allocator::recursive_sum_size(ptr_address addr, uint64_t& total, void* visited_ptr)
@@ -790,6 +1252,7 @@ namespace sal
       SAL_WARN("Recovering... rebuilding control blocks from segments!");
 
       stop_background_threads();
+      _leak_reclaimer.reset();  // superseded; rebuilt counts drop its pins
 
       // Phase 1: Clear all control blocks
       _ptr_alloc.clear_all();
@@ -816,14 +1279,17 @@ namespace sal
 
       _mapped_state->_segment_provider.ready_pinned_segments.clear();
       _mapped_state->_segment_provider.ready_unpinned_segments.clear();
+      _mapped_state->_segment_provider.ready_cold_segments.clear();
 
-      // Phase 3: Scan each segment, rebuilding object ID -> location mapping
-      uint32_t                max_provider_seq = 0;
-      recovery_location_index location_index(_ptr_alloc.current_max_address_count());
-      recovery_version_index  version_index(_ptr_alloc.current_max_address_count());
-      for (auto seg_idx : age_index)
+      // Phase 3: Scan segments in parallel, resolving each object ID to its newest copy
+      uint32_t              max_provider_seq = 0;
+      std::vector<uint32_t> scan_list;
+      std::vector<uint32_t> segment_rank(num_segs);
+      for (uint32_t pos = 0; pos < num_segs; ++pos)
       {
-         auto* seg = get_segment(segment_number(seg_idx));
+         auto  seg_idx = age_index[pos];
+         auto* seg     = get_segment(segment_number(seg_idx));
+         segment_rank[seg_idx] = num_segs - pos;
 
          if (seg->_provider_sequence == 0 && seg->get_alloc_pos() == 0)
          {
@@ -833,58 +1299,31 @@ namespace sal
 
          if (seg->_provider_sequence > max_provider_seq)
             max_provider_seq = seg->_provider_sequence;
-
-         auto* obj_ptr = reinterpret_cast<const alloc_header*>(seg->data);
-         auto* seg_end = reinterpret_cast<const alloc_header*>(
-             seg->data +
-             std::min<uint32_t>(segment_size - mapped_memory::segment_footer_size,
-                                seg->get_alloc_pos()));
-
-         while (obj_ptr < seg_end && obj_ptr->address() != null_ptr_address)
-         {
-            if (obj_ptr->size() == 0)
-               break;
-
-            if (obj_ptr->type() == header_type::sync_head)
-            {
-               auto* sync = reinterpret_cast<const sync_header*>(obj_ptr);
-               if (auto info = sync->get_root_info())
-                  version_index.record(*info);
-               obj_ptr = obj_ptr->next();
-               continue;
-            }
-
-            auto  addr = obj_ptr->address();
-            auto& cb   = _ptr_alloc.get_or_alloc(addr);
-
-            uint64_t abs_addr =
-                uint64_t(seg_idx) * segment_size +
-                (reinterpret_cast<const char*>(obj_ptr) - seg->data);
-            auto new_loc = location::from_absolute_address(abs_addr);
-
-            if (location_index.should_store(addr, obj_ptr->sequence(), new_loc))
-            {
-               cb.store(control_block_data().set_loc(new_loc).set_ref(1),
-                        std::memory_order_relaxed);
-            }
-
-            obj_ptr = obj_ptr->next();
-         }
+         scan_list.push_back(seg_idx);
       }
 
+      recovery_location_index location_index(_ptr_alloc.current_max_address_count(),
+                                             std::move(segment_rank));
+      recovery_version_index  version_index(_ptr_alloc.current_max_address_count());
+      std::atomic<uint32_t>   next_scan{0};
+      run_recovery_workers(recovery_thread_count(),
+                           [&](uint32_t)
+                           {
+                              for (uint32_t i; (i = next_scan.fetch_add(1)) < scan_list.size();)
+                              {
+                                 auto* seg = get_segment(segment_number(scan_list[i]));
+                                 scan_segment_objects(seg, scan_list[i], seg->get_alloc_pos(),
+                                                      &location_index, &version_index);
+                              }
+                           });
+      install_recovered_locations(&location_index);
+
       // Phase 3.5: Reconstruct custom CBs (version addresses) from root slots
       reconstruct_custom_cbs_from_roots(&version_index);
 
-      // Phase 4: Walk all root objects, recursively retain reachable nodes
+      // Phase 4: Walk all root objects, retaining reachable nodes
       recovery_visit_set visited(_ptr_alloc.current_max_address_count());
-      for (uint32_t i = 0; i < _root_objects->size(); ++i)
-      {
-         auto tid = _root_objects->at(i).load(std::memory_order_relaxed);
-         if (tid.root != null_ptr_address)
-            recursive_retain_all(tid.root, &visited);
-         if (tid.ver != null_ptr_address)
-            recursive_retain_all(tid.ver, &visited);
-      }
+      retain_all_reachable(&visited);
 
       // Phase 5: Free leaked objects
       _ptr_alloc.release_unreachable();
@@ -897,6 +1336,7 @@ namespace sal
 
       provider_populate_pinned_segments();
       provider_populate_unpinned_segments();
+      provider_populate_cold_segments();
       start_background_threads();
 
       SAL_WARN("Recovery complete.");
@@ -907,51 +1347,33 @@ namespace sal
       SAL_WARN("Resetting reference counts...");
 
       stop_background_threads();
+      _leak_reclaimer.reset();  // superseded; rebuilt counts drop its pins
 
       _ptr_alloc.reset_all_refs();
 
+      // Only the sync headers are needed: they carry the versions of custom CBs
       recovery_version_index version_index(_ptr_alloc.current_max_address_count());
       auto                   num_segs = _block_alloc.num_blocks();
-      for (uint32_t seg_idx = 0; seg_idx < num_segs; ++seg_idx)
-      {
-         auto* seg = get_segment(segment_number(seg_idx));
-         if (seg->_provider_sequence == 0 && seg->get_alloc_pos() == 0)
-            continue;
-
-         auto* obj_ptr = reinterpret_cast<const alloc_header*>(seg->data);
-         auto* seg_end = reinterpret_cast<const alloc_header*>(
-             seg->data +
-             std::min<uint32_t>(segment_size - mapped_memory::segment_footer_size,
-                                seg->get_alloc_pos()));
-
-         while (obj_ptr < seg_end && obj_ptr->address() != null_ptr_address)
-         {
-            if (obj_ptr->size() == 0)
-               break;
-
-            if (obj_ptr->type() == header_type::sync_head)
-            {
-               auto* sync = reinterpret_cast<const sync_header*>(obj_ptr);
-               if (auto info = sync->get_root_info())
-                  version_index.record(*info);
-            }
-
-            obj_ptr = obj_ptr->next();
-         }
-      }
+      std::atomic<uint32_t>  next_scan{0};
+      run_recovery_workers(
+          recovery_thread_count(),
+          [&](uint32_t)
+          {
+             for (uint32_t seg_idx; (seg_idx = next_scan.fetch_add(1)) < num_segs;)
+             {
+                auto* seg = get_segment(segment_number(seg_idx));
+                if (seg->_provider_sequence == 0 && seg->get_alloc_pos() == 0)
+                   continue;
+                scan_segment_objects(seg, seg_idx, seg->get_alloc_pos(), nullptr,
+                                     &version_index);
+             }
+          });
 
       // Reconstruct custom CBs before walking roots
       reconstruct_custom_cbs_from_roots(&version_index);
 
       recovery_visit_set visited(_ptr_alloc.current_max_address_count());
-      for (uint32_t i = 0; i < _root_objects->size(); ++i)
-      {
-         auto tid = _root_objects->at(i).load(std::memory_order_relaxed);
-         if (tid.root != null_ptr_address)
-            recursive_retain_all(tid.root, &visited);
-         if (tid.ver != null_ptr_address)
-            recursive_retain_all(tid.ver, &visited);
-      }
+      retain_all_reachable(&visited);
 
       _ptr_alloc.release_unreachable();
 
@@ -960,12 +1382,11 @@ namespace sal
 
    /**
     * Find the last valid sync header in a segment by walking the chain backward
-    * and verifying checksums. Returns the position of the last valid sync header,
-    * or 0 if none found.
+    * from pos and verifying checksums. Returns the position of the last valid
+    * sync header, or 0 if none found.
     */
-   static uint32_t find_last_valid_sync(const mapped_memory::segment* seg)
+   static uint32_t find_last_valid_sync(const mapped_memory::segment* seg, uint32_t pos)
    {
-      uint32_t pos = seg->_last_aheader_pos;
       while (pos > 0)
       {
          auto* ah = reinterpret_cast<const alloc_header*>(seg->data + pos);
@@ -1001,6 +1422,7 @@ namespace sal
       SAL_WARN("Power-loss recovery: validating segments and rebuilding state");
 
       stop_background_threads();
+      _leak_reclaimer.reset();  // superseded; rebuilt counts drop its pins
 
       // Phase 1: Clear all control blocks
       _ptr_alloc.clear_all();
@@ -1027,6 +1449,24 @@ namespace sal
 
       _mapped_state->_segment_provider.ready_pinned_segments.clear();
       _mapped_state->_segment_provider.ready_unpinned_segments.clear();
+      _mapped_state->_segment_provider.ready_cold_segments.clear();
+
+      // A durable background_full snapshot, when present, is the recovery
+      // point: segments allocated after it are dropped, segments that were
+      // still writable are cut back to their last sync header at the time,
+      // and its roots replace the roots file and the sync header root info.
+      constexpr uint32_t      no_cut = std::numeric_limits<uint32_t>::max();
+      const durable_snapshot* snap   = find_durable_snapshot();
+      std::vector<uint32_t>   durable_cut;
+      if (snap)
+      {
+         SAL_WARN("rolling back to durable snapshot {} ({} writable segments)",
+                  snap->generation, snap->open_count);
+         durable_cut.assign(num_segs, no_cut);
+         for (uint32_t i = 0; i < snap->open_count; ++i)
+            if (snap->open[i].seg < num_segs)
+               durable_cut[snap->open[i].seg] = snap->open[i].sync_pos;
+      }
 
       // Phase 3: Validate sync headers, truncate torn tails, collect root info
       // We collect (timestamp, root_index, root_address) from valid sync headers
@@ -1040,12 +1480,14 @@ namespace sal
       };
       std::vector<root_recovery_entry> recovered_roots;
 
-      uint32_t                max_provider_seq = 0;
-      recovery_location_index location_index(_ptr_alloc.current_max_address_count());
-      recovery_version_index  version_index(_ptr_alloc.current_max_address_count());
-      for (auto seg_idx : age_index)
+      uint32_t              max_provider_seq = 0;
+      std::vector<uint32_t> scan_list;
+      std::vector<uint32_t> segment_rank(num_segs);
+      for (uint32_t pos = 0; pos < num_segs; ++pos)
       {
-         auto* seg = get_segment(segment_number(seg_idx));
+         auto  seg_idx = age_index[pos];
+         auto* seg     = get_segment(segment_number(seg_idx));
+         segment_rank[seg_idx] = num_segs - pos;
 
          if (seg->_provider_sequence == 0 && seg->get_alloc_pos() == 0)
          {
@@ -1053,94 +1495,116 @@ namespace sal
             continue;
          }
 
+         if (snap && seg->_provider_sequence >= snap->next_provider_seq)
+         {
+            // Written only after the snapshot. Reset the header so a later
+            // recovery against a newer snapshot does not mistake it for data.
+            SAL_WARN("segment {}: allocated after the durable snapshot, dropping", seg_idx);
+            disable_segment_write_protection(segment_number(seg_idx));
+            _block_alloc.punch_hole(block_allocator::block_number(seg_idx));
+            new (seg) mapped_memory::segment();
+            seg->set_alloc_pos(0);
+            _mapped_state->_segment_provider.free_segments.set(seg_idx);
+            if (_mapped_state->_segment_data.is_read_only(segment_number(seg_idx)))
+               _mapped_state->_segment_data.added_to_free_segments(segment_number(seg_idx));
+            continue;
+         }
+
          if (seg->_provider_sequence > max_provider_seq)
             max_provider_seq = seg->_provider_sequence;
+         scan_list.push_back(seg_idx);
+      }
 
-         // Find last valid sync boundary
-         uint32_t valid_sync_pos = find_last_valid_sync(seg);
-
-         // Determine valid data end.
-         // For segments with valid sync headers, we know data up to the sync
-         // boundary is consistent. For segments without sync headers (e.g. the
-         // active segment that was never synced), we scan up to alloc_pos and
-         // rely on individual object checksums to detect corruption.
-         uint32_t valid_end = seg->get_alloc_pos();
-
-         // Collect root info from all valid sync headers in this segment
-         if (valid_sync_pos > 0)
+      // Each segment is validated and scanned independently; threads collect
+      // their recovered roots locally and they are merged before Phase 5.
+      const uint32_t                                threads = recovery_thread_count();
+      std::vector<std::vector<root_recovery_entry>> worker_roots(threads);
+      recovery_location_index location_index(_ptr_alloc.current_max_address_count(),
+                                             std::move(segment_rank));
+      recovery_version_index  version_index(_ptr_alloc.current_max_address_count());
+      std::atomic<uint32_t>   next_scan{0};
+      run_recovery_workers(threads, [&](uint32_t worker)
+      {
+         for (uint32_t i; (i = next_scan.fetch_add(1)) < scan_list.size();)
          {
-            uint32_t scan_pos = valid_sync_pos;
-            while (scan_pos > 0)
+            auto  seg_idx = scan_list[i];
+            auto* seg     = get_segment(segment_number(seg_idx));
+
+            // Segments a session could still write to when the durable
+            // snapshot was taken are only valid up to the sync header the
+            // snapshot saw, everything after it was committed later.
+            const uint32_t cut = snap ? durable_cut[seg_idx] : no_cut;
+
+            // Find last valid sync boundary
+            uint32_t valid_sync_pos =
+                find_last_valid_sync(seg, cut != no_cut ? cut : seg->_last_aheader_pos);
+
+            // Determine valid data end.
+            // For segments with valid sync headers, we know data up to the sync
+            // boundary is consistent. For segments without sync headers (e.g. the
+            // active segment that was never synced), we scan up to alloc_pos and
+            // rely on individual object checksums to detect corruption.
+            uint32_t valid_end = seg->get_alloc_pos();
+            if (cut != no_cut)
             {
-               auto* ah = reinterpret_cast<const alloc_header*>(seg->data + scan_pos);
-               if (ah->type() != header_type::sync_head)
-                  break;
-               auto* scan_sh = reinterpret_cast<const sync_header*>(ah);
-               auto  info    = scan_sh->get_root_info();
-               if (info)
+               valid_end = 0;
+               if (valid_sync_pos > 0)
                {
-                  version_index.record(*info);
-                  SAL_WARN("  found root_info in sync header at pos {}: root[{}] = {} ver_addr={} ver={} ts={}",
-                           scan_pos, info->root_index, info->root_address,
-                           info->version_address, info->root_version, *scan_sh->timestamp());
-                  recovered_roots.push_back(
-                      {scan_sh->timestamp(), info->root_index, info->root_address,
-                       info->version_address, info->root_version});
+                  auto* sh  = reinterpret_cast<const alloc_header*>(seg->data + valid_sync_pos);
+                  valid_end = std::min<uint32_t>(valid_sync_pos + sh->size(), seg->get_alloc_pos());
                }
-               if (scan_pos == scan_sh->prev_aheader_pos())
-                  break;  // prevent infinite loop
-               scan_pos = scan_sh->prev_aheader_pos();
+               seg->_last_aheader_pos = valid_sync_pos;
             }
-         }
 
-         SAL_WARN("segment {}: alloc_pos={} valid_end={} valid_sync_pos={} first_write_pos={}",
-                  seg_idx, seg->get_alloc_pos(), valid_end, valid_sync_pos,
-                  seg->get_first_write_pos());
-
-         // Truncate: zero data beyond valid_end, update alloc_pos
-         if (valid_end < seg->get_alloc_pos())
-         {
-            SAL_WARN("segment {}: truncating from {} to {} (torn tail)",
-                     seg_idx, seg->get_alloc_pos(), valid_end);
-            memset(seg->data + valid_end, 0,
-                   seg->get_alloc_pos() - valid_end);
-            seg->set_alloc_pos(valid_end);
-         }
-
-         // Phase 4: Scan validated segment data, rebuild object ID -> location
-         auto* obj_ptr = reinterpret_cast<const alloc_header*>(seg->data);
-         auto* seg_end = reinterpret_cast<const alloc_header*>(
-             seg->data + std::min<uint32_t>(segment_size - mapped_memory::segment_footer_size,
-                                            valid_end));
-
-         while (obj_ptr < seg_end && obj_ptr->address() != null_ptr_address)
-         {
-            if (obj_ptr->size() == 0)
-               break;
-
-            if (obj_ptr->type() == header_type::sync_head)
+            // Collect root info from all valid sync headers in this segment
+            if (valid_sync_pos > 0)
             {
-               obj_ptr = obj_ptr->next();
-               continue;
+               uint32_t scan_pos = valid_sync_pos;
+               while (scan_pos > 0)
+               {
+                  auto* ah = reinterpret_cast<const alloc_header*>(seg->data + scan_pos);
+                  if (ah->type() != header_type::sync_head)
+                     break;
+                  auto* scan_sh = reinterpret_cast<const sync_header*>(ah);
+                  auto  info    = scan_sh->get_root_info();
+                  if (info)
+                  {
+                     version_index.record(*info);
+                     SAL_WARN("  found root_info in sync header at pos {}: root[{}] = {} ver_addr={} ver={} ts={}",
+                              scan_pos, info->root_index, info->root_address,
+                              info->version_address, info->root_version, *scan_sh->timestamp());
+                     worker_roots[worker].push_back(
+                         {scan_sh->timestamp(), info->root_index, info->root_address,
+                          info->version_address, info->root_version});
+                  }
+                  if (scan_pos == scan_sh->prev_aheader_pos())
+                     break;  // prevent infinite loop
+                  scan_pos = scan_sh->prev_aheader_pos();
+               }
             }
 
-            auto  addr = obj_ptr->address();
-            auto& cb   = _ptr_alloc.get_or_alloc(addr);
-
-            uint64_t abs_addr =
-                uint64_t(seg_idx) * segment_size +
-                (reinterpret_cast<const char*>(obj_ptr) - seg->data);
-            auto new_loc = location::from_absolute_address(abs_addr);
+            SAL_WARN("segment {}: alloc_pos={} valid_end={} valid_sync_pos={} first_write_pos={}",
+                     seg_idx, seg->get_alloc_pos(), valid_end, valid_sync_pos,
+                     seg->get_first_write_pos());
 
-            if (location_index.should_store(addr, obj_ptr->sequence(), new_loc))
+            // Truncate: zero data beyond valid_end, update alloc_pos
+            if (valid_end < seg->get_alloc_pos())
             {
-               cb.store(control_block_data().set_loc(new_loc).set_ref(1),
-                        std::memory_order_relaxed);
+               SAL_WARN("segment {}: truncating from {} to {} (torn tail)",
+                        seg_idx, seg->get_alloc_pos(), valid_end);
+               memset(seg->data + valid_end, 0,
+                      seg->get_alloc_pos() - valid_end);
+               seg->set_alloc_pos(valid_end);
             }
 
-            obj_ptr = obj_ptr->next();
+            // Phase 4: Scan validated segment data, rebuild object ID -> location
+            scan_segment_objects(seg, seg_idx, valid_end, &location_index, nullptr);
          }
-      }
+      });
+      install_recovered_locations(&location_index);
+
+      for (auto& roots : worker_roots)
+         recovered_roots.insert(recovered_roots.end(), roots.begin(), roots.end());
 
       // Phase 5: Rebuild roots from sync headers (newest timestamp wins)
       // Sort by timestamp descending so we encounter newest first
@@ -1149,7 +1613,27 @@ namespace sal
 
       // Track which roots we've already set (first occurrence = newest)
       std::vector<bool> root_set(_root_objects->size(), false);
-      uint32_t          roots_recovered = 0;
+      uint32_t          roots_recovered     = 0;
+      uint32_t          roots_from_snapshot = 0;
+
+      // The durable snapshot's roots are exact; neither the roots file nor
+      // the sync headers may be newer than the data kept above.
+      if (snap)
+      {
+         for (uint32_t i = 0; i < _root_objects->size(); ++i)
+         {
+            auto tid = tree_id::unpack(snap->roots[i].tree);
+            if (tid.root != null_ptr_address && not resolve(tid.root).first)
+            {
+               SAL_WARN("root[{}] = {} from durable snapshot is invalid (no control block), clearing",
+                        i, *tid.root);
+               tid = null_tree_id;
+            }
+            _root_objects->at(i).store(tid, snap->roots[i].version, std::memory_order_relaxed);
+            root_set[i] = true;
+            roots_from_snapshot += tid.root != null_ptr_address;
+         }
+      }
       for (auto& entry : recovered_roots)
       {
          if (entry.root_index < _root_objects->size() && !root_set[entry.root_index])
@@ -1203,32 +1687,233 @@ namespace sal
       // Phase 5.5: Reconstruct custom CBs from root slots
       reconstruct_custom_cbs_from_roots(&version_index);
 
-      // Phase 6: Walk all valid roots, recursively retain reachable nodes
+      // Phase 6: Walk all valid roots, retaining reachable nodes
       recovery_visit_set visited(_ptr_alloc.current_max_address_count());
-      for (uint32_t i = 0; i < _root_objects->size(); ++i)
-      {
-         auto tid = _root_objects->at(i).load(std::memory_order_relaxed);
-         if (tid.root != null_ptr_address)
-            recursive_retain_all(tid.root, &visited);
-         if (tid.ver != null_ptr_address)
-            recursive_retain_all(tid.ver, &visited);
-      }
+      retain_all_reachable(&visited);
 
       // Phase 7: Free leaked objects
       _ptr_alloc.release_unreachable();
 
-      // Reset segment provider sequence counter
-      _mapped_state->_segment_provider._next_alloc_seq.store(max_provider_seq + 1,
-                                                              std::memory_order_relaxed);
+      // Reset segment provider sequence counter; dropped segments must never
+      // look older than the snapshot's cut once they are reused
+      uint32_t next_seq = max_provider_seq + 1;
+      if (snap)
+         next_seq = std::max(next_seq, snap->next_provider_seq);
+      _mapped_state->_segment_provider._next_alloc_seq.store(next_seq, std::memory_order_relaxed);
       _mapped_state->clean_exit_flag.store(false);
       _mapped_state->_read_lock_queue.reset_all_session_locks();
 
       provider_populate_pinned_segments();
       provider_populate_unpinned_segments();
+      provider_populate_cold_segments();
       start_background_threads();
 
-      SAL_WARN("Power-loss recovery complete. {} roots from sync headers, {} validated from roots file.",
-               roots_recovered, roots_from_file);
+      SAL_WARN("Power-loss recovery complete. {} roots from durable snapshot, {} from sync "
+               "headers, {} validated from roots file.",
+               roots_from_snapshot, roots_recovered, roots_from_file);
+   }
+
+   void allocator::begin_leak_reclamation(std::function<void(uint64_t)> on_complete)
+   {
+      if (leak_reclamation_active() || _mapped_state->_config.leak_reclaim_objects_per_sec == 0)
+         return;
+
+      uint32_t words     = _ptr_alloc.current_max_address_count() / 64;
+      auto     reclaimer = std::make_unique<leak_reclaimer>(words);
+      for (uint32_t w = 0; w < words; ++w)
+         reclaimer->candidates[w] = _ptr_alloc.allocated_bits(w);
+      reclaimer->on_complete = std::move(on_complete);
+
+      // Pin everything that holds references as of now: the root slots and
+      // releases queued before the restart, which the release workers would
+      // otherwise free (and cascade through) while we mark.  Pinned objects
+      // and everything below them stay allocated until the pass ends.
+      auto pin = [&](ptr_address addr)
+      {
+         if (addr == null_ptr_address)
+            return;
+         auto* cb = _ptr_alloc.try_get(addr);
+         if (!cb || cb->ref() == 0)
+            return;
+         cb->retain();
+         reclaimer->pinned.push_back(addr);
+         reclaimer->mark_stack.push_back(addr);
+      };
+
+      for (uint32_t i = 0; i < _root_objects->size(); ++i)
+      {
+         auto tid = _root_objects->at(i).load(std::memory_order_relaxed);
+         pin(tid.root);
+         pin(tid.ver);
+      }
+      for (uint32_t snum = 0; snum < _mapped_state->_session_data.session_capacity(); ++snum)
+      {
+         auto& queue = get_release_queue(allocator_session_number(snum));
+         for (auto pos = queue.get_read_pos(), end = queue.get_push_pos(); pos != end; ++pos)
+            pin(queue.at(pos));
+      }
+
+      SAL_WARN("leak reclamation: {} pinned addresses, {} allocated control blocks",
+               reclaimer->pinned.size(), _ptr_alloc.used());
+      _leak_reclaimer = std::move(reclaimer);
+   }
+
+   bool allocator::leak_reclamation_active() const noexcept
+   {
+      return _leak_reclaimer &&
+             _leak_reclaimer->state.load(std::memory_order_relaxed) != leak_reclaimer::phase::done;
+   }
+
+   void allocator::leak_reclaim_loop(segment_thread& thread)
+   {
+      sal::set_current_thread_name("leak_reclaim");
+
+      using phase     = leak_reclaimer::phase;
+      auto  ses       = get_session();
+      auto& reclaimer = *_leak_reclaimer;
+
+      // Work is spread over 10ms ticks, each holding the read lock only for
+      // its own share of the per-second budget.
+      while (reclaimer.state.load(std::memory_order_relaxed) != phase::done &&
+             thread.yield(std::chrono::milliseconds(10)))
+      {
+         uint64_t rate = _mapped_state->_config.leak_reclaim_objects_per_sec;
+         if (rate == 0)
+            continue;
+
+         auto     lock   = ses->lock();
+         uint64_t budget = std::max<uint64_t>(rate / 100, 1);
+         if (reclaimer.state.load(std::memory_order_relaxed) == phase::mark)
+            leak_reclaim_mark(reclaimer, budget);
+         else
+            leak_reclaim_sweep(*ses, reclaimer, budget);
+      }
+   }
+
+   void allocator::leak_reclaim_mark(leak_reclaimer& reclaimer, uint64_t budget)
+   {
+      for (; budget > 0 && !reclaimer.mark_stack.empty(); --budget)
+      {
+         auto addr = reclaimer.mark_stack.back();
+         reclaimer.mark_stack.pop_back();
+
+         // already marked, or allocated after the pass began
+         if (!reclaimer.take_candidate(addr))
+            continue;
+         reclaimer.marked.fetch_add(1, std::memory_order_relaxed);
+
+         auto* cb = _ptr_alloc.try_get(addr);
+         if (!cb)
+            continue;
+         auto cbd = cb->load(std::memory_order_acquire);
+         if (cbd.ref == 0 || allocator_session::is_custom_cb(cbd))
+            continue;
+
+         auto  loc = cbd.loc();
+         auto* obj = reinterpret_cast<const alloc_header*>(get_segment(loc.segment())->data +
+                                                           loc.segment_offset());
+         if (obj->address() != addr)
+            continue;
+
+         type_ops(obj).visit_children(obj,
+                                      [&](ptr_address child)
+                                      {
+                                         if (child != null_ptr_address)
+                                            reclaimer.mark_stack.push_back(child);
+                                      });
+      }
+
+      if (reclaimer.mark_stack.empty())
+      {
+         reclaimer.mark_stack.shrink_to_fit();
+         reclaimer.state.store(leak_reclaimer::phase::sweep, std::memory_order_relaxed);
+         SAL_WARN("leak reclamation: marked {} reachable objects, sweeping",
+                  reclaimer.marked.load(std::memory_order_relaxed));
+      }
+   }
+
+   void allocator::leak_reclaim_sweep(allocator_session& ses,
+                                      leak_reclaimer&    reclaimer,
+                                      uint64_t           budget)
+   {
+      // the candidate bits are left set: they identify leaked children that
+      // must not be released by their leaked parents
+      while (budget > 0 && reclaimer.sweep_word < reclaimer.candidates.size())
+      {
+         uint64_t bits = reclaimer.candidates[reclaimer.sweep_word];
+         budget -= std::min<uint64_t>(budget, 1 + std::popcount(bits));
+         while (bits)
+         {
+            uint32_t index = reclaimer.sweep_word * 64 + std::countr_zero(bits);
+            bits &= bits - 1;
+            leak_reclaim_free(ses, reclaimer, ptr_address(index));
+         }
+         ++reclaimer.sweep_word;
+      }
+
+      if (reclaimer.sweep_word < reclaimer.candidates.size())
+         return;
+
+      for (auto addr : reclaimer.pinned)
+         ses.release(addr);
+      reclaimer.pinned.clear();
+
+      auto freed = reclaimer.freed.load(std::memory_order_relaxed);
+      SAL_WARN("leak reclamation complete: freed {} objects, {} bytes", freed,
+               reclaimer.freed_bytes.load(std::memory_order_relaxed));
+      reclaimer.state.store(leak_reclaimer::phase::done, std::memory_order_relaxed);
+      if (reclaimer.on_complete)
+         reclaimer.on_complete(freed);
+   }
+
+   void allocator::leak_reclaim_free(allocator_session& ses,
+                                     leak_reclaimer&    reclaimer,
+                                     ptr_address        addr)
+   {
+      auto& cb  = _ptr_alloc.get(addr);
+      auto  pre = cb.load(std::memory_order_relaxed);
+      reclaimer.freed.fetch_add(1, std::memory_order_relaxed);
+
+      // Claimed but never initialized, or released but never freed: the crash
+      // interrupted alloc() or final_release().  In the latter case some of the
+      // children may already have been released, so leave them alone.
+      if (pre.cacheline_offset == control_block::max_cacheline_offset || pre.ref == 0)
+      {
+         cb.reset();
+         _ptr_alloc.free(addr);
+         return;
+      }
+
+      // Drop every leaked reference.  The last release reports the final
+      // location, after which the compactor can no longer move the object.
+      control_block_data last;
+      do
+         last = cb.release();
+      while (last.ref != 0);
+
+      if (allocator_session::is_custom_cb(pre))
+      {
+         if (_on_custom_cb_released)
+            _on_custom_cb_released(pre.cacheline_offset);
+      }
+      else if (auto loc = last.loc(); loc != location::null())
+      {
+         auto* obj = reinterpret_cast<const alloc_header*>(get_segment(loc.segment())->data +
+                                                           loc.segment_offset());
+
+         // References held by a leaked object are real: release the ones to
+         // live objects, leaked children are freed by the sweep itself.
+         type_ops(obj).visit_children(obj,
+                                      [&](ptr_address child)
+                                      {
+                                         if (child != null_ptr_address &&
+                                             !reclaimer.is_candidate(child))
+                                            ses.release(child);
+                                      });
+         reclaimer.freed_bytes.fetch_add(obj->size(), std::memory_order_relaxed);
+         ses.record_freed_space(obj, "leak_reclaim");
+      }
+      _ptr_alloc.free(addr);
    }
 
    allocator_session_number allocator::alloc_session_num() noexcept
@@ -1304,10 +1989,13 @@ namespace sal
     *   unlock the segment in the queue and there could be multiple, so giving them
     * a virtual age based upon the buffer position would work well. 
     */
-   void allocator::compactor_loop(segment_thread& thread)
+   void allocator::compactor_loop(segment_thread& thread, uint32_t worker)
    {
+      // the rcache queues are single-consumer, so only worker 0 promotes
+      const bool promote = worker == 0;
+
       // Set thread name for sal debug system
-      sal::set_current_thread_name("compactor");
+      sal::set_current_thread_name(promote ? "compactor" : "compactor_worker");
 
       auto ses = get_session();
       auto& sesr = *ses;
@@ -1327,12 +2015,14 @@ namespace sal
          while (thread.yield())
          {
             auto t0 = clock::now();
-            compactor_promote_rcache_data(sesr);
+            if (promote)
+               compactor_promote_rcache_data(sesr);
             auto t1 = clock::now();
-            compact_pinned_segment(sesr, &thread);
+            compact_pinned_segment(sesr, &thread, worker);
             auto t2 = clock::now();
-            compactor_promote_rcache_data(sesr);
-            compact_unpinned_segment(sesr, &thread);
+            if (promote)
+               compactor_promote_rcache_data(sesr);
+            compact_unpinned_segment(sesr, &thread, worker);
             auto t3 = clock::now();
 
             total_promote_ns += (t1 - t0).count() + (t3 - t2).count();
@@ -1344,8 +2034,9 @@ namespace sal
             if (elapsed >= std::chrono::seconds(5))
             {
                auto to_ms = [](uint64_t ns) { return ns / 1'000'000; };
-               SAL_WARN("compactor: iters={} promote={}ms pinned={}ms unpinned={}ms", iterations,
-                        to_ms(total_promote_ns), to_ms(total_pinned_ns), to_ms(total_unpinned_ns));
+               SAL_WARN("compactor[{}]: iters={} promote={}ms pinned={}ms unpinned={}ms", worker,
+                        iterations, to_ms(total_promote_ns), to_ms(total_pinned_ns),
+                        to_ms(total_unpinned_ns));
                total_promote_ns = total_pinned_ns = total_unpinned_ns = 0;
                iterations                                              = 0;
                last_report                                             = clock::now();
@@ -1356,10 +2047,12 @@ namespace sal
       {
          while (thread.yield())
          {
-            compactor_promote_rcache_data(sesr);
-            compact_pinned_segment(sesr, &thread);
-            compactor_promote_rcache_data(sesr);
-            compact_unpinned_segment(sesr, &thread);
+            if (promote)
+               compactor_promote_rcache_data(sesr);
+            compact_pinned_segment(sesr, &thread, worker);
+            if (promote)
+               compactor_promote_rcache_data(sesr);
+            compact_unpinned_segment(sesr, &thread, worker);
          }
       }
    }
@@ -1382,41 +2075,466 @@ namespace sal
    }
 
    /**
-    * Dedicated release thread loop — processes deferred object releases from all
-    * session release queues.  Uses fine-grained read locks so the compactor can
-    * continue recycling segments between individual releases.
+    * Release worker loop — processes deferred object releases from the session
+    * release queues this worker owns.  Read locks are taken per batch of
+    * release_lock_batch objects so the compactor can continue recycling
+    * segments between batches.
     *
     * For each object: lock → dereference → type_ops.destroy (cascades children
-    * back to queue or processes inline if full) → unlock → record_freed_space
-    * → free control block.
+    * back to this worker's queue or processes inline if full) → unlock →
+    * record_freed_space → free control block.
     */
-   void allocator::release_loop(segment_thread& thread)
+   void allocator::release_loop(segment_thread& thread, uint32_t worker)
    {
-      sal::set_current_thread_name("release");
+      sal::set_current_thread_name(worker == 0 ? "release" : "release_worker");
+
+      auto  ses   = get_session();
+      auto& sesr  = *ses;
+      auto& stats = _release_stats[worker];
+
+      // Publish our session so no other worker drains its queue, then wait for
+      // the rest of the workers so every queue has exactly one consumer.
+      const uint32_t own_session = *sesr.get_session_num();
+      _release_worker_sessions.fetch_or(1ull << own_session);
+      _release_workers_ready.fetch_add(1);
+      while (_release_workers_ready.load() < _release_workers)
+         if (not thread.yield(std::chrono::milliseconds(1)))
+            return;
+      const uint64_t worker_sessions = _release_worker_sessions.load();
 
-      auto  ses  = get_session();
-      auto& sesr = *ses;
+      auto owns = [&](uint32_t snum)
+      {
+         if (snum == own_session)
+            return true;
+         if (worker_sessions & (1ull << snum))
+            return false;
+         return snum % _release_workers == worker;
+      };
 
       ptr_address read_ids[1024];
       while (thread.yield())
       {
+         bool found_work = false;
          for (uint32_t snum = 0; snum < _mapped_state->_session_data.session_capacity(); ++snum)
          {
+            if (not owns(snum))
+               continue;
             auto& rqueue =
                 _mapped_state->_session_data.release_queue(allocator_session_number(snum));
+            if (rqueue.usage() == 0)
+               continue;
+
+            // mark busy before popping so wait_for_releases() never sees an
+            // empty queue while the popped batch is still in flight
+            if (not found_work)
+            {
+               found_work = true;
+               stats.idle.store(false);
+            }
+
+            auto start      = std::chrono::steady_clock::now();
             auto num_loaded = rqueue.pop(read_ids, 1024);
-            for (uint32_t i = 0; i < num_loaded; ++i)
+            for (uint32_t i = 0; i < num_loaded; i += release_lock_batch)
             {
-               // Fine-grained read lock prevents the compactor from recycling
-               // the segment we're reading from during dereference + destroy.
+               // The read lock prevents the compactor from recycling the
+               // segments we're reading from during dereference + destroy.
                // The lock is nested, so recursive final_release calls through
                // type_ops.destroy (when the queue is full) stay protected.
+               const uint32_t end = std::min<uint32_t>(num_loaded, i + release_lock_batch);
                sesr.retain_read_lock();
-               sesr.final_release(read_ids[i]);
+               for (uint32_t j = i; j < end; ++j)
+                  sesr.final_release(read_ids[j]);
                sesr.release_read_lock();
             }
+            stats.released.fetch_add(num_loaded, std::memory_order_relaxed);
+            stats.busy_ns.fetch_add(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start)
+                    .count(),
+                std::memory_order_relaxed);
          }
+
+         if (not found_work)
+         {
+            stats.last_drained_ms.store(steady_now_ms(), std::memory_order_relaxed);
+            if (not stats.idle.load(std::memory_order_relaxed))
+            {
+               std::lock_guard<std::mutex> lock(_release_idle_mutex);
+               stats.idle.store(true);
+               _release_idle_cv.notify_all();
+            }
+         }
+      }
+   }
+
+   /**
+    * True when nothing is queued and no worker holds popped releases.  The
+    * queues must be read before the idle flags: a worker clears its flag
+    * before popping, so an empty queue observed here implies the flag of the
+    * worker that emptied it is already visible.
+    */
+   bool allocator::release_backlog_drained() const
+   {
+      if (total_pending_releases() != 0)
+         return false;
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      for (uint32_t w = 0; w < _release_workers; ++w)
+         if (not _release_stats[w].idle.load())
+            return false;
+      return true;
+   }
+
+   bool allocator::wait_for_releases(std::chrono::milliseconds timeout)
+   {
+      // Only this process's release workers notify the cv; when another
+      // process drains the queues nothing does, so re-check in short slices.
+      constexpr auto               slice    = std::chrono::milliseconds(10);
+      const auto                   deadline = std::chrono::steady_clock::now() + timeout;
+      std::unique_lock<std::mutex> lock(_release_idle_mutex);
+      while (not release_backlog_drained())
+      {
+         const auto now = std::chrono::steady_clock::now();
+         if (now >= deadline)
+            return false;
+         _release_idle_cv.wait_for(lock, std::min<std::chrono::steady_clock::duration>(
+                                             slice, deadline - now));
       }
+      return true;
+   }
+
+   uint64_t allocator::release_backlog_age_ms() const
+   {
+      if (total_pending_releases() == 0)
+         return 0;
+      int64_t oldest = std::numeric_limits<int64_t>::max();
+      for (uint32_t w = 0; w < _release_workers; ++w)
+         oldest = std::min(oldest, _release_stats[w].last_drained_ms.load(std::memory_order_relaxed));
+      // workers that have never been idle report 0, i.e. pending since startup
+      return oldest > 0 ? uint64_t(std::max<int64_t>(0, steady_now_ms() - oldest)) : 0;
+   }
+
+   //-----------------------------------------------------------------------------
+   // Background Durability (sync_type::background_full)
+   //-----------------------------------------------------------------------------
+
+   void allocator::load_durable_snapshot()
+   {
+      _durable_scratch = std::make_unique<durable_snapshot>();
+      if (_durable_file.size() < 2 * durable_snapshot::slot_size())
+         _durable_file.resize(2 * durable_snapshot::slot_size());
+
+      _durable_as_of_ms.store(steady_now_ms());
+      // In other modes the snapshot is left for power-loss recovery and
+      // cleared once the background threads start, see
+      // start_background_threads().
+      if (_mapped_state->_config.sync_mode != sync_type::background_full)
+         return;
+      if (auto* snap = find_durable_snapshot())
+      {
+         _durability_started.store(snap->generation);
+         _durability_completed.store(snap->generation);
+         _durability_active.store(true);
+      }
+   }
+
+   const allocator::durable_snapshot* allocator::find_durable_snapshot() const noexcept
+   {
+      const durable_snapshot* best = nullptr;
+      for (uint32_t i = 0; i < 2; ++i)
+      {
+         auto* snap = reinterpret_cast<const durable_snapshot*>(
+             static_cast<const char*>(_durable_file.data()) + i * durable_snapshot::slot_size());
+         if (snap->valid() && (not best || snap->generation > best->generation))
+            best = snap;
+      }
+      return best;
+   }
+
+   void allocator::mark_undurable() noexcept
+   {
+      // after the root is published, so a snapshot that counts this commit
+      // also sees its root; the first pending commit starts the lag clock
+      if (_background_commits.fetch_add(1) == _durable_commits.load())
+         _durable_as_of_ms.store(steady_now_ms());
+   }
+
+   uint64_t allocator::durability_lag_ms() const noexcept
+   {
+      if (_background_commits.load(std::memory_order_relaxed) ==
+          _durable_commits.load(std::memory_order_relaxed))
+         return 0;
+      return uint64_t(
+          std::max<int64_t>(0, steady_now_ms() - _durable_as_of_ms.load(std::memory_order_relaxed)));
+   }
+
+   void allocator::throttle_durability_lag() noexcept
+   {
+      const uint64_t limit = 2 * uint64_t(_mapped_state->_config.max_durability_lag_ms);
+      if (limit == 0 || durability_lag_ms() <= limit) [[likely]]
+         return;
+
+      // the disk is falling behind, hold writers until a snapshot catches up;
+      // bounded so a stopped durability thread cannot block commits forever
+      _durability_requested.store(true);
+      std::unique_lock<std::mutex> lock(_durability_state_mutex);
+      _durability_cv.wait_for(lock, std::chrono::milliseconds(limit),
+                              [&] { return durability_lag_ms() <= limit; });
+   }
+
+   bool allocator::wait_for_durability(std::chrono::milliseconds timeout)
+   {
+      // without the durability thread background_full commits sync fully,
+      // see sync(), so none is waiting to become durable
+      if (not _background_durability.load())
+         return true;
+
+      std::unique_lock<std::mutex> lock(_durability_state_mutex);
+      // a snapshot already running may have missed commits made before this call
+      const uint64_t needed = _durability_started.load() + 1;
+      _durability_requested.store(true);
+      return _durability_cv.wait_for(lock, timeout,
+                                     [&] { return _durability_completed.load() >= needed; });
+   }
+
+   /**
+    * Writes one durability snapshot.
+    *
+    * Roots are read after the commit count, and the provider sequence and
+    * segment positions after the roots, so every commit counted as covered
+    * has its root recorded and every sync header that root depends on at or
+    * before the recorded positions.  The segment file is fsynced before the
+    * snapshot is written, and the snapshot only counts once the durable file
+    * itself is synced.
+    *
+    * @return false if the snapshot could not be made durable
+    */
+   bool allocator::durability_sync() noexcept
+   {
+      std::lock_guard<std::mutex> lock(_durability_mutex);
+      const auto                  start = std::chrono::steady_clock::now();
+
+      uint64_t gen;
+      {
+         // from here on the provider defers every segment it recycles until
+         // a snapshot newer than this one completes
+         std::lock_guard<std::mutex> state(_durability_state_mutex);
+         _durability_active.store(true);
+         gen = _durability_started.fetch_add(1) + 1;
+      }
+
+      const int64_t  as_of   = steady_now_ms();
+      const uint64_t covered = _background_commits.load();
+
+      auto& snap = *_durable_scratch;
+      for (uint32_t i = 0; i < _root_objects->size(); ++i)
+      {
+         // exchange() stores the version and check before the tree, retry
+         // until all three agree rather than record a torn version
+         auto&    rec = _root_objects->at(i);
+         tree_id  tid;
+         uint64_t ver = 0;
+         for (int attempt = 0; attempt < 1024; ++attempt)
+         {
+            tid = rec.load(std::memory_order_acquire);
+            ver = rec.version_for(tid);
+            if (ver != 0 || rec.check.load(std::memory_order_relaxed) ==
+                                root_object_check(tid.pack(), 0))
+               break;
+            std::this_thread::yield();
+         }
+         snap.roots[i] = {tid.pack(), ver};
+      }
+
+      snap.next_provider_seq =
+          _mapped_state->_segment_provider._next_alloc_seq.load(std::memory_order_acquire);
+      uint32_t open_count = 0;
+      for (uint32_t seg = 0, end = _block_alloc.num_blocks(); seg < end; ++seg)
+      {
+         if (not _mapped_state->_segment_data.is_writable(segment_number(seg)))
+            continue;
+         if (open_count == durable_snapshot::max_open_segments) [[unlikely]]
+         {
+            SAL_WARN("durability snapshot: more than {} writable segments, "
+                     "power-loss recovery falls back to sync headers",
+                     durable_snapshot::max_open_segments);
+            invalidate_durable_snapshot_locked();
+            return false;
+         }
+         snap.open[open_count++] = {seg, get_segment(segment_number(seg))->_last_aheader_pos};
+      }
+      snap.open_count = open_count;
+      snap.generation = gen;
+      snap.magic      = durable_snapshot::valid_magic;
+      snap.checksum   = snap.compute_checksum();
+
+      // everything the snapshot refers to reaches the media before it does
+      if (not _block_alloc.fsync(true))
+         return false;
+      memcpy(static_cast<char*>(_durable_file.data()) + (gen % 2) * durable_snapshot::slot_size(),
+             &snap, sizeof(snap));
+      _durable_file.sync(sync_type::full);
+
+      // stats first, so a woken wait_for_durability() caller sees them
+      _durability_syncs.fetch_add(1, std::memory_order_relaxed);
+      _last_durability_sync_us.store(std::chrono::duration_cast<std::chrono::microseconds>(
+                                         std::chrono::steady_clock::now() - start)
+                                         .count(),
+                                     std::memory_order_relaxed);
+      {
+         std::lock_guard<std::mutex> state(_durability_state_mutex);
+         _durability_completed.store(gen);
+         _durable_commits.store(covered);
+         _durable_as_of_ms.store(as_of);
+      }
+      _durability_cv.notify_all();
+
+      return true;
+   }
+
+   /// requires _durability_mutex; recovery falls back to the sync headers
+   void allocator::invalidate_durable_snapshot_locked() noexcept
+   {
+      for (uint32_t i = 0; i < 2; ++i)
+         reinterpret_cast<durable_snapshot*>(static_cast<char*>(_durable_file.data()) +
+                                             i * durable_snapshot::slot_size())
+             ->magic = 0;
+      _durable_file.sync(sync_type::full);
+
+      std::lock_guard<std::mutex> state(_durability_state_mutex);
+      _durability_active.store(false);
+   }
+
+   void allocator::durability_loop(segment_thread& thread)
+   {
+      sal::set_current_thread_name("durability");
+
+      int64_t last_ms = steady_now_ms();
+      while (thread.yield(std::chrono::milliseconds(1)))
+      {
+         const int64_t now      = steady_now_ms();
+         const int64_t interval = std::max<uint32_t>(1, _mapped_state->_config.max_durability_lag_ms / 2);
+
+         bool due = _durability_requested.exchange(false);
+         if (now - last_ms >= interval)
+         {
+            // commits waiting to become durable, or recycled segments waiting
+            // for a snapshot newer than the one that still needs them
+            due |= _background_commits.load(std::memory_order_relaxed) !=
+                   _durable_commits.load(std::memory_order_relaxed);
+            due |= _durability_deferred_count.load(std::memory_order_relaxed) != 0;
+         }
+         if (due)
+         {
+            durability_sync();
+            last_ms = now;
+         }
+      }
+
+      // leave nothing committed behind, and let the provider free what it held
+      if (_background_commits.load() != _durable_commits.load() ||
+          _durability_deferred_count.load() != 0)
+         durability_sync();
+   }
+
+   //-----------------------------------------------------------------------
+   // Group Commit
+   //-----------------------------------------------------------------------
+
+   void allocator::group_commit(sync_type                                   st,
+                                std::span<const mapped_memory::sync_range> ranges) noexcept
+   {
+      std::unique_lock<std::mutex> lock(_group_mutex);
+      _group_queued.insert(_group_queued.end(), ranges.begin(), ranges.end());
+      _group_queued_sync   = std::max(_group_queued_sync, st);
+      const uint64_t ticket = ++_group_requested;
+
+      while (_group_flushed < ticket)
+      {
+         if (_group_leader)
+         {
+            _group_cv.wait(lock);
+            continue;
+         }
+         _group_leader = true;
+
+         if (auto delay = _mapped_state->_config.group_commit_delay_us)
+         {
+            lock.unlock();
+            std::this_thread::sleep_for(std::chrono::microseconds(delay));
+            lock.lock();
+         }
+
+         // everything queued up to here, including our own ticket
+         const uint64_t  covered = _group_requested;
+         const sync_type batch   = _group_queued_sync;
+         _group_queued_sync      = sync_type::none;
+         std::swap(_group_queued, _group_flushing);
+         lock.unlock();
+
+         const auto start = std::chrono::steady_clock::now();
+         group_flush(batch, _group_flushing);
+         const uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                 std::chrono::steady_clock::now() - start)
+                                 .count();
+         _group_flushing.clear();
+
+         _group_flushes.fetch_add(1, std::memory_order_relaxed);
+         _group_flush_ns.fetch_add(ns, std::memory_order_relaxed);
+         if (ns > _group_flush_max_ns.load(std::memory_order_relaxed))
+            _group_flush_max_ns.store(ns, std::memory_order_relaxed);
+
+         lock.lock();
+         _group_flushed = covered;
+         _group_leader  = false;
+         _group_cv.notify_all();
+      }
+   }
+
+   /// one flush on behalf of every committer in the batch
+   void allocator::group_flush(sync_type st, std::vector<mapped_memory::sync_range>& ranges) noexcept
+   {
+      // fsync() writes back every dirty page of the segment file, mapped
+      // ones included, so only msync_sync needs the ranges themselves
+      if (st == sync_type::msync_sync && not ranges.empty())
+      {
+         // sessions write disjoint pages; merge the adjacent ones so a run
+         // of segments costs one msync
+         std::sort(ranges.begin(), ranges.end(),
+                   [](const auto& a, const auto& b) { return a.data < b.data; });
+         auto flush = [](char* begin, char* end)
+         {
+            if (::msync(begin, end - begin, MS_SYNC))
+               SAL_ERROR("msync ({}) failed: {}", sync_type::msync_sync, strerror(errno));
+         };
+         char* begin = ranges.front().data;
+         char* end   = begin + ranges.front().size;
+         for (const auto& r : ranges)
+         {
+            if (r.data > end)
+            {
+               flush(begin, end);
+               begin = r.data;
+            }
+            end = std::max(end, r.data + r.size);
+         }
+         flush(begin, end);
+      }
+
+      // we don't fsync(full=true) the _block_alloc because _root_object_file
+      // also needs to be synced and it will do a full (computer-wide) sync if
+      // needed and implicitly grab data synced by _block_alloc.
+      if (st >= sync_type::fsync)
+         _block_alloc.fsync(false);
+      _root_object_file.sync(st);
+
+      // we don't sync _ptr_alloc because that data can be recovered from data
+      // that is being synced. We also don't sync _mapped_state because it also
+      // can be recovered from data that is being synced.
+
+      // a commit synced by the caller must not be rolled back to an older
+      // background snapshot by power-loss recovery, so take a new one
+      if (_durability_active.load(std::memory_order_relaxed)) [[unlikely]]
+         durability_sync();
    }
 
    /**
@@ -1474,46 +2592,249 @@ namespace sal
                continue;
 
             assert(obj_ref->address() == addr);
+            compactor_promote_object(ses, obj_ref, pending_storage);
+         }
+      }
+      more_work |= compactor_admit_sampled_reads(ses, pending_storage);
+      _mapped_state->_cache_difficulty_state.compactor_promote_bytes(0);
+      return more_work;
+   }
+
+   /**
+    * Copies a read-only object into the session's write segment, which is
+    * pinned for the promoting compactor, and moves its control block there.
+    * The caller holds a read lock.
+    *
+    * @return true if the object moved, false if it changed under us
+    */
+   bool allocator::compactor_promote_object(allocator_session&        ses,
+                                            const smart_ref_base&     obj_ref,
+                                            std::vector<ptr_address>& pending_storage)
+   {
+      // reads the relaxed cached load of the location
+      const auto  start_loc    = obj_ref.loc();
+      const auto* obj          = obj_ref.obj();
+      const auto& ops          = type_ops(obj);
+      auto        compact_size = ops.compact_size(obj);
 
-            const auto& ops = type_ops(obj_ref.obj());
-            auto        compact_size = ops.compact_size(obj_ref.obj());
+      // TODO: return a scoped lock with new_loc and new_header
+      //the ses modify lock is held while modifying while allocating
+      auto [new_loc, new_header] =
+          ses.alloc_data<alloc_header>(compact_size, obj->type(), obj->address_seq());
 
-            // TODO: return a scoped lock with new_loc and new_header
-            //the ses modify lock is held while modifying while allocating
-            auto [new_loc, new_header] =
-                ses.alloc_data<alloc_header>(compact_size, obj_ref->type(), obj_ref->address_seq());
+      pending_release_list pending_releases(pending_storage);
+      ops.passive_compact_to(obj, new_header, pending_releases);
 
-            pending_release_list pending_releases(pending_storage);
-            ops.passive_compact_to(obj_ref.obj(), new_header, pending_releases);
+      if (config_update_checksum_on_compact())
+         if (not type_ops(new_header).has_checksum(new_header))
+            type_ops(new_header).update_checksum(new_header);
+
+      if (pending_releases.failed())
+      {
+         if (not ses.unalloc(compact_size))
+            ses.record_freed_space(new_header, "compactor_promote_release_failed");
+         return false;
+      }
 
-            if (config_update_checksum_on_compact())
-               if (not type_ops(new_header).has_checksum(new_header))
-                  type_ops(new_header).update_checksum(new_header);
+      /// if the location hasn't changed then we are good to go
+      ///     - and the objeect is still valid ref count
+      if (obj_ref.control().cas_move(start_loc, new_loc))
+      {
+         _mapped_state->_cache_difficulty_state.compactor_promote_bytes(obj->size());
+         ses.record_freed_space(obj, "compactor_promote_move");
+         release_pending_relocation_refs(ses, pending_releases);
+         _cache_promotions.fetch_add(1, std::memory_order_relaxed);
+         return true;
+      }
+      if (not ses.unalloc(compact_size))
+         ses.record_freed_space(new_header, "compactor_promote_unalloc_failed");
+      return false;
+   }
 
-            if (pending_releases.failed())
+   /**
+    * Feeds the addresses readers sampled under
+    * cache_admission_policy::frequency_sketch to the sketch and promotes
+    * each object whose estimated frequency beats the pinned cache's next
+    * victims.  Only objects outside pinned segments, or in the victim
+    * segment itself, are candidates; everything else is already cached.
+    *
+    * @return true if a session still has sampled reads queued
+    */
+   bool allocator::compactor_admit_sampled_reads(allocator_session&        ses,
+                                                 std::vector<ptr_address>& pending_storage)
+   {
+      const auto& cfg = _mapped_state->_config;
+      if (cfg.cache_admission != cache_admission_policy::frequency_sketch)
+         return false;
+
+      // sized for the number of objects that fit in the pinned budget
+      if (_sketch_budget_mb != cfg.max_pinned_cache_size_mb)
+      {
+         _sketch_budget_mb = cfg.max_pinned_cache_size_mb;
+         _sketch.resize(_sketch_budget_mb * 1024 * 1024 / 512);
+      }
+
+      bool        more_work = false;
+      ptr_address read_ids[1024];
+      const auto  victim_freq = std::max<uint32_t>(compactor_victim_frequency(ses), 1);
+      for (uint32_t snum = 0; snum < max_session_count; ++snum)
+      {
+         auto& accesses   = _read_samples[snum].accesses;
+         auto  num_loaded = accesses.pop(read_ids, 1024);
+         more_work |= accesses.usage() > 0;
+
+         for (uint32_t i = 0; i < num_loaded; ++i)
+         {
+            auto addr = read_ids[i];
+            _sketch.increment(*addr);
+            if (_sketch.frequency(*addr) <= victim_freq)
             {
-               if (not ses.unalloc(compact_size))
-                  ses.record_freed_space(new_header, "compactor_promote_release_failed");
+               _cache_admission_rejects.fetch_add(1, std::memory_order_relaxed);
                continue;
             }
 
-            /// if the location hasn't changed then we are good to go
-            ///     - and the objeect is still valid ref count
-            if (obj_ref.control().cas_move(start_loc, new_loc))
-            {
-               _mapped_state->_cache_difficulty_state.compactor_promote_bytes(obj_ref->size());
-               ses.record_freed_space(obj_ref.obj(), "compactor_promote_move");
-               release_pending_relocation_refs(ses, pending_releases);
-            }
-            else
+            // the address was sampled without holding a reference, so it
+            // may have been freed or reused since
+            auto state = ses.lock();  // read only lock
+            auto cbd   = _ptr_alloc.get(addr).load(std::memory_order_acquire);
+            if (cbd.ref == 0 or allocator_session::is_custom_cb(cbd))
+               continue;
+            const auto loc = cbd.loc();
+            if (not is_read_only(loc))
+               continue;
+            if (_mapped_state->_segment_data.is_pinned(loc.segment()) and
+                loc.segment() != _victim_segment)
+               continue;
+
+            auto obj_ref = ses.get_ref<alloc_header>(addr);
+            if (obj_ref.loc() != loc or obj_ref->address() != addr)
+               continue;
+            if (obj_ref->size() > max_cacheable_object_size)
+               continue;
+            compactor_promote_object(ses, obj_ref, pending_storage);
+         }
+      }
+      return more_work;
+   }
+
+   /**
+    * Average sketch frequency of a sample of live objects in the pinned
+    * segment provider_munlock_excess_segments() would unpin next, or 0 while
+    * the pinned budget still has room.  An admitted object displaces data
+    * of roughly that popularity, so it must be read more often than it.
+    * The estimate is refreshed when the victim changes and every 64 calls.
+    */
+   uint32_t allocator::compactor_victim_frequency(allocator_session& ses)
+   {
+      auto&          provider_state = _mapped_state->_segment_provider;
+      const uint64_t max_count =
+          _mapped_state->_config.max_pinned_cache_size_mb / (segment_size / 1024 / 1024);
+      if (provider_state.mlock_segments.count() < max_count)
+      {
+         _victim_segment = segment_number(-1);
+         _victim_frequency.store(0, std::memory_order_relaxed);
+         return 0;
+      }
+
+      uint64_t oldest_age = -1;
+      uint32_t oldest_seg = -1;
+      for (auto seg : provider_state.mlock_segments)
+      {
+         uint64_t vage = _mapped_state->_segment_data.get_vage(segment_number(seg));
+         if (vage < oldest_age and vage != 0)
+         {
+            oldest_age = vage;
+            oldest_seg = seg;
+         }
+      }
+      if (oldest_age == uint64_t(-1))
+         return _victim_frequency.load(std::memory_order_relaxed);
+
+      const auto victim = segment_number(oldest_seg);
+      if (victim == _victim_segment and ++_victim_checks < 64)
+         return _victim_frequency.load(std::memory_order_relaxed);
+      _victim_segment = victim;
+      _victim_checks  = 0;
+
+      // the read lock keeps the segment from being recycled while we walk it
+      auto        state   = ses.lock();
+      const auto* shead   = (const mapped_memory::segment*)get_segment(victim);
+      const auto* send    = (const alloc_header*)shead->end();
+      const auto* foo     = (const alloc_header*)(shead);
+      uint64_t    total   = 0;
+      uint32_t    sampled = 0;
+      while (foo < send and sampled < 32)
+      {
+         if (foo->type() != header_type::sync_head)
+         {
+            auto obj_ref = ses.get_ref<alloc_header>(foo->address());
+            if (obj_ref.ref() != 0 and obj_ref.obj() == foo)
             {
-               if (not ses.unalloc(compact_size))
-                  ses.record_freed_space(new_header, "compactor_promote_unalloc_failed");
+               total += _sketch.frequency(*foo->address());
+               ++sampled;
             }
          }
+         if (foo->next() <= foo)
+            break;
+         foo = foo->next();
       }
-      _mapped_state->_cache_difficulty_state.compactor_promote_bytes(0);
-      return more_work;
+      const uint32_t freq = sampled ? uint32_t(total / sampled) : 0;
+      _victim_frequency.store(freq, std::memory_order_relaxed);
+      return freq;
+   }
+
+   /**
+    * The index holds segments whose freed space reached the lower of the
+    * pinned and unpinned compaction thresholds.  When that threshold
+    * differs from the one the index was built with (first pass, a runtime
+    * config change, or invalidate() after recovery), install it and
+    * re-insert every segment that now qualifies.  Entries that fall below
+    * a raised threshold are dropped lazily by for_each_compaction_candidate.
+    */
+   void allocator::refresh_compaction_index()
+   {
+      const auto&    cfg = _mapped_state->_config;
+      const uint32_t threshold =
+          uint32_t(std::min(cfg.compact_pinned_unused_threshold_mb,
+                            cfg.compact_unpinned_unused_threshold_mb)) *
+          1024 * 1024;
+      if (_compact_index.threshold() == threshold)
+         return;
+
+      const auto& seg_data = _mapped_state->_segment_data;
+      _compact_index.rebuild(threshold, _block_alloc.num_blocks(),
+                             [&](uint32_t seg) { return seg_data.get_freed_space(segment_number(seg)); });
+   }
+
+   template <typename Fn>
+   void allocator::for_each_compaction_candidate(uint32_t worker, uint32_t min_freed, Fn&& fn)
+   {
+      const auto& seg_data  = _mapped_state->_segment_data;
+      auto        qualifies = [&](segment_number seg)
+      {
+         return seg_data.may_compact(seg) and
+                seg_data.get_freed_space(seg) >= _compact_index.threshold();
+      };
+
+      _compact_index.for_each(
+          _block_alloc.num_blocks(),
+          [&](uint32_t i)
+          {
+             const segment_number seg(i);
+             if (not compactor_owns(seg, worker))
+                return;
+             if (not qualifies(seg))
+             {
+                // re-check after the erase so a concurrent update_compaction_index()
+                // between the two loads cannot be lost
+                _compact_index.erase(i);
+                if (qualifies(seg))
+                   _compact_index.insert(i);
+                return;
+             }
+             if (seg_data.get_freed_space(seg) >= min_freed)
+                fn(seg);
+          });
    }
 
    /**
@@ -1527,10 +2848,10 @@ namespace sal
     * Overall performance is based upon the % of data in memory and limiting
     * the number of SSD IO operations.  
     */
-   bool allocator::compact_pinned_segment(allocator_session& ses, const segment_thread* thread)
+   bool allocator::compact_pinned_segment(allocator_session&    ses,
+                                          const segment_thread* thread,
+                                          uint32_t              worker)
    {
-      auto total_segs = _block_alloc.num_blocks();
-
       size_t total_qualifying = 0;
       // Define N as the maximum number of top segments to track
       constexpr int                                     N = 16;  // Number of top segments to track
@@ -1538,21 +2859,20 @@ namespace sal
 
       uint32_t    potential_free_space = 0;
       const auto& seg_data             = _mapped_state->_segment_data;
-      for (segment_number i{0}; i < total_segs; ++i)
-      {
-         if (not seg_data.may_compact(i) or not seg_data.is_pinned(i))
-            continue;
-         const auto freed_space = seg_data.get_freed_space(i);
-         if (freed_space < _mapped_state->_config.compact_pinned_unused_threshold_mb * 1024 * 1024)
-            continue;
-
-         int64_t vage = seg_data.get_vage(i);
-
-         // Check if this segment should be included (if array isn't full yet or if the vage is
-         // higher than the lowest one we have)
-         if (insert_sorted_pair(qualifying_segments, total_qualifying, {i, vage}))
-            potential_free_space += freed_space;
-      }
+      refresh_compaction_index();
+      for_each_compaction_candidate(
+          worker, _mapped_state->_config.compact_pinned_unused_threshold_mb * 1024 * 1024,
+          [&](segment_number i)
+          {
+             if (not seg_data.is_pinned(i))
+                return;
+             int64_t vage = seg_data.get_vage(i);
+
+             // Check if this segment should be included (if array isn't full yet or if the vage is
+             // higher than the lowest one we have)
+             if (insert_sorted_pair(qualifying_segments, total_qualifying, {i, vage}))
+                potential_free_space += seg_data.get_freed_space(i);
+          });
       if (potential_free_space < segment_size)
       {
          usleep(1000);
@@ -1563,14 +2883,15 @@ namespace sal
       {
          if (thread && thread->get_stop_flag().load(std::memory_order_relaxed))
             return false;
-         compact_segment(ses, qualifying_segments[i].first, thread);
+         compact_segment(ses, qualifying_segments[i].first, thread, worker);
       }
       return total_qualifying != N;
    }
 
-   bool allocator::compact_unpinned_segment(allocator_session& ses, const segment_thread* thread)
+   bool allocator::compact_unpinned_segment(allocator_session&    ses,
+                                            const segment_thread* thread,
+                                            uint32_t              worker)
    {
-      auto   total_segs       = _block_alloc.num_blocks();
       size_t total_qualifying = 0;
 
       // Define N as the maximum number of top segments to track
@@ -1581,47 +2902,31 @@ namespace sal
       const auto& seg_data             = _mapped_state->_segment_data;
 
       // Debug counters — compiled out unless debug_compactor is set
-      uint32_t not_compactable = 0, pinned_count = 0, below_threshold = 0;
-      uint32_t nc_active = 0, nc_pending = 0, nc_free = 0, nc_queued = 0, nc_zero = 0;
-
-      for (segment_number i{0}; i < total_segs; ++i)
-      {
-         const auto freed_space = seg_data.get_freed_space(i);
-         if (not seg_data.may_compact(i))
-         {
-            if constexpr (debug_compactor)
-            {
-               ++not_compactable;
-               auto f = seg_data.get_flags(i);
-               if (f & 0x04) ++nc_active;
-               else if (f & 0x08) ++nc_pending;
-               else if (f & 0x10) ++nc_free;
-               else if (f & 0x20) ++nc_queued;
-               else if (f == 0) ++nc_zero;
-            }
-            continue;
-         }
-         if (seg_data.is_pinned(i))
-         {
-            if constexpr (debug_compactor)
-               ++pinned_count;
-            continue;
-         }
-         if (freed_space <
-             _mapped_state->_config.compact_unpinned_unused_threshold_mb * 1024 * 1024)
-         {
-            if constexpr (debug_compactor)
-               ++below_threshold;
-            continue;
-         }
-
-         int64_t vage = seg_data.get_vage(i);
-
-         // Check if this segment should be included (if array isn't full yet or if the vage is
-         // higher than the lowest one we have)
-         if (insert_sorted_pair(qualifying_segments, total_qualifying, {i, vage}))
-            potential_free_space += freed_space;
-      }
+      uint32_t candidates = 0, pinned_count = 0;
+
+      refresh_compaction_index();
+      for_each_compaction_candidate(
+          worker, _mapped_state->_config.compact_unpinned_unused_threshold_mb * 1024 * 1024,
+          [&](segment_number i)
+          {
+             if constexpr (debug_compactor)
+                ++candidates;
+             if (seg_data.is_pinned(i))
+             {
+                if constexpr (debug_compactor)
+                   ++pinned_count;
+                return;
+             }
+             // cold segments are compacted by the cold tier thread
+             if (_block_alloc.in_tier_file(block_allocator::block_number(*i)))
+                return;
+             int64_t vage = seg_data.get_vage(i);
+
+             // Check if this segment should be included (if array isn't full yet or if the vage is
+             // higher than the lowest one we have)
+             if (insert_sorted_pair(qualifying_segments, total_qualifying, {i, vage}))
+                potential_free_space += seg_data.get_freed_space(i);
+          });
       if (potential_free_space < segment_size)
       {
          if constexpr (debug_compactor)
@@ -1631,9 +2936,9 @@ namespace sal
             if (now - last_log >= std::chrono::seconds(5))
             {
                SAL_WARN(
-                   "compact_unpinned: no work — segs={} nc={} (active={} pending={} free={} queued={} zero={}) pinned={} below_thresh={} qualifying={} potential_free={}KB",
-                   total_segs, not_compactable, nc_active, nc_pending, nc_free, nc_queued, nc_zero,
-                   pinned_count, below_threshold, total_qualifying, potential_free_space / 1024);
+                   "compact_unpinned: no work — segs={} indexed={} candidates={} pinned={} qualifying={} potential_free={}KB",
+                   _block_alloc.num_blocks(), _compact_index.count(), candidates, pinned_count,
+                   total_qualifying, potential_free_space / 1024);
                last_log = now;
             }
          }
@@ -1646,17 +2951,26 @@ namespace sal
       {
          if (thread && thread->get_stop_flag().load(std::memory_order_relaxed))
             return false;
-         compact_segment(ses, qualifying_segments[i].first, thread);
+         compact_segment(ses, qualifying_segments[i].first, thread, worker);
       }
 
       return total_qualifying != N;
    }
 
-   void allocator::compact_segment(allocator_session& ses,
-                                   segment_number     seg_num,
-                                   const segment_thread* thread)
+   void allocator::compact_segment(allocator_session&    ses,
+                                   segment_number        seg_num,
+                                   const segment_thread* thread,
+                                   uint32_t              worker)
    {
       //      SAL_ERROR("compact_segment: {:L}", seg_num);
+      const auto start_time = std::chrono::steady_clock::now();
+      uint64_t   relocated  = 0;
+
+      // another thread may have selected the same segment; the claim is
+      // dropped when the segment is queued for recycling
+      if (not _mapped_state->_segment_data.try_claim_compaction(seg_num))
+         return;
+
       auto        state = ses.lock();
       const auto* s     = get_segment(seg_num);
 
@@ -1677,6 +2991,7 @@ namespace sal
       }
       catch (...)
       {
+         _mapped_state->_segment_data.release_compaction_claim(seg_num);
          return;
       }
 
@@ -1726,6 +3041,7 @@ namespace sal
 
          if (obj_ref.control().cas_move(obj_ref.loc(), loc))
          {
+            relocated += compact_size;
             ses.record_freed_space(obj_ref.obj(), "compactor_segment_move");
             release_pending_relocation_refs(ses, pending_releases);
          }
@@ -1740,7 +3056,10 @@ namespace sal
       while (foo < send)
       {
          if (thread && thread->get_stop_flag().load(std::memory_order_relaxed))
+         {
+            _mapped_state->_segment_data.release_compaction_claim(seg_num);
             return;
+         }
          if (foo->type() == header_type::sync_head)
             src_vage =
                 msec_timestamp(*reinterpret_cast<const sync_header*>(foo)->timestamp() / 1000);
@@ -1771,7 +3090,129 @@ namespace sal
       // std::cerr<<"done freeing end_ptr: " << _mapped_state->end_ptr.load() <<" <== " << seg_num <<"\n";
 
       //   ARBTRIE_DEBUG("pushing recycled segment: ", seg_num);
-      _mapped_state->_read_lock_queue.push_recycled_segment(seg_num);
+      {
+         std::lock_guard<std::mutex> lock(_recycle_mutex);
+         _mapped_state->_read_lock_queue.push_recycled_segment(seg_num);
+      }
+
+      auto& stats = worker == cold_tier_worker ? _cold_tier_stats : _compactor_stats[worker];
+      stats.segments_compacted.fetch_add(1, std::memory_order_relaxed);
+      stats.bytes_relocated.fetch_add(relocated, std::memory_order_relaxed);
+      stats.busy_ns.fetch_add(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() -
+                                                               start_time)
+              .count(),
+          std::memory_order_relaxed);
+   }
+
+   //-----------------------------------------------------------------------
+   // Cold Tier
+   //-----------------------------------------------------------------------
+
+   void allocator::cold_tier_loop(segment_thread& thread)
+   {
+      sal::set_current_thread_name("cold_tier");
+
+      auto  ses  = get_session();
+      auto& sesr = *ses;
+      // everything this session copies lands in segments backed by the tier file
+      sesr.set_alloc_to_pinned(false);
+      sesr.set_alloc_to_cold(true);
+
+      // segments finalized before the index existed, or rewritten by recovery
+      const auto& seg_data = _mapped_state->_segment_data;
+      for (uint32_t i = 0; i < _block_alloc.num_blocks(); ++i)
+         if (seg_data.may_compact(segment_number(i)))
+            _aged_index.insert(i);
+
+      bool idle = false;
+      while (thread.yield(std::chrono::milliseconds(idle ? 100 : 0)))
+         idle = not cold_tier_pass(sesr, thread);
+   }
+
+   /**
+    * Compacts the cold segments with the most freed space, then copies the
+    * oldest aged unpinned hot segments into the cold tier.  Returns false
+    * when there was nothing to do.
+    *
+    * Cold candidates come from _compact_index and hot ones from
+    * _aged_index, so a pass does not visit free or partly written segments.
+    */
+   bool allocator::cold_tier_pass(allocator_session& ses, const segment_thread& thread)
+   {
+      constexpr int N = 8;  // segments of each kind per pass
+      std::array<std::pair<segment_number, int64_t>, N> cold_segments;
+      std::array<std::pair<segment_number, int64_t>, N> aged_segments;
+      size_t                                            total_cold = 0;
+      size_t                                            total_aged = 0;
+
+      const auto&    cfg       = _mapped_state->_config;
+      const auto&    seg_data  = _mapped_state->_segment_data;
+      const uint64_t min_freed = uint64_t(cfg.compact_unpinned_unused_threshold_mb) * 1024 * 1024;
+      const int64_t  cutoff =
+          int64_t(*sal::get_current_time_msec()) - int64_t(cfg.cold_tier_age_sec) * 1000;
+
+      const uint32_t end = _block_alloc.num_blocks();
+      auto           cold = [&](uint32_t i)
+      { return _block_alloc.in_tier_file(block_allocator::block_number(i)); };
+
+      // the compactor workers drop entries that no longer qualify
+      refresh_compaction_index();
+      _compact_index.for_each(
+          end,
+          [&](uint32_t i)
+          {
+             const segment_number seg(i);
+             if (not cold(i) or not seg_data.may_compact(seg) or seg_data.is_pinned(seg))
+                return;
+             const uint64_t freed = seg_data.get_freed_space(seg);
+             if (freed >= min_freed)
+                insert_sorted_pair(cold_segments, total_cold, {seg, int64_t(freed)});
+          });
+
+      _aged_index.for_each(
+          end,
+          [&](uint32_t i)
+          {
+             const segment_number seg(i);
+             auto stale = [&] { return cold(i) or not seg_data.may_compact(seg); };
+             if (stale())
+             {
+                // re-check after the erase so a concurrent finalize is not lost
+                _aged_index.erase(i);
+                if (not stale())
+                   _aged_index.insert(i);
+                return;
+             }
+             if (seg_data.is_pinned(seg))
+                return;
+             const int64_t vage = seg_data.get_vage(seg);
+             if (vage != 0 and vage <= cutoff)
+                insert_sorted_pair(aged_segments, total_aged, {seg, -vage});  // oldest first
+          });
+
+      for (uint32_t i = 0; i < total_cold; ++i)
+      {
+         if (thread.get_stop_flag().load(std::memory_order_relaxed))
+            return true;
+         compact_segment(ses, cold_segments[i].first, &thread, cold_tier_worker);
+      }
+      for (uint32_t i = 0; i < total_aged; ++i)
+      {
+         if (thread.get_stop_flag().load(std::memory_order_relaxed))
+            return true;
+         const uint64_t segs  = _cold_tier_stats.segments_compacted.load(std::memory_order_relaxed);
+         const uint64_t bytes = _cold_tier_stats.bytes_relocated.load(std::memory_order_relaxed);
+         compact_segment(ses, aged_segments[i].first, &thread, cold_tier_worker);
+         if (_cold_tier_stats.segments_compacted.load(std::memory_order_relaxed) != segs)
+         {
+            _cold_segments_migrated.fetch_add(1, std::memory_order_relaxed);
+            _cold_bytes_migrated.fetch_add(
+                _cold_tier_stats.bytes_relocated.load(std::memory_order_relaxed) - bytes,
+                std::memory_order_relaxed);
+         }
+      }
+      return total_cold + total_aged > 0;
    }
 
    // called when a segment is being prepared for use by the provider thread
@@ -1802,6 +3243,17 @@ namespace sal
           _mapped_state->_cache_difficulty_state.total_promoted_bytes.load(
               std::memory_order_relaxed);
 
+      result.cache_admission = uint8_t(_mapped_state->_config.cache_admission);
+      for (uint32_t snum = 0; snum < max_session_count; ++snum)
+      {
+         result.cache_sampled_reads +=
+             _read_samples[snum].sampled_reads.load(std::memory_order_relaxed);
+         result.cache_sampled_hits += _read_samples[snum].pinned_hits.load(std::memory_order_relaxed);
+      }
+      result.cache_promotions        = _cache_promotions.load(std::memory_order_relaxed);
+      result.cache_admission_rejects = _cache_admission_rejects.load(std::memory_order_relaxed);
+      result.cache_victim_frequency  = _victim_frequency.load(std::memory_order_relaxed);
+
       // Initialize total non-value nodes counter
       result.total_non_value_nodes = 0;
 
@@ -1824,6 +3276,7 @@ namespace sal
          seg_info.is_finalized  = seg->is_finalized();
          seg_info.is_free       = _mapped_state->_segment_provider.free_segments.test(*i);
          seg_info.bitmap_pinned = _mapped_state->_segment_provider.mlock_segments.test(*i);
+         seg_info.is_cold       = _block_alloc.in_tier_file(block_allocator::block_number(*i));
          seg_info.age =
              seg->_provider_sequence;  // TODO: rename seg_info.age to seg_info.provider_sequence
                                        /*
@@ -1835,6 +3288,13 @@ namespace sal
 
          result.segments.push_back(seg_info);
          result.total_free_space += freed_space;
+         if (not seg_info.is_free)
+         {
+            const uint64_t live =
+                uint64_t(std::max<int64_t>(0, seg_info.alloc_pos - int64_t(freed_space)));
+            (seg_info.is_cold ? result.cold_segments : result.hot_segments) += 1;
+            (seg_info.is_cold ? result.cold_live_bytes : result.hot_live_bytes) += live;
+         }
          //result.total_read_nodes += stats.nodes_with_read_bit;
          //result.total_read_bytes += stats.total_bytes;
       }
@@ -1879,6 +3339,41 @@ namespace sal
       result.free_release_count = _id_alloc.free_release_count();
       */
 
+      if (_leak_reclaimer)
+      {
+         auto& r                         = *_leak_reclaimer;
+         result.leak_reclaim_phase       = leak_reclaimer::phase_name(r.state.load());
+         result.leak_reclaim_marked      = r.marked.load(std::memory_order_relaxed);
+         result.leak_reclaim_freed       = r.freed.load(std::memory_order_relaxed);
+         result.leak_reclaim_freed_bytes = r.freed_bytes.load(std::memory_order_relaxed);
+      }
+
+      // Background durability
+      result.durability_active            = _durability_active.load(std::memory_order_relaxed);
+      result.durability_generation        = _durability_completed.load(std::memory_order_relaxed);
+      result.durability_syncs             = _durability_syncs.load(std::memory_order_relaxed);
+      result.durability_lag_ms            = durability_lag_ms();
+      result.last_durability_sync_us      = _last_durability_sync_us.load(std::memory_order_relaxed);
+      result.durability_deferred_segments = _durability_deferred_count.load(std::memory_order_relaxed);
+
+      {
+         std::lock_guard<std::mutex> lock(_group_mutex);
+         result.group_commit_requests = _group_flushed;
+      }
+      result.group_commit_flushes = _group_flushes.load(std::memory_order_relaxed);
+      result.group_flush_total_us = _group_flush_ns.load(std::memory_order_relaxed) / 1000;
+      result.group_flush_max_us   = _group_flush_max_ns.load(std::memory_order_relaxed) / 1000;
+
+      result.huge_pages_segments = _huge_pages.load(std::memory_order_relaxed);
+      result.huge_pages_control  = _ptr_alloc.huge_pages();
+      result.huge_page_segments  = _huge_page_segments.load(std::memory_order_relaxed);
+
+      result.cold_tier_attached     = _block_alloc.has_tier_file();
+      result.hot_disk_bytes         = _block_alloc.disk_usage();
+      result.cold_disk_bytes        = _block_alloc.disk_usage(true);
+      result.cold_segments_migrated = _cold_segments_migrated.load(std::memory_order_relaxed);
+      result.cold_bytes_migrated    = _cold_bytes_migrated.load(std::memory_order_relaxed);
+
       // Control block stats
       result.control_block_zones    = _ptr_alloc.num_allocated_zones();
       result.control_block_capacity = _ptr_alloc.current_max_address_count();
@@ -1887,6 +3382,31 @@ namespace sal
       result.recycled_queue_depth    = _mapped_state->_read_lock_queue.recycled_queue_depth();
       result.recycled_queue_capacity = _mapped_state->_read_lock_queue.recycled_queue_capacity();
 
+      // Release backlog and per-worker release throughput
+      result.pending_releases       = total_pending_releases();
+      result.release_backlog_age_ms = release_backlog_age_ms();
+      for (uint32_t w = 0; w < _release_workers; ++w)
+      {
+         const auto&                         stats = _release_stats[w];
+         seg_alloc_dump::release_worker_info info;
+         info.worker   = w;
+         info.released = stats.released.load(std::memory_order_relaxed);
+         info.busy_ns  = stats.busy_ns.load(std::memory_order_relaxed);
+         result.release_workers.push_back(info);
+      }
+
+      // Per-worker compactor throughput
+      for (uint32_t w = 0; w < _compactor_workers; ++w)
+      {
+         const auto&                           stats = _compactor_stats[w];
+         seg_alloc_dump::compactor_worker_info info;
+         info.worker             = w;
+         info.segments_compacted = stats.segments_compacted.load(std::memory_order_relaxed);
+         info.bytes_relocated    = stats.bytes_relocated.load(std::memory_order_relaxed);
+         info.busy_ns            = stats.busy_ns.load(std::memory_order_relaxed);
+         result.compactor_workers.push_back(info);
+      }
+
       return result;
    }
 
@@ -1900,23 +3420,66 @@ namespace sal
     */
    void allocator::provider_process_recycled_segments()
    {
-      auto& provider_state = _mapped_state->_segment_provider;
-
       // Process all available recycled segments
       while (auto available = _mapped_state->_read_lock_queue.available_to_pop())
       {
          segment_number segs[available];
          int popped = _mapped_state->_read_lock_queue.pop_recycled_segments(segs, available);
-         // Set the recycled segment in the free_segments bitset and punch
-         // holes to release disk space and commit charge immediately.
+
+         // While a durable snapshot may still refer to the data in these
+         // segments they are held until a snapshot started after now completes
+         uint64_t needed = 0;
+         if (popped > 0)
+         {
+            std::lock_guard<std::mutex> state(_durability_state_mutex);
+            if (_durability_active.load())
+               needed = _durability_started.load() + 1;
+         }
          for (int i = 0; i < popped; ++i)
          {
-            _block_alloc.punch_hole(
-                block_allocator::block_number(*segs[i]));
-            provider_state.free_segments.set(*segs[i]);
-            _mapped_state->_segment_data.added_to_free_segments(segs[i]);
+            if (needed)
+               _durability_deferred.push_back({segs[i], needed});
+            else
+               free_recycled_segment(segs[i]);
          }
       }
+      provider_release_deferred_segments();
+   }
+
+   /**
+    * Set the recycled segment in the free_segments bitset and punch
+    * holes to release disk space and commit charge immediately.
+    */
+   void allocator::free_recycled_segment(segment_number seg)
+   {
+      _block_alloc.punch_hole(block_allocator::block_number(*seg));
+      _mapped_state->_segment_provider.free_segments.set(*seg);
+      _mapped_state->_segment_data.added_to_free_segments(seg);
+   }
+
+   /// frees deferred segments whose snapshot completed, or all of them once
+   /// no durable snapshot needs protecting
+   void allocator::provider_release_deferred_segments()
+   {
+      if (_durability_deferred.empty())
+         return;
+
+      bool     active;
+      uint64_t completed;
+      {
+         std::lock_guard<std::mutex> state(_durability_state_mutex);
+         active    = _durability_active.load();
+         completed = _durability_completed.load();
+      }
+      std::erase_if(_durability_deferred,
+                    [&](const deferred_segment& d)
+                    {
+                       if (active && d.needed > completed)
+                          return false;
+                       free_recycled_segment(d.seg);
+                       return true;
+                    });
+      _durability_deferred_count.store(_durability_deferred.size(), std::memory_order_relaxed);
    }
 
    std::optional<segment_number> allocator::find_first_free_and_pinned_segment()
@@ -1945,6 +3508,7 @@ namespace sal
 
          provider_populate_pinned_segments();
          provider_populate_unpinned_segments();
+         provider_populate_cold_segments();
       }
    }
    void allocator::provider_populate_pinned_segments()
@@ -1991,6 +3555,19 @@ namespace sal
       _mapped_state->_segment_data.added_to_provider_queue(seg_num);
       provider_state.ready_unpinned_segments.push(seg_num);
    }
+   void allocator::provider_populate_cold_segments()
+   {
+      auto& provider_state = _mapped_state->_segment_provider;
+      if (not _block_alloc.has_tier_file() or provider_state.ready_cold_segments.usage() > 1)
+         return;
+
+      segment_number seg_num{provider_state.free_segments.unset_first_set()};
+      if (seg_num == provider_state.free_segments.invalid_index)
+         seg_num = provider_allocate_new_segment();
+      provider_prepare_segment(seg_num, false /* don't pin it*/, true /* cold */);
+      _mapped_state->_segment_data.added_to_provider_queue(seg_num);
+      provider_state.ready_cold_segments.push(seg_num);
+   }
 
    segment_number allocator::provider_allocate_new_segment()
    {
@@ -1998,7 +3575,7 @@ namespace sal
       return segment_number(*block_num);
    }
 
-   void allocator::provider_prepare_segment(segment_number seg_num, bool pin)
+   void allocator::provider_prepare_segment(segment_number seg_num, bool pin, bool cold)
    {
       auto& provider_state = _mapped_state->_segment_provider;
 
@@ -2010,6 +3587,13 @@ namespace sal
       // Update the virtual age in segment metadata to match the segment header's initial value
       disable_segment_write_protection(seg_num);
 
+      // A segment is backed by the cold tier file exactly while it is
+      // handed out for cold data.  The block's old contents are gone either
+      // way; the segment is reinitialized below.
+      if (_block_alloc.has_tier_file() and
+          not _block_alloc.move_block(block_allocator::block_number(*seg_num), cold))
+         SAL_WARN("segment {} stays in the {} tier", *seg_num, cold ? "hot" : "cold");
+
       auto sp = _block_alloc.get<mapped_memory::segment>(block_allocator::block_number(*seg_num));
       // Resolve effective max_count from the (already RLIMIT-capped) config.
       // If 0, mlock would never succeed — skip the attempt entirely.
@@ -2020,9 +3604,12 @@ namespace sal
          // if it is not already mlocked, mlock it
          if (not provider_state.mlock_segments.test(*seg_num))
          {
+            // advise first so mlock faults the segment in as huge pages
+            advise_segment_huge_pages(seg_num, true);
             if (mlock(sp, segment_size) != 0) [[unlikely]]
             {
                SAL_ERROR("mlock error({}) {}", errno, strerror(errno));
+               advise_segment_huge_pages(seg_num, false);
                update_segment_pinned_state(seg_num, false);
             }
             else
@@ -2041,6 +3628,7 @@ namespace sal
             {
                SAL_ERROR("munlock error(", errno, ") ", strerror(errno));
             }
+            advise_segment_huge_pages(seg_num, false);
             update_segment_pinned_state(seg_num, false);
          }
       }
@@ -2105,6 +3693,7 @@ namespace sal
       else
       {
          // Clear both the bitmap and the meta bit using the helper
+         advise_segment_huge_pages(segment_number(oldest_seg), false);
          update_segment_pinned_state(segment_number(oldest_seg), false);
       }
 
@@ -2119,16 +3708,64 @@ namespace sal
          SAL_ERROR("madvise error(", errno, ") ", strerror(errno));
    }
 
+   uint32_t allocator::page_out_unpinned() noexcept
+   {
+#ifdef MADV_PAGEOUT
+      uint32_t advised = 0;
+      for (uint32_t i = 0; i < _block_alloc.num_blocks(); ++i)
+      {
+         if (_mapped_state->_segment_data.is_pinned(segment_number(i)))
+            continue;
+         // reclaim skips dirty file pages, so write them back first
+         auto* seg = get_segment(segment_number(i));
+         ::msync(seg, segment_size, MS_SYNC);
+         // read back a page at a time, as an unpinned segment is, instead of
+         // letting readahead restore the whole segment on the first fault
+         ::madvise(seg, segment_size, MADV_RANDOM);
+         if (madvise(seg, segment_size, MADV_PAGEOUT) == 0)
+            ++advised;
+      }
+      return advised;
+#else
+      return 0;
+#endif
+   }
+
+   void allocator::advise_segment_huge_pages(segment_number seg_num, bool huge) noexcept
+   {
+      if (not _huge_pages.load(std::memory_order_relaxed))
+         return;
+      if (block_allocator::advise_huge_pages(get_segment(seg_num), segment_size, huge))
+      {
+         _huge_page_segments.fetch_add(huge ? 1 : -1, std::memory_order_relaxed);
+         return;
+      }
+      if (_huge_pages.exchange(false, std::memory_order_relaxed))
+         SAL_WARN("huge pages unavailable for pinned segments ({}), using normal pages",
+                  strerror(errno));
+   }
+
    void allocator::start_background_threads()
    {
       stop_background_threads();
 
+      // recovery may have rebuilt freed space without going through the index
+      _compact_index.invalidate();
+
+      _compactor_workers = std::clamp<uint32_t>(_mapped_state->_config.compactor_threads, 1,
+                                                max_compactor_threads);
+
       // Initialize and start all threads after _mapped_state is set
       _compactor_thread.emplace(&_mapped_state->compact_thread_state, "compactor",
-                                [this](segment_thread& thread) { compactor_loop(thread); });
+                                [this](segment_thread& thread) { compactor_loop(thread, 0); });
+
+      _release_workers = std::clamp<uint32_t>(_mapped_state->_config.release_threads, 1,
+                                              max_release_threads);
+      _release_worker_sessions.store(0);
+      _release_workers_ready.store(0);
 
       _release_thread.emplace(&_mapped_state->release_thread_state, "release",
-                              [this](segment_thread& thread) { release_loop(thread); });
+                              [this](segment_thread& thread) { release_loop(thread, 0); });
 
       _read_bit_decay_thread.emplace(&_mapped_state->read_bit_decay_thread_state, "read_bit_decay",
                                      [this](segment_thread& thread)
@@ -2139,26 +3776,117 @@ namespace sal
                                        [this](segment_thread& thread) { provider_loop(thread); });
 
       _read_bit_decay_thread->start();
-      _release_thread->start();
-      _compactor_thread->start();
+
+      // helpers shard the release queues with worker 0, so they only run in
+      // the process that won ownership of the release thread
+      if (_release_thread->start())
+      {
+         for (uint32_t w = 1; w < _release_workers; ++w)
+         {
+            auto& helper = _release_helpers[w - 1];
+            helper.emplace(&_release_helper_states[w - 1], "release" + std::to_string(w),
+                           [this, w](segment_thread& thread) { release_loop(thread, w); });
+            helper->start();
+         }
+      }
+
+      // helpers partition the segment space with worker 0, so they only run
+      // in the process that won ownership of the compactor
+      if (_compactor_thread->start())
+      {
+         for (uint32_t w = 1; w < _compactor_workers; ++w)
+         {
+            auto& helper = _compactor_helpers[w - 1];
+            helper.emplace(&_compactor_helper_states[w - 1], "compactor" + std::to_string(w),
+                           [this, w](segment_thread& thread) { compactor_loop(thread, w); });
+            helper->start();
+         }
+         if (_block_alloc.has_tier_file())
+         {
+            _cold_tier_thread.emplace(&_cold_tier_thread_state, "cold_tier",
+                                      [this](segment_thread& thread) { cold_tier_loop(thread); });
+            _cold_tier_thread->start();
+         }
+      }
       _segment_provider_thread->start();
+
+      if (_mapped_state->_config.sync_mode == sync_type::background_full)
+      {
+         _durability_thread.emplace(&_durability_thread_state, "durability",
+                                    [this](segment_thread& thread) { durability_loop(thread); });
+         _durability_thread->start();
+         _background_durability.store(true);
+      }
+      else if (find_durable_snapshot())
+      {
+         // Left by an earlier background_full run and no longer needed by
+         // recovery.  A stale snapshot would make every synchronous commit
+         // refresh it and hold back recycled segments, see sync().
+         std::lock_guard<std::mutex> lock(_durability_mutex);
+         invalidate_durable_snapshot_locked();
+      }
+
+      if (leak_reclamation_active())
+      {
+         _leak_reclaim_thread.emplace(&_leak_reclaim_thread_state, "leak_reclaim",
+                                      [this](segment_thread& thread)
+                                      { leak_reclaim_loop(thread); });
+         _leak_reclaim_thread->start();
+      }
    }
 
    void allocator::stop_background_threads()
    {
       // Stop all threads
+      // The leak reclaimer queues releases, so stop it before the release workers
+      if (_leak_reclaim_thread)
+      {
+         _leak_reclaim_thread->stop();
+         _leak_reclaim_thread.reset();
+      }
+
       if (_read_bit_decay_thread)
       {
          _read_bit_decay_thread->stop();
          _read_bit_decay_thread.reset();
       }
 
-      // Stop release thread before compactor so pending releases drain first
+      // Stop release workers before compactor so pending releases drain first
+      for (auto& helper : _release_helpers)
+      {
+         if (helper)
+         {
+            helper->stop();
+            helper.reset();
+         }
+      }
       if (_release_thread)
       {
          _release_thread->stop();
          _release_thread.reset();
       }
+      {
+         // stopped workers hold nothing in flight; wake anyone waiting on them
+         std::lock_guard<std::mutex> lock(_release_idle_mutex);
+         for (auto& stats : _release_stats)
+            stats.idle.store(true);
+         _release_idle_cv.notify_all();
+      }
+
+      if (_cold_tier_thread)
+      {
+         _cold_tier_thread->stop();
+         _cold_tier_thread.reset();
+      }
+
+      for (auto& helper : _compactor_helpers)
+      {
+         if (helper)
+         {
+            helper->stop();
+            helper.reset();
+         }
+      }
 
       if (_compactor_thread)
       {
@@ -2172,6 +3900,16 @@ namespace sal
          _segment_provider_thread->stop();
          _segment_provider_thread.reset();
       }
+
+      // Stopped after the provider so that its final snapshot is newer than
+      // every segment the provider deferred, which can then all be freed.
+      if (_durability_thread)
+      {
+         _background_durability.store(false);
+         _durability_thread->stop();
+         _durability_thread.reset();
+      }
+      provider_release_deferred_segments();
    }
    void allocator::set_runtime_config(const runtime_config& cfg)
    {
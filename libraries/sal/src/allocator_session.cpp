@@ -5,6 +5,7 @@
 #include <sal/mapped_memory/segment_impl.hpp>
 #include <sal/time.hpp>
 #include <ucc/round.hpp>
+#include <algorithm>
 #include <chrono>
 
 namespace sal
@@ -55,7 +56,7 @@ namespace sal
    {
       auto t0 = std::chrono::steady_clock::now();
 
-      auto [num, ptr] = _sega.get_new_segment(_alloc_to_pinned);
+      auto [num, ptr] = _sega.get_new_segment(_alloc_to_pinned, _alloc_to_cold);
       _alloc_seg_num  = num;
       _alloc_seg_ptr  = ptr;
 
@@ -96,6 +97,31 @@ namespace sal
 
    void allocator_session::sync(sync_type st, const runtime_config& cfg, std::span<char> user_data)
    {
+      // background_full commits protect pages like mprotect; the allocator's
+      // durability thread does the flushing
+      if (st == sync_type::background_full)
+         st = sync_type::mprotect;
+
+      // Durable modes leave the flush to the allocator's group commit, which
+      // shares it with concurrent committers; the segments only protect and
+      // report the pages they wrote.
+      const bool      grouped = st >= sync_type::msync_sync;
+      const sync_type seg_st  = grouped ? sync_type::mprotect : st;
+      _sync_ranges.clear();
+      auto note_range = [&](mapped_memory::segment* seg, uint32_t from)
+      {
+         if (not grouped)
+            return;
+         const uint32_t page  = system_config::os_page_size();
+         const uint32_t begin = from & ~(page - 1);
+         const uint32_t end   = std::min<uint32_t>(
+             ucc::round_up_multiple<uint32_t>(
+                 std::max(seg->get_alloc_pos(), seg->get_first_write_pos()), page),
+             segment_size);
+         if (end > begin)
+            _sync_ranges.push_back({seg->data + begin, end - begin});
+      };
+
       // Sync the active segment to advance _first_writable_page past all
       // committed data. Without this, is_read_only() returns false for
       // objects in the current segment even after transaction commit.
@@ -104,8 +130,10 @@ namespace sal
            !user_data.empty()))
       {
          auto pos_before = _alloc_seg_ptr->get_alloc_pos();
+         auto dirty_from = std::min(pos_before, _alloc_seg_ptr->get_first_write_pos());
          _sega.record_session_write(_session_num,
-                                    _alloc_seg_ptr->sync(st, cfg, user_data));
+                                    _alloc_seg_ptr->sync(seg_st, cfg, user_data));
+         note_range(_alloc_seg_ptr, dirty_from);
          // Count sync header padding as reclaimable space so the compactor
          // knows segments filled with many small commits are mostly free.
          auto sync_hdr_size = _alloc_seg_ptr->get_alloc_pos() - pos_before;
@@ -115,6 +143,7 @@ namespace sal
              _alloc_seg_ptr->data + pos_before,
              sync_hdr_size,
              "active_sync_padding");
+         _sega.update_compaction_index(_alloc_seg_num);
       }
 
       // Process finalized dirty segments
@@ -136,8 +165,11 @@ namespace sal
          const bool was_partial_finalized =
              seg->is_finalized() and not seg->is_read_only();
 
-         const auto bytes_synced = seg->sync(st, cfg, user_data);
+         const uint32_t dirty_from   = std::min(pos_before, seg->get_first_write_pos());
+         const auto     bytes_synced = seg->sync(seg_st, cfg, user_data);
          _sega.record_session_write(_session_num, bytes_synced);
+         if (bytes_synced > 0)
+            note_range(seg, dirty_from);
 
          // Only attribute last_aheader to freed_space when sync() actually
          // wrote a new sync_header in *this* drain pass. The natural-fill
@@ -175,15 +207,20 @@ namespace sal
                    seg->data + tail_start,
                    tail,
                    "drain_fall_through_tail");
+               _sega.update_compaction_index(seg_num);
             }
          }
 
          assert(seg->is_finalized() ? seg->is_read_only() : true);
          if (seg->is_read_only())
+         {
             _sega._mapped_state->_segment_data.prepare_for_compaction(
                 seg_num, seg->age_accumulator.average());
+            _sega.update_compaction_index(seg_num);
+            _sega.update_aged_index(seg_num);
+         }
          seg_num = _dirty_segments.pop();
       }
-      _sega.sync(st);
+      _sega.sync(st, _sync_ranges);
    }
 }  // namespace sal
@@ -136,13 +136,18 @@ namespace sal
       // Reserve the maximum virtual address space early to ensure contiguity
       uint64_t max_potential_size = static_cast<uint64_t>(max_blocks) * block_size;
 
+      // Blocks that span whole huge pages get a huge-page aligned base so that
+      // every block can be mapped with PMD entries when huge pages are enabled.
+      const uint64_t align_slack =
+          block_size % system_config::huge_page_size == 0 ? system_config::huge_page_size : 0;
+
       while (max_potential_size > 0)
       {
          // Try to reserve the entire potential address space without mapping files
          _reserved_base =
-             ::mmap(nullptr,                      // Let the system choose the address
-                    max_potential_size,           // Reserve enough space for all potential blocks
-                    PROT_NONE,                    // No access permissions initially
+             ::mmap(nullptr,                           // Let the system choose the address
+                    max_potential_size + align_slack,  // Reserve enough space for all potential blocks
+                    PROT_NONE,                         // No access permissions initially
                     MAP_PRIVATE | MAP_ANONYMOUS,  // Private anonymous mapping (not backed by file)
                     -1,                           // No file descriptor for anonymous mapping
                     0                             // No offset
@@ -150,6 +155,17 @@ namespace sal
 
          if (_reserved_base != MAP_FAILED)
          {
+            if (align_slack)
+            {
+               auto base    = reinterpret_cast<uintptr_t>(_reserved_base);
+               auto aligned = (base + align_slack - 1) & ~uintptr_t(align_slack - 1);
+               if (aligned != base)
+                  ::munmap(_reserved_base, aligned - base);
+               if (align_slack - (aligned - base))
+                  ::munmap(reinterpret_cast<char*>(aligned) + max_potential_size,
+                           align_slack - (aligned - base));
+               _reserved_base = reinterpret_cast<void*>(aligned);
+            }
             _reservation_size = max_potential_size;
             SAL_INFO("Reserved contiguous address space:  size={}", _reservation_size);
             break;
@@ -302,6 +318,8 @@ namespace sal
 
          ::close(_fd);
       }
+      if (_tier_fd >= 0)
+         ::close(_tier_fd);
 
       // Release the reserved address space if we had one
       if (_reserved_base && _reserved_base != MAP_FAILED && _reservation_size > 0)
@@ -332,6 +350,11 @@ namespace sal
             SAL_ERROR("Failed to fsync file: {}", strerror(errno));
             return false;
          }
+         if (_tier_fd >= 0 && ::fsync(_tier_fd) < 0)
+         {
+            SAL_ERROR("Failed to fsync tier file: {}", strerror(errno));
+            return false;
+         }
          return true;
       }
       return false;
@@ -395,6 +418,10 @@ namespace sal
 
       if (addr != MAP_FAILED)
       {
+         // advise before mlock faults the range in, so it can fault in as huge pages
+         if (_huge_pages.load(std::memory_order_relaxed))
+            advise_mapped_huge_pages(addr, map_size);
+
          if (mlock)
          {
             // Use the cached RLIMIT_MEMLOCK (no syscall on hot path).
@@ -574,6 +601,22 @@ namespace sal
       _file_size = new_size;
       _num_blocks.store(nblocks, std::memory_order_release);
 
+      // Drop the truncated blocks from the tier file as well
+      if (_tier_fd >= 0)
+      {
+         for (uint64_t b = nblocks; b * _block_size < _tier_file_size; ++b)
+            if (_tier_bits[b / 64].fetch_and(~(1ull << (b % 64)), std::memory_order_relaxed) &
+                (1ull << (b % 64)))
+               _tier_blocks.fetch_sub(1, std::memory_order_relaxed);
+         if (_tier_file_size > new_size)
+         {
+            if (::ftruncate(_tier_fd, new_size) == 0)
+               _tier_file_size = new_size;
+            else
+               SAL_WARN("Failed to truncate tier file: {}", strerror(errno));
+         }
+      }
+
       // Restore the protection on the released virtual address space
       if (_reserved_base && _reservation_size > 0)
       {
@@ -598,19 +641,72 @@ namespace sal
       sal_debug("Truncated file to {} blocks ({} bytes)", nblocks, new_size);
    }
 
+   bool block_allocator::advise_huge_pages(void* addr, uint64_t size, bool huge) noexcept
+   {
+#ifdef MADV_HUGEPAGE
+      return ::madvise(addr, size, huge ? MADV_HUGEPAGE : MADV_NOHUGEPAGE) == 0;
+#else
+      (void)addr;
+      (void)size;
+      (void)huge;
+      errno = ENOTSUP;
+      return false;
+#endif
+   }
+
+   bool block_allocator::enable_huge_pages() noexcept
+   {
+      std::lock_guard l{_resize_mutex};
+      _huge_pages.store(true, std::memory_order_relaxed);
+      if (auto size = _file_size.load(std::memory_order_relaxed))
+         advise_mapped_huge_pages(_mapped_base, size);
+      return _huge_pages.load(std::memory_order_relaxed);
+   }
+
+   void block_allocator::advise_mapped_huge_pages(void* addr, uint64_t size) noexcept
+   {
+      if (advise_huge_pages(addr, size))
+         return;
+      SAL_WARN("huge pages unavailable for {} ({}), using normal pages", _filename.native(),
+               strerror(errno));
+      _huge_pages.store(false, std::memory_order_relaxed);
+   }
+
    bool block_allocator::punch_hole(block_number block, uint32_t count) noexcept
    {
 #ifdef __linux__
       if (!_fd || count == 0)
          return false;
 
-      off_t  offset = static_cast<off_t>(*block) * _block_size;
-      off_t  len    = static_cast<off_t>(count) * _block_size;
+      if (_tier_fd < 0)
+         return punch_range(_fd, static_cast<off_t>(*block) * _block_size,
+                            static_cast<off_t>(count) * _block_size);
+
+      // each block is punched in whichever file backs it
+      bool ok = true;
+      for (uint32_t i = 0; i < count; ++i)
+      {
+         block_number b(*block + i);
+         ok &= punch_range(in_tier_file(b) ? _tier_fd : _fd,
+                           static_cast<off_t>(*b) * _block_size, _block_size);
+      }
+      return ok;
+#else
+      (void)block;
+      (void)count;
+      return false;
+#endif
+   }
 
+   bool block_allocator::punch_range([[maybe_unused]] int   fd,
+                                     [[maybe_unused]] off_t offset,
+                                     [[maybe_unused]] off_t len) noexcept
+   {
+#ifdef __linux__
       // FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE deallocates the disk
       // blocks backing [offset, offset+len) without changing file size.
       // The virtual mapping stays valid; reads return zeroes.
-      if (::fallocate(_fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, offset, len) == 0)
+      if (::fallocate(fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, offset, len) == 0)
       {
          // Also tell the kernel to drop the page cache for this range
          void* addr = static_cast<char*>(_mapped_base) + offset;
@@ -619,12 +715,166 @@ namespace sal
       }
 
       // EOPNOTSUPP on filesystems that don't support hole punching (e.g. tmpfs)
-      sal_debug("fallocate PUNCH_HOLE failed for block {}: {}", *block, strerror(errno));
+      sal_debug("fallocate PUNCH_HOLE failed at offset {}: {}", offset, strerror(errno));
+#endif
       return false;
+   }
+
+   bool block_allocator::map_block_from(int fd, uint64_t block) noexcept
+   {
+      off_t offset = static_cast<off_t>(block) * _block_size;
+      void* addr   = static_cast<char*>(_reserved_base) + offset;
+      if (::mmap(addr, _block_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED | MAP_NORESERVE,
+                 fd, offset) == MAP_FAILED)
+      {
+         SAL_ERROR("Failed to map block {} from {}: {}", block,
+                   fd == _tier_fd ? _tier_filename.native() : _filename.native(), strerror(errno));
+         return false;
+      }
+      if (_huge_pages.load(std::memory_order_relaxed))
+         advise_mapped_huge_pages(addr, _block_size);
+      return true;
+   }
+
+   void block_allocator::attach_tier_file(std::filesystem::path file)
+   {
+#ifdef __linux__
+      std::lock_guard l{_resize_mutex};
+      if (_tier_fd >= 0)
+         throw std::runtime_error("block_allocator: a tier file is already attached");
+
+      int fd = ::open(file.native().c_str(), O_CLOEXEC | O_RDWR | O_CREAT, 0644);
+      if (fd == -1)
+         throw std::system_error(errno, std::generic_category(),
+                                 "unable to open tier file " + file.native());
+      auto fail = [&](const std::string& what)
+      {
+         int err = errno;
+         ::close(fd);
+         throw std::system_error(err, std::generic_category(), what + " " + file.native());
+      };
+      if (::flock(fd, LOCK_EX | LOCK_NB) != 0)
+         fail("unable to lock tier file");
+
+      struct stat st;
+      if (::fstat(fd, &st) != 0)
+         fail("unable to stat tier file");
+
+      // The extents record which file backs each block, so both files must
+      // be able to give a block's range back.  Probe past the end of the
+      // tier file, where punching changes nothing.
+      uint64_t probe = (uint64_t(st.st_size) + _block_size - 1) / _block_size * _block_size;
+      if (::fallocate(fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, probe, _block_size) != 0)
+         fail("tier file filesystem cannot punch holes:");
+
+      _tier_bits      = std::make_unique<std::atomic<uint64_t>[]>((_max_blocks + 63) / 64);
+      _tier_fd        = fd;
+      _tier_filename  = std::move(file);
+      _tier_file_size = st.st_size;
+
+      // Every block with data in the tier file was moved there; map it over
+      // the primary mapping.  Data past the mapped blocks belongs to blocks
+      // truncated away while the tier file was not attached.
+      const uint64_t mapped = _file_size.load(std::memory_order_relaxed) / _block_size;
+      off_t          pos    = 0;
+      while (pos < st.st_size)
+      {
+         off_t data = ::lseek(fd, pos, SEEK_DATA);
+         if (data < 0)
+            break;  // ENXIO: no data past pos
+         off_t hole = ::lseek(fd, data, SEEK_HOLE);
+         if (hole < 0)
+            hole = st.st_size;
+
+         uint64_t b = data / _block_size;
+         for (; b * _block_size < uint64_t(hole) && b < mapped; ++b)
+         {
+            if (!map_block_from(fd, b))
+               throw std::runtime_error("unable to map block from tier file " +
+                                        _tier_filename.native());
+            _tier_bits[b / 64].fetch_or(1ull << (b % 64), std::memory_order_relaxed);
+            _tier_blocks.fetch_add(1, std::memory_order_relaxed);
+         }
+         if (b >= mapped)
+         {
+            if (b * _block_size < uint64_t(hole))
+               SAL_WARN("tier file {} holds data past the {} mapped blocks, ignoring it",
+                        _tier_filename.native(), mapped);
+            break;
+         }
+         pos = b * _block_size;
+      }
+#else
+      throw std::runtime_error("block_allocator: tier files require hole punching (Linux only): " +
+                               file.native());
+#endif
+   }
+
+   bool block_allocator::move_block(block_number block, bool to_tier) noexcept
+   {
+#ifdef __linux__
+      std::lock_guard l{_resize_mutex};
+      if (_tier_fd < 0)
+         return !to_tier;
+      if (in_tier_file(block) == to_tier)
+         return true;
+
+      const uint64_t b      = *block;
+      const off_t    offset = static_cast<off_t>(b) * _block_size;
+      if (to_tier && _tier_file_size < uint64_t(offset) + _block_size)
+      {
+         if (::ftruncate(_tier_fd, offset + _block_size) != 0)
+         {
+            SAL_ERROR("Failed to grow tier file {}: {}", _tier_filename.native(), strerror(errno));
+            return false;
+         }
+         _tier_file_size = offset + _block_size;
+      }
+
+      const int to_fd   = to_tier ? _tier_fd : _fd;
+      const int from_fd = to_tier ? _fd : _tier_fd;
+      if (!map_block_from(to_fd, b))
+      {
+         map_block_from(from_fd, b);
+         return false;
+      }
+
+      // The file a block leaves must not keep data in its range, or the
+      // next attach_tier_file() would map it from the wrong file.
+      if (::fallocate(from_fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, offset, _block_size) !=
+          0)
+      {
+         SAL_ERROR("Failed to punch block {} out of {}: {}", b,
+                   to_tier ? _filename.native() : _tier_filename.native(), strerror(errno));
+         map_block_from(from_fd, b);
+         return false;
+      }
+
+      if (to_tier)
+      {
+         _tier_bits[b / 64].fetch_or(1ull << (b % 64), std::memory_order_relaxed);
+         _tier_blocks.fetch_add(1, std::memory_order_relaxed);
+      }
+      else
+      {
+         _tier_bits[b / 64].fetch_and(~(1ull << (b % 64)), std::memory_order_relaxed);
+         _tier_blocks.fetch_sub(1, std::memory_order_relaxed);
+      }
+      return true;
 #else
       (void)block;
-      (void)count;
-      return false;
+      return !to_tier;
 #endif
    }
+
+   uint64_t block_allocator::disk_usage(bool tier) const noexcept
+   {
+      int fd = tier ? _tier_fd : _fd;
+      if (fd < 0)
+         return 0;
+      struct stat st;
+      if (::fstat(fd, &st) != 0)
+         return 0;
+      return uint64_t(st.st_blocks) * 512;
+   }
 }  // namespace sal
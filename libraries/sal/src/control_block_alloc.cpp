@@ -6,7 +6,8 @@
 
 namespace sal
 {
-   control_block_alloc::control_block_alloc(const std::filesystem::path& dir) : _dir(dir)
+   control_block_alloc::control_block_alloc(const std::filesystem::path& dir, bool huge_pages)
+       : _dir(dir)
    {
       std::filesystem::create_directories(dir);
       _dir    = dir;
@@ -28,6 +29,13 @@ namespace sal
           dir / "free_list.bin", detail::ptrs_per_zone / 8, detail::max_allocated_zones);
 
       SAL_ERROR("free_list.bit blocksize: {}", detail::ptrs_per_zone / 8);
+      if (huge_pages)
+      {
+         // every retain/release lands on a random control block, so the zones
+         // are where huge pages save the most TLB misses
+         _zone_allocator->enable_huge_pages();
+         _zone_free_list->enable_huge_pages();
+      }
       //   _zone_free_list->reserve(1, true);
       //   _zone_allocator->reserve(1, true);
       ensure_capacity(1);
@@ -201,7 +201,8 @@ namespace sal
 
    void mapping::sync(sync_type st) noexcept
    {
-      if (st <= sync_type::mprotect)
+      // background_full is flushed by the allocator's durability thread
+      if (st <= sync_type::mprotect || st == sync_type::background_full)
          return;
       if (st == sync_type::msync_async)
       {
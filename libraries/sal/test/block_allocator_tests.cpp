@@ -460,4 +460,88 @@ TEST_CASE("Block allocator truncate operations", "[block_allocator]")
 
    // Clean up
    fs::remove(temp_path);
-}
\ No newline at end of file
+}
+TEST_CASE("Block allocator huge page backing", "[block_allocator]")
+{
+   fs::path temp_path = fs::temp_directory_path() / "sal_test_huge_pages.dat";
+   fs::remove(temp_path);
+
+   {
+      sal::block_allocator alloc(temp_path, BLOCK_SIZE, MAX_BLOCKS);
+      alloc.reserve(1);
+      auto [first, first_offset] = alloc.alloc();
+
+      // blocks spanning whole huge pages start on a huge page boundary
+      auto* base = alloc.get<char>(first_offset);
+      CHECK(reinterpret_cast<uintptr_t>(base) % sal::system_config::huge_page_size == 0);
+      base[0] = 'a';
+
+      // whether the kernel accepts the advice depends on THP and the filesystem;
+      // either way the blocks must stay usable
+      bool enabled = alloc.enable_huge_pages();
+      CHECK(alloc.huge_pages() == enabled);
+
+      alloc.reserve(3);
+      auto [second, second_offset] = alloc.alloc();
+      auto* next                   = alloc.get<char>(second_offset);
+      next[BLOCK_SIZE - 1]         = 'b';
+      CHECK(base[0] == 'a');
+      CHECK(next[BLOCK_SIZE - 1] == 'b');
+      CHECK(alloc.huge_pages() == enabled);
+   }
+
+   fs::remove(temp_path);
+}
+
+TEST_CASE("Block allocator tier file", "[block_allocator]")
+{
+   fs::path temp_path = fs::temp_directory_path() / "sal_test_tier_primary.dat";
+   fs::path tier_path = fs::temp_directory_path() / "sal_test_tier_cold.dat";
+   fs::remove(temp_path);
+   fs::remove(tier_path);
+
+   {
+      sal::block_allocator alloc(temp_path, BLOCK_SIZE, MAX_BLOCKS);
+      alloc.attach_tier_file(tier_path);
+      REQUIRE(alloc.has_tier_file());
+
+      alloc.reserve(3);
+      auto [hot, hot_offset]   = alloc.alloc();
+      auto [cold, cold_offset] = alloc.alloc();
+      CHECK_FALSE(alloc.in_tier_file(cold));
+
+      // the block keeps its address when it moves, only its contents go
+      auto* cold_ptr = alloc.get<char>(cold_offset);
+      REQUIRE(alloc.move_block(cold, true));
+      CHECK(alloc.in_tier_file(cold));
+      CHECK(alloc.tier_blocks() == 1);
+      CHECK(alloc.get<char>(cold_offset) == cold_ptr);
+
+      alloc.get<char>(hot_offset)[0] = 'h';
+      cold_ptr[0]                    = 'c';
+      cold_ptr[BLOCK_SIZE - 1]       = 'd';
+      CHECK(alloc.fsync());
+      CHECK(alloc.disk_usage(true) >= 2 * sal::system_config::os_page_size());
+   }
+
+   {
+      // reattaching maps the block from the tier file again
+      sal::block_allocator alloc(temp_path, BLOCK_SIZE, MAX_BLOCKS);
+      alloc.attach_tier_file(tier_path);
+      CHECK(alloc.tier_blocks() == 1);
+      CHECK_FALSE(alloc.in_tier_file(sal::block_allocator::block_number(0)));
+      CHECK(alloc.in_tier_file(sal::block_allocator::block_number(1)));
+      CHECK(alloc.get(sal::block_allocator::block_number(0))[0] == 'h');
+      auto* cold_ptr = alloc.get(sal::block_allocator::block_number(1));
+      CHECK(cold_ptr[0] == 'c');
+      CHECK(cold_ptr[BLOCK_SIZE - 1] == 'd');
+
+      // moving back punches the tier file
+      REQUIRE(alloc.move_block(sal::block_allocator::block_number(1), false));
+      CHECK(alloc.tier_blocks() == 0);
+      CHECK(alloc.disk_usage(true) == 0);
+   }
+
+   fs::remove(temp_path);
+   fs::remove(tier_path);
+}
@@ -0,0 +1,109 @@
+#include <algorithm>
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <sal/compaction_index.hpp>
+
+namespace
+{
+   constexpr uint64_t test_bits = 64 * 4096;
+   using index_type             = sal::compaction_index<test_bits>;
+
+   std::vector<uint32_t> collect(index_type& idx, uint64_t end = test_bits)
+   {
+      std::vector<uint32_t> out;
+      idx.for_each(end, [&](uint32_t seg) { out.push_back(seg); });
+      return out;
+   }
+}  // namespace
+
+TEST_CASE("compaction_index ignores updates until built", "[compaction_index]")
+{
+   auto idx = std::make_unique<index_type>();
+   idx->update(5, 1u << 30);
+   CHECK(collect(*idx).empty());
+
+   std::vector<uint32_t> freed(1000, 0);
+   freed[7]   = 100;
+   freed[900] = 50;
+   REQUIRE(idx->rebuild(60, freed.size(), [&](uint32_t s) { return freed[s]; }));
+   CHECK_FALSE(idx->rebuild(60, freed.size(), [&](uint32_t s) { return freed[s]; }));
+   CHECK(collect(*idx) == std::vector<uint32_t>{7});
+
+   idx->update(900, 59);
+   CHECK(idx->count() == 1);
+   idx->update(900, 60);
+   CHECK(collect(*idx) == std::vector<uint32_t>{7, 900});
+}
+
+TEST_CASE("compaction_index visits candidates in order across summary words",
+          "[compaction_index]")
+{
+   auto idx = std::make_unique<index_type>();
+   idx->rebuild(1, 0, [](uint32_t) { return 0u; });
+
+   std::mt19937         rng(42);
+   std::set<uint32_t>   expected;
+   for (int i = 0; i < 5000; ++i)
+   {
+      uint32_t seg = rng() % test_bits;
+      expected.insert(seg);
+      idx->insert(seg);
+   }
+   auto got = collect(*idx);
+   CHECK(got == std::vector<uint32_t>(expected.begin(), expected.end()));
+   CHECK(idx->count() == expected.size());
+
+   // end bounds the walk
+   uint32_t bound = 100000;
+   auto     below = collect(*idx, bound);
+   CHECK(below == std::vector<uint32_t>(expected.begin(), expected.lower_bound(bound)));
+
+   // erase everything and make sure empty words are skipped and re-fillable
+   for (auto seg : expected)
+      idx->erase(seg);
+   CHECK(collect(*idx).empty());
+   idx->insert(4095);
+   idx->insert(4096);
+   CHECK(collect(*idx) == std::vector<uint32_t>{4095, 4096});
+}
+
+TEST_CASE("compaction_index keeps concurrent inserts", "[compaction_index]")
+{
+   auto idx = std::make_unique<index_type>();
+   idx->rebuild(1, 0, [](uint32_t) { return 0u; });
+
+   constexpr uint32_t       threads = 4;
+   constexpr uint32_t       per     = 20000;
+   std::vector<std::thread> writers;
+   for (uint32_t t = 0; t < threads; ++t)
+      writers.emplace_back(
+          [&, t]
+          {
+             for (uint32_t i = 0; i < per; ++i)
+                idx->update((i * threads + t) % test_bits, 1);
+          });
+
+   // a concurrent walker that prunes empty words must not lose inserts
+   std::atomic<bool> done{false};
+   std::thread       walker(
+       [&]
+       {
+          while (not done.load())
+             idx->for_each(test_bits, [](uint32_t) {});
+       });
+
+   for (auto& w : writers)
+      w.join();
+   done = true;
+   walker.join();
+
+   CHECK(idx->count() == std::min<uint64_t>(threads * per, test_bits));
+   CHECK(collect(*idx).size() == idx->count());
+}
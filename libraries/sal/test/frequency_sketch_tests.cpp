@@ -0,0 +1,63 @@
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <random>
+
+#include <sal/frequency_sketch.hpp>
+
+TEST_CASE("frequency_sketch counts and saturates", "[frequency_sketch]")
+{
+   sal::frequency_sketch sketch(1024);
+   CHECK(sketch.capacity() == 1024);
+   CHECK(sketch.frequency(42) == 0);
+
+   for (int i = 0; i < 5; ++i)
+      sketch.increment(42);
+   CHECK(sketch.frequency(42) == 5);
+
+   for (int i = 0; i < 100; ++i)
+      sketch.increment(42);
+   CHECK(sketch.frequency(42) == sal::frequency_sketch::max_frequency);
+}
+
+TEST_CASE("frequency_sketch separates hot keys from a scan", "[frequency_sketch]")
+{
+   sal::frequency_sketch sketch(4096);
+   std::mt19937_64       rng(7);
+
+   // a few hot keys read repeatedly, interleaved with a scan of keys read once
+   for (uint64_t round = 0; round < 8; ++round)
+   {
+      for (uint64_t hot = 0; hot < 64; ++hot)
+         sketch.increment(hot);
+      for (int i = 0; i < 1000; ++i)
+         sketch.increment(1'000'000 + rng());
+   }
+
+   uint32_t min_hot = sal::frequency_sketch::max_frequency;
+   for (uint64_t hot = 0; hot < 64; ++hot)
+      min_hot = std::min(min_hot, sketch.frequency(hot));
+
+   uint32_t scanned_over_hot = 0;
+   for (int i = 0; i < 1000; ++i)
+      scanned_over_hot += sketch.frequency(1'000'000 + rng()) >= min_hot;
+
+   CHECK(min_hot >= 4);
+   CHECK(scanned_over_hot < 10);
+}
+
+TEST_CASE("frequency_sketch ages counters", "[frequency_sketch]")
+{
+   sal::frequency_sketch sketch(64);
+   for (int i = 0; i < 12; ++i)
+      sketch.increment(1);
+   CHECK(sketch.frequency(1) == 12);
+
+   // fill the sample with other keys until the sketch halves its counters
+   uint64_t key  = 2;
+   uint64_t prev = sketch.additions();
+   for (sketch.increment(key++); sketch.additions() >= prev; sketch.increment(key++))
+      prev = sketch.additions();
+   CHECK(sketch.frequency(1) <= 7);
+   CHECK(sketch.additions() < sketch.sample_size());
+}
@@ -0,0 +1,124 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+/**
+ * TLB miss counters and huge page residency for benchmark programs.
+ *
+ * Usage:
+ *   bench::tlb_counters tlb;   // starts counting this thread
+ *   run_lookups();
+ *   tlb.print(ops);            // dTLB loads/misses per op, or n/a
+ *   bench::print_huge_page_residency();
+ *
+ * Counts user-space dTLB loads and misses of the calling thread via
+ * perf_event_open.  When the counters are unavailable (non-Linux, VMs
+ * without a PMU, or perf_event_paranoid > 2) print() says so and the
+ * benchmark runs unchanged.
+ */
+
+namespace bench
+{
+   class tlb_counters
+   {
+     public:
+      tlb_counters()
+      {
+#ifdef __linux__
+         _loads  = open_counter(PERF_COUNT_HW_CACHE_RESULT_ACCESS);
+         _misses = open_counter(PERF_COUNT_HW_CACHE_RESULT_MISS);
+         for (int fd : {_loads, _misses})
+            if (fd >= 0)
+            {
+               ::ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+               ::ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+#endif
+      }
+      ~tlb_counters()
+      {
+         for (int fd : {_loads, _misses})
+            if (fd >= 0)
+               ::close(fd);
+      }
+      tlb_counters(const tlb_counters&)            = delete;
+      tlb_counters& operator=(const tlb_counters&) = delete;
+
+      bool     available() const { return _misses >= 0; }
+      uint64_t loads() const { return read_counter(_loads); }
+      uint64_t misses() const { return read_counter(_misses); }
+
+      void print(uint64_t ops) const
+      {
+         if (!available() || ops == 0)
+         {
+            std::printf("  dTLB: n/a (perf counters unavailable)\n");
+            return;
+         }
+         uint64_t l = loads(), m = misses();
+         std::printf("  dTLB misses: %.3f/op", double(m) / ops);
+         if (_loads >= 0 && l)
+            std::printf("  miss rate: %.4f%%", 100.0 * m / l);
+         std::printf("\n");
+      }
+
+     private:
+#ifdef __linux__
+      static int open_counter(uint64_t result)
+      {
+         perf_event_attr attr;
+         std::memset(&attr, 0, sizeof(attr));
+         attr.size           = sizeof(attr);
+         attr.type           = PERF_TYPE_HW_CACHE;
+         attr.config         = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                               (result << 16);
+         attr.disabled       = 1;
+         attr.exclude_kernel = 1;
+         attr.exclude_hv     = 1;
+         return int(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+      }
+#endif
+      static uint64_t read_counter(int fd)
+      {
+         uint64_t v = 0;
+         if (fd < 0 || ::read(fd, &v, sizeof(v)) != sizeof(v))
+            return 0;
+         return v;
+      }
+
+      int _loads  = -1;
+      int _misses = -1;
+   };
+
+   /// Prints how much of the process is mapped with PMD (2 MB) pages.
+   inline void print_huge_page_residency()
+   {
+      std::ifstream in("/proc/self/smaps_rollup");
+      std::string   line;
+      std::string   out;
+      while (std::getline(in, line))
+      {
+         auto colon = line.find(':');
+         if (colon == std::string::npos)
+            continue;
+         auto name = line.substr(0, colon);
+         if (name == "AnonHugePages" || name == "ShmemPmdMapped" || name == "FilePmdMapped")
+         {
+            auto value = line.substr(line.find_first_not_of(' ', colon + 1));
+            out += "  " + name + ": " + value;
+         }
+      }
+      if (!out.empty())
+         std::printf("  huge pages:%s\n", out.c_str());
+   }
+}  // namespace bench
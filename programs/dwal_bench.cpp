@@ -1,4 +1,6 @@
+#include <algorithm>
 #include <atomic>
+#include <bit>
 #include <chrono>
 #include <csignal>
 #include <cstring>
@@ -143,6 +145,15 @@ struct bench_config
    uint32_t merge_threads   = 2;
    uint32_t max_rw_entries  = 100000;
    uint64_t pinned_cache_mb = 1024 * 8;
+   uint32_t committers      = 4;  ///< --commit-sync: committing threads
+   uint32_t roots_per_tx    = 4;  ///< --commit-sync: roots written per transaction
+
+   /// --commit-sync: write paths for the per-root WAL phase (one phase each)
+   std::vector<psitri::dwal::wal_io_mode> wal_io          = {psitri::dwal::wal_io_mode::sync};
+   bool                                   wal_preallocate = false;
+
+   uint32_t burst_idle_ms   = 200;  ///< --bursty: pause between bursts
+   uint32_t max_rw_arena_mb = 0;    ///< --bursty: RW arena limit (0 = library default)
 
    bool reset_db = false;
    bool no_mlock = false;
@@ -151,10 +162,15 @@ struct bench_config
    uint32_t reopen_every = 0;  ///< Close and reopen DB every N rounds (0 = disabled).
 
    // Mode selection (default: dwal + rw)
-   bool run_write_only = false;
-   bool run_rw         = false;
-   bool run_direct     = false;
-   bool run_dwal       = false;
+   bool run_write_only   = false;
+   bool run_rw           = false;
+   bool run_direct       = false;
+   bool run_dwal         = false;
+   bool run_sorted_batch = false;  ///< Per-key sorted upserts vs. upsert_batch().
+   bool run_commit_sync  = false;  ///< fsync'd commits: per-root WAL files vs. shared log.
+   bool run_bursty       = false;  ///< Bursty ingest: static vs. adaptive swap thresholds.
+   bool run_scan         = false;  ///< Full scans with and without buffered writes.
+   bool run_read_scale   = false;  ///< Buffered point gets by reader thread count.
 
    std::string db_dir   = "./dwal_bench_db";
    std::string csv_path = "./dwal_bench_results.csv";
@@ -522,6 +538,590 @@ static void write_only_bench(const bench_config& cfg,
    print_db_stats("close", db, ws);
 }
 
+// ── Sorted batch benchmark ──────────────────────────────────────
+//
+// Each transaction applies batch_size random keys in ascending order, either
+// one upsert_sorted() per key or a single upsert_batch(), which rebuilds each
+// leaf once per run of keys that land in it.
+
+static void sorted_batch_bench(const bench_config&          cfg,
+                               bool                         use_batch,
+                               csv_logger&                  csv,
+                               const std::filesystem::path& db_dir)
+{
+   const char* phase_name = use_batch ? "sorted_batch" : "sorted_per_key";
+
+   sal::runtime_config rcfg;
+   rcfg.max_pinned_cache_size_mb             = cfg.no_mlock ? 0 : cfg.pinned_cache_mb;
+   rcfg.compact_pinned_unused_threshold_mb   = 1;
+   rcfg.compact_unpinned_unused_threshold_mb = 2;
+
+   auto db = database::open(db_dir, psitri::open_mode::create_or_open, rcfg);
+   auto ws = db->start_write_session();
+   print_db_stats("open", db, ws);
+
+   std::cout << "═══════════════════════════════════════════════════════════════\n"
+             << "  " << phase_name << " — sorted writes per transaction\n"
+             << "  rounds=" << cfg.rounds << " items=" << format_comma(cfg.items)
+             << " batch=" << cfg.batch_size << " val_size=" << cfg.value_size << "\n"
+             << "═══════════════════════════════════════════════════════════════\n";
+
+   std::vector<char>        key;
+   std::vector<std::string> keys;
+   std::vector<batch_op>    ops;
+   uint64_t                 seq = 0;
+
+   auto overall_start = std::chrono::steady_clock::now();
+
+   for (uint32_t r = 0; r < cfg.rounds && !bench::interrupted(); ++r)
+   {
+      reshuffle_random_buf();
+      auto     start    = std::chrono::steady_clock::now();
+      uint32_t inserted = 0;
+
+      while (inserted < cfg.items && !bench::interrupted())
+      {
+         uint32_t batch = std::min(cfg.batch_size, cfg.items - inserted);
+         keys.clear();
+         for (uint32_t i = 0; i < batch; ++i)
+         {
+            to_key(rand_from_seq(seq + i), key);
+            keys.emplace_back(key.data(), key.size());
+         }
+         std::sort(keys.begin(), keys.end());
+         keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+         auto tx = ws->start_transaction(0);
+         if (use_batch)
+         {
+            ops.clear();
+            for (size_t i = 0; i < keys.size(); ++i)
+               ops.push_back({keys[i], value_type(random_value(seq + i, cfg.value_size))});
+            tx.upsert_batch(ops);
+         }
+         else
+         {
+            for (size_t i = 0; i < keys.size(); ++i)
+               tx.upsert_sorted(keys[i], random_value(seq + i, cfg.value_size));
+         }
+         tx.commit();
+         seq += batch;
+         inserted += batch;
+      }
+
+      auto     end      = std::chrono::steady_clock::now();
+      double   secs     = std::chrono::duration<double>(end - start).count();
+      uint64_t ips      = uint64_t(inserted / secs);
+      auto     db_bytes = dir_size_bytes(db_dir);
+      auto     stats    = db->get_stats();
+
+      std::cout << std::setw(4) << std::left << r << " " << std::setw(14) << std::right
+                << format_comma(seq) << "  " << std::setw(12) << format_comma(ips)
+                << "  upserts/sec  db=" << format_size(db_bytes)
+                << "  alloc=" << format_comma(ws->get_total_allocated_objects()) << std::endl;
+
+      csv.log_round(phase_name, r, seq, ips, 0, 0.0, 0, db_bytes, stats.total_free_bytes,
+                    ws->get_total_allocated_objects(), ws->get_pending_release_count(),
+                    stats.pinned_bytes, stats.pinned_segments, stats.recycled_queue_depth);
+   }
+
+   double overall_secs =
+       std::chrono::duration<double>(std::chrono::steady_clock::now() - overall_start).count();
+   std::cout << "───────────────────────────────────────────────────────────────\n"
+             << "total: " << format_comma(seq) << " upserts in " << std::fixed
+             << std::setprecision(3) << overall_secs << " sec  ("
+             << format_comma(uint64_t(seq / overall_secs)) << " upserts/sec)\n";
+   print_db_stats("close", db, ws);
+}
+
+// ── Commit-sync benchmark ──────────────────────────────────────
+//
+// Committer threads run multi-root transactions, each on its own roots,
+// with every commit waiting for an fsync of the WAL.  Compares a WAL file
+// per root (one sync per root written) — once per --wal-io write path —
+// with the shared log, where one group commit covers every root and every
+// concurrent committer.
+
+static const char* wal_io_name(psitri::dwal::wal_io_mode mode)
+{
+   switch (mode)
+   {
+      case psitri::dwal::wal_io_mode::thread_pool:
+         return "thread_pool";
+      case psitri::dwal::wal_io_mode::io_uring:
+         return "io_uring";
+      default:
+         return "sync";
+   }
+}
+
+static void commit_sync_bench(const bench_config&          cfg,
+                              bool                         shared_log,
+                              psitri::dwal::wal_io_mode    wal_io,
+                              csv_logger&                  csv,
+                              const std::filesystem::path& db_dir)
+{
+   std::string phase_name = shared_log ? "commit_sync_shared" : "commit_sync_per_root";
+   if (!shared_log && wal_io != psitri::dwal::wal_io_mode::sync)
+      phase_name += std::string("_") + wal_io_name(wal_io);
+
+   sal::runtime_config rcfg;
+   rcfg.max_pinned_cache_size_mb             = cfg.no_mlock ? 0 : cfg.pinned_cache_mb;
+   rcfg.compact_pinned_unused_threshold_mb   = 1;
+   rcfg.compact_unpinned_unused_threshold_mb = 2;
+
+   auto db = database::open(db_dir, psitri::open_mode::create_or_open, rcfg);
+   auto ws = db->start_write_session();
+
+   dwal::dwal_config dcfg;
+   dcfg.merge_threads  = cfg.merge_threads;
+   dcfg.max_rw_entries = cfg.max_rw_entries;
+   dcfg.shared_log      = shared_log;
+   dcfg.commit_sync     = sal::sync_type::fsync;
+   dcfg.wal_io          = wal_io;
+   dcfg.wal_preallocate = cfg.wal_preallocate;
+   auto dwal_db         = std::make_unique<dwal::dwal_database>(db, db_dir / "wal", dcfg);
+   g_active_dwal.store(dwal_db.get(), std::memory_order_relaxed);
+
+   uint32_t roots_per_tx = std::clamp<uint32_t>(cfg.roots_per_tx, 1, cfg.batch_size);
+   uint32_t committers   = std::clamp<uint32_t>(cfg.committers, 1, 512 / roots_per_tx);
+
+   std::cout << "═══════════════════════════════════════════════════════════════\n"
+             << "  " << phase_name << " — fsync per commit\n"
+             << "  rounds=" << cfg.rounds << " items=" << format_comma(cfg.items)
+             << " batch=" << cfg.batch_size << " val_size=" << cfg.value_size << "\n"
+             << "  committers=" << committers << " roots_per_tx=" << roots_per_tx;
+   if (!shared_log)
+      std::cout << " wal_io="
+                << wal_io_name(dwal_db->wal_io() ? dwal_db->wal_io()->mode()
+                                                 : dwal::wal_io_mode::sync)
+                << " prealloc=" << (cfg.wal_preallocate ? "on" : "off");
+   std::cout << "\n"
+             << "═══════════════════════════════════════════════════════════════\n";
+
+   uint64_t total_keys    = 0;
+   auto     overall_start = std::chrono::steady_clock::now();
+
+   for (uint32_t r = 0; r < cfg.rounds && !bench::interrupted(); ++r)
+   {
+      uint32_t commits_per_thread = std::max<uint32_t>(1, cfg.items / cfg.batch_size / committers);
+      uint64_t syncs_before       = shared_log ? dwal_db->shared_log()->sync_count() : 0;
+
+      dwal::atomic_latency_histogram latency;
+      std::vector<std::thread>       threads;
+      auto                           start = std::chrono::steady_clock::now();
+      for (uint32_t t = 0; t < committers; ++t)
+      {
+         threads.emplace_back(
+             [&, t]
+             {
+                std::vector<uint32_t> roots;
+                for (uint32_t i = 0; i < roots_per_tx; ++i)
+                   roots.push_back(t * roots_per_tx + i);
+
+                std::vector<char> key;
+                uint64_t          seq = (uint64_t(t) << 40) + uint64_t(r) * cfg.items;
+                for (uint32_t c = 0; c < commits_per_thread && !bench::interrupted(); ++c)
+                {
+                   auto              tx_start = std::chrono::steady_clock::now();
+                   dwal::transaction tx(*dwal_db, roots);
+                   for (uint32_t i = 0; i < cfg.batch_size; ++i, ++seq)
+                   {
+                      to_key(rand_from_seq(seq), key);
+                      tx.upsert(roots[i % roots_per_tx], std::string_view(key.data(), key.size()),
+                                std::string_view(random_value(seq, cfg.value_size).data(),
+                                                 cfg.value_size));
+                   }
+                   tx.commit();
+                   latency.record(std::chrono::steady_clock::now() - tx_start);
+                }
+             });
+      }
+      for (auto& th : threads)
+         th.join();
+
+      double   secs  = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      auto     lat   = latency.snapshot();
+      uint64_t keys  = lat.count * cfg.batch_size;
+      uint64_t ips   = uint64_t(keys / secs);
+      uint64_t syncs = shared_log ? dwal_db->shared_log()->sync_count() - syncs_before
+                                  : lat.count * roots_per_tx;
+      total_keys += keys;
+
+      std::cout << std::setw(4) << std::left << r << " " << std::setw(12) << std::right
+                << format_comma(uint64_t(lat.count / secs)) << " commits/sec  "
+                << std::setw(12) << format_comma(ips) << " upserts/sec  latency "
+                << lat.to_string() << "  syncs=" << format_comma(syncs) << std::endl;
+
+      auto stats = db->get_stats();
+      csv.log_round(phase_name.c_str(), r, total_keys, ips, 0, 0.0, 0, dir_size_bytes(db_dir),
+                    stats.total_free_bytes, ws->get_total_allocated_objects(),
+                    ws->get_pending_release_count(), stats.pinned_bytes, stats.pinned_segments,
+                    stats.recycled_queue_depth);
+   }
+
+   double overall_secs =
+       std::chrono::duration<double>(std::chrono::steady_clock::now() - overall_start).count();
+   std::cout << "───────────────────────────────────────────────────────────────\n"
+             << "total: " << format_comma(total_keys) << " upserts in " << std::fixed
+             << std::setprecision(3) << overall_secs << " sec  ("
+             << format_comma(uint64_t(total_keys / overall_secs)) << " upserts/sec)\n";
+
+   g_active_dwal.store(nullptr, std::memory_order_relaxed);
+   dwal_db.reset();
+}
+
+// ── Bursty ingest benchmark ─────────────────────────────────────
+//
+// One writer alternates bursts of --items upserts at full speed with
+// --burst-idle-ms of silence, so the merge pool sees ingest far above and
+// far below its own rate.  Run once with the static swap thresholds and
+// once with dwal_config::adaptive_swap, reporting the commit latency
+// distribution of each — the hard backpressure stall shows up in p99.
+
+static void bursty_bench(const bench_config&          cfg,
+                         bool                         adaptive,
+                         csv_logger&                  csv,
+                         const std::filesystem::path& db_dir)
+{
+   const char* phase_name = adaptive ? "bursty_adaptive" : "bursty_static";
+
+   sal::runtime_config rcfg;
+   rcfg.max_pinned_cache_size_mb             = cfg.no_mlock ? 0 : cfg.pinned_cache_mb;
+   rcfg.compact_pinned_unused_threshold_mb   = 1;
+   rcfg.compact_unpinned_unused_threshold_mb = 2;
+
+   auto db = database::open(db_dir, psitri::open_mode::create_or_open, rcfg);
+   auto ws = db->start_write_session();
+
+   dwal::dwal_config dcfg;
+   dcfg.merge_threads  = cfg.merge_threads;
+   dcfg.max_rw_entries = cfg.max_rw_entries;
+   dcfg.adaptive_swap  = adaptive;
+   if (cfg.max_rw_arena_mb)
+      dcfg.max_rw_arena_bytes = uint64_t(cfg.max_rw_arena_mb) << 20;
+   auto dwal_db = std::make_unique<dwal::dwal_database>(db, db_dir / "wal", dcfg);
+   g_active_dwal.store(dwal_db.get(), std::memory_order_relaxed);
+
+   std::cout << "═══════════════════════════════════════════════════════════════\n"
+             << "  " << phase_name << " — bursts of writes with idle gaps\n"
+             << "  rounds=" << cfg.rounds << " items=" << format_comma(cfg.items)
+             << " batch=" << cfg.batch_size << " val_size=" << cfg.value_size
+             << " idle=" << cfg.burst_idle_ms << "ms\n"
+             << "  max_rw=" << format_comma(cfg.max_rw_entries)
+             << " arena_limit=" << format_size(dcfg.max_rw_arena_bytes) << "\n"
+             << "═══════════════════════════════════════════════════════════════\n";
+
+   std::vector<char>              key;
+   uint64_t                       seq = 0;
+   dwal::atomic_latency_histogram overall;
+   auto                           overall_start = std::chrono::steady_clock::now();
+
+   for (uint32_t r = 0; r < cfg.rounds && !bench::interrupted(); ++r)
+   {
+      reshuffle_random_buf();
+      dwal::atomic_latency_histogram latency;
+      auto                           start    = std::chrono::steady_clock::now();
+      uint32_t                       inserted = 0;
+
+      while (inserted < cfg.items && !bench::interrupted())
+      {
+         uint32_t batch    = std::min(cfg.batch_size, cfg.items - inserted);
+         auto     tx_start = std::chrono::steady_clock::now();
+         auto     tx       = dwal_db->start_write_transaction(0);
+         for (uint32_t i = 0; i < batch; ++i, ++seq)
+         {
+            to_key(rand_from_seq(seq), key);
+            tx.upsert(std::string_view(key.data(), key.size()),
+                      std::string_view(random_value(seq, cfg.value_size).data(), cfg.value_size));
+         }
+         tx.commit();
+         auto lat = std::chrono::steady_clock::now() - tx_start;
+         latency.record(lat);
+         overall.record(lat);
+         inserted += batch;
+      }
+
+      double   secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      uint64_t ips  = uint64_t(inserted / secs);
+      auto     lat  = latency.snapshot();
+
+      std::cout << std::setw(4) << std::left << r << " " << std::setw(12) << std::right
+                << format_comma(ips) << " upserts/sec  latency " << lat.to_string();
+      auto ms = dwal_db->get_merge_stats();
+      for (auto& [root, f] : ms.root_flow)
+         std::cout << "  " << f.to_string();
+      std::cout << std::endl;
+
+      auto stats = db->get_stats();
+      csv.log_round(phase_name, r, seq, ips, 0, 0.0, 0, dir_size_bytes(db_dir),
+                    stats.total_free_bytes, ws->get_total_allocated_objects(),
+                    ws->get_pending_release_count(), stats.pinned_bytes, stats.pinned_segments,
+                    stats.recycled_queue_depth);
+
+      std::this_thread::sleep_for(std::chrono::milliseconds(cfg.burst_idle_ms));
+   }
+
+   auto   all = overall.snapshot();
+   double overall_secs =
+       std::chrono::duration<double>(std::chrono::steady_clock::now() - overall_start).count();
+   std::cout << "───────────────────────────────────────────────────────────────\n"
+             << "total: " << format_comma(seq) << " upserts in " << std::fixed
+             << std::setprecision(3) << overall_secs << " sec (idle included)\n"
+             << "commit latency: " << all.to_string() << "\n"
+             << "p99 commit latency: " << all.percentile_us(0.99) << " us\n"
+             << dwal_db->get_merge_stats().to_string();
+
+   g_active_dwal.store(nullptr, std::memory_order_relaxed);
+   dwal_db.reset();
+}
+
+// ── Scan benchmark ─────────────────────────────────────────────
+//
+// Full scans of root 0, --items keys in the Tri, through the DWAL merge
+// cursor (read_mode::latest): first with nothing buffered, then with an RO
+// and an RW btree of --max-rw writes each — overwrites, removes and short
+// range removes over the same keys.  Each round also scans the Tri cursor
+// alone as the baseline.
+
+static void scan_bench(const bench_config&          cfg,
+                       csv_logger&                  csv,
+                       const std::filesystem::path& db_dir)
+{
+   sal::runtime_config rcfg;
+   rcfg.max_pinned_cache_size_mb             = cfg.no_mlock ? 0 : cfg.pinned_cache_mb;
+   rcfg.compact_pinned_unused_threshold_mb   = 1;
+   rcfg.compact_unpinned_unused_threshold_mb = 2;
+
+   auto db = database::open(db_dir, psitri::open_mode::create_or_open, rcfg);
+   auto ws = db->start_write_session();
+
+   std::cout << "═══════════════════════════════════════════════════════════════\n"
+             << "  scan — full scans through the DWAL merge cursor\n"
+             << "  rounds=" << cfg.rounds << " items=" << format_comma(cfg.items)
+             << " buffered=" << format_comma(cfg.max_rw_entries) << " per layer"
+             << " val_size=" << cfg.value_size << "\n"
+             << "═══════════════════════════════════════════════════════════════\n";
+
+   std::vector<char> key;
+   for (uint64_t seq = 0; seq < cfg.items && !bench::interrupted();)
+   {
+      auto tx = ws->start_transaction(0);
+      for (uint32_t i = 0; i < 10000 && seq < cfg.items; ++i, ++seq)
+      {
+         to_key(rand_from_seq(seq), key);
+         tx.upsert(std::string_view(key.data(), key.size()), random_value(seq, cfg.value_size));
+      }
+      tx.commit();
+   }
+
+   // No merge threads: the RO btree stays buffered for the whole run.
+   dwal::dwal_config dcfg;
+   dcfg.merge_threads  = 0;
+   dcfg.max_rw_entries = UINT32_MAX;
+   auto dwal_db = std::make_unique<dwal::dwal_database>(db, db_dir / "wal", dcfg);
+   g_active_dwal.store(dwal_db.get(), std::memory_order_relaxed);
+
+   // Rewrites existing keys: every 10th is removed, and every 1000th
+   // starts a range remove spanning about 100 of them.
+   uint64_t buffered_seq = 0;
+   auto     buffer_writes = [&]
+   {
+      auto tx = dwal_db->start_write_transaction(0);
+      for (uint32_t i = 0; i < cfg.max_rw_entries; ++i, ++buffered_seq)
+      {
+         uint64_t seq = (buffered_seq * 7919) % cfg.items;
+         to_key(rand_from_seq(seq), key);
+         std::string_view k(key.data(), key.size());
+         // Keys compare by their bytes, so the range end is computed on the
+         // key read as a big-endian number.
+         uint64_t order = std::byteswap(uint64_t(rand_from_seq(seq)));
+         uint64_t span  = UINT64_MAX / cfg.items * 100;
+         if (i % 1000 == 0 && order + span > order)
+         {
+            std::string low(k);
+            to_key(std::byteswap(order + span), key);
+            tx.remove_range(low, std::string_view(key.data(), key.size()));
+         }
+         else if (i % 10 == 0)
+            tx.remove(k);
+         else
+            tx.upsert(k, std::string_view(random_value(seq, cfg.value_size).data(),
+                                          cfg.value_size));
+      }
+      tx.commit();
+   };
+
+   auto tri_rs = db->start_read_session();
+   auto time_scan = [](auto& cur) -> std::pair<uint64_t, double>
+   {
+      auto     start = std::chrono::steady_clock::now();
+      uint64_t keys  = 0;
+      for (cur.seek_begin(); !cur.is_end(); cur.next())
+         ++keys;
+      return {keys, std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+                        .count()};
+   };
+
+   for (const char* phase_name : {"scan_unbuffered", "scan_buffered"})
+   {
+      if (bench::interrupted())
+         break;
+      if (phase_name == std::string_view("scan_buffered"))
+      {
+         buffer_writes();
+         dwal_db->swap_rw_to_ro(0);
+         buffer_writes();
+      }
+      std::cout << phase_name << ":\n";
+
+      for (uint32_t r = 0; r < cfg.rounds && !bench::interrupted(); ++r)
+      {
+         auto tri                  = tri_rs->create_cursor(0);
+         auto [tri_keys, tri_secs] = time_scan(tri);
+         auto mc                   = dwal_db->create_cursor(0, dwal::read_mode::latest);
+         auto [keys, secs]         = time_scan(*mc);
+         uint64_t kps              = uint64_t(keys / secs);
+
+         std::cout << std::setw(4) << std::left << r << " merged " << std::setw(12)
+                   << std::right << format_comma(keys) << " keys " << std::setw(12)
+                   << format_comma(kps) << " keys/sec   tri alone " << std::setw(12)
+                   << format_comma(uint64_t(tri_keys / tri_secs)) << " keys/sec" << std::endl;
+
+         auto stats = db->get_stats();
+         csv.log_round(phase_name, r, keys, kps, 0, 0.0, 0, dir_size_bytes(db_dir),
+                       stats.total_free_bytes, ws->get_total_allocated_objects(),
+                       ws->get_pending_release_count(), stats.pinned_bytes,
+                       stats.pinned_segments, stats.recycled_queue_depth);
+      }
+   }
+
+   g_active_dwal.store(nullptr, std::memory_order_relaxed);
+   dwal_db.reset();
+}
+
+// ── Read scalability benchmark ─────────────────────────────────
+//
+// Point gets from root 0's RO btree (--max-rw keys, left buffered with no
+// merge threads) through dwal_database::get(read_mode::buffered), by
+// reader thread count: 1, 2, 4, ... up to --readers.  Each thread does
+// --items gets per round.
+
+static void read_scale_bench(const bench_config&          cfg,
+                             csv_logger&                  csv,
+                             const std::filesystem::path& db_dir)
+{
+   sal::runtime_config rcfg;
+   rcfg.max_pinned_cache_size_mb             = cfg.no_mlock ? 0 : cfg.pinned_cache_mb;
+   rcfg.compact_pinned_unused_threshold_mb   = 1;
+   rcfg.compact_unpinned_unused_threshold_mb = 2;
+
+   auto db = database::open(db_dir, psitri::open_mode::create_or_open, rcfg);
+   auto ws = db->start_write_session();
+
+   std::cout << "═══════════════════════════════════════════════════════════════\n"
+             << "  read-scale — buffered gets by reader thread count\n"
+             << "  rounds=" << cfg.rounds << " gets/thread=" << format_comma(cfg.items)
+             << " buffered=" << format_comma(cfg.max_rw_entries)
+             << " max_readers=" << cfg.readers << "\n"
+             << "═══════════════════════════════════════════════════════════════\n";
+
+   dwal::dwal_config dcfg;
+   dcfg.merge_threads  = 0;
+   dcfg.max_rw_entries = UINT32_MAX;
+   auto dwal_db = std::make_unique<dwal::dwal_database>(db, db_dir / "wal", dcfg);
+   g_active_dwal.store(dwal_db.get(), std::memory_order_relaxed);
+
+   const uint64_t    keys = std::max<uint64_t>(cfg.max_rw_entries, 1);
+   std::vector<char> key;
+   {
+      auto tx = dwal_db->start_write_transaction(0);
+      for (uint64_t seq = 0; seq < keys; ++seq)
+      {
+         to_key(rand_from_seq(seq), key);
+         tx.upsert(std::string_view(key.data(), key.size()),
+                   std::string_view(random_value(seq, cfg.value_size).data(), cfg.value_size));
+      }
+      tx.commit();
+   }
+   dwal_db->swap_rw_to_ro(0);
+
+   // Fault in the RO btree so the first round is not the slowest.
+   for (uint64_t seq = 0; seq < keys; ++seq)
+   {
+      to_key(rand_from_seq(seq), key);
+      dwal_db->get(0, std::string_view(key.data(), key.size()), dwal::read_mode::buffered);
+   }
+
+   std::vector<uint32_t> thread_counts;
+   for (uint32_t t = 1; t < cfg.readers; t *= 2)
+      thread_counts.push_back(t);
+   thread_counts.push_back(std::max(cfg.readers, 1u));
+
+   uint64_t single = 0;
+   for (uint32_t threads : thread_counts)
+   {
+      for (uint32_t r = 0; r < cfg.rounds && !bench::interrupted(); ++r)
+      {
+         std::atomic<uint64_t>    found{0};
+         std::atomic<uint32_t>    ready{0};
+         std::atomic<bool>        go{false};
+         std::vector<std::thread> readers;
+         for (uint32_t t = 0; t < threads; ++t)
+            readers.emplace_back(
+                [&, t]
+                {
+                   std::vector<char> k;
+                   uint64_t          local_found = 0;
+                   const uint64_t    salt        = rand_from_seq(t * 999983ULL + r + 1);
+                   ready.fetch_add(1, std::memory_order_relaxed);
+                   while (!go.load(std::memory_order_acquire))
+                      ;
+                   for (uint64_t i = 0; i < cfg.items; ++i)
+                   {
+                      to_key(rand_from_seq(rand_from_seq(i + salt) % keys), k);
+                      local_found +=
+                          dwal_db->get(0, std::string_view(k.data(), k.size()),
+                                       dwal::read_mode::buffered)
+                              .found;
+                   }
+                   found.fetch_add(local_found, std::memory_order_relaxed);
+                });
+         while (ready.load(std::memory_order_relaxed) < threads)
+            std::this_thread::yield();
+
+         auto start = std::chrono::steady_clock::now();
+         go.store(true, std::memory_order_release);
+         for (auto& th : readers)
+            th.join();
+         double secs =
+             std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+         uint64_t total = uint64_t(threads) * cfg.items;
+         uint64_t gps   = uint64_t(total / secs);
+         if (threads == 1 && r == 0)
+            single = gps;
+         double found_pct = 100.0 * found.load() / total;
+
+         std::cout << std::setw(3) << std::right << threads << " threads  round " << r
+                   << "  " << std::setw(14) << format_comma(gps) << " gets/sec  "
+                   << std::setw(12) << format_comma(gps / threads) << " per thread  "
+                   << std::fixed << std::setprecision(2)
+                   << (single ? double(gps) / single : 0.0) << "x  found=" << std::setprecision(1)
+                   << found_pct << "%" << std::endl;
+
+         auto stats = db->get_stats();
+         csv.log_round("read_scale", threads, total, 0, gps, found_pct, 0,
+                       dir_size_bytes(db_dir), stats.total_free_bytes,
+                       ws->get_total_allocated_objects(), ws->get_pending_release_count(),
+                       stats.pinned_bytes, stats.pinned_segments, stats.recycled_queue_depth);
+      }
+   }
+
+   g_active_dwal.store(nullptr, std::memory_order_relaxed);
+   dwal_db.reset();
+}
+
 // ── Write + concurrent read benchmark ──────────────────────────
 //
 // 1 writer thread (main), N reader threads, trie read mode only.
@@ -997,6 +1597,11 @@ MODES (default: --dwal --rw):
   --direct            Use direct COW backend (no DWAL buffering)
   --dwal              Use DWAL buffered backend
   --all               All combinations (write-only + rw, direct + dwal)
+  --sorted-batch      Sorted upserts per key vs. upsert_batch (direct; use a large -b)
+  --commit-sync       fsync'd multi-root commits: per-root WAL files vs. shared log
+  --bursty            Bursts of writes with idle gaps: static vs. adaptive swapping
+  --scan              Full scans through the merge cursor, with and without buffered writes
+  --read-scale        Buffered point gets by reader thread count (1, 2, 4, ... up to -t)
 
 OPTIONS:
   -r, --rounds N          Rounds per invocation       (default: 10)
@@ -1006,6 +1611,13 @@ OPTIONS:
   -t, --readers N         Reader threads               (default: 6)
   --merge-threads N       DWAL merge pool threads      (default: 2)
   --max-rw N              DWAL RW btree swap threshold (default: 100,000)
+  --committers N          --commit-sync threads        (default: 4)
+  --roots-per-tx N        --commit-sync roots per tx   (default: 4)
+  --wal-io MODE           --commit-sync per-root WAL writes: sync, thread, uring or all
+                          (default: sync)
+  --wal-prealloc          Preallocate and recycle per-root WAL files
+  --burst-idle-ms N       --bursty pause between bursts (default: 200)
+  --max-rw-arena-mb N     --bursty RW arena limit in MB (default: 1024)
   -d, --db-dir PATH       Database directory prefix    (default: ./dwal_bench_db)
   --csv-log PATH          CSV log file                 (default: ./dwal_bench_results.csv)
   --reset                 Wipe DB directories before starting
@@ -1026,6 +1638,24 @@ EXAMPLES:
   # Direct COW write-only, 100 rounds:
   dwal-bench --direct --write-only -r 100
 
+  # Per-key sorted upserts vs. batched leaf rebuilds, 1000 keys per commit:
+  dwal-bench --sorted-batch -b 1000 --reset
+
+  # Commit latency with an fsync per commit, per-root WALs vs. shared log:
+  dwal-bench --commit-sync -i 40000 -r 3 --committers 8 --reset
+
+  # Per-root commit latency for each WAL write path, preallocated files:
+  dwal-bench --commit-sync --wal-io all --wal-prealloc -i 40000 -r 3 --reset
+
+  # Commit latency under bursts, with a small arena to force backpressure:
+  dwal-bench --bursty -i 500000 -r 6 --max-rw 50000 --max-rw-arena-mb 64 --reset
+
+  # Scan throughput over 2M keys, with 100K buffered writes in RO and RW:
+  dwal-bench --scan -i 2000000 -r 3 --max-rw 100000 --reset
+
+  # Gets/sec from 1 to 16 readers over a 1M-key RO btree:
+  dwal-bench --read-scale -t 16 -i 5000000 -r 1 --max-rw 1000000 --reset
+
   # All 4 combinations, large cache:
   dwal-bench --all --pinned-cache-mb 61440 --reset
 )";
@@ -1103,6 +1733,44 @@ int main(int argc, char** argv)
          cfg.run_direct = true;
       else if (arg == "--dwal")
          cfg.run_dwal = true;
+      else if (arg == "--sorted-batch")
+         cfg.run_sorted_batch = true;
+      else if (arg == "--commit-sync")
+         cfg.run_commit_sync = true;
+      else if (arg == "--bursty")
+         cfg.run_bursty = true;
+      else if (arg == "--scan")
+         cfg.run_scan = true;
+      else if (arg == "--read-scale")
+         cfg.run_read_scale = true;
+      else if (arg == "--burst-idle-ms")
+         cfg.burst_idle_ms = std::stoi(next());
+      else if (arg == "--max-rw-arena-mb")
+         cfg.max_rw_arena_mb = std::stoi(next());
+      else if (arg == "--committers")
+         cfg.committers = std::stoi(next());
+      else if (arg == "--roots-per-tx")
+         cfg.roots_per_tx = std::stoi(next());
+      else if (arg == "--wal-io")
+      {
+         using psitri::dwal::wal_io_mode;
+         auto mode = next();
+         if (mode == "sync")
+            cfg.wal_io = {wal_io_mode::sync};
+         else if (mode == "thread")
+            cfg.wal_io = {wal_io_mode::thread_pool};
+         else if (mode == "uring")
+            cfg.wal_io = {wal_io_mode::io_uring};
+         else if (mode == "all")
+            cfg.wal_io = {wal_io_mode::sync, wal_io_mode::thread_pool, wal_io_mode::io_uring};
+         else
+         {
+            std::cerr << "Unknown --wal-io: " << mode << "\n";
+            return 1;
+         }
+      }
+      else if (arg == "--wal-prealloc")
+         cfg.wal_preallocate = true;
       else if (arg == "--read-mode")
       {
          auto mode = next();
@@ -1140,7 +1808,8 @@ int main(int argc, char** argv)
    }
 
    // Default mode: --dwal --rw
-   if (!cfg.run_write_only && !cfg.run_rw)
+   if (!cfg.run_write_only && !cfg.run_rw && !cfg.run_sorted_batch && !cfg.run_commit_sync &&
+       !cfg.run_bursty && !cfg.run_scan && !cfg.run_read_scale)
       cfg.run_rw = true;
    if (!cfg.run_direct && !cfg.run_dwal)
       cfg.run_dwal = true;
@@ -1164,6 +1833,16 @@ int main(int argc, char** argv)
       std::cout << " write-only";
    if (cfg.run_rw)
       std::cout << " rw";
+   if (cfg.run_sorted_batch)
+      std::cout << " sorted-batch";
+   if (cfg.run_commit_sync)
+      std::cout << " commit-sync";
+   if (cfg.run_bursty)
+      std::cout << " bursty";
+   if (cfg.run_scan)
+      std::cout << " scan";
+   if (cfg.run_read_scale)
+      std::cout << " read-scale";
    std::cout << " | backends:";
    if (cfg.run_direct)
       std::cout << " direct";
@@ -1215,6 +1894,79 @@ int main(int argc, char** argv)
       std::cout << "\n";
    }
 
+   for (bool use_batch : {false, true})
+   {
+      if (!cfg.run_sorted_batch || bench::interrupted())
+         break;
+
+      auto dir = std::filesystem::path(cfg.db_dir + (use_batch ? "_sorted_batch" : "_sorted_key"));
+      if (cfg.reset_db)
+      {
+         std::error_code ec;
+         std::filesystem::remove_all(dir, ec);
+      }
+      sorted_batch_bench(cfg, use_batch, csv, dir);
+      std::cout << "\n";
+   }
+
+   std::vector<std::pair<bool, psitri::dwal::wal_io_mode>> sync_phases;
+   for (auto mode : cfg.wal_io)
+      sync_phases.emplace_back(false, mode);
+   sync_phases.emplace_back(true, psitri::dwal::wal_io_mode::sync);
+   for (auto [shared_log, wal_io] : sync_phases)
+   {
+      if (!cfg.run_commit_sync || bench::interrupted())
+         break;
+
+      auto dir = std::filesystem::path(cfg.db_dir + (shared_log ? "_sync_shared" : "_sync_root"));
+      if (cfg.reset_db)
+      {
+         std::error_code ec;
+         std::filesystem::remove_all(dir, ec);
+      }
+      commit_sync_bench(cfg, shared_log, wal_io, csv, dir);
+      std::cout << "\n";
+   }
+
+   for (bool adaptive : {false, true})
+   {
+      if (!cfg.run_bursty || bench::interrupted())
+         break;
+
+      auto dir = std::filesystem::path(cfg.db_dir + (adaptive ? "_bursty_adaptive" : "_bursty_static"));
+      if (cfg.reset_db)
+      {
+         std::error_code ec;
+         std::filesystem::remove_all(dir, ec);
+      }
+      bursty_bench(cfg, adaptive, csv, dir);
+      std::cout << "\n";
+   }
+
+   if (cfg.run_scan && !bench::interrupted())
+   {
+      auto dir = std::filesystem::path(cfg.db_dir + "_scan");
+      if (cfg.reset_db)
+      {
+         std::error_code ec;
+         std::filesystem::remove_all(dir, ec);
+      }
+      scan_bench(cfg, csv, dir);
+      std::cout << "\n";
+   }
+
+   if (cfg.run_read_scale && !bench::interrupted())
+   {
+      auto dir = std::filesystem::path(cfg.db_dir + "_read_scale");
+      if (cfg.reset_db)
+      {
+         std::error_code ec;
+         std::filesystem::remove_all(dir, ec);
+      }
+      read_scale_bench(cfg, csv, dir);
+      std::cout << "\n";
+   }
+
    csv.log_marker("run_end");
    std::cout << "done.\n";
    return 0;
@@ -370,6 +370,8 @@ class PsiTriEngine : public KVEngine
                 << "  avg_clines/inner: " << std::fixed << std::setprecision(2)
                 << s.average_clines_per_inner_node()
                 << "  avg_branches/inner: " << s.average_branch_per_inner_node() << "\n";
+      std::cout << "  leaf_bytes: " << format_comma(s.total_leaf_size) << "  avg_leaf_size: "
+                << (s.leaf_nodes ? s.total_leaf_size / s.leaf_nodes : 0) << "\n";
       std::cout << "  stats took " << std::fixed << std::setprecision(3) << elapsed << " sec\n";
    }
 };
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <csignal>
@@ -6,11 +7,13 @@
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <sys/resource.h>
 #include <thread>
 #include <unistd.h>
 #include <vector>
 
 #include "bench_signal.hpp"
+#include "bench_tlb.hpp"
 
 #include <boost/program_options/cmdline.hpp>
 #include <boost/program_options/options_description.hpp>
@@ -254,19 +257,58 @@ void get_test(benchmark_config   cfg,
    auto              root = ses.get_root(0);
    cursor            cur(root);
 
-   auto     start = std::chrono::steady_clock::now();
-   uint64_t found = 0;
+   bench::tlb_counters tlb;
+   auto                start = std::chrono::steady_clock::now();
+   uint64_t            found = 0;
+   uint64_t            count = 0;
    for (uint64_t i = 0; i < uint64_t(cfg.items) * cfg.rounds && !bench::interrupted(); ++i)
    {
       make_key(i, key);
       auto result = cur.get(key_view(key.data(), key.size()), &buf);
       if (result >= 0)
          ++found;
+      ++count;
    }
    auto   end  = std::chrono::steady_clock::now();
    double secs = std::chrono::duration<double>(end - start).count();
    auto   gps  = uint64_t(found / secs);
-   std::cout << format_comma(gps) << " gets/sec  (" << format_comma(found) << " found)\n";
+   std::cout << format_comma(gps) << " gets/sec  (" << format_comma(found) << " found)\n"
+             << std::flush;
+   tlb.print(count);
+   bench::print_huge_page_residency();
+}
+
+/// Gets that wander a few keys back and forth from the previous one, as
+/// locality-heavy readers do; a cursor positioned in a leaf that spans the
+/// next key resumes there instead of descending from the root.
+void get_near_test(benchmark_config   cfg,
+                   write_session&     ses,
+                   const std::string& name,
+                   auto               make_key)
+{
+   print_header(name, cfg);
+
+   std::vector<char> key;
+   std::string       buf;
+   auto              root  = ses.get_root(0);
+   cursor            cur(root);
+   const uint64_t    total = uint64_t(cfg.items) * cfg.rounds;
+
+   auto     start = std::chrono::steady_clock::now();
+   uint64_t found = 0;
+   uint64_t pos   = 0;
+   for (uint64_t i = 0; i < total && !bench::interrupted(); ++i)
+   {
+      pos = (pos + total - 8 + uint64_t(rand_from_seq(i)) % 17) % total;
+      make_key(pos, key);
+      if (cur.get(key_view(key.data(), key.size()), &buf) >= 0)
+         ++found;
+   }
+   auto   end  = std::chrono::steady_clock::now();
+   double secs = std::chrono::duration<double>(end - start).count();
+   std::cout << format_comma(uint64_t(found / secs)) << " gets/sec  (" << format_comma(found)
+             << " found)\n"
+             << std::flush;
 }
 
 // -- Iterate benchmark --
@@ -401,8 +443,9 @@ void lower_bound_test(benchmark_config   cfg,
    auto              root = ses.get_root(0);
    cursor            cur(root);
 
-   auto     start = std::chrono::steady_clock::now();
-   uint64_t count = 0;
+   bench::tlb_counters tlb;
+   auto                start = std::chrono::steady_clock::now();
+   uint64_t            count = 0;
    for (uint64_t i = 0; i < uint64_t(cfg.items) * cfg.rounds && !bench::interrupted(); ++i)
    {
       make_key(i, key);
@@ -412,7 +455,10 @@ void lower_bound_test(benchmark_config   cfg,
    auto   end  = std::chrono::steady_clock::now();
    double secs = std::chrono::duration<double>(end - start).count();
    auto   lps  = uint64_t(count / secs);
-   std::cout << format_comma(lps) << " lower_bounds/sec  (" << format_comma(count) << " ops)\n";
+   std::cout << format_comma(lps) << " lower_bounds/sec  (" << format_comma(count) << " ops)\n"
+             << std::flush;
+   tlb.print(count);
+   bench::print_huge_page_residency();
 }
 
 // -- Random get benchmark (point lookups, mix of found/not-found) --
@@ -429,9 +475,10 @@ void get_rand_test(benchmark_config   cfg,
    auto              root = ses.get_root(0);
    cursor            cur(root);
 
-   auto     start = std::chrono::steady_clock::now();
-   uint64_t count = 0;
-   uint64_t found = 0;
+   bench::tlb_counters tlb;
+   auto                start = std::chrono::steady_clock::now();
+   uint64_t            count = 0;
+   uint64_t            found = 0;
    for (uint64_t i = 0; i < uint64_t(cfg.items) * cfg.rounds && !bench::interrupted(); ++i)
    {
       make_key(i, key);
@@ -444,7 +491,86 @@ void get_rand_test(benchmark_config   cfg,
    double secs = std::chrono::duration<double>(end - start).count();
    auto   gps  = uint64_t(count / secs);
    std::cout << format_comma(gps) << " gets/sec  (" << format_comma(found) << " found / "
-             << format_comma(count) << " ops)\n";
+             << format_comma(count) << " ops)\n"
+             << std::flush;
+   tlb.print(count);
+   bench::print_huge_page_residency();
+}
+
+// -- Beyond-RAM gets: blocking get vs async_get --
+
+read_task<> cold_get_worker(const cursor& cur,
+                            uint64_t&     next,
+                            uint64_t      count,
+                            uint64_t      total,
+                            uint64_t&     found,
+                            auto          make_key)
+{
+   std::vector<char> key;
+   while (next < count && !bench::interrupted())
+   {
+      make_key(rand_from_seq(next++) % total, key);
+      if (co_await cur.async_get(key_view(key.data(), key.size())))
+         ++found;
+   }
+}
+
+/// Gets of known keys with the unpinned segments paged out before each
+/// pass: first one blocking get at a time, then with a read_scheduler
+/// keeping `depth` async_gets in flight on this one thread.  Pair with
+/// --pinned-mb to leave most of the tree unpinned.
+void cold_get_test(benchmark_config   cfg,
+                   database&          db,
+                   write_session&     ses,
+                   const std::string& name,
+                   auto               make_key)
+{
+   print_header(name, cfg);
+
+   const uint64_t total = uint64_t(cfg.items) * cfg.rounds;
+   cursor         cur(ses.get_root(0));
+
+   for (uint32_t depth : {0u, 16u, 64u, 256u})
+   {
+      if (bench::interrupted())
+         break;
+      uint32_t advised = db.page_out_unpinned();
+
+      rusage before{}, after{};
+      getrusage(RUSAGE_SELF, &before);
+      auto     start = std::chrono::steady_clock::now();
+      uint64_t found = 0;
+      if (depth == 0)
+      {
+         std::vector<char> key;
+         std::string       buf;
+         for (uint64_t i = 0; i < cfg.items && !bench::interrupted(); ++i)
+         {
+            make_key(rand_from_seq(i) % total, key);
+            if (cur.get(key_view(key.data(), key.size()), &buf) >= 0)
+               ++found;
+         }
+      }
+      else
+      {
+         uint64_t       next = 0;
+         read_scheduler sched;
+         for (uint32_t d = 0; d < depth; ++d)
+            sched.spawn(cold_get_worker(cur, next, cfg.items, total, found, make_key));
+         sched.run();
+      }
+      auto end = std::chrono::steady_clock::now();
+      getrusage(RUSAGE_SELF, &after);
+
+      double secs = std::chrono::duration<double>(end - start).count();
+      std::cout << std::setw(12) << std::left
+                << (depth ? "async x" + std::to_string(depth) : std::string("blocking"))
+                << std::setw(12) << std::right << format_comma(uint64_t(found / secs))
+                << " gets/sec  " << std::setw(10) << format_comma(after.ru_majflt - before.ru_majflt)
+                << " major faults  (" << format_comma(found) << " found, " << advised
+                << " segments paged out)\n"
+                << std::flush;
+   }
 }
 
 // -- Multi-writer benchmark: N writers each on their own tree --
@@ -769,6 +895,132 @@ void multithread_rw_test(benchmark_config            cfg,
              << format_comma(uint64_t(final_ops / overall_secs)) << "/sec\n";
 }
 
+// -- Recovery benchmark: reopen with each recovery mode at increasing thread counts --
+
+void recovery_test(std::shared_ptr<database>& db, const std::string& db_dir, uint32_t max_threads)
+{
+   std::cout << "---------------------  recovery  "
+             << "-------------------------------------\n";
+   std::cout << "recovery threads: 1.." << max_threads << "\n";
+   std::cout << "-----------------------------------------------------------------------\n";
+
+   struct mode_case
+   {
+      const char*   name;
+      recovery_mode mode;
+   };
+   // power_loss last: without --sync full it may roll roots back, shrinking
+   // the database measured by later runs
+   const mode_case modes[] = {{"app_crash", recovery_mode::app_crash},
+                              {"full_verify", recovery_mode::full_verify},
+                              {"power_loss", recovery_mode::power_loss}};
+
+   for (const auto& m : modes)
+   {
+      double single = 0;
+      for (uint32_t t = 1; !bench::interrupted(); t = std::min(t * 2, max_threads))
+      {
+         db.reset();
+
+         runtime_config rc;
+         rc.recovery_threads = t;
+         auto start          = std::chrono::steady_clock::now();
+         db                  = database::open(db_dir, open_mode::create_or_open, rc, m.mode);
+         double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+         if (t == 1)
+            single = elapsed;
+
+         std::cout << std::setw(12) << std::left << m.name << std::right
+                   << " threads: " << std::setw(3) << t
+                   << "  open: " << std::fixed << std::setprecision(3) << elapsed << " sec"
+                   << "  speedup: " << std::setprecision(2) << single / elapsed << "x\n";
+
+         if (t >= max_threads)
+            break;
+      }
+   }
+}
+
+// -- Durability benchmark: commit latency of mprotect vs background_full vs fsync --
+
+void durability_test(benchmark_config          cfg,
+                     std::shared_ptr<database>& db,
+                     write_session&            ses,
+                     auto                      make_key)
+{
+   const uint32_t commits = std::max(1u, cfg.items / cfg.batch_size);
+   std::cout << "---------------------  durability  "
+             << "-----------------------------------\n";
+   std::cout << "commits: " << format_comma(commits) << "  batch: " << format_comma(cfg.batch_size)
+             << "  value_size: " << cfg.value_size << "\n";
+   std::cout << "-----------------------------------------------------------------------\n";
+
+   struct mode_case
+   {
+      const char*    name;
+      sal::sync_type mode;
+   };
+   const mode_case modes[] = {{"mprotect", sal::sync_type::mprotect},
+                              {"background_full", sal::sync_type::background_full},
+                              {"fsync", sal::sync_type::fsync}};
+
+   std::vector<char>   key;
+   std::vector<double> latency_us;
+   uint64_t            seq = 0;
+   for (const auto& m : modes)
+   {
+      if (bench::interrupted())
+         break;
+      ses.set_sync(m.mode);
+      latency_us.clear();
+      uint64_t max_lag = 0;
+
+      auto start = std::chrono::steady_clock::now();
+      for (uint32_t c = 0; c < commits && !bench::interrupted(); ++c)
+      {
+         reshuffle_random_buf();
+         auto tx = ses.start_transaction(0);
+         for (uint32_t i = 0; i < cfg.batch_size; ++i, ++seq)
+         {
+            make_key(seq, key);
+            tx.upsert(key_view(key.data(), key.size()), random_value(seq, cfg.value_size));
+         }
+         auto t0 = std::chrono::steady_clock::now();
+         tx.commit();
+         latency_us.push_back(
+             std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0)
+                 .count());
+
+         // stats walk the allocator, sample them sparingly
+         if (m.mode == sal::sync_type::background_full && c % 64 == 0)
+            max_lag = std::max(max_lag, db->get_stats().durability_lag_ms);
+      }
+      double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      if (latency_us.empty())
+         break;
+
+      std::sort(latency_us.begin(), latency_us.end());
+      auto pct = [&](double p) { return latency_us[size_t(p * (latency_us.size() - 1))]; };
+      std::cout << std::setw(16) << std::left << m.name << std::right << std::setw(10)
+                << format_comma(uint64_t(latency_us.size() / secs)) << " commits/sec"
+                << "  p50: " << std::fixed << std::setprecision(1) << std::setw(8) << pct(0.50)
+                << " us  p99: " << std::setw(8) << pct(0.99) << " us";
+      if (m.mode == sal::sync_type::background_full)
+      {
+         // time to make everything committed above durable
+         auto w0 = std::chrono::steady_clock::now();
+         db->wait_for_durability();
+         double drain_ms =
+             std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - w0)
+                 .count();
+         std::cout << "  max lag: " << max_lag << " ms  drain: " << std::setprecision(1)
+                   << drain_ms << " ms";
+      }
+      std::cout << "\n";
+   }
+   ses.set_sync(cfg.sync);
+}
+
 static void crash_handler(int sig, siginfo_t* info, void* /*ctx*/)
 {
    const char* name = (sig == SIGBUS) ? "SIGBUS" : (sig == SIGSEGV) ? "SIGSEGV" : "SIGILL";
@@ -799,6 +1051,8 @@ int main(int argc, char** argv)
    bool        reset    = false;
    bool        stat     = false;
    bool        validate = false;
+   bool        huge     = false;
+   uint64_t    pinned_mb;
    std::string db_dir   = "./psitridb";
    std::string bench    = "all";
    std::string sync_str = "none";
@@ -811,15 +1065,21 @@ int main(int argc, char** argv)
    opt("batch,b", po::value<uint32_t>(&batch)->default_value(512), "batch size");
    opt("items,i", po::value<uint32_t>(&items)->default_value(1000000), "number of items per round");
    opt("value-size,s", po::value<uint32_t>(&value_size)->default_value(8), "value size in bytes");
-   opt("threads,t", po::value<uint32_t>(&threads)->default_value(4), "number of read threads for multithread test");
+   opt("threads,t", po::value<uint32_t>(&threads)->default_value(4), "number of read threads for multithread test (max recovery threads for recovery)");
    opt("db-dir,d", po::value<std::string>(&db_dir)->default_value("./psitridb"), "database dir");
    opt("bench", po::value<std::string>(&bench)->default_value("all"),
        "benchmark: all, insert, upsert, get, iterate, remove, remove-rand, lower-bound, get-rand, "
        "multiwriter-rand, multiwriter-seq, "
        "multithread-lowerbound-rand, multithread-lowerbound-known, "
-       "multithread-get-rand, multithread-get-known");
+       "multithread-get-rand, multithread-get-known, durability, recovery, "
+       "cold-get (not part of all)");
    opt("sync", po::value<std::string>(&sync_str)->default_value("none"),
-       "sync mode: none (no sync), safe (msync async), full (msync sync)");
+       "sync mode: none (no sync), safe (msync async), full (msync sync), "
+       "background (mprotect, fsync within max_durability_lag_ms)");
+   opt("huge-pages", po::bool_switch(&huge)->default_value(false),
+       "back pinned segments and control blocks with transparent huge pages");
+   opt("pinned-mb", po::value<uint64_t>(&pinned_mb)->default_value(runtime_config().max_pinned_cache_size_mb),
+       "RAM for pinned segments in MB; the rest of the database can be paged out");
    opt("reset", po::bool_switch(&reset), "reset database before running");
    opt("stat", po::bool_switch(&stat)->default_value(false), "print database stats and exit");
    opt("validate", po::bool_switch(&validate)->default_value(false), "validate tree after each round");
@@ -844,7 +1104,10 @@ int main(int argc, char** argv)
    // Open or create
    bool created = !std::filesystem::exists(db_dir / std::filesystem::path("data"));
 
-   auto db  = database::open(db_dir);
+   runtime_config rc;
+   rc.huge_pages = huge;
+   rc.max_pinned_cache_size_mb = pinned_mb;
+   auto db       = database::open(db_dir, open_mode::create_or_open, rc);
    auto ses = db->start_write_session();
 
    if (stat)
@@ -858,9 +1121,11 @@ int main(int argc, char** argv)
       sync = sal::sync_type::fsync;
    else if (sync_str == "full")
       sync = sal::sync_type::full;
+   else if (sync_str == "background")
+      sync = sal::sync_type::background_full;
    else if (sync_str != "none")
    {
-      std::cerr << "invalid --sync mode: " << sync_str << " (use none, safe, full)\n";
+      std::cerr << "invalid --sync mode: " << sync_str << " (use none, safe, full, background)\n";
       return 1;
    }
 
@@ -871,7 +1136,7 @@ int main(int argc, char** argv)
    std::cout << "psitri-benchmark: db=" << db_dir << (created ? " (new)" : " (existing)") << "\n";
    std::cout << "rounds=" << rounds << " items=" << format_comma(items)
              << " batch=" << batch << " value_size=" << value_size
-             << " sync=" << sync_str << "\n\n";
+             << " sync=" << sync_str << (huge ? " huge_pages" : "") << "\n\n";
 
    auto run_all    = (bench == "all");
    auto be_seq_key = [](uint64_t seq, auto& v) { to_key(to_big_endian(seq), v); };
@@ -905,6 +1170,8 @@ int main(int argc, char** argv)
    if (should_run("get"))
    {
       get_test(cfg, *ses, "big endian seq get", be_seq_key);
+      if (!bench::interrupted())
+         get_near_test(cfg, *ses, "big endian nearby get", be_seq_key);
       if (!bench::interrupted())
          get_test(cfg, *ses, "dense random get", rand_key);
    }
@@ -970,6 +1237,27 @@ int main(int argc, char** argv)
       print_stats(*ses);
    }
 
+   // -- Commit latency per durability mode --
+   if (should_run("durability"))
+      durability_test(cfg, db, *ses, rand_key);
+
+   // -- Beyond-RAM gets (pages the database out, so only on request) --
+   if (!bench::interrupted() && bench == "cold-get")
+   {
+      if (!ses->get_root(0))
+         insert_test(cfg, *ses, "dense random insert", rand_key);
+      cold_get_test(cfg, *db, *ses, "random get beyond RAM", rand_key);
+   }
+
+   // -- Recovery (reopens the database, so it runs last) --
+   if (should_run("recovery"))
+   {
+      if (!ses->get_root(0))
+         insert_test(cfg, *ses, "dense random insert", rand_key);
+      ses.reset();
+      recovery_test(db, db_dir, std::max(threads, 1u));
+   }
+
    if (bench::interrupted())
       std::cout << "\nInterrupted — exiting gracefully.\n";
    else
@@ -19,18 +19,33 @@
  *   full_zmm_lut    — same but perm vector from a precomputed table (table fits in L1 for N≤12)
  *   vpermt2b_scalar — (baseline) scalar gather using precomputed perm16 table
  *   single_zmm      — pure single-ZMM vpermt2b for tiny headers (≤64 bytes total)
+ *   capacity3       — arrays sized by slot capacity: three independent tail
+ *                     memmoves, clines untouched (the layout leaf_node uses)
+ *
+ * It also times the other two operations the cacheline layout targets: the
+ * key-hash scan behind a point get (find_byte loop vs match_byte_mask32) and
+ * the COW clone copy (exact memcpy vs memcpy_aligned_64byte), then runs insert,
+ * get and clone on real leaf_node instances.
  *
  * Build:  cmake --build build/release --target leaf-insert-benchmark
  * Run:    ./build/release/bin/leaf-insert-benchmark
  */
 
 #include <algorithm>
+#include <bit>
 #include <cassert>
 #include <chrono>
 #include <cstdint>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <random>
+#include <string>
+#include <vector>
+
+#include <psitri/node/leaf.hpp>
+#include <psitri/util.hpp>
+#include <ucc/fast_memcpy.hpp>
 
 #if defined(__AVX512VBMI2__) || defined(__AVX512VBMI__)
 #include <immintrin.h>
@@ -736,6 +751,240 @@ static void verify_all(const char* name, Fn&& fn)
    printf("  %-16s  %s\n", name, fails ? "FAIL" : "OK");
 }
 
+// ── approach 9: capacity layout — arrays sized by slot capacity, not N ───────
+//
+// With `K` slots per array (K >= N+1) the arrays no longer slide against each
+// other on insert: each array only shifts its own tail, and the clines never
+// move.  This is the layout leaf_node uses.
+
+struct CapHeader
+{
+   alignas(64) uint8_t buf[BUF];
+   int N;
+   int C;
+   int K;
+
+   uint8_t*  kh() noexcept { return buf; }
+   uint16_t* ko() noexcept { return reinterpret_cast<uint16_t*>(buf + K); }
+   uint16_t* vo() noexcept { return reinterpret_cast<uint16_t*>(buf + 3 * K); }
+   uint32_t* cl() noexcept { return reinterpret_cast<uint32_t*>(buf + 5 * K); }
+
+   void load(Header& h)
+   {
+      N = h.N; C = h.C; K = std::max(N + 1, (N + 8) & ~7);
+      std::memcpy(kh(), h.kh(), N);
+      std::memcpy(ko(), h.ko(), N * 2);
+      std::memcpy(vo(), h.vo(), N * 2);
+      std::memcpy(cl(), h.cl(), C * 4);
+   }
+   bool same_as(Header& h)
+   {
+      return N == h.N && std::memcmp(kh(), h.kh(), N) == 0 &&
+             std::memcmp(ko(), h.ko(), N * 2) == 0 && std::memcmp(vo(), h.vo(), N * 2) == 0 &&
+             std::memcmp(cl(), h.cl(), C * 4) == 0;
+   }
+};
+
+static void insert_capacity(CapHeader& h, int bn) noexcept
+{
+   const int tail = h.N - bn;
+   std::memmove(h.kh() + bn + 1, h.kh() + bn, tail);
+   std::memmove(h.ko() + bn + 1, h.ko() + bn, tail * 2);
+   std::memmove(h.vo() + bn + 1, h.vo() + bn, tail * 2);
+   h.N++;
+   h.kh()[bn] = 0; h.ko()[bn] = 0; h.vo()[bn] = 0;
+}
+
+static void verify_capacity()
+{
+   int fails = 0;
+   for (int N : {0, 1, 4, 8, 12, 15, 16, 24, 25, 31, 32, 63, 64, 100, 200})
+      for (int C : {0, 4, 8, 16})
+         for (int frac : {0, 1, 2, 3, 4})
+         {
+            int bn = (N * frac) / 4;
+            if ((N + 8) * 5 + C * 4 + 64 > BUF) continue;
+
+            Header ref;
+            ref.N = N; ref.C = C;
+            ref.fill_random();
+            CapHeader tst;
+            tst.load(ref);
+
+            insert_reference(ref, bn);
+            insert_capacity(tst, bn);
+            if (!tst.same_as(ref))
+            {
+               if (fails < 2) printf("    FAIL N=%-3d C=%-2d bn=%-3d\n", N, C, bn);
+               ++fails; ++g_failures;
+            }
+         }
+   printf("  %-16s  %s\n", "capacity3", fails ? "FAIL" : "OK");
+}
+
+// ── point get: key-hash scan ──────────────────────────────────────────────────
+//
+// leaf_node::get() scans the 1-byte key hashes for candidates.  The old loop
+// restarted find_byte after every false positive and handled the tail with
+// scalar code; the masked scan compares 32 hashes per vector and walks the
+// match bits.  Reading past N is safe in the node because the key offsets
+// follow the hashes, so the benchmark mirrors that with a full buffer.
+
+static int scan_find_byte(const uint8_t* kh, int N, uint8_t h, int want) noexcept
+{
+   int base = 0, remaining = N;
+   while (remaining)
+   {
+      int idx = psitri::find_byte(kh + base, remaining, h);
+      if (idx == remaining) return N;
+      base += idx;
+      if (base == want) return base;
+      ++base; remaining = N - base;
+   }
+   return N;
+}
+
+static int scan_mask32(const uint8_t* kh, int N, uint8_t h, int want) noexcept
+{
+   for (int base = 0; base < N; base += 32)
+   {
+      uint32_t m = psitri::match_byte_mask32(kh + base, h);
+      if (N - base < 32) m &= (1u << (N - base)) - 1;
+      while (m)
+      {
+         int i = base + std::countr_zero(m);
+         if (i == want) return i;
+         m &= m - 1;
+      }
+   }
+   return N;
+}
+
+static void verify_scan()
+{
+   int     fails = 0;
+   uint8_t kh[BUF];
+   for (int N : {1, 7, 8, 31, 32, 33, 64, 100, 255})
+      for (int rep = 0; rep < 200; ++rep)
+      {
+         for (auto& b : kh) b = uint8_t(rng() & 0x1f);  // dense hash collisions
+         int want = int(rng() % (N + 1));                // N == miss
+         uint8_t h = want < N ? kh[want] : 0xff;
+         if (scan_find_byte(kh, N, h, want) != want || scan_mask32(kh, N, h, want) != want)
+            ++fails, ++g_failures;
+      }
+   printf("  %-16s  %s\n", "hash scan", fails ? "FAIL" : "OK");
+}
+
+static void bench_scan(const char* name, int (*scan)(const uint8_t*, int, uint8_t, int), int N)
+{
+   alignas(64) uint8_t kh[BUF];
+   for (auto& b : kh) b = uint8_t(rng());
+   int i = 0;
+   double ns = bench_ns([&] {
+      int want = i++ % N;
+      g_sink += scan(kh, N, kh[want], want);
+   });
+   printf("  %-18s  N=%-3d         %6.2f ns\n", name, N, ns);
+}
+
+// ── COW clone: copying the live regions ──────────────────────────────────────
+//
+// clone_from copies the header+arrays and the alloc area.  With both regions
+// cacheline aligned and rounded to 64 bytes they can use memcpy_aligned_64byte
+// instead of an exact-length memcpy.
+
+static void bench_clone(int head, int alloc)
+{
+   alignas(64) static uint8_t src[BUF];
+   alignas(64) static uint8_t dst[BUF];
+   for (auto& b : src) b = uint8_t(rng());
+   const int ahead  = (head + 63) & ~63;
+   const int aalloc = (alloc + 63) & ~63;
+
+   double exact = bench_ns([&] {
+      std::memcpy(dst, src, head);
+      std::memcpy(dst + BUF - alloc, src + BUF - alloc, alloc);
+      g_sink ^= dst[0];
+   });
+   double aligned = bench_ns([&] {
+      ucc::memcpy_aligned_64byte(dst, src, ahead);
+      ucc::memcpy_aligned_64byte(dst + BUF - aalloc, src + BUF - aalloc, aalloc);
+      g_sink ^= dst[0];
+   });
+   printf("  head=%-4d alloc=%-4d  memcpy %6.2f ns   aligned64 %6.2f ns\n", head, alloc, exact,
+          aligned);
+}
+
+// ── real leaf_node: insert, point get, COW clone ─────────────────────────────
+
+using psitri::branch_number;
+using psitri::leaf_node;
+
+static leaf_node* make_leaf(void* buf, const std::vector<std::string>& keys, int n)
+{
+   auto* node = new (buf) leaf_node(leaf_node::max_leaf_size, {sal::ptr_address(1), 0}, keys[0],
+                                    psitri::value_type(keys[0]));
+   for (int i = 1; i < n; ++i)
+   {
+      psitri::op::leaf_insert ins{.src   = *node,
+                                  .lb    = node->lower_bound(keys[i]),
+                                  .key   = keys[i],
+                                  .value = psitri::value_type(keys[i])};
+      node->apply(ins);
+   }
+   return node;
+}
+
+static void bench_leaf(int N)
+{
+   std::vector<std::string> keys;
+   for (int i = 0; i < N + 1; ++i)
+   {
+      char k[16];
+      snprintf(k, sizeof(k), "key%05u", unsigned(rng() % 100000));
+      keys.emplace_back(k);
+   }
+   void* a = std::aligned_alloc(64, leaf_node::max_leaf_size);
+   void* b = std::aligned_alloc(64, leaf_node::max_leaf_size);
+
+   // insert one key into an N-branch node (node rebuilt from a snapshot each time)
+   leaf_node* base = make_leaf(a, keys, N);
+   double     ins  = bench_ns(
+       [&] {
+          std::memcpy(b, a, leaf_node::max_leaf_size);
+          auto*                   node = static_cast<leaf_node*>(b);
+          psitri::op::leaf_insert op{.src   = *node,
+                                     .lb    = node->lower_bound(keys[N]),
+                                     .key   = keys[N],
+                                     .value = psitri::value_type(keys[N])};
+          node->apply(op);
+          g_sink += node->num_branches();
+       },
+       500'000);
+   double copy = bench_ns(
+       [&] {
+          std::memcpy(b, a, leaf_node::max_leaf_size);
+          g_sink += static_cast<leaf_node*>(b)->num_branches();
+       },
+       500'000);
+
+   int    i   = 0;
+   double get = bench_ns([&] { g_sink += *base->get(keys[i++ % N]); });
+
+   double clone = bench_ns(
+       [&] {
+          auto* c = new (b) leaf_node(leaf_node::max_leaf_size, {sal::ptr_address(2), 0}, base);
+          g_sink += c->num_branches();
+       },
+       500'000);
+
+   printf("  N=%-3d  insert %6.2f ns   get %6.2f ns   clone %6.2f ns   (capacity %u)\n", N,
+          ins - copy, get, clone, base->capacity());
+   std::free(a);
+   std::free(b);
+}
+
 // ── benchmark ─────────────────────────────────────────────────────────────────
 
 template <typename Fn>
@@ -783,6 +1032,8 @@ int main()
    verify_all("full_zmm_lut2",  insert_full_zmm_lut2);
    verify_all("sliding_lut",    insert_sliding_lut);
 #endif
+   verify_capacity();
+   verify_scan();
 
    if (g_failures) { printf("\n%d failure(s) — aborting.\n\n", g_failures); return 1; }
 
@@ -825,5 +1076,33 @@ int main()
    run_sweep("sliding_lut",   insert_sliding_lut);
 #endif
 
+   printf("  [capacity3]\n");
+   for (auto& tc : cases)
+   {
+      Header seed;
+      seed.N = tc.N; seed.C = C;
+      seed.fill_random();
+      CapHeader h;
+      h.load(seed);
+      double ns = bench_ns([&] { h.N = tc.N; insert_capacity(h, tc.bn); g_sink ^= h.buf[0]; });
+      printf("  %-18s  N=%-3d bn=%-3d  %6.2f ns\n", "capacity3", tc.N, tc.bn, ns);
+   }
+
+   printf("\n--- point get: key-hash scan (ns/lookup) ---\n\n");
+   for (int N : {8, 16, 32, 48, 64, 128})
+   {
+      bench_scan("find_byte loop", scan_find_byte, N);
+      bench_scan("mask32 scan", scan_mask32, N);
+   }
+
+   printf("\n--- COW clone: live-region copy ---\n\n");
+   for (auto [head, alloc] : {std::pair{64 + 8 * 17, 120}, {64 + 16 * 17, 400},
+                              {64 + 40 * 17, 900}, {64 + 64 * 17, 800}})
+      bench_clone(head, alloc);
+
+   printf("\n--- leaf_node: insert (in place), point get, COW clone ---\n\n");
+   for (int N : {6, 12, 20, 36, 60})  // spare slots left, so no growth inside the loop
+      bench_leaf(N);
+
    return 0;
 }